@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+# Decoder/viewer for the binary screen stream (T4.x firmware).
+#
+# Sends 'V' to start streaming and 'v' to stop on exit. Packets are described
+# in src/util/util_screenstream.h.
+#
+#   screenstream.py /dev/ttyACM0              live window (tkinter + Pillow)
+#   screenstream.py /dev/ttyACM0 --png out/   one PNG per received frame
+#   screenstream.py -f capture.bin --png out/ decode a recorded stream
+#
+# Requires pyserial for live capture and Pillow for display/PNG output.
+
+import argparse
+import os
+import time
+
+WIDTH, HEIGHT = 128, 64
+FRAME_SIZE = WIDTH * HEIGHT // 8
+SYNC = b'\xfeS'
+HEADER_SIZE = 6
+CHECKSUM_SIZE = 2
+MAX_PAYLOAD_SIZE = FRAME_SIZE + (FRAME_SIZE + 127) // 128
+
+
+def fletcher16(data):
+    sum1 = sum2 = 0
+    for b in data:
+        sum1 = (sum1 + b) % 255
+        sum2 = (sum2 + sum1) % 255
+    return sum2 << 8 | sum1
+
+
+def unrle(payload):
+    out = bytearray()
+    i = 0
+    while i < len(payload):
+        control = payload[i]
+        i += 1
+        if control < 0x80:
+            out += payload[i:i + control + 1]
+            i += control + 1
+        else:
+            out += bytes([payload[i]]) * (control - 0x80 + 2)
+            i += 1
+    return out
+
+
+class Decoder:
+    def __init__(self):
+        self.buffer = bytearray()
+        self.frame = bytearray(FRAME_SIZE)
+        self.synced = False  # have a keyframe to apply deltas to
+        self.sequence = None
+        self.errors = 0
+        self.packets = 0
+
+    def feed(self, data):
+        """Yields a copy of the frame for every packet applied."""
+        self.buffer += data
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                del self.buffer[:-1]  # keep a possible partial sync byte
+                return
+            del self.buffer[:start]
+            if len(self.buffer) < HEADER_SIZE:
+                return
+            length = self.buffer[4] | self.buffer[5] << 8
+            size = HEADER_SIZE + length + CHECKSUM_SIZE
+            if length > MAX_PAYLOAD_SIZE:
+                del self.buffer[:2]  # not a real header
+                continue
+            if len(self.buffer) < size:
+                return
+
+            packet = bytes(self.buffer[:size])
+            checksum = packet[-2] | packet[-1] << 8
+            if checksum != fletcher16(packet[2:HEADER_SIZE + length]):
+                self.errors += 1
+                self.synced = False
+                del self.buffer[:2]
+                continue
+            del self.buffer[:size]
+
+            kind, sequence = packet[2], packet[3]
+            if self.sequence is not None and sequence != (self.sequence + 1) & 0xff:
+                self.synced = False  # lost some
+            self.sequence = sequence
+
+            data = unrle(packet[HEADER_SIZE:HEADER_SIZE + length])
+            if len(data) != FRAME_SIZE:
+                self.errors += 1
+                self.synced = False
+                continue
+
+            if kind == ord('K'):
+                self.frame[:] = data
+                self.synced = True
+            elif kind == ord('D') and self.synced:
+                for i, d in enumerate(data):
+                    if d:
+                        self.frame[i] ^= d
+            else:
+                continue
+            self.packets += 1
+            yield bytes(self.frame)
+
+
+def to_image(frame, scale):
+    from PIL import Image
+    img = Image.new('1', (WIDTH, HEIGHT))
+    px = img.load()
+    for page in range(HEIGHT // 8):
+        for x in range(WIDTH):
+            b = frame[page * WIDTH + x]
+            for bit in range(8):
+                px[x, page * 8 + bit] = 1 if b & (1 << bit) else 0
+    if scale > 1:
+        img = img.resize((WIDTH * scale, HEIGHT * scale), Image.NEAREST)
+    return img
+
+
+def main():
+    parser = argparse.ArgumentParser(description='O_C screen stream viewer')
+    parser.add_argument('port', nargs='?', help='serial port of the module')
+    parser.add_argument('-f', '--file', help='decode a recorded stream instead')
+    parser.add_argument('--png', metavar='DIR', help='write each frame as a PNG')
+    parser.add_argument('--record', metavar='FILE', help='save the raw stream')
+    parser.add_argument('--rate', type=int, default=7, choices=range(1, 10),
+                        help='max frame rate setting 1-9 (1, 2, 5, 10, 15, 20, 30, 40, 60 fps)')
+    parser.add_argument('--scale', type=int, default=4)
+    args = parser.parse_args()
+    if not args.port and not args.file:
+        parser.error('need a serial port or --file')
+
+    decoder = Decoder()
+    record = open(args.record, 'wb') if args.record else None
+    if args.png:
+        os.makedirs(args.png, exist_ok=True)
+    count = 0
+
+    def handle(frame):
+        nonlocal count
+        count += 1
+        if args.png:
+            to_image(frame, args.scale).save(os.path.join(args.png, 'frame_%05d.png' % count))
+
+    if args.file:
+        with open(args.file, 'rb') as f:
+            for frame in decoder.feed(f.read()):
+                handle(frame)
+        print('%d frames, %d errors' % (count, decoder.errors))
+        return
+
+    import serial
+    port = serial.Serial(args.port, timeout=0.05)
+    port.write(b'V' + str(args.rate).encode())
+
+    last_resync = 0
+
+    def poll():
+        nonlocal last_resync
+        data = port.read(4096)
+        if record:
+            record.write(data)
+        latest = None
+        for frame in decoder.feed(data):
+            handle(frame)
+            latest = frame
+        if not decoder.synced and time.time() - last_resync > 0.5:
+            port.write(b'V')  # ask for a keyframe
+            last_resync = time.time()
+        return latest
+
+    try:
+        if args.png:
+            while True:
+                poll()
+        else:
+            import tkinter as tk
+            from PIL import ImageTk
+            root = tk.Tk()
+            root.title('O_C ' + args.port)
+            label = tk.Label(root)
+            label.pack()
+            started = time.time()
+
+            def update():
+                frame = poll()
+                if frame is not None:
+                    label.image = ImageTk.PhotoImage(to_image(frame, args.scale))
+                    label.configure(image=label.image)
+                    elapsed = time.time() - started
+                    root.title('O_C %s - %.1f fps' % (args.port, count / elapsed if elapsed else 0))
+                root.after(5, update)
+
+            update()
+            root.mainloop()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        port.write(b'v')
+        port.close()
+        if record:
+            record.close()
+
+
+if __name__ == '__main__':
+    main()
@@ -3,7 +3,9 @@
  * Started with example code from ChatGPT.
  */
 
+#include <algorithm>
 #include <memory>
+#include <new>
 #include <type_traits>
 
 using RegID = uint64_t;
@@ -34,30 +36,14 @@ template<RegID First, RegID... Rest>
 struct NoDuplicateIDs<First, Rest...>
     : std::bool_constant<((First != Rest) && ...) && NoDuplicateIDs<Rest...>::value> {};
 
-// --- Registry ---
-template <class T, size_t Slots, typename... Declarations>
-struct Registry {
-    using FactoryFn = T* (*)();
+// --- Compile-time facts about the declared applets ---
+template <typename... Declarations>
+struct RegistryInfo {
     static constexpr size_t Size = sizeof...(Declarations);
 
-    // Compile-time build of factories array
-    static constexpr std::array<FactoryFn, Size> buildFactories() {
-        std::array<FactoryFn, Size> arr{
-          (+[]() -> T* { return new typename Declarations::type(); }) ...
-        };
-        return arr;
-    }
-
-    static constexpr std::array<FactoryFn, Size> factories = buildFactories();
-
-    mutable std::array<std::array<T*, Size>, Slots> instances{}; // Raw pointers, default nullptr
-
-    constexpr Registry() {
-        static_assert(NoDuplicateIDs<Declarations::id...>::value,
-                      "Duplicate Applet IDs detected in Registry!");
-        // TODO: compiler doesn't like this syntax?
-        //(static_assert(Declarations::id <= MaxID, "Applet ID exceeds MaxID for Registry"), ...);
-    }
+    // worst case of all the applet types, for in-place storage
+    static constexpr size_t MaxSize = std::max({sizeof(typename Declarations::type) ...});
+    static constexpr size_t MaxAlign = std::max({alignof(typename Declarations::type) ...});
 
     static constexpr std::array<RegID, sizeof...(Declarations)> getIds() {
       std::array<RegID, sizeof...(Declarations)> arr{ Declarations::id ... };
@@ -73,6 +59,10 @@ struct Registry {
     static constexpr std::array<const uint8_t*, sizeof...(Declarations)> getIcons() {
       return {Declarations::type::applet_icon_() ...};
     }
+    // sizeof each applet, in declaration order. See test/host/applet_sizes.cpp
+    static constexpr std::array<size_t, sizeof...(Declarations)> getSizes() {
+      return {sizeof(typename Declarations::type) ...};
+    }
 
     const char* getName(int index) const {
       return getNames()[index];
@@ -81,15 +71,45 @@ struct Registry {
       return getIcons()[index];
     }
 
+    static constexpr int getIndex(RegID id) {
+      auto Ids = getIds();
+      for (size_t i = 0; i < Size; ++i) {
+        if (id == Ids[i]) return i;
+      }
+      return -1;
+    }
+
+    constexpr RegistryInfo() {
+        static_assert(NoDuplicateIDs<Declarations::id...>::value,
+                      "Duplicate Applet IDs detected in Registry!");
+        // TODO: compiler doesn't like this syntax?
+        //(static_assert(Declarations::id <= MaxID, "Applet ID exceeds MaxID for Registry"), ...);
+    }
+};
+
+// --- Registry ---
+// Each applet is created with new the first time it's used in a slot, and
+// kept forever after that.
+template <class T, size_t Slots, typename... Declarations>
+struct Registry : RegistryInfo<Declarations...> {
+    using Info = RegistryInfo<Declarations...>;
+    using Info::Size;
+    using FactoryFn = T* (*)();
+
+    // Compile-time build of factories array
+    static constexpr std::array<FactoryFn, Size> buildFactories() {
+        std::array<FactoryFn, Size> arr{
+          (+[]() -> T* { return new typename Declarations::type(); }) ...
+        };
+        return arr;
+    }
+
+    static constexpr std::array<FactoryFn, Size> factories = buildFactories();
+
+    mutable std::array<std::array<T*, Size>, Slots> instances{}; // Raw pointers, default nullptr
+
     T* get(RegID id, size_t slot = 0) const {
-        int idx = -1;
-        auto Ids = getIds();
-        for (size_t i = 0; i < Size; ++i) {
-          if (id == Ids[i]) {
-            idx = i;
-            break;
-          }
-        }
+        const int idx = Info::getIndex(id);
         if (idx < 0 || !factories[idx]) {
             return nullptr;
         }
@@ -102,3 +122,73 @@ struct Registry {
         return instances[slot][idx];
     }
 };
+
+#ifndef APPLET_ARENA_BUDGET
+#define APPLET_ARENA_BUDGET 2048 // bytes per applet
+#endif
+
+// --- Registry with fixed storage ---
+// Each slot owns two buffers big enough for the largest applet, and applets
+// are constructed in them with placement new. No heap, and the RAM cost is
+// known at build time: Slots * 2 * BufferSize.
+//
+// Asking for an applet that isn't in either buffer destroys whatever is in
+// the least recently used one and constructs the new applet there. The other
+// buffer still holds the applet being replaced, so it can be Unload()ed and
+// finish its current ISR/View after the switch. The active applet is fetched
+// every tick, which keeps it the most recent.
+//
+// Applets that get switched away and back again start from a fresh object
+// instead of keeping their old state; Start() and OnDataReceive() set them up
+// either way.
+template <class T, size_t Slots, typename... Declarations>
+struct ArenaRegistry : RegistryInfo<Declarations...> {
+    using Info = RegistryInfo<Declarations...>;
+    using Info::Size;
+    using ConstructFn = T* (*)(void *);
+    using DestroyFn = void (*)(T *);
+
+    static constexpr size_t Buffers = 2;
+    static constexpr size_t BufferSize = (Info::MaxSize + Info::MaxAlign - 1) / Info::MaxAlign * Info::MaxAlign;
+
+    static_assert(Info::MaxSize <= APPLET_ARENA_BUDGET,
+                  "An applet is larger than APPLET_ARENA_BUDGET - see `make applet_sizes` in software/test");
+
+    template <class A>
+    static T* construct(void *p) { return new (p) A(); }
+    template <class A>
+    static void destroy(T *p) { static_cast<A *>(p)->~A(); }
+
+    static constexpr std::array<ConstructFn, Size> constructors{ &construct<typename Declarations::type> ... };
+    static constexpr std::array<DestroyFn, Size> destructors{ &destroy<typename Declarations::type> ... };
+
+    alignas(Info::MaxAlign) static inline uint8_t arena[Slots][Buffers][BufferSize];
+
+    mutable std::array<std::array<T*, Buffers>, Slots> instances{};
+    mutable std::array<std::array<int, Buffers>, Slots> loaded{}; // index + 1, 0 = empty
+    mutable std::array<uint8_t, Slots> recent{};
+
+    T* get(RegID id, size_t slot = 0) const {
+        const int idx = Info::getIndex(id);
+        if (idx < 0) {
+            return nullptr;
+        }
+        for (size_t b = 0; b < Buffers; ++b) {
+            if (loaded[slot][b] == idx + 1) {
+                recent[slot] = b;
+                return instances[slot][b];
+            }
+        }
+
+        const size_t b = recent[slot] ^ 1;
+        if (loaded[slot][b]) {
+            destructors[loaded[slot][b] - 1](instances[slot][b]);
+            loaded[slot][b] = 0;
+        }
+        SERIAL_PRINTLN("AppletRegistry: construct - ID: %u Index: %d Slot: %u", id, idx, slot);
+        instances[slot][b] = constructors[idx](arena[slot][b]);
+        loaded[slot][b] = idx + 1;
+        recent[slot] = b;
+        return instances[slot][b];
+    }
+};
@@ -1,13 +1,18 @@
 #pragma once
 
 #include "../dsputils.h"
+#include "PsramArena.h"
 #include <Audio.h>
-#include <smalloc.h>
 
 // TODO: this should be backed by an ordinary ring buffer. I don't think the
 // std::copy helps performance much, so extracting and simplifying the ring
 // logic would both make this easier to work with and simplify things.
-template <typename T = int16_t>
+//
+// With PowerOfTwo set, NumSamples is rounded down to a power of two and
+// read positions wrap with a mask instead of a division. That's most of the
+// cost of a random-access read on the M7, which matters for modulated delay
+// lines reading several taps per sample.
+template <typename T = int16_t, bool PowerOfTwo = false>
 class AudioBuffer {
 public:
   size_t NumSamples;
@@ -15,7 +20,9 @@ public:
   /**
    * Make sure buffer has NumSamples elements and that it is 0 filled!
    **/
-  AudioBuffer(T* buffer, size_t NumSamples) : NumSamples(NumSamples), buffer(buffer) {}
+  AudioBuffer(T* buffer, size_t NumSamples)
+    : NumSamples(PowerOfTwo ? FloorPowerOfTwo(NumSamples) : NumSamples),
+      buffer(buffer) {}
 
   void WriteSample(const T sample) {
     buffer[write_ix++] = sample;
@@ -23,8 +30,7 @@ public:
   }
 
   T ReadSample(size_t samples_back) {
-    int read_ix = (NumSamples + write_ix - samples_back) % NumSamples;
-    return buffer[read_ix];
+    return buffer[ReadIndex(samples_back)];
   }
 
   void Write(const audio_block_t* block) {
@@ -84,7 +90,7 @@ public:
     // TODO: This can read past the write head. It should stop reading at the
     // write head instead and return the number of samples read.
     size_t read = 0;
-    size_t read_ix = (write_ix - samples_back + NumSamples) % NumSamples;
+    size_t read_ix = ReadIndex(samples_back);
     while (N - read + read_ix > NumSamples) {
       std::copy_n(buffer + read_ix, NumSamples - read_ix, data + read);
       read += NumSamples - read_ix;
@@ -103,7 +109,7 @@ public:
     // TODO: This can read past the write head. It should stop reading at the
     // write head instead and return the number of samples read.
     size_t read = 0;
-    size_t read_ix = (write_ix - samples_back + NumSamples) % NumSamples;
+    size_t read_ix = ReadIndex(samples_back);
     while (size - read + read_ix > NumSamples) {
       std::copy_n(buffer + read_ix, NumSamples - read_ix, data + read);
       read += NumSamples - read_ix;
@@ -130,33 +136,88 @@ public:
     );
   }
 
+  enum Interpolation {
+    INTERP_LINEAR,
+    INTERP_HERMITE,
+  };
+
+  // Same as calling ReadInterp() (or its linear equivalent) for each of
+  // samples_back[0..n), but the buffer reads, the interpolation weights and
+  // the interpolation itself are done as separate passes over small arrays,
+  // so the arithmetic runs without index math or branches in between and the
+  // compiler can unroll/pipeline it. Up to AUDIO_BLOCK_SAMPLES at a time is
+  // the intended use; longer requests are done in tiles to bound stack use.
+  template <Interpolation Mode = INTERP_HERMITE>
+  void ReadInterpBlock(const float* samples_back, float* out, size_t n) {
+    static constexpr size_t kTile = 32;
+    static constexpr size_t kPoints = Mode == INTERP_HERMITE ? 4 : 2;
+    float t[kTile];
+    float x[kPoints][kTile];
+
+    while (n) {
+      const size_t count = n < kTile ? n : kTile;
+      for (size_t i = 0; i < count; ++i) {
+        size_t back = static_cast<size_t>(samples_back[i]);
+        t[i] = 1.0f - (samples_back[i] - back);
+        // Oldest point first; the rest follow without another wrap
+        size_t ix = ReadIndex(back + kPoints / 2);
+        for (size_t p = 0; p < kPoints; ++p) {
+          x[p][i] = buffer[ix];
+          if (++ix == NumSamples) ix = 0;
+        }
+      }
+      if (Mode == INTERP_HERMITE) {
+        for (size_t i = 0; i < count; ++i) {
+          out[i] = InterpHermite(x[0][i], x[1][i], x[2][i], x[kPoints - 1][i], t[i]);
+        }
+      } else {
+        for (size_t i = 0; i < count; ++i) {
+          out[i] = InterpLinear(x[0][i], x[1][i], t[i]);
+        }
+      }
+      samples_back += count;
+      out += count;
+      n -= count;
+    }
+  }
+
 protected:
   T* buffer;
   size_t write_ix = 0;
+
+  size_t ReadIndex(size_t samples_back) const {
+    if (PowerOfTwo) return (write_ix - samples_back) & (NumSamples - 1);
+    return (NumSamples + write_ix - samples_back) % NumSamples;
+  }
+
+  static constexpr size_t FloorPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p <= n / 2) p <<= 1;
+    return p;
+  }
 };
 
-template <typename T = int16_t>
-class ExtAudioBuffer : public AudioBuffer<T> {
+template <typename T = int16_t, bool PowerOfTwo = false>
+class ExtAudioBuffer : public AudioBuffer<T, PowerOfTwo> {
 public:
-  ExtAudioBuffer(size_t samples) : AudioBuffer<T>(nullptr, samples) {}
+  ExtAudioBuffer(size_t samples) : AudioBuffer<T, PowerOfTwo>(nullptr, samples) {}
   ~ExtAudioBuffer() {
     Release();
   }
 
+  // Buffers come from the shared PSRAM arena, zero-filled, and are charged
+  // to the audio slot that's starting; see PsramArena.h. Acquire() can
+  // fail if the slot's budget is spent, check IsReady().
   void Acquire() {
     if (this->buffer == nullptr) {
-      this->buffer = static_cast<T*>(extmem_calloc(this->NumSamples, sizeof(T)));
+      this->buffer = static_cast<T*>(PsramArena::Allocate(this->NumSamples * sizeof(T)));
+      this->write_ix = 0;
     }
   }
 
-  // TODO: Might need to 0 data; not sure if better on init or uninit though:
-  // - extmem_calloc assumes the data is already 0-filled
-  // https://github.com/PaulStoffregen/cores/blob/58224e5554d0cda93f92c52078a500a0d898a996/teensy4/extmem.c#L38
-  // - The extmem pool isn't 0-filled on uninit
-  // https://github.com/PaulStoffregen/cores/blob/master/teensy4/startup.c#L500
   void Release() {
     if (this->buffer != nullptr) {
-      extmem_free(this->buffer);
+      PsramArena::Free(this->buffer);
       this->buffer = nullptr;
     }
   }
@@ -2,6 +2,7 @@
 
 #include "AudioBuffer.h"
 #include "AudioParam.h"
+#include "DspTables.h"
 #include "../dsputils.h"
 #include "../dsputils_arm.h"
 #include "../util/util_macros.h"
@@ -14,7 +15,9 @@ template <
   size_t ChunkSize = 8,
   // Crossfade time will be AUDIO_SAMPLE_RATE / CrossfadeSamples
   // 2048 give ~48ms, or ~22hz, just below human audio range
-  size_t CrossfadeSamples = 2048>
+  size_t CrossfadeSamples = 2048,
+  // Round the buffer down to a power of two so reads wrap with a mask
+  bool PowerOfTwoBuffer = false>
 class AudioDelayExt : public AudioStream {
 public:
   float MAX_DELAY_SECS, MIN_DELAY_SECS;
@@ -24,27 +27,15 @@ public:
     fb.fill(Interpolated(0.0f, AUDIO_BLOCK_SAMPLES / ChunkSize));
 
     // -1 and +2 to ensure we have enough points for hermite interpolation
-    MAX_DELAY_SECS = (BufferLength - 1) / AUDIO_SAMPLE_RATE_EXACT;
+    MAX_DELAY_SECS = (buffer.NumSamples - 1) / AUDIO_SAMPLE_RATE_EXACT;
     MIN_DELAY_SECS = (ChunkSize + 2) / AUDIO_SAMPLE_RATE_EXACT;
   }
 
   void Acquire() {
     buffer.Acquire();
-    // TODO xfade lut should be static
-    xfade_in_scalars = new q15_t[CrossfadeSamples];
-    xfade_out_scalars = new q15_t[CrossfadeSamples];
-    float n = static_cast<float>(CrossfadeSamples - 1);
-    for (size_t i = 0; i < CrossfadeSamples; i++) {
-      float out, in;
-      EqualPowerFade(out, in, i / n);
-      xfade_in_scalars[i] = float_to_q15(in);
-      xfade_out_scalars[i] = float_to_q15(out);
-    }
   }
 
   void Release() {
-    delete[] xfade_in_scalars;
-    delete[] xfade_out_scalars;
     buffer.Release();
   }
 
@@ -133,13 +124,15 @@ private:
     // size_t phase_inc = 1;
   };
 
+  // Shared by every delay with the same CrossfadeSamples
+  static constexpr const q15_t* xfade_in_scalars = DspTables::EqualPowerFadeIn<CrossfadeSamples>();
+  static constexpr const q15_t* xfade_out_scalars = DspTables::EqualPowerFadeOut<CrossfadeSamples>();
+
   audio_block_t* input_queue_array[1];
-  q15_t* xfade_in_scalars;
-  q15_t* xfade_out_scalars;
   std::array<CrossfadeTarget, Taps> target_delay;
   std::array<OnePole<Interpolated>, Taps> delay_secs;
   std::array<Interpolated, Taps> fb;
-  ExtAudioBuffer<int16_t> buffer;
+  ExtAudioBuffer<int16_t, PowerOfTwoBuffer> buffer;
   size_t taps_ = Taps;
 
   void ReadCrossfadeChunk(
@@ -182,13 +175,18 @@ private:
     }
   }
 
-  // Bunch of attempts at doing faster pitch shifting modulation, but just doing
-  // sample by sample is shockingly faster than all of them...
+  // Bunch of attempts at doing faster pitch shifting modulation below. Sample
+  // by sample was shockingly faster than all of them; the buffer's block read
+  // beats it by keeping the reads and the math in separate passes.
   void ReadStretchChunk(OnePole<Interpolated>& tap_delay, int16_t* chunk_out) {
+    float samples_back[ChunkSize];
+    float interp[ChunkSize];
+    for (uint_fast8_t sample = 0; sample < ChunkSize; sample++) {
+      samples_back[sample] = tap_delay.ReadNext() * AUDIO_SAMPLE_RATE_EXACT - sample;
+    }
+    buffer.ReadInterpBlock(samples_back, interp, ChunkSize);
     for (uint_fast8_t sample = 0; sample < ChunkSize; sample++) {
-      chunk_out[sample] = Clip16(buffer.ReadInterp(
-        tap_delay.ReadNext() * AUDIO_SAMPLE_RATE_EXACT - sample
-      ));
+      chunk_out[sample] = Clip16(interp[sample]);
     }
   }
 
@@ -97,7 +97,7 @@ public:
         was_held_ = cur_hold;
 
         // Record incoming audio unless freeze is active.
-        if (in && !cur_freeze) g_buffer.Write(in);
+        if (in && !cur_freeze && g_buffer.IsReady()) g_buffer.Write(in);
 
         // LIVE FX mode: FWD + offset=0 + hold (and not frozen) routes live audio
         // through bit crush / sample decimation directly, ignoring div/slice logic.
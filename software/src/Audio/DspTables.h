@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../dsputils.h"
+#include "../util/util_constexpr_math.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Lookup tables shared by the audio effects. Each one is generated at
+// compile time by util::ConstexprTable and only exists in the build if an
+// effect uses it; sized tables get one copy per size. Starting an effect
+// therefore costs no allocation or math, and every instance reads the same
+// table.
+//
+// They're plain const arrays, which Teensy 4 copies to DTCM at startup with
+// the rest of the initialized data. That suits these, as they're read every
+// sample or chunk in update(). A table that's only read now and then should
+// be declared PROGMEM instead, to stay in flash.
+namespace DspTables {
+
+// x in Q15, rounded and saturated like float_to_q15()
+constexpr int16_t ToQ15(float x) {
+  const int32_t q = static_cast<int32_t>(x * 32768.0f + (x > 0.0f ? 0.5f : -0.5f));
+  return q > 32767 ? 32767 : q < -32768 ? -32768 : q;
+}
+
+// EqualPowerFade() over Size steps, from 0 to 1 inclusive
+template <size_t Size, bool In>
+struct EqualPowerFadeCurve {
+  static constexpr int16_t at(size_t i) {
+    float fade_out = 0.0f, fade_in = 0.0f;
+    EqualPowerFade(fade_out, fade_in, i / static_cast<float>(Size - 1));
+    return ToQ15(In ? fade_in : fade_out);
+  }
+};
+
+template <size_t Size>
+constexpr const int16_t *EqualPowerFadeIn() {
+  return util::ConstexprTable<EqualPowerFadeCurve<Size, true>, Size>::values;
+}
+
+template <size_t Size>
+constexpr const int16_t *EqualPowerFadeOut() {
+  return util::ConstexprTable<EqualPowerFadeCurve<Size, false>, Size>::values;
+}
+
+// Hann window, round(sin²(π i / (Size - 1)) × 32767)
+template <size_t Size>
+struct HannCurve {
+  static constexpr int16_t at(size_t i) {
+    const double s = util::cmath::sin(util::cmath::kPi * i / (Size - 1));
+    return static_cast<int16_t>(s * s * 32767.0 + 0.5);
+  }
+};
+
+template <size_t Size>
+constexpr const int16_t *Hann() {
+  return util::ConstexprTable<HannCurve<Size>, Size>::values;
+}
+
+} // namespace DspTables
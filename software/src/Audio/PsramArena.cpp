@@ -0,0 +1,77 @@
+#ifdef ARDUINO_TEENSY41
+
+#include <Arduino.h>
+#include <smalloc.h>
+#include "PsramArena.h"
+#include "../util/util_buddy_arena.h"
+
+extern "C" uint8_t external_psram_size;
+extern char _extram_start[];
+
+namespace PsramArena {
+
+using Arena = util::BuddyArena<kChunkBytes, kMaxBytes / kChunkBytes, kMaxOwners>;
+
+static Arena arena;
+static bool reserved = false;
+static uint8_t current_owner = kUnowned;
+
+// Reserve what's left of PSRAM less the headroom, once
+static void Reserve() {
+  if (reserved) return;
+  reserved = true;
+  if (!external_psram_size) return;
+
+  // Same probe as the debug menu: the next extmem allocation is at the start
+  // of the free space
+  char *probe = static_cast<char *>(extmem_malloc(1));
+  if (!probe) return;
+  const ptrdiff_t free_bytes = _extram_start + (size_t(external_psram_size) << 20) - probe;
+  extmem_free(probe);
+  if (free_bytes <= ptrdiff_t(kHeadroom + kChunkBytes)) return;
+
+  size_t bytes = (free_bytes - kHeadroom) / kChunkBytes * kChunkBytes;
+  if (bytes > kMaxBytes) bytes = kMaxBytes;
+  void *region = extmem_malloc(bytes);
+  if (!region) return;
+
+  // PSRAM isn't cleared at startup, so every chunk starts out dirty
+  arena.Init(region, bytes);
+  for (uint8_t owner = 0; owner < kMaxOwners; ++owner) arena.set_budget(owner, bytes / 2);
+}
+
+void *Allocate(size_t bytes) {
+  Reserve();
+  if (!arena.capacity()) return extmem_calloc(bytes, 1);
+  return arena.Allocate(bytes, current_owner);
+}
+
+void Free(void *p) {
+  if (!p) return;
+  if (arena.Owns(p)) arena.Free(p);
+  else extmem_free(p);
+}
+
+Stats GetStats() {
+  return { arena.capacity(), arena.used(), arena.available(), arena.largest_available() };
+}
+
+size_t used(uint8_t owner) {
+  return arena.used(owner);
+}
+
+size_t budget(uint8_t owner) {
+  return arena.capacity() ? arena.budget(owner) : 0;
+}
+
+OwnerScope::OwnerScope(uint8_t owner) : previous_(current_owner) {
+  current_owner = owner < kMaxOwners ? owner : kUnowned;
+}
+
+OwnerScope::~OwnerScope() {
+  current_owner = previous_;
+}
+
+} // namespace PsramArena
+
+#endif
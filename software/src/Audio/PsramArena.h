@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Shared PSRAM arena for audio effect buffers (see util::BuddyArena).
+//
+// The arena is reserved from extmem on first use, leaving kHeadroom for
+// everything else that uses extmem directly. Allocations are charged to the
+// current owner, which AudioAppletSubapp sets to the audio slot while an
+// applet starts; each slot may use up to half of the arena. Without PSRAM,
+// or outside the arena, this falls back to plain extmem_calloc/extmem_free.
+//
+// Main loop only: applets acquire and release buffers in Start()/Unload().
+namespace PsramArena {
+
+static constexpr size_t kChunkBytes = 16 * 1024;
+static constexpr size_t kMaxBytes = 16 * 1024 * 1024;
+static constexpr size_t kHeadroom = 2 * 1024 * 1024;
+static constexpr uint8_t kMaxOwners = 8;
+static constexpr uint8_t kUnowned = kMaxOwners;
+
+// Zero-filled memory, or nullptr if it doesn't fit the owner's budget
+void *Allocate(size_t bytes);
+void Free(void *p);
+
+struct Stats {
+  size_t capacity;
+  size_t used;
+  size_t available;
+  size_t largest_available;
+};
+
+// All zeros until the first allocation or without PSRAM
+Stats GetStats();
+size_t used(uint8_t owner);
+size_t budget(uint8_t owner);
+
+// Charge allocations made in scope to owner
+class OwnerScope {
+public:
+  explicit OwnerScope(uint8_t owner);
+  ~OwnerScope();
+
+private:
+  uint8_t previous_;
+};
+
+} // namespace PsramArena
@@ -36,16 +36,6 @@
 // float SafeNoteFrequencyAnalyzer::lpf_cutoff = 0.0f;
 // bool  SafeNoteFrequencyAnalyzer::lpf_initiated = false;
 
-/**
- *  Copy internal blocks of data to class buffer
- *
- *  @param destination destination address
- *  @param source      source address
- */
-static void copy_buffer(void *destination, const void *source) {
-    memcpy(destination, source, AUDIO_BLOCK_SAMPLES * sizeof(int16_t)); // AUDIO_BLOCK_SAMPLES samples copied are 2 bytes each
-}
-
 // Derive alpha for LPF from cutoff (Hz) and sample rate.
 // α = 1 - exp(-2π fc / Fs)
 static inline float lpf_alpha_from_cutoff(float cutoff_hz, float sample_rate_hz) {
@@ -65,55 +55,28 @@ void SafeNoteFrequencyAnalyzer::update( void ) {
     
     audio_block_t *block;
 
-    // lightweight timing: record first block arrival for the current buffer,
-    // and compute buffer-fill latency when the buffer becomes full.
-    const uint32_t now_us = (uint32_t)micros();
-    
     block = receiveReadOnly();
     if (!block) return;
-    if (state==0) first_block_time_us = now_us;
     
-    if ( !enabled ) {
+    if ( !enabled || !detector ) {
         release( block );
         return;
     }
-    
-    if ( next_buffer ) {
-        blocklist1[state++] = block;
-    } else {
-        blocklist2[state++] = block;
-    }
 
-    if (state >= needed_blocks) {
-        // compute start index so we copy the tail window
-        int start = state - needed_blocks;  // 0-based within the current list
-        int dst_idx = 0;
-        for (int i = 0; i < needed_blocks; ++i) {
-            const audio_block_t* srcblk = next_buffer ? blocklist1[start + i]
-                                                      : blocklist2[start + i];
-            copy_buffer(AudioBuffer + dst_idx, srcblk->data);
-            // optionally enable this to prefilter: filter_inplace_block(AudioBuffer + dst_idx);
-            dst_idx += AUDIO_BLOCK_SAMPLES;
-        }
-
-        // mark that we are ready to process this sliding window
-        process_buffer = true;
+    // The detector keeps its own copy of the window, so blocks go straight
+    // back to the pool instead of being held for the length of the window.
+    // optionally enable this to prefilter (on a copy, the block is shared):
+    // int16_t filtered[AUDIO_BLOCK_SAMPLES]; memcpy(filtered, block->data, sizeof(filtered));
+    // filter_inplace_block(filtered);
+    const uint32_t start_us = (uint32_t)micros();
+    const bool analysed = detector->Push(block->data, AUDIO_BLOCK_SAMPLES);
+    release( block );
+
+    if (analysed) {
         process();
-        first_run = false;
-        // When we’ve consumed a block, release the **oldest** one to avoid leaks:
-        // (only if state has grown beyond needed_blocks)
-        if (state > needed_blocks) {
-            int release_idx = 0;  // release the oldest of the queue
-            if (next_buffer) { release(blocklist1[release_idx]); blocklist1[release_idx] = nullptr; }
-            else              { release(blocklist2[release_idx]); blocklist2[release_idx] = nullptr; }
-
-            // shift remaining pointers left by one (cheap memmove of pointers, not audio)
-            if (next_buffer) memmove(&blocklist1[0], &blocklist1[1], (state-1)*sizeof(audio_block_t*));
-            else             memmove(&blocklist2[0], &blocklist2[1], (state-1)*sizeof(audio_block_t*));
-            state -= 1;
-        }
+        last_buffer_latency_us = (uint32_t)(1000000.0f * AUDIO_GUITARTUNER_WINDOW / AUDIO_SAMPLE_RATE_EXACT)
+                               + ((uint32_t)micros() - start_us);
     }
-    
 }
 
 // low pass filtering for YIN optimization. filters audio buffer in place to save memory
@@ -135,136 +98,23 @@ void SafeNoteFrequencyAnalyzer::filter_inplace_block(int16_t *dst) {
 }
 
 /**
- *  Start the Yin algorithm
+ *  Gate the detector's latest estimate.
  *
- *  TODO: Significant speed up would be to use spectral domain to find fundamental frequency.
- *  This paper explains: https://aubio.org/phd/thesis/brossier06thesis.pdf -> Section 3.2.4
- *  page 79. Might have to downsample for low fundmental frequencies because of fft buffer
- *  size limit.
+ *  The whole difference function is computed per window via FFT (see
+ *  YinPitchDetector), rather than a few lags per audio block as before,
+ *  so every hop gives a complete estimate.
  */
 void SafeNoteFrequencyAnalyzer::process( void ) {
+    if (!detector->found()) return;
 
-    // const uint32_t now_us = (uint32_t)micros();
-    // first_block_time_us = now_us;
-    const int16_t *p = AudioBuffer;
-    uint16_t cycles = 64;
-    uint16_t tau = tau_global;
-
-    do {
-        uint16_t x = 0;
-        uint64_t sum = 0;
-        // using XMAX as the bound for the below while loop introduces instability at low pitches
-        // uint16_t XMAX = (tau < half_window_samples) ? (uint16_t)(half_window_samples - tau) : 0;
-        // if (XMAX == 0) break; // nothing valid to sum for this tau
-        do {
-            int16_t current, lag, delta;
-
-            lag = *((int16_t *)p + (x + tau));
-            current = *((int16_t *)p + x);
-            delta = (current - lag);
-            sum += delta * delta;
-            x += 4;
-
-            lag = *((int16_t *)p + (x + tau));
-            current = *((int16_t *)p + x);
-            delta = (current - lag);
-            sum += delta * delta;
-            x += 4;
-
-            lag = *((int16_t *)p + (x + tau));
-            current = *((int16_t *)p + x);
-            delta = (current - lag);
-            sum += delta * delta;
-            x += 4;
-
-            lag = *((int16_t *)p + (x + tau));
-            current = *((int16_t *)p + x);
-            delta = (current - lag);
-            sum += delta * delta;
-            x += 4;
-        } while (x < half_window_samples);
-
-        // update running stats, estimate tau for next cycle
-        uint64_t rs = running_sum;
-        rs += sum;
-        yin_buffer[yin_idx] = sum * tau;
-        rs_buffer[yin_idx] = rs;
-        running_sum = rs;
-        yin_idx = (++yin_idx >= 5) ? 0 : yin_idx;
-        tau = estimate(yin_buffer, rs_buffer, yin_idx, tau);
-
-        // tau = 0 means we've found a pitch
-        if (tau == 0) {
-            tau_global = 1; // reset to 1 for now.
-            process_buffer = false;
-            new_output = true;
-            yin_idx = 1;
-            running_sum = 0;
-            return;
-        }
-    } while (--cycles);
-
-    // Reset per-buffer state before returning to caller
-    if (tau >= half_window_samples) {
-        process_buffer = false;
-        new_output = false;
-        yin_idx = 1;
-        running_sum = 0;
-        tau_global = 1; // conservative restart on miss
-        return;
-    }
-
-    tau_global = tau;
-    // last_buffer_latency_us = (uint32_t)((uint32_t)micros() - first_block_time_us );
-}
-
+    periodicity = detector->periodicity();
+    // do not update data if periodicity drops by at least 0.05
+    // this helps with low frequency jitteriness as YIN struggles to find a good match the lower we get our latency
+    if ((periodicity - p_last_accepted) <= -0.05f || periodicity < 0.90f) return;
 
-/**
- *  check the sampled data for fundamental frequency
- *
- *  @param yin  buffer to hold sum*tau value
- *  @param rs   buffer to hold running sum for sampled window
- *  @param head buffer index
- *  @param tau  lag we are currently working on gets incremented
- *
- *  @return tau
- */
-uint16_t SafeNoteFrequencyAnalyzer::estimate( uint64_t *yin, uint64_t *rs, uint16_t head, uint16_t tau ) {
-    const uint64_t *y = ( uint64_t * )yin;
-    const uint64_t *r = ( uint64_t * )rs;
-    uint16_t _tau, _head;
-    const float thresh = yin_threshold;
-    _tau = tau;
-    _head = head;
-
-    if ( _tau > 4 ) {
-        
-        uint16_t idx0, idx1, idx2;
-        idx0 = _head;
-        idx1 = _head + 1;
-        idx1 = ( idx1 >= 5 ) ? 0 : idx1;
-        idx2 = head + 2;
-        idx2 = ( idx2 >= 5 ) ? 0 : idx2;
-        
-        float s0, s1, s2;
-        s0 = ( ( float )*( y+idx0 ) / *( r+idx0 ) );
-        s1 = ( ( float )*( y+idx1 ) / *( r+idx1 ) );
-        s2 = ( ( float )*( y+idx2 ) / *( r+idx2 ) );
-        
-        if ( s1 < thresh && s1 < s2 ) {
-            uint16_t period = _tau - 3;
-            periodicity = 1 - s1;
-            // do not update data if periodicity drops by at least 0.05
-            // this helps with low frequency jitteriness as YIN struggles to find a good match the lower we get our latency
-            if ((periodicity - p_last_accepted) <= -0.05f || periodicity < 0.90f){
-                return 0;
-            }
-            p_last_accepted = periodicity; // now that we know we aren't accepting a dud, save this value
-            data = period + 0.5f * ( s0 - s2 ) / ( s0 - 2.0f * s1 + s2 );
-            return 0;
-        }
-    }
-    return _tau + 1;
+    p_last_accepted = periodicity; // now that we know we aren't accepting a dud, save this value
+    data = detector->period();
+    new_output = true;
 }
 
 /**
@@ -272,42 +122,26 @@ uint16_t SafeNoteFrequencyAnalyzer::estimate( uint64_t *yin, uint64_t *rs, uint1
  *
  *  @param threshold Allowed uncertainty
  */
-void SafeNoteFrequencyAnalyzer::begin( float threshold , float cutoff_hz) {
+void SafeNoteFrequencyAnalyzer::begin( float threshold , float cutoff_hz, uint16_t hop) {
 
-    size_t n = AUDIO_GUITARTUNER_BLOCKS * 128;
-    AudioBuffer = reinterpret_cast<int16_t*>(
-        ::operator new[](n * sizeof(int16_t), std::align_val_t(4)));
-
-    // choosing a window in ms based on the lowest note we care to detect. higher values increase latency
-    const float window_ms = 42.0f;   // this is what's going to affect the lowest pitch we can track; use 18–24 ms range
-    window_samples = (uint16_t)lrintf(AUDIO_SAMPLE_RATE_EXACT * (window_ms / 1000.0f));
-
-    // round up to blocks of 128
-    needed_blocks = (window_samples + AUDIO_BLOCK_SAMPLES - 1) / AUDIO_BLOCK_SAMPLES;
-    if (needed_blocks < 4) needed_blocks = 4;                                                // safety
-    if (needed_blocks > AUDIO_GUITARTUNER_BLOCKS) needed_blocks = AUDIO_GUITARTUNER_BLOCKS;  // cap at our buffer
-    HALF_BLOCKS = (uint16_t)((uint32_t)needed_blocks * AUDIO_BLOCK_SAMPLES / 2);
-
-    // Derive sample counts
-    window_samples      = (uint16_t)(needed_blocks * AUDIO_BLOCK_SAMPLES);
-    half_window_samples = (uint16_t)(window_samples >> 1);
+    Detector *d = new Detector;
+    d->Init(threshold, hop);
 
     // initialize actual YIN parameters
     __disable_irq( );
-    process_buffer = false;
+    Detector *previous = detector;
+    detector       = d;
     yin_threshold  = threshold;
     lpf_cutoff     = (float)cutoff_hz;
     lpf_alpha      = lpf_alpha_from_cutoff(lpf_cutoff, AUDIO_SAMPLE_RATE_EXACT);             // Cache alpha unless cutoff changes
     periodicity    = 0.0f;
-    next_buffer    = true;
-    running_sum    = 0;
-    tau_global     = 1;
-    first_run      = true;
-    yin_idx        = 1;
+    p_last_accepted = 1.0f;
+    last_buffer_latency_us = 0;
     enabled        = true;
-    state          = 0;
     data           = 0.0f;
     __enable_irq( );
+
+    delete previous; // begin() again without end()
 }
 
 /**
@@ -355,6 +189,7 @@ float SafeNoteFrequencyAnalyzer::probability( void ) {
 void SafeNoteFrequencyAnalyzer::threshold( float p ) {
     __disable_irq( );
     yin_threshold = p;
+    if (detector) detector->set_threshold(p);
     __enable_irq( );
 }
 
@@ -376,27 +211,15 @@ void SafeNoteFrequencyAnalyzer::end() {
         release(b);   // return block to audio pool
     }
 
-    // Release any queued blocks while IRQs are still disabled to avoid races/double-free.
-    for (int i = 0; i < AUDIO_GUITARTUNER_BLOCKS; ++i) {
-        if (blocklist1[i]) { release(blocklist1[i]); blocklist1[i] = nullptr; }
-        if (blocklist2[i]) { release(blocklist2[i]); blocklist2[i] = nullptr; }
-    }
-
-    state = 0;
-    process_buffer = false;
-    first_run = true;
     new_output = false;
     lpf_initiated = false;
-    yin_idx = 1;
-    running_sum = 0;
-    tau_global = 1;
 
-    int16_t *buf_to_free = AudioBuffer;
-    AudioBuffer = nullptr;
+    Detector *to_free = detector;
+    detector = nullptr;
     __enable_irq();
 
     // Free heap memory outside IRQ-disabled region
-    if (buf_to_free) ::operator delete[](buf_to_free, std::align_val_t(4));
+    delete to_free;
 
 } // flush and disable to save CPU usage
 void SafeNoteFrequencyAnalyzer::pause_switch(bool p) {} // quick on/off switch without teardown (like for audio being unplugged)
@@ -36,20 +36,23 @@
 
 #include <Arduino.h>     // github.com/PaulStoffregen/cores/blob/master/teensy4/Arduino.h
 #include <AudioStream.h> // github.com/PaulStoffregen/cores/blob/master/teensy4/AudioStream.h
+#include "YinPitchDetector.h"
 /***********************************************************************
  *              Safe to adjust these values below                      *
  *                                                                     *
- *  This parameter defines the size of the buffer.                     *
+ *  1.  AUDIO_GUITARTUNER_WINDOW - Analysis window in samples, a       *
+ *                      power of two. Periods up to half the window    *
+ *                      are found; the default (2048) measures down    *
+ *                      to ~43 Hz (F1) with a 46 ms window.            *
  *                                                                     *
- *  1.  AUDIO_GUITARTUNER_BLOCKS -  Buffer size is 128 * AUDIO_BLOCKS. *
- *                      The more AUDIO_GUITARTUNER_BLOCKS the lower    *
- *                      the frequency you can detect. The default      *
- *                      (24) is set to measure down to 29.14 Hz        *
- *                      or B(flat)0.                                   *
+ *  2.  AUDIO_GUITARTUNER_HOP - Default samples between estimates.     *
+ *                      Each estimate costs two FFTs of the window     *
+ *                      size, independent of the pitch.                *
  *                                                                     *
  ***********************************************************************/
 //one block = ~2.9ms of signal time per https://forum.pjrc.com/index.php?threads/different-range-fft-algorithm.32252/page-2
-#define AUDIO_GUITARTUNER_BLOCKS  24
+#define AUDIO_GUITARTUNER_WINDOW  2048
+#define AUDIO_GUITARTUNER_HOP     (4 * AUDIO_BLOCK_SAMPLES)
 /***********************************************************************/
 class SafeNoteFrequencyAnalyzer : public AudioStream {
 public:
@@ -60,21 +63,18 @@ public:
      */
     SafeNoteFrequencyAnalyzer(void) : AudioStream(1, inputQueueArray), enabled(false), new_output(false) {
         inputQueueArray[0] = nullptr;
-        for (int i = 0; i < AUDIO_GUITARTUNER_BLOCKS; ++i) {
-            blocklist1[i] = nullptr;
-            blocklist2[i] = nullptr;
-        }
     }
     
     /**
      *  initialize variables and start conversion
      *
      *  @param threshold Allowed uncertainty
-     *  @param cpu_max   How much cpu usage before throttling
+     *  @param lp_cutoff_hz Pre-filter cutoff (0 to disable)
+     *  @param hop       Samples between estimates
      *
      *  @return none
      */
-    void begin(float threshold, float lp_cutoff_hz);
+    void begin(float threshold, float lp_cutoff_hz, uint16_t hop = AUDIO_GUITARTUNER_HOP);
     
     /**
      *  sets threshold value
@@ -123,37 +123,18 @@ public:
     bool isEnabled(); // get enabled state for TuneTracker functionality
     
 private:
-    /**
-     *  check the sampled data for fundamental frequency
-     *
-     *  @param yin  buffer to hold sum*tau value
-     *  @param rs   buffer to hold running sum for sampled window
-     *  @param head buffer index
-     *  @param tau  lag we are currently working on this gets incremented
-     *
-     *  @return tau
-     */
-    uint16_t estimate( uint64_t *yin, uint64_t *rs, uint16_t head, uint16_t tau );
-
-    /**
-     *  compartamentalized function to adapt frequency search area based on how high or low we are
-     */
-    void adapt_window_from_tau(float tau_samples);
-
-    // recovery path functions for tau window shortening/lengthening
-    void set_window_blocks(uint16_t nb);
-    void widen_to_max_window();
+    using Detector = YinPitchDetector<AUDIO_GUITARTUNER_WINDOW>;
 
     /**
-     *  process audio data
+     *  gate a new estimate from the detector and publish it
      *
      *  @return none
      */
     void process( void );
 
     /**
-     *  performs LPF on audio buffer based on specified cuttoff freq,
-     *  before it is processed on the next run into the YIN algorithm
+     *  performs LPF on an audio block based on specified cuttoff freq,
+     *  before it is pushed into the YIN window
      *
      *  @return none
      */
@@ -162,28 +143,13 @@ private:
     /**
      *  Variables
      */
-    uint64_t running_sum;
-    uint16_t tau_global;
-    uint64_t  yin_buffer[5];
-    uint64_t  rs_buffer[5];
-    // comment out old definition for now to test new way
-    //    int16_t  AudioBuffer[AUDIO_GUITARTUNER_BLOCKS*128] __attribute__ ( ( aligned ( 4 ) ) );
-    // heap-managed buffer so it can be freed on end()/Unload()
-    int16_t *AudioBuffer = nullptr;
-    uint8_t  yin_idx, state;
+    // heap-managed so it can be freed on end()/Unload()
+    Detector *detector = nullptr;
     float    periodicity, yin_threshold, data;
-    bool     enabled, next_buffer, first_run;
-    volatile bool new_output, process_buffer;
-    audio_block_t *blocklist1[AUDIO_GUITARTUNER_BLOCKS];
-    audio_block_t *blocklist2[AUDIO_GUITARTUNER_BLOCKS];
+    bool     enabled;
+    volatile bool new_output;
     audio_block_t *inputQueueArray[1];
 
-    //custom params for optimizing YIN
-    uint16_t needed_blocks;     // how many 128-sample blocks our window needs
-    uint16_t window_samples;    // number of samples our analysis uses
-    uint16_t half_window_samples; // half the number of samples for processing
-    uint16_t HALF_BLOCKS;       // redefinition of constant, to accomodate sliding window algo
-
     // one-pole low-pass params (simple, cheap smoothing)
     float lpf_alpha;   // default smoothing coefficient (0..1)
     float lpf_state;     // persistent filter state across samples/blocks
@@ -191,27 +157,8 @@ private:
     bool lpf_initiated = false; // initialize LPF state on first use to avoid a startup step
 
     // delay calculation params
-    uint32_t first_block_time_us;
     uint32_t last_buffer_latency_us; // can read via debugger/Serial if needed
 
-    // --- confidence/holding & smoothing state ---
-    float sm_logf = NAN;           // log2 smoothing state (initialized lazy)
-    float last_good_period = 0.0f; // period (samples) of last accepted lock
-    bool  have_good = false;       // have we accepted at least one good lock?
-    uint8_t hold_count = 0;        // how many frames left to hold last_good_period
-
-    // tuning constants for gating/hold
-    static constexpr float   CONF_RISE = 0.97f;  // need this to accept a *new* lock
-    static constexpr float   CONF_FALL = 0.95f;  // lower bar to keep an *existing* lock (hysteresis)
-    static constexpr uint8_t HOLD_MAX  = 8;      // frames to keep last good on low confidence (≈ 6×process cadence)
-
-    // octave / decay guards
-    uint8_t octave_suspect = 0;     // consecutive potential octave-down hits
-    static constexpr float  OCTAVE_DOWN_RATIO = 1.6f; // period growth treated as octave-ish
-    static constexpr uint8_t OCTAVE_CONFIRM   = 4;    // need this many consecutive before accepting
-
-    uint64_t tau_min_next = 0;
-    uint64_t tau_max_next = 0;
     float p_last_accepted = 1.00f; // last accepted periodicity, for gating what values we accept
 };
 #endif
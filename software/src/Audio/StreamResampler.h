@@ -0,0 +1,288 @@
+#pragma once
+
+#include "../OC_config.h"
+#include "../dsputils.h"
+#include "../util/util_constexpr_math.h"
+#include <Audio.h>
+#include <math.h>
+#include <stdlib.h>
+
+enum InterpolationMethod {
+  INTERPOLATION_ZOH,
+  INTERPOLATION_LINEAR,
+  INTERPOLATION_HERMITE,
+  INTERPOLATION_SINC
+};
+
+// Windowed-sinc kernel for INTERPOLATION_SINC: kTaps taps for each of
+// kPhases + 1 fractional positions (the last equals the first, one sample
+// on, so phases can be interpolated without wrapping). The cutoff is just
+// under the input Nyquist, which is what's left to remove when going up to
+// the audio rate, and each phase is normalized to unity gain at DC.
+struct SincKernel {
+  static constexpr int kTaps = 8;
+  static constexpr int kPhases = 32;
+  static constexpr double kCutoff = 0.45; // of the input rate
+
+  // Tap t of phase p sits at t - (kTaps / 2 - 1) - p / kPhases samples from
+  // the interpolated point
+  static constexpr double Tap(int phase, int tap) {
+    const double x = tap - (kTaps / 2 - 1) - double(phase) / kPhases;
+    const double arg = util::cmath::kPi * 2.0 * kCutoff * x;
+    const double sinc = x == 0.0 ? 1.0 : util::cmath::sin(arg) / arg;
+    // Blackman
+    const double w = 2.0 * util::cmath::kPi * (x + kTaps / 2) / kTaps;
+    return sinc * (0.42 - 0.5 * util::cmath::cos(w) + 0.08 * util::cmath::cos(2.0 * w));
+  }
+
+  static constexpr float at(size_t i) {
+    const int phase = i / kTaps;
+    double sum = 0.0;
+    for (int t = 0; t < kTaps; ++t) sum += Tap(phase, t);
+    return static_cast<float>(Tap(phase, i % kTaps) / sum);
+  }
+
+  using Table = util::ConstexprTable<SincKernel, (kPhases + 1) * kTaps>;
+};
+
+// Converts a stream pushed at control rate (one sample per core tick) to
+// audio blocks. This is the part of InterpolatingStream that doesn't need
+// the Audio library, so it can be run on the host.
+//
+// By default the read rate sticks to the nominal ratio and is only forced
+// up or down when the buffer would run dry or fill up. That keeps latency
+// to a minimum, but the core and audio clocks drift against each other, so
+// it happens regularly, and every time it does the read jumps.
+//
+// Adaptive() turns it into an asynchronous rate converter instead: a PI
+// loop steers the read rate so the fill level at the start of each block
+// settles on a target a few samples above what a block needs. The integral
+// term ends up as the measured ratio of the two clocks. The target adds
+// kMargin samples of latency over the fixed mode.
+// Default buffer: as many blocks' worth of input at any core rate as
+// AUDIO_BLOCK_SAMPLES holds at the stock 16666 Hz
+static constexpr size_t kStreamResamplerSize =
+  (AUDIO_BLOCK_SAMPLES * OC_CORE_ISR_FREQ + 16665) / 16666;
+
+template <size_t BufferSize = kStreamResamplerSize>
+class StreamResampler {
+public:
+  // Input samples of headroom over a block's worth, for clock jitter; the
+  // same time at any core rate
+  static constexpr float kMargin = 8.0f * OC_CORE_ISR_RATE_SCALE;
+  // Loop gains per block, on the fill error in input samples: critically
+  // damped, settling in a few hundred blocks
+  static constexpr float kProportional = 0.02f;
+  static constexpr float kIntegral = kProportional * kProportional / 4.0f;
+
+  StreamResampler(float ratio) : delta(ratio), ratio_(ratio) {}
+
+  void Acquire() {
+    if (buffer == nullptr) {
+      buffer = static_cast<int16_t*>(calloc(BufferSize, sizeof(int16_t)));
+      Push(0.0f);
+    }
+  }
+
+  void Release() {
+    if (buffer != nullptr) {
+      free(buffer);
+      buffer = nullptr;
+    }
+  }
+
+  void Push(int16_t value) {
+    if (buffer == nullptr) return;
+    buffer[write_ix++] = value;
+    write_ix %= BufferSize;
+  }
+
+  inline float Length() const {
+    float w = static_cast<float>(write_ix);
+    return w >= read_ix ? w - read_ix : w + BufferSize - read_ix;
+  }
+
+  void Method(InterpolationMethod val) {
+    method = val;
+  }
+
+  void Adaptive(bool val) {
+    adaptive = val;
+    primed = false;
+    ratio_ = delta;
+  }
+
+  // Input samples per output sample: the nominal ratio, or what the loop
+  // has measured in adaptive mode
+  float ratio() const {
+    return adaptive ? ratio_ : delta;
+  }
+
+  float input_rate() const {
+    return ratio() * AUDIO_SAMPLE_RATE_EXACT;
+  }
+
+  // Blocks where the buffer held too little for the read rate, so it was
+  // slowed down, or nothing could be output at all
+  uint32_t underruns() const {
+    return underrun_count;
+  }
+
+  // Blocks where the buffer held too much, so the read rate was sped up
+  uint32_t overruns() const {
+    return overrun_count;
+  }
+
+  void ResetCounters() {
+    underrun_count = overrun_count = 0;
+  }
+
+  // Fill one block; false if there isn't enough input yet
+  bool Render(int16_t* out) {
+    if (buffer == nullptr) return false;
+    const int padding = Padding();
+    const float l = Length();
+
+    if (adaptive && !primed) {
+      // Start (or restart) at the target, so the loop starts settled
+      if (l < Target(padding)) return false;
+      primed = true;
+    }
+    if (l < padding + 1) {
+      ++underrun_count;
+      primed = false;
+      return false;
+    }
+
+    float d = delta;
+    float lo, hi;
+    // These should be boundary deltas that would result in consuming too
+    // many or too few samples.
+    hi = floorf(l - (padding - 1)) / AUDIO_BLOCK_SAMPLES;
+    if (adaptive) {
+      const float error = l - Target(padding);
+      d = ratio_ + kProportional * error / AUDIO_BLOCK_SAMPLES;
+      // Leave room for the next block's worth without overwriting
+      lo = (l - (BufferSize - 1 - kMargin - ratio_ * AUDIO_BLOCK_SAMPLES)) / AUDIO_BLOCK_SAMPLES;
+      if (d <= hi && d >= lo) ratio_ += kIntegral * error / AUDIO_BLOCK_SAMPLES;
+    } else {
+      lo = ceilf(l - (padding + 1)) / AUDIO_BLOCK_SAMPLES;
+    }
+    if (d > hi) {
+      d = hi;
+      ++underrun_count;
+    } else if (d < lo) {
+      d = lo;
+      ++overrun_count;
+    }
+
+    switch (method) {
+      case INTERPOLATION_ZOH:
+        RenderZOH(d, out);
+        break;
+      case INTERPOLATION_LINEAR:
+        RenderLinear(d, out);
+        break;
+      case INTERPOLATION_SINC:
+        RenderSinc(d, out);
+        break;
+      case INTERPOLATION_HERMITE:
+      default:
+        RenderHermite(d, out);
+        break;
+    }
+    return true;
+  }
+
+private:
+  int16_t* buffer = nullptr;
+  size_t write_ix = 0;
+  float read_ix = 0.0f;
+  float delta;
+  InterpolationMethod method = INTERPOLATION_ZOH;
+
+  bool adaptive = false;
+  bool primed = false;
+  float ratio_;
+  uint32_t underrun_count = 0;
+  uint32_t overrun_count = 0;
+
+  // Samples read past the interpolated point
+  int Padding() const {
+    switch (method) {
+      case INTERPOLATION_ZOH:
+        return 0;
+      case INTERPOLATION_LINEAR:
+        return 1;
+      case INTERPOLATION_SINC:
+        return SincKernel::kTaps - 1;
+      case INTERPOLATION_HERMITE:
+      default:
+        return 3;
+    }
+  }
+
+  // Fill level to hold at the start of a block
+  float Target(int padding) const {
+    const float target = ratio_ * AUDIO_BLOCK_SAMPLES + padding + 1 + kMargin;
+    return target < BufferSize - 1 ? target : BufferSize - 1;
+  }
+
+  void RenderZOH(float d, int16_t* out) {
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+      int read_int = static_cast<int>(read_ix);
+      out[i] = buffer[read_int];
+      read_ix += d;
+      if (read_ix >= BufferSize) read_ix -= BufferSize;
+    }
+  }
+
+  void RenderLinear(float d, int16_t* out) {
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+      int read_int = static_cast<int>(read_ix);
+      float read_dec = read_ix - read_int;
+      out[i] = InterpLinear(
+        buffer[read_int], buffer[(read_int + 1) % BufferSize], read_dec
+      );
+      read_ix += d;
+      if (read_ix >= BufferSize) read_ix -= BufferSize;
+    }
+  }
+
+  void RenderHermite(float d, int16_t* out) {
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+      int read_int = static_cast<int>(read_ix);
+      float read_dec = read_ix - read_int;
+      out[i] = Clip16(InterpHermite(
+        buffer[read_int],
+        buffer[(read_int + 1) % BufferSize],
+        buffer[(read_int + 2) % BufferSize],
+        buffer[(read_int + 3) % BufferSize],
+        read_dec
+      ));
+      read_ix += d;
+      if (read_ix >= BufferSize) read_ix -= BufferSize;
+    }
+  }
+
+  // Polyphase: the two phases either side of the fractional position are
+  // blended, then applied to kTaps samples
+  void RenderSinc(float d, int16_t* out) {
+    const float* kernel = SincKernel::Table::values;
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+      int read_int = static_cast<int>(read_ix);
+      float phase = (read_ix - read_int) * SincKernel::kPhases;
+      int phase_int = static_cast<int>(phase);
+      float phase_dec = phase - phase_int;
+      const float* c0 = kernel + phase_int * SincKernel::kTaps;
+      const float* c1 = c0 + SincKernel::kTaps;
+      float acc = 0.0f;
+      for (int t = 0; t < SincKernel::kTaps; t++) {
+        acc += buffer[(read_int + t) % BufferSize] * InterpLinear(c0[t], c1[t], phase_dec);
+      }
+      out[i] = Clip16(acc);
+      read_ix += d;
+      if (read_ix >= BufferSize) read_ix -= BufferSize;
+    }
+  }
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "../util/util_fft.h"
+
+// YIN pitch estimation (de Cheveigné & Kawahara, 2002) over a sliding window
+// of Size samples, searching periods of up to Size / 2 samples.
+//
+// The difference function d(tau) = sum (x[j] - x[j + tau])^2 over the first
+// half of the window is expanded into two energy terms, which are running
+// sums, and a cross-correlation, which comes from one forward and one
+// inverse FFT of Size points. That's O(N log N) for every lag at once instead
+// of O(N) per lag, so a whole window is analysed in one go rather than a few
+// lags per audio block.
+//
+// Samples are pushed in as they arrive and a new estimate is made every Hop
+// samples once the window is full.
+template <size_t Size = 2048>
+class YinPitchDetector {
+public:
+  static_assert(Size >= 64 && !(Size & (Size - 1)), "Size must be a power of two");
+  static constexpr size_t kMaxLag = Size / 2;
+  static constexpr size_t kMinLag = 2;
+
+  void Init(float threshold, size_t hop) {
+    threshold_ = threshold;
+    hop_ = hop ? hop : 1;
+    Reset();
+  }
+
+  void Reset() {
+    memset(ring_, 0, sizeof(ring_));
+    write_ = 0;
+    filled_ = 0;
+    since_analysis_ = 0;
+    period_ = 0.0f;
+    periodicity_ = 0.0f;
+  }
+
+  void set_threshold(float threshold) {
+    threshold_ = threshold;
+  }
+
+  // Add samples. The first estimate is made as soon as the window is full,
+  // then one every hop samples. Returns true if at least one was made.
+  bool Push(const int16_t *samples, size_t n) {
+    bool analysed = false;
+    while (n) {
+      const bool filling = filled_ < Size;
+      size_t chunk = filling ? Size - filled_ : hop_ - since_analysis_;
+      if (chunk > n) chunk = n;
+      for (size_t i = 0; i < chunk; ++i) ring_[(write_ + i) & (Size - 1)] = samples[i];
+      write_ = (write_ + chunk) & (Size - 1);
+      samples += chunk;
+      n -= chunk;
+
+      if (filling) {
+        filled_ += chunk;
+        if (filled_ < Size) continue;
+      } else {
+        since_analysis_ += chunk;
+        if (since_analysis_ < hop_) continue;
+      }
+      Analyze();
+      since_analysis_ = 0;
+      analysed = true;
+    }
+    return analysed;
+  }
+
+  // Analyse Size samples, oldest first
+  bool Analyze(const int16_t *window) {
+    memcpy(ring_, window, sizeof(ring_));
+    write_ = 0;
+    filled_ = Size;
+    return Analyze();
+  }
+
+  bool found() const {
+    return period_ > 0.0f;
+  }
+
+  // Period in samples, with sub-sample interpolation; 0 if nothing was found
+  float period() const {
+    return period_;
+  }
+
+  // 1 - d'(tau) at the chosen period, or at the deepest dip if nothing
+  // was below the threshold
+  float periodicity() const {
+    return periodicity_;
+  }
+
+  // Cumulative mean normalized difference d'(tau) of the last analysis,
+  // kMaxLag values
+  const float *difference() const {
+    return im_;
+  }
+
+private:
+  int16_t ring_[Size];
+  float re_[Size];
+  float im_[Size];
+  size_t write_ = 0;
+  size_t filled_ = 0;
+  size_t hop_ = Size / 4;
+  size_t since_analysis_ = 0;
+  float threshold_ = 0.15f;
+  float period_ = 0.0f;
+  float periodicity_ = 0.0f;
+
+  float sample(size_t i) const {
+    return ring_[(write_ + i) & (Size - 1)] * (1.0f / 32768.0f);
+  }
+
+  bool Analyze() {
+    // Window in re, its first half in im: one complex FFT gives both spectra
+    float head_energy = 0.0f;
+    for (size_t i = 0; i < kMaxLag; ++i) {
+      const float x = sample(i);
+      re_[i] = im_[i] = x;
+      head_energy += x * x;
+    }
+    for (size_t i = kMaxLag; i < Size; ++i) {
+      re_[i] = sample(i);
+      im_[i] = 0.0f;
+    }
+    util::FFT<Size>::Forward(re_, im_);
+
+    // Z = B + iA, with B the window's and A the first half's spectrum. The
+    // correlation sum a[j] b[j + tau] is the inverse of conj(A) B; each bin
+    // needs its mirror, so bins k and Size - k are done as a pair.
+    for (size_t k = 0; k <= Size / 2; ++k) {
+      const size_t m = (Size - k) & (Size - 1);
+      const float zr = re_[k], zi = im_[k], yr = re_[m], yi = im_[m];
+      const float br = 0.5f * (zr + yr), bi = 0.5f * (zi - yi);
+      const float ar = 0.5f * (zi + yi), ai = -0.5f * (zr - yr);
+      const float pr = ar * br + ai * bi, pi = ar * bi - ai * br;
+      re_[k] = pr;
+      im_[k] = pi;
+      // P is Hermitian, the mirror bin is its conjugate
+      re_[m] = pr;
+      im_[m] = -pi;
+    }
+    util::FFT<Size>::Inverse(re_, im_);
+
+    // d(tau) = sum a^2 + sum b[tau..]^2 - 2 * correlation into re, and
+    // normalized by its running mean into im
+    const float scale = 2.0f / Size;
+    float tail_energy = head_energy;
+    float running_sum = 0.0f;
+    im_[0] = 1.0f;
+    for (size_t tau = 1; tau < kMaxLag; ++tau) {
+      const float out = sample(tau - 1), in = sample(tau - 1 + kMaxLag);
+      tail_energy += in * in - out * out;
+      float d = head_energy + tail_energy - scale * re_[tau];
+      if (d < 0.0f) d = 0.0f;
+      re_[tau] = d;
+      running_sum += d;
+      im_[tau] = running_sum > 0.0f ? d * tau / running_sum : 1.0f;
+    }
+
+    // First dip below the threshold, followed down to its minimum
+    const float *cmnd = im_;
+    size_t best = kMinLag;
+    for (size_t tau = kMinLag; tau < kMaxLag - 1; ++tau) {
+      if (cmnd[tau] < threshold_) {
+        while (tau + 1 < kMaxLag - 1 && cmnd[tau + 1] < cmnd[tau]) ++tau;
+        period_ = Interpolate(re_, tau);
+        periodicity_ = 1.0f - cmnd[tau];
+        return true;
+      }
+      if (cmnd[tau] < cmnd[best]) best = tau;
+    }
+    period_ = 0.0f;
+    periodicity_ = 1.0f - cmnd[best];
+    return false;
+  }
+
+  // Parabolic fit through d() around the minimum; d' is skewed by the
+  // normalization, which shows at short periods
+  static float Interpolate(const float *d, size_t tau) {
+    const float s0 = d[tau - 1], s1 = d[tau], s2 = d[tau + 1];
+    const float denominator = s0 - 2.0f * s1 + s2;
+    if (denominator <= 0.0f) return tau;
+    return tau + 0.5f * (s0 - s2) / denominator;
+  }
+};
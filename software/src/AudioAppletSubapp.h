@@ -1,7 +1,9 @@
 #pragma once
 
 #include "AudioIO.h"
+#include "Audio/PsramArena.h"
 #include "HemisphereAudioApplet.h"
+#include "HSProfiler.h"
 #include "OC_ui.h"
 #include "PhzConfig.h"
 #include "elapsedMillis.h"
@@ -54,11 +56,11 @@ public:
   void Init() {
     for (size_t slot = 0; slot < Slots; slot++) {
       if (IsStereo(slot)) {
-        get_selected_stereo_applet(slot).BaseStart(LEFT_HEMISPHERE);
+        StartApplet(get_selected_stereo_applet(slot), LEFT_HEMISPHERE, slot);
         ForEachSide(side) ConnectStereoToNext(side, slot);
       } else {
         ForEachSide(side) {
-          get_selected_mono_applet(side, slot).BaseStart(side);
+          StartApplet(get_selected_mono_applet(side, slot), side, slot);
           ConnectMonoToNext(side, slot);
         }
       }
@@ -87,10 +89,10 @@ public:
     AudioNoInterrupts();
     for (size_t i = 0; i < Slots; i++) {
       if (IsStereo(i)) {
-        get_selected_stereo_applet(i).Controller();
+        AppletController(get_selected_stereo_applet(i), i * 2);
       } else {
-        get_selected_mono_applet(LEFT_HEMISPHERE, i).Controller();
-        get_selected_mono_applet(RIGHT_HEMISPHERE, i).Controller();
+        AppletController(get_selected_mono_applet(LEFT_HEMISPHERE, i), i * 2);
+        AppletController(get_selected_mono_applet(RIGHT_HEMISPHERE, i), i * 2 + 1);
       }
     }
     if (cpu_percent <= 100)
@@ -99,6 +101,9 @@ public:
     if (last_stats_update > STATS_TIMEOUT) {
       AudioInterrupts(); // force usage refresh
       last_stats_update = 0;
+#ifdef APPLET_PROFILING
+      RecordAudioUsage();
+#endif
       mem_percent = static_cast<int16_t>(
         100 * static_cast<float>(AudioMemoryUsageMax())
         / OC::AudioIO::AUDIO_MEMORY
@@ -106,9 +111,52 @@ public:
       cpu_percent = static_cast<int16_t>(AudioProcessorUsageMax());
       AudioProcessorUsageMaxReset();
       AudioMemoryUsageMaxReset();
+      const PsramArena::Stats psram = PsramArena::GetStats();
+      psram_width = psram.capacity ? psram.used * 128 / psram.capacity : 0;
     }
   }
 
+  // Buffers the applet acquires in Start() are charged to its slot
+  static void StartApplet(HemisphereAudioApplet &applet, HEM_SIDE side, size_t slot) {
+    PsramArena::OwnerScope owner(slot);
+    applet.BaseStart(side);
+  }
+
+  static void AppletController(HemisphereAudioApplet &applet, int slot) {
+    HS_PROFILE_APPLET(CONTROLLER, &applet, slot);
+    applet.Controller();
+  }
+
+#ifdef APPLET_PROFILING
+  // The Audio library only reports usage per AudioStream, as a percentage of
+  // one block; an applet's input and output streams stand in for its graph.
+  void RecordAudioUsage() {
+    const float block_cycles = F_CPU_ACTUAL / AUDIO_SAMPLE_RATE_EXACT * AUDIO_BLOCK_SAMPLES;
+    auto record = [block_cycles](HemisphereAudioApplet &applet, int slot) {
+      AudioStream *in = applet.InputStream();
+      AudioStream *out = applet.OutputStream();
+      float usage = 0.0f;
+      if (in) {
+        usage += in->processorUsageMax();
+        in->processorUsageMaxReset();
+      }
+      if (out && out != in) {
+        usage += out->processorUsageMax();
+        out->processorUsageMaxReset();
+      }
+      HS_PROFILE_RECORD(AUDIO, &applet, slot, uint32_t(usage * block_cycles / 100.0f));
+    };
+    for (size_t i = 0; i < Slots; i++) {
+      if (IsStereo(i)) {
+        record(get_selected_stereo_applet(i), i * 2);
+      } else {
+        record(get_selected_mono_applet(LEFT_HEMISPHERE, i), i * 2);
+        record(get_selected_mono_applet(RIGHT_HEMISPHERE, i), i * 2 + 1);
+      }
+    }
+  }
+#endif
+
   void mainloop() {
     for (size_t slot = 0; slot < Slots; slot++) {
       if (IsStereo(slot)) {
@@ -122,6 +170,8 @@ public:
 
   void View() {
     gfxDottedLine(0, 0, 127, 0);
+    // PSRAM arena usage, solid over the dotted line
+    if (psram_width) gfxLine(0, 0, psram_width - 1, 0);
 
     const bool forcemenu = (state[0] != EDIT_APPLET && state[1] != EDIT_APPLET)
       || state[0] == SWITCH_APPLET || state[1] == SWITCH_APPLET;
@@ -204,7 +254,7 @@ public:
 
   void SwapMonoStereo(int c) {
     if (IsStereo(c)) {
-      get_selected_stereo_applet(c).BaseStart(HEM_SIDE(LEFT_HEMISPHERE + AUDIO_SLOT_L));
+      StartApplet(get_selected_stereo_applet(c), HEM_SIDE(LEFT_HEMISPHERE + AUDIO_SLOT_L), c);
       ForEachSide(side) {
         get_selected_mono_applet(side, c).Disconnect();
         get_selected_mono_applet(side, c).Unload();
@@ -215,7 +265,7 @@ public:
       get_selected_stereo_applet(c).Disconnect();
       get_selected_stereo_applet(c).Unload();
       ForEachSide(side) {
-        get_selected_mono_applet(side, c).BaseStart(HEM_SIDE(side + AUDIO_SLOT_L));
+        StartApplet(get_selected_mono_applet(side, c), HEM_SIDE(side + AUDIO_SLOT_L), c);
         ConnectMonoToNext(side, c);
         if (c > 0) ConnectSlotToNext(side, c - 1);
       }
@@ -272,7 +322,7 @@ public:
     get_selected_stereo_applet(slot).Unload();
     sel = ix;
     auto& app = get_selected_stereo_applet(slot);
-    app.BaseStart(HEM_SIDE(side + AUDIO_SLOT_L));
+    StartApplet(app, HEM_SIDE(side + AUDIO_SLOT_L), slot);
     ForEachSide(side) ConnectStereoToNext(side, slot);
     if (slot > 0) {
       ForEachSide(side) ConnectSlotToNext(side, slot - 1);
@@ -286,7 +336,7 @@ public:
     get_selected_mono_applet(side, slot).Unload();
     sel = ix;
     auto& app = get_selected_mono_applet(side, slot);
-    app.BaseStart(HEM_SIDE(side + AUDIO_SLOT_L));
+    StartApplet(app, HEM_SIDE(side + AUDIO_SLOT_L), slot);
     ConnectMonoToNext(side, slot);
     if (slot > 0) ConnectSlotToNext(side, slot - 1);
   }
@@ -546,6 +596,7 @@ private:
 
   int16_t mem_percent = 0;
   int16_t cpu_percent = 0;
+  uint8_t psram_width = 0; // pixels, of 128
 
   elapsedMillis last_stats_update = 0;
   static constexpr int STATS_TIMEOUT = 250;
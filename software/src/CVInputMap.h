@@ -48,6 +48,10 @@ public:
   inline uint8_t index() const {
     return source & 0x1f; // lower 5 bits
   }
+  // bit for the output read by this map, if any, for evaluation order
+  uint32_t dac_mask() const {
+    return (source_type() == TYPE_DAC) ? (1u << index()) : 0;
+  }
   constexpr int channel_count(SourceType t) const {
     switch(t) {
       default:
@@ -484,6 +488,10 @@ public:
   inline uint8_t index() const {
     return source & 0x1f;
   }
+  // bit for the output read by this map, if any, for evaluation order
+  uint32_t dac_mask() const {
+    return (source_type() == TYPE_DAC) ? (1u << index()) : 0;
+  }
   const bool is_clock() const {
     return (source_type() == TYPE_INTERNAL) && (index() <= 1);
   }
@@ -38,7 +38,7 @@ using simfloat = int32_t;
 #include "HemisphereApplet.h"
 #include "HSUtils.h"
 
-#define HSAPPLICATION_CURSOR_TICKS 4000
+#define HSAPPLICATION_CURSOR_TICKS OC_CORE_TICKS_MS(240)
 #define HSAPPLICATION_5V 7680
 #define HSAPPLICATION_3V 4608
 #define HSAPPLICATION_CHANGE_THRESHOLD 32
@@ -78,6 +78,9 @@ public:
         // Cursor countdowns. See CursorBlink(), ResetCursor(), gfxCursor()
         if (--cursor_countdown < -HSAPPLICATION_CURSOR_TICKS) cursor_countdown = HSAPPLICATION_CURSOR_TICKS;
 
+        // MIDI queued by the main loop, before the app picks up MIDI clock
+        HS::frame.MIDIState.ProcessQueuedMIDI(OC::CORE::ticks);
+
         Controller();
 
         // set outputs from IO frame
@@ -176,7 +179,7 @@ public:
         return frame.clocked[ch];
     }
 
-    void ClockOut(int ch, int ticks = 100) {
+    void ClockOut(int ch, int ticks = OC_CORE_TICKS_MS(6)) {
         frame.ClockOut( (DAC_CHANNEL)ch, ticks );
     }
 
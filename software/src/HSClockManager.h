@@ -18,8 +18,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-// A "tick" is one ISR cycle, which happens 16666.667 times per second, or a million
-// times per minute. A "tock" is a metronome beat.
+// A "tick" is one ISR cycle, which happens OC_CORE_ISR_FREQ times per second, or
+// OC_CORE_TICKS_PER_MINUTE times per minute (a million at the default 16.67 kHz).
+// A "tock" is a metronome beat.
 
 #pragma once
 
@@ -29,15 +30,15 @@
 #include "OC_core.h"
 #include "HSMIDI.h"
 #include "HSUtils.h"
-#include <functional>
+#include "util/util_ringbuffer.h"
 #include <vector>
 
 namespace HS {
 
 static constexpr uint16_t CLOCK_TEMPO_MIN = 1;
 static constexpr uint16_t CLOCK_TEMPO_MAX = 0xFFFF;
-static constexpr uint32_t CLOCK_TICKS_MIN = 1000000 / CLOCK_TEMPO_MAX;
-static constexpr uint32_t CLOCK_TICKS_MAX = 1000000 / CLOCK_TEMPO_MIN;
+static constexpr uint32_t CLOCK_TICKS_MIN = OC_CORE_TICKS_PER_MINUTE / CLOCK_TEMPO_MAX;
+static constexpr uint32_t CLOCK_TICKS_MAX = OC_CORE_TICKS_PER_MINUTE / CLOCK_TEMPO_MIN;
 
 constexpr int MIDI_CLOCK_PPQN = 2;
 constexpr int MIDI_OUT_PPQN = 24;
@@ -85,9 +86,21 @@ public:
 
     bool boop[8] = {0,0,0,0,0,0,0,0}; // Manual triggers
 
-    std::queue<Task> syncfn_queue;
+    // Callbacks deferred to the next downbeat. Plain function + context so the
+    // queue is trivially copyable and never allocates; it's filled from the UI
+    // and drained by the core ISR. Only the ISR looks at pending tasks, so
+    // duplicates are dropped there, not when queueing.
+    struct SyncTask {
+        void (*fn)(void *);
+        void *context;
+    };
+    static constexpr size_t SYNC_QUEUE_SIZE = 8; // must be pow2
+    util::RingBuffer<SyncTask, SYNC_QUEUE_SIZE> syncfn_queue;
+    uint32_t sync_overflows = 0; // tasks dropped because the queue was full
+    uint8_t sync_high_water = 0; // most tasks pending at once
 
     ClockManager() {
+        syncfn_queue.Init();
         SetTempoBPM(120);
     }
 
@@ -104,13 +117,13 @@ public:
         clock_ppqn = constrain(clkppqn, 0, 24);
     }
 
-    /* Set ticks per tock, based on one million ticks per minute divided by beats per minute.
+    /* Set ticks per tock, based on ticks per minute divided by beats per minute.
      * This is approximate, because the arithmetical value is likely to be fractional, and we
      * need to live with a certain amount of imprecision here. So I'm not even rounding up.
      */
     void SetTempoBPM(uint16_t bpm) {
         bpm = constrain(bpm, CLOCK_TEMPO_MIN, CLOCK_TEMPO_MAX);
-        ticks_per_beat = 1000000 / bpm;
+        ticks_per_beat = OC_CORE_TICKS_PER_MINUTE / bpm;
         tempo_setting = tempo = bpm;
     }
     
@@ -123,7 +136,7 @@ public:
         // update the tempo
         uint32_t clock_diff = total / count;
         ticks_per_beat = constrain(clock_diff, CLOCK_TICKS_MIN, CLOCK_TICKS_MAX); // time since last clock is new tempo
-        tempo_setting = tempo = 1000000 / ticks_per_beat; // imprecise, for display purposes
+        tempo_setting = tempo = OC_CORE_TICKS_PER_MINUTE / ticks_per_beat; // imprecise, for display purposes
     }
 
     int8_t GetMultiply(int ch = 0) {return tocks_per_beat[ch];}
@@ -137,7 +150,7 @@ public:
      */
     uint16_t GetTempo() {return tempo_setting;}
     float GetTempoFloat() {
-      return 1000000.0f / ticks_per_beat;
+      return float(OC_CORE_TICKS_PER_MINUTE) / ticks_per_beat;
     }
     uint32_t GetTempoTicks() {return ticks_per_beat;}
     uint32_t GetCycleTicks(int ch = 0) {
@@ -146,17 +159,36 @@ public:
       return 0;
     }
 
-    void BeatSync(std::function<void()> func) {
-      // TODO: prevent duplicates...
-      syncfn_queue.emplace(func);
+    // Returns false if the task couldn't be queued
+    bool BeatSync(void (*fn)(void *), void *context = nullptr) {
+      if (!syncfn_queue.writable()) {
+        ++sync_overflows;
+        return false;
+      }
+      syncfn_queue.Write({fn, context});
+      const size_t pending = syncfn_queue.readable();
+      if (pending > sync_high_water) sync_high_water = pending;
+      return true;
+    }
+    bool SyncPending() const {
+      return syncfn_queue.readable();
     }
     void ProcessBeatSync() {
-      if (syncfn_queue.empty()) return;
       // Things that should only happen on the downbeat
       // such as: preset load, multiplier change, etc...
-      while (!syncfn_queue.empty()) {
-        syncfn_queue.front()();
-        syncfn_queue.pop();
+      // Only the tasks pending now; anything queued by a task waits a beat.
+      // A task queued more than once in the same beat runs once.
+      SyncTask done[SYNC_QUEUE_SIZE];
+      size_t num_done = 0;
+      size_t pending = syncfn_queue.readable();
+      while (pending--) {
+        const SyncTask t = syncfn_queue.Read();
+        bool duplicate = false;
+        for (size_t i = 0; i < num_done && !duplicate; ++i)
+          duplicate = done[i].fn == t.fn && done[i].context == t.context;
+        if (duplicate) continue;
+        done[num_done++] = t;
+        t.fn(t.context);
       }
     }
 
@@ -241,7 +273,7 @@ public:
 
         }
         if (reset) Reset(1); // skip the one we're already on
-        if (beatsync && !syncfn_queue.empty())
+        if (beatsync && SyncPending())
           ProcessBeatSync();
 
         // handle syncing to physical clocks
@@ -261,7 +293,7 @@ public:
 
                 // update the tempo
                 ticks_per_beat = constrain(ppqn * avg_diff, CLOCK_TICKS_MIN, CLOCK_TICKS_MAX);
-                tempo_setting = tempo = 1000000 / ticks_per_beat; // imprecise, for display purposes
+                tempo_setting = tempo = OC_CORE_TICKS_PER_MINUTE / ticks_per_beat; // imprecise, for display purposes
 
                 int ticks_per_clock = ticks_per_beat / ppqn; // rounded down
 
@@ -339,7 +371,7 @@ public:
     void Modulate(int tempo_diff, int shuffle_diff) {
       shuffle = constrain(shuffle_setting + shuffle_diff, 0, 99);
       tempo = constrain(tempo_setting + tempo_diff, CLOCK_TEMPO_MIN, CLOCK_TEMPO_MAX);
-      ticks_per_beat = 1000000 / tempo;
+      ticks_per_beat = OC_CORE_TICKS_PER_MINUTE / tempo;
     }
 
     bool IsRunning() const {return (running && !paused);}
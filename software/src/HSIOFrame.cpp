@@ -454,30 +454,36 @@ void HS::IOFrame::Load(OC::IOFrame *ioframe) {
         }
     }
 
-    // pre-calculate clock triggers
+    // pre-calculate clock triggers, except for inputs patched from another
+    // applet; those wait until it has run
     for (int ch = 0; ch < APPLET_SLOTS * 2; ++ch) {
-      bool result = 0;
-      const size_t virt_chan = (ch) % (APPLET_SLOTS * 2);
-
-      // clock triggers
-      // TODO: implement div/mult within DigitalInputMap and get rid of
-      //       this call to clock_m
-      if (clock_m.IsRunning() && clock_m.GetMultiply(virt_chan) != 0)
-          result = clock_m.Tock(virt_chan) && CheckSkip(virt_chan);
-      else {
-          result = trigmap[ch].Clock() && CheckSkip(ch);
-      }
+      if (deferred_clocks & (1u << ch)) continue;
+      ProcessClock(ch);
+    }
+}
 
-      // Try to eat a boop
-      result = result || (clock_m.Beep(virt_chan) && CheckSkip(virt_chan));
+void HS::IOFrame::ProcessClock(int ch) {
+    bool result = 0;
+    const size_t virt_chan = (ch) % (APPLET_SLOTS * 2);
+
+    // clock triggers
+    // TODO: implement div/mult within DigitalInputMap and get rid of
+    //       this call to clock_m
+    if (clock_m.IsRunning() && clock_m.GetMultiply(virt_chan) != 0)
+        result = clock_m.Tock(virt_chan) && CheckSkip(virt_chan);
+    else {
+        result = trigmap[ch].Clock() && CheckSkip(ch);
+    }
 
-      if (result) {
-          cycle_ticks[ch] = OC::CORE::ticks - last_clock[ch];
-          last_clock[ch] = OC::CORE::ticks;
-      }
+    // Try to eat a boop
+    result = result || (clock_m.Beep(virt_chan) && CheckSkip(virt_chan));
 
-      clocked[ch] = result;
+    if (result) {
+        cycle_ticks[ch] = OC::CORE::ticks - last_clock[ch];
+        last_clock[ch] = OC::CORE::ticks;
     }
+
+    clocked[ch] = result;
 }
 
 void HS::IOFrame::Send(OC::IOFrame *ioframe) {
@@ -514,10 +520,15 @@ void HS::IOFrame::Send(OC::IOFrame *ioframe) {
       }
        */
 
-      outputs[i].push(output_slew[i]);
-      if (i < DAC_CHANNEL_COUNT)
-        ioframe->outputs.set_pitch_value(chan[i], outputs[i].get(output_atten[i]));
+      if (!(pushed_outputs & (1u << i)))
+        outputs[i].push(output_slew[i]);
     }
+    pushed_outputs = 0;
+
+    // Attenuated values for the whole frame, all pitch mode
+    for (int i = 0; i < DAC_CHANNEL_COUNT; ++i)
+      ioframe->outputs.values[chan[i]] = outputs[i].get(output_atten[i]);
+    std::fill(std::begin(ioframe->outputs.modes), std::end(ioframe->outputs.modes), OC::OUTPUT_MODE_PITCH);
 
     if (autoMIDIOut) MIDIState.Send(outputs);
 }
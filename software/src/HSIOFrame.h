@@ -19,6 +19,7 @@
 #include "OC_digital_inputs.h"
 #include "HSicons.h"
 #include "HSClockManager.h"
+#include "HSMIDIIngest.h"
 #include "util/util_macros.h"
 #include "util/clkdivmult.h"
 #include "src/extern/bjorklund.h"
@@ -34,6 +35,13 @@ static constexpr int MIDIMAP_MAX = 8;
 static constexpr int IO_CHANNEL_COUNT = 32;
 #endif
 
+#if defined(__IMXRT1062__)
+static constexpr size_t MIDI_INGEST_SIZE = 64;
+#else
+static constexpr size_t MIDI_INGEST_SIZE = 16;
+#endif
+static constexpr size_t MIDI_INGEST_PER_TICK = 4; // messages processed per core tick, at most
+
 struct MIDIFrame;
 struct IOFrame;
 
@@ -60,7 +68,117 @@ struct MIDINoteData {
     uint8_t note; // data1
     uint8_t vel;  // data2
 };
-using NoteBuffer = std::vector<MIDINoteData>;
+
+// Held notes for one MIDI channel, in the order they were pressed.
+// Storage is indexed by note number, so it's fixed-size and never allocates:
+// a doubly-linked list gives O(1) push/promote/remove, and a 128-bit
+// presence mask gives O(1) lowest/highest queries.
+class NoteStack {
+public:
+    static constexpr uint8_t NONE = 0xff;
+
+    class iterator {
+    public:
+        iterator(const NoteStack *s, uint8_t n) : stack(s) { Load(n); }
+        const MIDINoteData &operator*() const { return data; }
+        const MIDINoteData *operator->() const { return &data; }
+        iterator &operator++() { Load(stack->next_[data.note]); return *this; }
+        bool operator!=(const iterator &other) const { return data.note != other.data.note; }
+        bool operator==(const iterator &other) const { return data.note == other.data.note; }
+    private:
+        void Load(uint8_t n) {
+            data.note = n;
+            data.vel = (n == NONE) ? 0 : stack->vel_[n];
+        }
+        const NoteStack *stack;
+        MIDINoteData data;
+    };
+
+    NoteStack() { clear(); }
+
+    // Appends a note as the latest; a held note is promoted and its velocity updated
+    void push(const uint8_t note, const uint8_t vel) {
+        if (note > 127) return;
+        if (contains(note)) Unlink(note);
+        else {
+            mask_[note >> 5] |= (1u << (note & 31));
+            ++size_;
+        }
+        vel_[note] = vel;
+        prev_[note] = tail_;
+        next_[note] = NONE;
+        if (tail_ == NONE) head_ = note;
+        else next_[tail_] = note;
+        tail_ = note;
+    }
+
+    void remove(const uint8_t note) {
+        if (note > 127 || !contains(note)) return;
+        Unlink(note);
+        mask_[note >> 5] &= ~(1u << (note & 31));
+        --size_;
+    }
+
+    void clear() {
+        head_ = tail_ = NONE;
+        size_ = 0;
+        for (int i = 0; i < 4; ++i) mask_[i] = 0;
+    }
+
+    bool contains(const uint8_t note) const {
+        return (mask_[note >> 5] >> (note & 31)) & 1;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Oldest held note (pedal)
+    uint8_t first() const { return empty() ? 0 : head_; }
+    // Most recently pressed note
+    uint8_t last() const { return empty() ? 0 : tail_; }
+    uint8_t last_vel() const { return empty() ? 0 : vel_[tail_]; }
+
+    // Lowest/highest held note; 127/0 when empty, same as a scan would give
+    uint8_t lowest() const {
+        for (int i = 0; i < 4; ++i) {
+            if (mask_[i]) return (i << 5) + __builtin_ctz(mask_[i]);
+        }
+        return 127;
+    }
+    uint8_t highest() const {
+        for (int i = 3; i >= 0; --i) {
+            if (mask_[i]) return (i << 5) + 31 - __builtin_clz(mask_[i]);
+        }
+        return 0;
+    }
+
+    // Velocity of the nth most recent note, n = 1 for the latest
+    uint8_t vel_from_last(int n) const {
+        uint8_t note = tail_;
+        while (--n > 0 && note != NONE) note = prev_[note];
+        return (note == NONE) ? 0 : vel_[note];
+    }
+
+    iterator begin() const { return iterator(this, head_); }
+    iterator end() const { return iterator(this, NONE); }
+
+private:
+    void Unlink(const uint8_t note) {
+        const uint8_t p = prev_[note], n = next_[note];
+        if (p == NONE) head_ = n;
+        else next_[p] = n;
+        if (n == NONE) tail_ = p;
+        else prev_[n] = p;
+    }
+
+    uint32_t mask_[4];
+    uint8_t prev_[128];
+    uint8_t next_[128];
+    uint8_t vel_[128];
+    uint8_t head_, tail_;
+    uint8_t size_;
+};
+using NoteBuffer = NoteStack;
 
 struct PolyphonyData {
     uint8_t note;
@@ -611,75 +729,51 @@ struct MIDIFrame {
         }
     }
 
-    void RemoveNoteData(NoteBuffer &buffer, const uint8_t note) {
-        buffer.erase(
-            std::remove_if(buffer.begin(), buffer.end(), [&](MIDINoteData const &data) {
-                return data.note == note;
-            }),
-            buffer.end()
-        );
-    }
-
     void MonoBufferPush(const uint8_t m_ch, const uint8_t note, const uint8_t vel) {
         if (CheckMidiChannelFilter(m_ch)) {
-            RemoveNoteData(note_buffer[m_ch], note); // if new note is already in buffer, promote to latest and update velocity
-            note_buffer[m_ch].push_back({note, vel}); // else just append to the end
+            // if new note is already in buffer, promote to latest and update velocity
+            note_buffer[m_ch].push(note, vel);
         }
     }
 
     void MonoBufferPop(const uint8_t m_ch, const uint8_t note) {
         if (CheckMidiChannelFilter(m_ch)) {
-            RemoveNoteData(note_buffer[m_ch], note);
-            if (note_buffer[m_ch].size() == 0) note_buffer[m_ch].shrink_to_fit(); // free up memory when MIDI is not used
+            note_buffer[m_ch].remove(note);
         }
     }
 
     void ClearMonoBuffer(const int8_t m_ch = -1) {
         if (m_ch > 0) {
             note_buffer[m_ch].clear();
-            note_buffer[m_ch].shrink_to_fit();
         } else { // clear on all channels if no args passed
             for (uint8_t c = 0; c < 16; ++c) {
                 note_buffer[c].clear();
-                note_buffer[c].shrink_to_fit();
             }
         }
     }
 
-    // int GetNote(std::vector<MIDINoteData> &buffer, const int n) {
-    //     return buffer.at(buffer.size()-n).note;
-    // }
-
-    int GetNoteFirst(NoteBuffer &buffer) {
-        return buffer.front().note;
+    int GetNoteFirst(const NoteBuffer &buffer) {
+        return buffer.first();
     }
 
-    int GetNoteLast(NoteBuffer &buffer) {
-        return buffer.back().note;
+    int GetNoteLast(const NoteBuffer &buffer) {
+        return buffer.last();
     }
 
-    int GetNoteLastInv(NoteBuffer &buffer) {
-        return 127 - buffer.back().note;
+    int GetNoteLastInv(const NoteBuffer &buffer) {
+        return 127 - buffer.last();
     }
 
-    int GetNoteMin(NoteBuffer &buffer) {
-        uint8_t m = 127;
-        std::for_each (buffer.begin(), buffer.end(), [&](MIDINoteData const &data) {
-            if (data.note < m) m = data.note;
-        });
-        return m;
+    int GetNoteMin(const NoteBuffer &buffer) {
+        return buffer.lowest();
     }
 
-    int GetNoteMax(NoteBuffer &buffer) {
-        uint8_t m = 0;
-        std::for_each (buffer.begin(), buffer.end(), [&](MIDINoteData const &data) {
-            if (data.note > m) m = data.note;
-        });
-        return m;
+    int GetNoteMax(const NoteBuffer &buffer) {
+        return buffer.highest();
     }
 
-    int GetVel(NoteBuffer &buffer, const int n) {
-        return buffer.at(buffer.size()-n).vel;
+    int GetVel(const NoteBuffer &buffer, const int n) {
+        return buffer.vel_from_last(n);
     }
 
     void ClearSustainLatch(int8_t m_ch = -1) {
@@ -723,6 +817,19 @@ struct MIDIFrame {
     }
 
     void ProcessMIDIMsg(const MIDIMessage msg);
+
+    // Incoming messages are queued by the main loop and processed in the ISR
+    MIDIIngestQueue<MIDIMessage, MIDI_INGEST_SIZE> ingest;
+
+    bool QueueMIDIMsg(const MIDIMessage msg) {
+      return ingest.Push(msg, OC::CORE::ticks);
+    }
+    void ProcessQueuedMIDI(uint32_t now) {
+      ingest.Drain(now, MIDI_INGEST_PER_TICK, [this](const MIDIMessage &msg) {
+        ProcessMIDIMsg(msg);
+      });
+    }
+
     void Send(const SlewedValue *outvals);
 
     void SendAfterTouch(const uint8_t midi_ch, uint8_t val) {
@@ -812,6 +919,17 @@ struct IOFrame {
     /* MIDI message queue/cache */
     MIDIFrame MIDIState;
 
+    // Virtual patching between applets; see HSPatchGraph.h
+    uint32_t deferred_clocks = 0; // clocked[] computed by the app just before the applet runs
+    uint32_t pushed_outputs = 0; // outputs already updated this tick
+
+    // The masks belong to the app that set them; other apps clock every
+    // input in Load()
+    void ClearPatching() {
+      deferred_clocks = 0;
+      pushed_outputs = 0;
+    }
+
     OC::IOFrame* current_ioframe;
     OC::IOFrame* GetLatestIOFrame() const {
       return current_ioframe;
@@ -864,6 +982,16 @@ struct IOFrame {
         return (0 == clockinskip[ch] || random(100) >= clockinskip[ch]);
     }
 
+    // Apply slew to an applet's outputs as soon as it has run, so applets
+    // later in the same tick read the new values
+    void PushOutputs(int ch, int count = 2) {
+        for (int i = ch; i < ch + count; ++i) {
+            outputs[i].push(output_slew[i]);
+            pushed_outputs |= (1u << i);
+        }
+    }
+    void ProcessClock(int ch);
+
     // --- Hard IO ---
     void Load(OC::IOFrame *ioframe);
     void Send(OC::IOFrame *ioframe);
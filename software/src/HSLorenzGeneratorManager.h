@@ -26,7 +26,7 @@
 
 #include "src/extern/streams_lorenz_generator.h"
 
-#define LORENZ_PROCESS_TICKS 16
+#define LORENZ_PROCESS_TICKS OC_CORE_TICKS_US(960)
 
 class LorenzGeneratorManager {
     static LorenzGeneratorManager *instance;
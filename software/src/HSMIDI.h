@@ -34,6 +34,7 @@
 // See https://www.pjrc.com/teensy/td_midi.html
 
 #include <MIDI.h>
+#include "util/util_sysex.h"
 #if defined(__IMXRT1062__)
 #include <USBHost_t36.h>
 
@@ -340,43 +341,112 @@ protected:
         usbMIDI.send_now();
     }
 
-    bool ExtractSysExData(uint8_t *V, char target_id) {
+    /* Packs up to 48 unpacked bytes directly into the outgoing message */
+    void SendSysEx(const uint8_t *data, size_t size, char target_id) {
+        uint8_t sysex[SYSEX_DATA_MAX_SIZE];
+        util::SysExPacker packer = BeginSysEx(sysex, target_id);
+        packer.Write(data, size);
+        EndSysEx(sysex, packer);
+    }
+
+    bool ExtractSysExData(uint8_t *V, char target_id, size_t max_size = SYSEX_DATA_MAX_SIZE) {
         // Get the full sysex dump from the MIDI library
         uint8_t *sysex = usbMIDI.getSysExArray();
 
-        bool verify = (sysex[1] == 0x7d && sysex[2] == 0x62 && sysex[3] == target_id);
+        bool verify = VerifySysEx(sysex, target_id);
         if (verify) { // Does the received SysEx belong to this app?
-            // Strip the header and end-of-exclusive byte to reveal packed data
-            PackedData packed;
-            uint8_t psize = 0;
-            uint8_t data[SYSEX_DATA_MAX_SIZE];
-            for (int i = 0; i < SYSEX_DATA_MAX_SIZE; i++)
-            {
-                uint8_t b = sysex[i + 4]; // Getting packed bytes past the header
-                if (b == 0xf7) break;
-                data[psize++] = b;
-            }
-            packed.set_data(psize, data);
+            // Unpack from past the header up to the end-of-exclusive byte
+            util::SysExUnpacker unpacker(sysex + 4, SYSEX_DATA_MAX_SIZE);
+            unpacker.Read(V, max_size);
+        }
+        return verify;
+    }
 
-            // Unpack the data and set the value array
-            UnpackedData unpacked = packed.unpack();
-            for (int i = 0; i < unpacked.size; i++)
-            {
-                V[i] = unpacked.data[i];
+    /* Settings (a settings::SettingsBase) are sent in as many messages as they
+     * need, each carrying a run of whole values; see SettingsBase::SaveChunk().
+     *
+     * If chunk_hashes is given, the caller keeps it between calls, with
+     * SysExSettingsChunks<Settings>() entries zeroed to begin with, and messages
+     * whose values haven't changed since they were last sent are skipped.
+     * Returns the number of messages sent.
+     */
+    static constexpr size_t kSysExSettingsMaxBytes = 48;
+
+    // Enough chunk_hashes for any values: every message but the last is full to
+    // within one value, which takes at most 4 bytes
+    template <typename Settings>
+    static constexpr size_t SysExSettingsChunks() {
+        return Settings::storageSize() / (kSysExSettingsMaxBytes - Settings::kChunkHeaderSize - 4) + 1;
+    }
+
+    template <typename Settings>
+    int SendSysExSettings(const Settings &settings, char target_id, uint32_t *chunk_hashes = nullptr) {
+        uint8_t sysex[SYSEX_DATA_MAX_SIZE];
+        int sent = 0;
+        size_t first = 0;
+        for (size_t chunk = 0; ; ++chunk) {
+            const size_t count = settings.ChunkLength(first, kSysExSettingsMaxBytes);
+            if (!count) break;
+            if (chunk_hashes) {
+                const uint32_t hash = settings.ChunkHash(first, count);
+                if (chunk_hashes[chunk] == hash) {
+                    first += count;
+                    continue;
+                }
+                chunk_hashes[chunk] = hash;
             }
-            last_app_code = target_id;
-        } else {
-            if (sysex[1] == 0x7d && sysex[2] == 0x62) {
-                last_app_code = sysex[3];
-            } else last_app_code = 0; // Unknown application
+
+            util::SysExPacker packer = BeginSysEx(sysex, target_id);
+            settings.SaveChunk(first, count, packer);
+            EndSysEx(sysex, packer);
+            first += count;
+            ++sent;
         }
-        return verify;
+        return sent;
+    }
+
+    /* Applies one message sent by SendSysExSettings() */
+    template <typename Settings>
+    bool ExtractSysExSettings(Settings &settings, char target_id) {
+        uint8_t *sysex = usbMIDI.getSysExArray();
+        if (!VerifySysEx(sysex, target_id)) return false;
+
+        util::SysExUnpacker unpacker(sysex + 4, SYSEX_DATA_MAX_SIZE);
+        return settings.RestoreChunk(unpacker);
     }
 
     char LastSysExApplicationCode() {return last_app_code;}
 
+    /* For apps that write their fields straight into the message:
+     *   uint8_t sysex[SYSEX_DATA_MAX_SIZE];
+     *   util::SysExPacker packer = BeginSysEx(sysex, 'X');
+     *   packer.Write<uint16_t>(value); ...
+     *   EndSysEx(sysex, packer);
+     */
+    util::SysExPacker BeginSysEx(uint8_t *sysex, char target_id) {
+        sysex[0] = 0xf0;      // Start of exclusive
+        sysex[1] = 0x7d;      // Non-Commercial Manufacturer
+        sysex[2] = 0x62;      // Beige Maze
+        sysex[3] = target_id; // Target product
+        return util::SysExPacker(sysex + 4, SYSEX_DATA_MAX_SIZE - 5);
+    }
+
+    void EndSysEx(uint8_t *sysex, const util::SysExPacker &packer) {
+        uint8_t size = 4 + packer.written();
+        sysex[size++] = 0xf7; // End of exclusive
+        usbMIDI.sendSysEx(size, sysex);
+        usbMIDI.send_now();
+    }
+
 private:
     char last_app_code; // The most recent application code received
+
+    bool VerifySysEx(const uint8_t *sysex, char target_id) {
+        if (sysex[1] == 0x7d && sysex[2] == 0x62) {
+            last_app_code = sysex[3];
+        } else last_app_code = 0; // Unknown application
+        return last_app_code == target_id;
+    }
 };
 
 /*
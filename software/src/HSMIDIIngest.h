@@ -0,0 +1,112 @@
+/* Phazerville MIDI ingest queue
+ *
+ * Incoming MIDI, handed from the main loop to the core ISR
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+namespace HS {
+
+// The main loop reads the MIDI devices and pushes each message here, stamped
+// with OC::CORE::ticks; the core ISR drains a few per tick, oldest first, so
+// a burst of clock and CC data is spread over several ticks instead of all
+// landing in one. Single producer, single consumer, and the consumer never
+// blocks the producer: when the queue is full, new messages are dropped and
+// counted.
+//
+// Size must be a power of two.
+template <typename Message, size_t Size>
+class MIDIIngestQueue {
+public:
+  static_assert(Size && !(Size & (Size - 1)), "Size must be a power of two");
+
+  struct Event {
+    uint32_t tick;
+    Message msg;
+  };
+
+  // Main loop side
+  bool Push(const Message &msg, uint32_t tick) {
+    const uint32_t write = write_;
+    if (write - read_ >= Size) {
+      ++dropped;
+      return false;
+    }
+    events_[write & (Size - 1)] = {tick, msg};
+    std::atomic_signal_fence(std::memory_order_release);
+    write_ = write + 1;
+    ++received;
+    return true;
+  }
+
+  // ISR side. Processes up to max_count events stamped at or before now,
+  // in the order they were pushed.
+  // @return number of events processed
+  template <typename F>
+  size_t Drain(uint32_t now, size_t max_count, F &&process) {
+    uint32_t read = read_;
+    const uint32_t write = write_;
+    std::atomic_signal_fence(std::memory_order_acquire);
+    if (write - read > max_depth) max_depth = write - read;
+
+    size_t count = 0;
+    while (count < max_count && read != write) {
+      const Event &event = events_[read & (Size - 1)];
+      const int32_t latency = now - event.tick;
+      if (latency < 0) break; // not due yet
+
+      process(event.msg);
+      if (uint32_t(latency) > max_latency) max_latency = latency;
+      latency_sum += latency;
+      ++processed;
+
+      std::atomic_signal_fence(std::memory_order_release);
+      read_ = ++read;
+      ++count;
+    }
+    return count;
+  }
+
+  size_t readable() const { return write_ - read_; }
+
+  // Discards everything queued, counted as dropped. Only while the ISR
+  // isn't draining, e.g. when switching apps.
+  void Flush() {
+    const uint32_t write = write_;
+    dropped += write - read_;
+    read_ = write;
+  }
+
+  // average ticks between Push and processing
+  uint32_t mean_latency() const {
+    return processed ? latency_sum / processed : 0;
+  }
+
+  // Counters only; queued events are kept
+  void ResetStats() {
+    received = dropped = processed = 0;
+    max_depth = max_latency = 0;
+    latency_sum = 0;
+  }
+
+  // written by the main loop
+  uint32_t received = 0;
+  uint32_t dropped = 0;
+
+  // written by the ISR
+  uint32_t processed = 0;
+  uint32_t max_depth = 0;
+  uint32_t max_latency = 0;
+  uint64_t latency_sum = 0;
+
+private:
+  Event events_[Size];
+  volatile uint32_t write_ = 0;
+  volatile uint32_t read_ = 0;
+};
+
+} // namespace HS
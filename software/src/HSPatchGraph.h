@@ -0,0 +1,97 @@
+/* Phazerville Patch Graph
+ *
+ * Evaluation order for applet slots that read each other's outputs
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace HS {
+
+// An applet can read another slot's output through a CVInputMap or
+// DigitalInputMap patched to that DAC channel. Running the slots in a fixed
+// order costs a tick of latency whenever the source comes later, and how much
+// depends on which slots are involved. This sorts the slots so every source
+// runs before the applets reading it.
+//
+// Slots in a feedback loop (including one reading its own output) can't all
+// go first; they are flagged in cyclic, run in slot order, and the patch that
+// closes the loop is read a tick late, as before.
+template <int Slots>
+struct PatchGraph {
+  static_assert(Slots <= 8, "PatchGraph uses 8-bit slot masks");
+
+  uint8_t order[Slots]; // slot indexes, in evaluation order
+  uint8_t cyclic = 0; // slots in a feedback loop
+  uint8_t reads[Slots] = {}; // for each slot, the slots it reads from
+
+  PatchGraph() {
+    for (int i = 0; i < Slots; ++i) order[i] = i;
+  }
+
+  // Outputs (as DAC channel bits) to the slots producing them; each slot
+  // owns two channels. Channels past the applet slots are ignored.
+  static uint8_t SlotMask(uint32_t channels) {
+    uint8_t mask = 0;
+    for (int s = 0; s < Slots; ++s) {
+      if (channels & (3u << (s * 2))) mask |= (1 << s);
+    }
+    return mask;
+  }
+
+  // @return true if the order changed
+  bool Update(const uint8_t (&slot_reads)[Slots]) {
+    if (!memcmp(reads, slot_reads, sizeof(reads))) return false;
+    memcpy(reads, slot_reads, sizeof(reads));
+    Sort();
+    return true;
+  }
+
+  bool is_cyclic(int slot) const {
+    return (cyclic >> slot) & 1;
+  }
+
+private:
+  void Sort() {
+    // a slot is in a loop if it can reach itself
+    uint8_t reach[Slots];
+    memcpy(reach, reads, sizeof(reach));
+    for (int pass = 0; pass < Slots; ++pass) {
+      for (int s = 0; s < Slots; ++s) {
+        for (int t = 0; t < Slots; ++t) {
+          if (reach[s] & (1 << t)) reach[s] |= reach[t];
+        }
+      }
+    }
+    cyclic = 0;
+    uint8_t loop[Slots]; // slots in the same loop as each one
+    for (int s = 0; s < Slots; ++s) {
+      loop[s] = 0;
+      for (int t = 0; t < Slots; ++t) {
+        if ((reach[s] & (1 << t)) && (reach[t] & (1 << s))) loop[s] |= (1 << t);
+      }
+      if (loop[s] & (1 << s)) cyclic |= (1 << s);
+    }
+
+    // Kahn's algorithm, lowest slot first. When only loops are left, the
+    // lowest slot of a loop with no other pending inputs goes next.
+    uint8_t done = 0;
+    for (int n = 0; n < Slots; ++n) {
+      int next = -1;
+      for (int s = 0; s < Slots && next < 0; ++s) {
+        const uint8_t bit = (1 << s);
+        if (!(done & bit) && !(reads[s] & ~done & ~bit)) next = s;
+      }
+      for (int s = 0; s < Slots && next < 0; ++s) {
+        const uint8_t bit = (1 << s);
+        if (!(done & bit) && !(reads[s] & ~done & ~loop[s])) next = s;
+      }
+      order[n] = next;
+      done |= (1 << next);
+    }
+  }
+};
+
+} // namespace HS
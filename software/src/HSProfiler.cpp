@@ -0,0 +1,93 @@
+#include <Arduino.h>
+#include "HSProfiler.h"
+#include "OC_core.h"
+
+#ifdef APPLET_PROFILING
+
+namespace HS {
+namespace Profiler {
+
+static Entry entries[kMaxEntries];
+
+static Entry *match_entry(const char *name, int slot) {
+  for (int i = 0; i < kMaxEntries; ++i) {
+    if (entries[i].name == name && entries[i].slot == slot) return &entries[i];
+  }
+  return nullptr;
+}
+
+static Entry *find_entry(const char *name, int slot) {
+  Entry *e = match_entry(name, slot);
+  if (e) return e;
+
+  // Not found; take an unused entry, or replace the one idle the longest.
+  // Both ISR and main loop can get here, so re-check and claim atomically.
+  noInterrupts();
+  e = match_entry(name, slot);
+  if (!e) {
+    e = &entries[0];
+    for (int i = 0; i < kMaxEntries && e->name; ++i) {
+      if (!entries[i].name || entries[i].last_tick < e->last_tick) e = &entries[i];
+    }
+    memset(e, 0, sizeof(Entry));
+    for (int p = 0; p < PHASE_COUNT; ++p) e->phase[p].cycles.Reset();
+    e->slot = slot;
+    e->name = name;
+  }
+  interrupts();
+  return e;
+}
+
+void Record(Phase phase, const char *name, int slot, uint32_t cycles) {
+  Entry *e = find_entry(name, slot);
+  e->last_tick = OC::CORE::ticks;
+
+  PhaseStats &stats = e->phase[phase];
+  stats.cycles.push(cycles);
+  ++stats.count;
+
+  const int bits = cycles ? 32 - __builtin_clz(cycles) : 0;
+  const int bucket = constrain(bits - kBucketShift, 0, kBuckets - 1);
+  if (stats.histogram[bucket] < 0xffff) ++stats.histogram[bucket];
+}
+
+void Reset() {
+  noInterrupts();
+  memset(entries, 0, sizeof(entries));
+  interrupts();
+}
+
+int entry_count() {
+  int count = 0;
+  while (count < kMaxEntries && entries[count].name) ++count;
+  return count;
+}
+
+const Entry &entry(int index) {
+  return entries[index];
+}
+
+void Dump() {
+  static const char * const phase_names[PHASE_COUNT] = { "ctrl", "view", "audio" };
+
+  Serial.println("applet,slot,phase,count,avg_cycles,min_cycles,max_cycles,histogram");
+  for (int i = 0; i < kMaxEntries; ++i) {
+    const Entry &e = entries[i];
+    if (!e.name) continue;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+      const PhaseStats &stats = e.phase[p];
+      if (!stats.count) continue;
+      Serial.printf("%s,%u,%s,%lu,%lu,%lu,%lu,", e.name, e.slot, phase_names[p],
+                    stats.count, stats.cycles.value(), stats.cycles.min_value(),
+                    stats.cycles.max_value());
+      for (int b = 0; b < kBuckets; ++b)
+        Serial.printf(b ? " %u" : "%u", stats.histogram[b]);
+      Serial.println();
+    }
+  }
+}
+
+} // namespace Profiler
+} // namespace HS
+
+#endif // APPLET_PROFILING
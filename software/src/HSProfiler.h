@@ -0,0 +1,83 @@
+#pragma once
+
+// Per-applet cycle profiling for Controller(), View() and audio update().
+//
+// Build with -DAPPLET_PROFILING to enable; otherwise HS_PROFILE_APPLET
+// compiles to nothing and no table is allocated.
+//
+// Results are kept in a small fixed table keyed by applet name + slot. The
+// name pointer is unique per applet class, and applet IDs are derived from it
+// anyway. Each phase is written from one context only: Controller and audio
+// usage from the core ISR, View from the main loop.
+
+#include <stdint.h>
+#include "util/util_profiling.h"
+
+namespace HS {
+namespace Profiler {
+
+enum Phase : uint8_t {
+  CONTROLLER,
+  VIEW,
+  AUDIO,
+  PHASE_COUNT
+};
+
+#ifdef APPLET_PROFILING
+
+static constexpr int kMaxEntries = 16;
+static constexpr int kBuckets = 12;
+// Bucket 0 counts calls under 256 cycles, bucket n counts [2^(n+7), 2^(n+8)),
+// and the last bucket is open-ended
+static constexpr int kBucketShift = 8;
+
+struct PhaseStats {
+  debug::AveragedCycles cycles;
+  uint32_t count;
+  uint16_t histogram[kBuckets]; // saturating
+};
+
+struct Entry {
+  const char *name; // nullptr = unused
+  uint8_t slot;
+  uint32_t last_tick; // for replacing stale entries
+  PhaseStats phase[PHASE_COUNT];
+};
+
+void Record(Phase phase, const char *name, int slot, uint32_t cycles);
+void Reset();
+void Dump(); // to Serial, one line per entry and phase
+
+int entry_count();
+const Entry &entry(int index);
+
+class ScopedAppletProfile {
+public:
+  ScopedAppletProfile(Phase phase, const char *name, int slot)
+  : phase_(phase), slot_(slot), name_(name), cycles_() { }
+
+  ~ScopedAppletProfile() {
+    Record(phase_, name_, slot_, cycles_.read());
+  }
+
+private:
+  Phase phase_;
+  uint8_t slot_;
+  const char *name_;
+  debug::CycleMeasurement cycles_;
+};
+
+#define HS_PROFILE_APPLET(phase, applet, slot) \
+  HS::Profiler::ScopedAppletProfile applet_profile_(HS::Profiler::phase, (applet)->applet_name(), slot)
+#define HS_PROFILE_RECORD(phase, applet, slot, cycles) \
+  HS::Profiler::Record(HS::Profiler::phase, (applet)->applet_name(), slot, cycles)
+
+#else
+
+#define HS_PROFILE_APPLET(phase, applet, slot) do {} while (0)
+#define HS_PROFILE_RECORD(phase, applet, slot, cycles) do {} while (0)
+
+#endif // APPLET_PROFILING
+
+} // namespace Profiler
+} // namespace HS
@@ -146,7 +146,7 @@ namespace HS {
   }
   void QueueBeatSync() {
     if (clock_m.IsRunning())
-      clock_m.BeatSync( &ProcessBeatSync );
+      clock_m.BeatSync( [](void *) { ProcessBeatSync(); } );
     else
       ProcessBeatSync();
   }
@@ -721,7 +721,7 @@ void gfxPrintVoltage(int cv) {
 
 void gfxPrintFreqFromPitch(int16_t pitch) {
   uint32_t num = ComputePhaseIncrement(pitch);
-  uint32_t denom = 0xffffffff / 16666;
+  uint32_t denom = 0xffffffff / OC_CORE_ISR_FREQ;
   bool swap = num < denom;
   if (swap) {
     uint32_t t = num;
@@ -22,9 +22,9 @@
 #define HEMISPHERE_CENTER_INPUT_CV (NorthernLightModular*HEMISPHERE_MAX_CV/2)
 #define HEMISPHERE_MAX_INPUT_CV (6*ONE_OCTAVE + NorthernLightModular*(4*ONE_OCTAVE)) // 6V or 10V
 #define HEMISPHERE_CENTER_DETENT 80
-#define HEMISPHERE_CLOCK_TICKS 17 // one millisecond
-#define HEMISPHERE_CURSOR_TICKS 5000
-#define HEMISPHERE_ADC_LAG 33
+#define HEMISPHERE_CLOCK_TICKS OC_CORE_TICKS_MS(1) // one millisecond
+#define HEMISPHERE_CURSOR_TICKS OC_CORE_TICKS_MS(300)
+#define HEMISPHERE_ADC_LAG OC_CORE_TICKS_US(2000)
 #define HEMISPHERE_CHANGE_THRESHOLD 32
 
 // Hemisphere-specific macros
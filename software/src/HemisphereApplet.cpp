@@ -1,5 +1,6 @@
 #include "HemisphereApplet.h"
 #include "HSUtils.h"
+#include "HSProfiler.h"
 
 using namespace HS;
 
@@ -30,6 +31,7 @@ void HemisphereApplet::BaseStart(const HEM_SIDE hemisphere_) {
     }
 }
 void HemisphereApplet::BaseView(bool full_screen, bool parked) const {
+    HS_PROFILE_APPLET(VIEW, this, hemisphere);
     //if (HS::select_mode == hemisphere)
     gfxHeader(applet_name(), (HS::ALWAYS_SHOW_ICONS || full_screen) ? applet_icon() : nullptr);
     // If active, draw the full screen view instead of the application screen
@@ -119,7 +121,8 @@ int HemisphereApplet::SemitoneIn(int ch) const {
 }
 
 /* Has the specified Digital input been clocked this cycle? (rising edge of a gate)
- * This is pre-calculated in HS::IOFrame::Load() according to input mappings and internal clock settings
+ * This is pre-calculated in HS::IOFrame::Load() according to input mappings and internal clock settings,
+ * or by the app just before this applet runs when the input is patched from another applet
  */
 bool HemisphereApplet::Clock(int ch, bool physical) const {
     return frame.clocked[ch + io_offset];
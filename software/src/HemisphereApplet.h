@@ -122,6 +122,9 @@ public:
       graphics.drawBitmap8(96 - (hemisphere & 1)*64, 28, 8, (hemisphere & 1) ? RIGHT_ICON : LEFT_ICON);
     }
     virtual void AuxButton() { CancelEdit(); }
+    // Outputs read through the applet's own CVInputMaps, as a mask of
+    // DAC channels (see CVInputMap::dac_mask)
+    virtual uint32_t InputSources() { return 0; }
 
     // Arbitrary applet data blobs, key format:
     // 5-bit preset ID
@@ -194,6 +197,13 @@ public:
       return OC::Strings::capital_letters[ch + io_offset];
     }
 
+    // All the outputs this applet reads, through its slot's input maps and its own
+    uint32_t BaseInputSources() {
+      return cvmap[io_offset].dac_mask() | cvmap[io_offset + 1].dac_mask()
+        | trigmap[io_offset].dac_mask() | trigmap[io_offset + 1].dac_mask()
+        | InputSources();
+    }
+
     // Buffered I/O functions
     int ViewIn(int ch) const {return frame.In(io_offset + ch);}
     int ViewOut(int ch) const {return frame.ViewOut(io_offset + ch);}
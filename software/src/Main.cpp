@@ -45,8 +45,13 @@
 #include "util/util_debugpins.h"
 #include "VBiasManager.h"
 #include "HSMIDI.h"
+#include "HSProfiler.h"
 
 #include "PhzConfig.h"
+#if defined(__IMXRT1062__)
+#include "OC_scale_library.h"
+#include "util/util_screenstream.h"
+#endif
 
 #if defined(ARDUINO_TEENSY41)
 USBHost thisUSB;
@@ -95,6 +100,66 @@ uint_fast8_t MENU_REDRAW = true;
 static OC::UiMode ui_mode = OC::UI_MODE_MENU;
 static OC::IOFrame io_frame;
 
+#if defined(__IMXRT1062__)
+/*  ---------------- binary screen streaming over USB serial ---------------   */
+// 'V' starts streaming (or forces a keyframe), 'v' stops, '1'-'9' set the max
+// frame rate. Frames only go out when the screen changed; see
+// util/util_screenstream.h and res/screenstream.py
+namespace ScreenStream {
+
+using Encoder = util::ScreenStreamEncoder<SH1106_128x64_Driver::kFrameSize>;
+static Encoder encoder;
+static uint8_t packet[Encoder::kMaxPacketSize];
+static const uint8_t kFrameRates[] = { 1, 2, 5, 10, 15, 20, 30, 40, 60 };
+
+static bool enabled = false;
+static bool requested = false;
+static uint32_t interval_us = 1000000 / 30;
+static elapsedMicros since_request;
+
+void Start() {
+  if (!enabled) encoder.Init();
+  encoder.RequestKeyframe();
+  enabled = true;
+}
+
+void Stop() {
+  enabled = false;
+  if (requested) display::frame_buffer.capture_cancel();
+  requested = false;
+}
+
+void SetRate(int index) {
+  interval_us = 1000000 / kFrameRates[index];
+}
+
+void Poll() {
+  if (!requested) {
+    if (since_request < interval_us) return;
+    since_request = 0;
+    display::frame_buffer.capture_request();
+    requested = true;
+    return;
+  }
+
+  const uint8_t *frame = display::frame_buffer.captured();
+  if (!frame) return;
+  const size_t size = encoder.Encode(frame, packet);
+  display::frame_buffer.capture_retire();
+  requested = false;
+
+  if (!size) return;
+  if (Serial.availableForWrite() >= int(size)) {
+    Serial.write(packet, size);
+  } else {
+    // host isn't keeping up; the next frame it gets has to stand alone
+    encoder.RequestKeyframe();
+  }
+}
+
+} // namespace ScreenStream
+#endif
+
 /*  ------------------------ UI timer ISR ---------------------------   */
 
 IntervalTimer UI_timer;
@@ -280,9 +345,10 @@ void setup() {
   OC::ui.Init();
   OC::ui.configure_encoders(OC::calibration_data.encoder_config());
 
-  SERIAL_PRINTLN("* CORE ISR @%luus", OC_CORE_TIMER_RATE);
+  SERIAL_PRINTLN("* CORE ISR @%luHz (%luns)", OC_CORE_ISR_FREQ, OC_CORE_ISR_PERIOD_NS);
   io_frame.Reset();
-  CORE_timer.begin(CORE_timer_ISR, OC_CORE_TIMER_RATE);
+  // float period, since faster rates aren't a whole number of microseconds
+  CORE_timer.begin(CORE_timer_ISR, OC_CORE_ISR_PERIOD_NS / 1000.0f);
   CORE_timer.priority(OC_CORE_TIMER_PRIO);
 
   // Wait until there's at least some ADC values read
@@ -349,6 +415,10 @@ void setup() {
   // initialize LittleFS for config files
   PhzConfig::Init();
 
+  // Scala library index; built in the background on first boot with a card
+  if (!OC::scale_library.Open() && SDcard_Ready)
+    OC::scale_library.StartIndexing(SD);
+
   // Display loading splash screen and optional calibration
   bool reset_settings = false;
   ui_mode = OC::ui.Splashscreen(reset_settings, 0);
@@ -430,6 +500,7 @@ void FASTRUN loop() {
 
     // Take care of queued tasks
     OC::CORE::FlushTasks();
+    OC::scale_library.Poll();
 
     // UI events
     if (UI_MODE_APP_SETTINGS == ui_mode) {
@@ -469,10 +540,10 @@ void FASTRUN loop() {
       do {
         int cmd = Serial.read();
         switch (cmd) {
-#ifdef PRINT_DEBUG
           case 'z':
             Serial.println("-=[ PEW PEW NERDS! ]=-");
             Serial.println("Secret Menu Options:");
+#ifdef PRINT_DEBUG
             Serial.printf("'I' = Toggle App ISR [%s]\n", OC::CORE::app_isr_enabled ? "ON" : "OFF");
             Serial.printf("'D' = Toggle Display Redraw [%s]\n", OC::CORE::display_update_enabled ? "ON" : "OFF");
             Serial.printf("'L' = Toggle App Loop [%s]\n", OC::CORE::app_loop_enabled ? "ON" : "OFF");
@@ -484,9 +555,17 @@ void FASTRUN loop() {
             Serial.println("'s' = list all files on SD card");
             Serial.println("'C' = clear/reset default Config file");
             Serial.println("'F' = format/erase all LittleFS files");
+#endif
+#endif
+#if defined(__IMXRT1062__)
+            Serial.println("'V' = stream screen (binary), 'v' = stop, '1'-'9' = frame rate");
+#endif
+#ifdef APPLET_PROFILING
+            Serial.println("'P' = dump applet profiling table, 'p' = reset it");
 #endif
             break;
 
+#ifdef PRINT_DEBUG
           case 'I':
             OC::CORE::app_isr_enabled = !OC::CORE::app_isr_enabled;
             Serial.printf("App ISR = %s\n", OC::CORE::app_isr_enabled ? "ON" : "OFF");
@@ -541,6 +620,26 @@ void FASTRUN loop() {
           case '>':
             // simulate Right Encoder turn
             break;
+#endif
+#ifdef APPLET_PROFILING
+          case 'P':
+            HS::Profiler::Dump();
+            break;
+          case 'p':
+            HS::Profiler::Reset();
+            break;
+#endif
+#if defined(__IMXRT1062__)
+          case 'V':
+            ScreenStream::Start();
+            break;
+          case 'v':
+            ScreenStream::Stop();
+            break;
+          case '1': case '2': case '3': case '4': case '5':
+          case '6': case '7': case '8': case '9':
+            ScreenStream::SetRate(cmd - '1');
+            break;
 #endif
           default:
             capreq = true;
@@ -553,6 +652,13 @@ void FASTRUN loop() {
       }
     }
 
+#if defined(__IMXRT1062__)
+    if (ScreenStream::enabled) {
+      ScreenStream::Poll();
+      continue;
+    }
+#endif
+
     // check for frame buffer to have capture data ready
     const uint8_t *capture_data = display::frame_buffer.captured();
     if (capture_data && cap_send_time > 950) {
@@ -186,6 +186,44 @@ void DAC8565::Write(uint32_t cmd, uint32_t data) {
 
 }
 
+void DAC8565::WriteAll(const uint32_t *data) {
+#if defined(NORTHERNLIGHT) && !defined(NLM_DIY)
+  const uint32_t flip = 0;
+#else
+  const uint32_t flip = kMaxValue; // values are <= kMaxValue, so same as kMaxValue - data
+#endif
+
+#if defined(__MK20DX256__)
+  // Each frame is two FIFO entries. Frame n is queued while frame n - 1 is
+  // still being shifted out, and n - 1's receive entries are only popped
+  // after that, so the bus runs without gaps and the only wait is for the
+  // last frame.
+  for (int i = 0; i < 4; ++i) {
+    SPIFIFO.write(kChannelCommand[i], SPI_CONTINUE);
+    SPIFIFO.write16(data[i] ^ flip);
+    if (i) {
+      SPIFIFO.read();
+      SPIFIFO.read();
+    }
+  }
+  SPIFIFO.read();
+  SPIFIFO.read();
+#elif defined(__IMXRT1062__) // Teensy 4.x
+  uint32_t frames[4];
+  for (int i = 0; i < 4; ++i)
+    frames[i] = (kChannelCommand[i] << 16) | ((data[i] ^ flip) & 0xFFFF);
+
+  // A single command setup, then all four frames go into the FIFO
+  LPSPI4_TCR = (LPSPI4_TCR & 0xF8000000) | LPSPI_TCR_FRAMESZ(23)
+    | LPSPI_TCR_PCS(0) | LPSPI_TCR_RXMSK;
+  LPSPI4_TDR = frames[0];
+  LPSPI4_TDR = frames[1];
+  LPSPI4_TDR = frames[2];
+  LPSPI4_SR = LPSPI_SR_TCF; //  clear transmit complete flag before last write to FIFO
+  LPSPI4_TDR = frames[3];
+#endif
+}
+
 // adapted from https://github.com/xxxajk/spi4teensy3 (MISO disabled) : 
 
 #if defined(__MK20DX256__)
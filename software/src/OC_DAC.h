@@ -21,6 +21,14 @@ static inline void dac8568_raw_write(uint32_t data) {
 static inline void dac8568_set_channel(uint32_t channel, uint32_t data) {
   dac8568_raw_write(0x03000000 | ((channel & 0x07) << 20) | ((data & 0xFFFF) << 4));
 }
+// All channels back to back; data is XORed with flip (0 or 0xFFFF)
+static inline void dac8568_set_all(const uint32_t *data, uint32_t flip) {
+  uint32_t words[8];
+  for (uint32_t channel = 0; channel < 8; ++channel)
+    words[channel] = 0x03000000 | (channel << 20) | (((data[channel] ^ flip) & 0xFFFF) << 4);
+  for (uint32_t channel = 0; channel < 8; ++channel)
+    dac8568_raw_write(words[channel]);
+}
 #endif
 
 class DAC8565 {
@@ -47,6 +55,11 @@ public:
   inline static void WriteChannelD(uint32_t data) { Write(kChannelCommand[3], data); }
 #endif
 
+  // Writes all four channels as one burst. The frames are computed up front
+  // and queued back to back, rather than waiting for each channel's transfer
+  // to complete before starting the next.
+  static void WriteAll(const uint32_t *data);
+
 private:
   static void Write(uint32_t cmd, uint32_t data);
 
@@ -191,6 +204,12 @@ public:
     values_[channel] = USAT16(value);
   }
 
+  // Set all channels at once, values[i] going to channels[i]
+  static void set(const DAC_CHANNEL *channels, const int32_t *values) {
+    for (int i = 0; i < DAC_CHANNEL_COUNT; ++i)
+      values_[channels[i]] = USAT16(values[i]);
+  }
+
   static uint32_t value(size_t index) {
     return values_[index];
   }
@@ -299,31 +318,10 @@ public:
   static void Update() {
     #if defined(__IMXRT1062__) && defined(ARDUINO_TEENSY41)
       if (DAC8568_Uses_SPI) {
-        if (DAC_is_inverted) {
-          dac8568_set_channel(0, values_[0]);
-          dac8568_set_channel(1, values_[1]);
-          dac8568_set_channel(2, values_[2]);
-          dac8568_set_channel(3, values_[3]);
-          dac8568_set_channel(4, values_[4]);
-          dac8568_set_channel(5, values_[5]);
-          dac8568_set_channel(6, values_[6]);
-          dac8568_set_channel(7, values_[7]);
-        } else {
-          dac8568_set_channel(0, MAX_VALUE - values_[0]);
-          dac8568_set_channel(1, MAX_VALUE - values_[1]);
-          dac8568_set_channel(2, MAX_VALUE - values_[2]);
-          dac8568_set_channel(3, MAX_VALUE - values_[3]);
-          dac8568_set_channel(4, MAX_VALUE - values_[4]);
-          dac8568_set_channel(5, MAX_VALUE - values_[5]);
-          dac8568_set_channel(6, MAX_VALUE - values_[6]);
-          dac8568_set_channel(7, MAX_VALUE - values_[7]);
-        }
+        dac8568_set_all(values_, DAC_is_inverted ? 0 : MAX_VALUE);
       } else {
     #endif
-        DAC8565::WriteChannelA(values_[0]);
-        DAC8565::WriteChannelB(values_[1]);
-        DAC8565::WriteChannelC(values_[2]);
-        DAC8565::WriteChannelD(values_[3]);
+        DAC8565::WriteAll(values_);
     #if defined(__IMXRT1062__) && defined(ARDUINO_TEENSY41)
       }
     #endif
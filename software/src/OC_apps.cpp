@@ -189,7 +189,7 @@ static void SaveGlobalSettings() {
   }
   */
 
-  PhzConfig::save_config(); // save to default config file
+  PhzConfig::defer_save(); // save to default config file
 #else // --- Teensy 3.2
   memcpy(global_settings.user_scales, OC::user_scales, sizeof(OC::user_scales));
   memcpy(global_settings.user_patterns, OC::user_patterns, sizeof(OC::user_patterns));
@@ -411,12 +411,11 @@ void AppSwitcher::Init(bool reset_settings) {
     char filename[] = "000.SCL";
     bool scala_file_loaded[Scales::SCALE_USER_COUNT] = {false};
     for (size_t i = 0; i < Scales::SCALE_USER_COUNT; ++i) {
+      filename[2] = char('0' + i);
       if (SDcard_Ready && SD.exists(filename)) {
-        filename[2] = char('0' + i);
         File file = SD.open(filename);
         if (file) {
-          Scales::LoadScala(user_scales[i], file);
-          scala_file_loaded[i] = true;
+          scala_file_loaded[i] = Scales::LoadScala(user_scales[i], file);
         }
         file.close();
       }
@@ -708,6 +707,8 @@ bool Ui::AppSettings(bool drawmenu) {
   delay(1);
 
   if (change_app) {
+    // MIDI the previous app queued and didn't get to
+    HS::frame.MIDIState.ingest.Flush();
     app_switcher.set_current_app(cursor.cursor_pos());
     FreqMeasure.end();
     OC::DigitalInputs::reInit();
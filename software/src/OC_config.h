@@ -1,6 +1,9 @@
 #ifndef OC_CONFIG_H_
 #define OC_CONFIG_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #if defined(__MK20DX256__) && F_CPU != 120000000
 #error "Please compile O&C firmware for Teensy 3.2 with CPU speed 120MHz"
 #endif
@@ -20,9 +23,37 @@ static constexpr int ADC_CHANNEL_COUNT = 4;
 // 66us = 15.1515...kHz
 // 72us = 13.888...kHz
 // 100us = 10Khz
-static constexpr uint32_t OC_CORE_ISR_FREQ = 16666U;
-static constexpr uint32_t OC_CORE_TIMER_RATE = (1000000UL / OC_CORE_ISR_FREQ);
+//
+// T4.x can run the core faster; build with e.g. -DOC_CORE_ISR_HZ=33333.
+// Streams from the core to the audio library (StreamResampler) size their
+// buffers from the rate, so they hold the same time at any allowed rate.
+// Anything measured in ticks should come from OC_CORE_TICKS_MS/US, or from
+// OC_CORE_ISR_FREQ, so it lasts just as long at any rate.
+#ifdef OC_CORE_ISR_HZ
+#ifndef __IMXRT1062__
+#error "OC_CORE_ISR_HZ is only supported on Teensy 4.x"
+#endif
+static_assert(OC_CORE_ISR_HZ >= 16666 && OC_CORE_ISR_HZ <= 48000, "OC_CORE_ISR_HZ out of range");
+static constexpr uint32_t OC_CORE_ISR_PERIOD_NS = (1000000000UL + OC_CORE_ISR_HZ / 2) / OC_CORE_ISR_HZ;
+#else
+static constexpr uint32_t OC_CORE_ISR_PERIOD_NS = 60000UL;
+#endif
+static constexpr uint32_t OC_CORE_ISR_FREQ = 1000000000UL / OC_CORE_ISR_PERIOD_NS;
+static constexpr uint32_t OC_CORE_TIMER_RATE = OC_CORE_ISR_PERIOD_NS / 1000; // whole us
+static constexpr uint32_t OC_CORE_TICKS_PER_MINUTE = 60000000000ULL / OC_CORE_ISR_PERIOD_NS;
 static constexpr uint32_t OC_UI_TIMER_RATE   = 1000UL;
+// Lookup tables tuned at the stock 16666 Hz are generated for their original
+// rate times this, so they are unchanged at the default and keep their timing
+// at other rates
+static constexpr double OC_CORE_ISR_RATE_SCALE = OC_CORE_ISR_FREQ / 16666.0;
+
+// Durations in core ticks, rounded to nearest
+constexpr uint32_t OC_CORE_TICKS_US(uint32_t us) {
+  return (uint64_t(us) * 1000 + OC_CORE_ISR_PERIOD_NS / 2) / OC_CORE_ISR_PERIOD_NS;
+}
+constexpr uint32_t OC_CORE_TICKS_MS(uint32_t ms) {
+  return (uint64_t(ms) * 1000000 + OC_CORE_ISR_PERIOD_NS / 2) / OC_CORE_ISR_PERIOD_NS;
+}
 
 // From kinetis.h
 // Cortex-M4: 0,16,32,48,64,80,96,112,128,144,160,176,192,208,224,240
@@ -35,7 +66,7 @@ static constexpr uint32_t SCREENSAVER_TIMEOUT_S = 25; // default time out menu (
 static constexpr uint32_t SCREENSAVER_TIMEOUT_MAX_S = 120;
 
 namespace OC {
-static constexpr size_t kMaxTriggerDelayTicks = 96;
+static constexpr size_t kMaxTriggerDelayTicks = OC_CORE_TICKS_US(96 * 60);
 };
 
 #define OCTAVES 10      // # octaves
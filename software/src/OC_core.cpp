@@ -2,25 +2,40 @@
 
 extern char _heap_end[], *__brkval;
 
-/*volatile*/ std::queue<Task> fn_queue;
-//volatile bool fn_queue_lock = false;
-
-void OC::CORE::DeferTask(Task func) {
-  // This simply ignores Tasks from the ISR while flushing...
-  // Hopefully that's more like debouncing or frame drops and not missed clocks...
-  //if (!fn_queue_lock) // oh no!
-  fn_queue.emplace(func);
+#ifdef __IMXRT1062__
+static constexpr size_t kTaskQueueSize = 16;
+#else
+static constexpr size_t kTaskQueueSize = 8;
+#endif
+
+static util::MPSCQueue<Task, kTaskQueueSize> task_queues[OC::CORE::TASK_PRIORITY_COUNT];
+
+bool OC::CORE::DeferTask(Task func, TaskPriority priority) {
+  return task_queues[priority].Push(func);
 }
+
 void OC::CORE::FlushTasks() {
-  if (fn_queue.empty()) return;
-  //noInterrupts();
-  //fn_queue_lock = true;
-  while (!fn_queue.empty()) {
-    fn_queue.front()();
-    fn_queue.pop();
+  // Bounded, so tasks queued by tasks (or a busy ISR) wait for the next call.
+  // A storage task can block on flash for a while, so only one runs per call.
+  bool stored = false;
+  for (size_t budget = kTaskQueueSize * TASK_PRIORITY_COUNT; budget; --budget) {
+    Task task;
+    const int last = stored ? TASK_STORAGE : TASK_PRIORITY_COUNT;
+    int p = 0;
+    while (p < last && !task_queues[p].Pop(task)) ++p;
+    if (p == last) break;
+    stored |= (p == TASK_STORAGE);
+    task();
   }
-  //interrupts();
-  //fn_queue_lock = false;
+}
+
+OC::CORE::TaskStats OC::CORE::GetTaskStats(TaskPriority priority) {
+  const auto &q = task_queues[priority];
+  return { uint32_t(q.size()), q.peak(), q.dropped() };
+}
+
+void OC::CORE::ResetTaskStats() {
+  for (auto &q : task_queues) q.ResetStats();
 }
 
 int OC::CORE::FreeRam() {
@@ -9,10 +9,10 @@
 #include "OC_menus.h"
 #include "util/util_debugpins.h"
 #include "src/drivers/display.h"
-#include <functional>
-#include <queue>
+#include "util/util_task_queue.h"
 
-using Task = std::function<void()>;
+// Deferred work, run from loop(); see OC::CORE::DeferTask
+using Task = util::InplaceTask<8>;
 
 namespace OC {
   namespace CORE {
@@ -21,8 +21,27 @@ namespace OC {
     extern volatile bool display_update_enabled;
     extern volatile bool app_loop_enabled;
 
-    void DeferTask(Task func);
+    // Highest priority first; FlushTasks() always runs the most urgent
+    // pending task next, and at most one TASK_STORAGE task per call.
+    enum TaskPriority : uint8_t {
+      TASK_REALTIME, // timing-sensitive output, e.g. MIDI clock
+      TASK_UI,
+      TASK_STORAGE, // saving/loading, can take a while
+      TASK_PRIORITY_COUNT
+    };
+
+    struct TaskStats {
+      uint32_t pending;
+      uint32_t peak; // most tasks pending at once
+      uint32_t dropped; // rejected because the queue was full
+    };
+
+    // Safe to call from the ISRs as well as the main loop; never allocates.
+    // @return false if the task was dropped
+    bool DeferTask(Task func, TaskPriority priority = TASK_UI);
     void FlushTasks();
+    TaskStats GetTaskStats(TaskPriority priority);
+    void ResetTaskStats();
     int FreeRam();
   }; // namespace CORE
 
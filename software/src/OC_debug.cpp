@@ -11,6 +11,8 @@
 #include "OC_ui.h"
 #include "OC_strings.h"
 #include "OC_apps.h"
+#include "HSProfiler.h"
+#include "HSIOFrame.h"
 #include "util/util_math.h"
 #include "util/util_misc.h"
 #include "src/extern/dspinst.h"
@@ -18,6 +20,7 @@
 
 #ifdef ARDUINO_TEENSY41
 #include <Audio.h>
+#include "Audio/PsramArena.h"
 
 extern "C" uint8_t external_psram_size;
 extern char _extram_start[], _extram_end[];
@@ -103,6 +106,12 @@ static void debug_menu_ram() {
   graphics.setPrintPos(2, 32);
   graphics.printf("PSRAM %7d (%dKB)", psram, psram >> 10);
   extmem_free(derp);
+
+  const PsramArena::Stats arena = PsramArena::GetStats();
+  graphics.setPrintPos(2, 42);
+  graphics.printf("ARENA %4dK/%dK", int(arena.used >> 10), int(arena.capacity >> 10));
+  graphics.setPrintPos(2, 52);
+  graphics.printf("FREE  %4dK MAX %dK", int(arena.available >> 10), int(arena.largest_available >> 10));
 #endif
 }
 
@@ -119,7 +128,7 @@ static void debug_menu_core() {
                   debug::cycles_to_us(DEBUG::ISR_cycles.min_value()),
                   isr_us,
                   debug::cycles_to_us(DEBUG::ISR_cycles.max_value()),
-                  (isr_us * 100) /  OC_CORE_TIMER_RATE);
+                  (isr_us * 100000) / OC_CORE_ISR_PERIOD_NS);
 
   y += 10;
   graphics.setPrintPos(2, y);
@@ -194,6 +203,41 @@ static void debug_menu_gfx() {
                   debug::cycles_to_us(DEBUG::MENU_draw_cycles.min_value()),
                   debug::cycles_to_us(DEBUG::MENU_draw_cycles.value()),
                   debug::cycles_to_us(DEBUG::MENU_draw_cycles.max_value()));
+
+  const uint32_t sent = display::pages_sent();
+  const uint32_t skipped = display::pages_skipped();
+  graphics.setPrintPos(2, 32);
+  graphics.printf("PAGES %lu sent", sent);
+  graphics.setPrintPos(2, 42);
+  graphics.printf("      %lu skip %2lu%%", skipped,
+                  (sent + skipped) ? uint32_t(uint64_t(skipped) * 100 / (sent + skipped)) : 0);
+}
+
+// Deferred tasks: pending/peak/dropped per priority
+FLASHMEM
+static void debug_menu_tasks() {
+  static const char * const names[] = { "RT", "UI", "STOR" };
+  for (int p = 0; p < CORE::TASK_PRIORITY_COUNT; ++p) {
+    const CORE::TaskStats stats = CORE::GetTaskStats(CORE::TaskPriority(p));
+    graphics.setPrintPos(2, 12 + p * 10);
+    graphics.printf("%-4s %2lu pk%2lu !%lu", names[p], stats.pending, stats.peak, stats.dropped);
+  }
+  // Hemisphere/Quadrants beat-sync ring
+  graphics.setPrintPos(2, 12 + CORE::TASK_PRIORITY_COUNT * 10);
+  graphics.printf("Sync %2u pk%2u !%lu", HS::clock_m.syncfn_queue.readable(),
+                  HS::clock_m.sync_high_water, HS::clock_m.sync_overflows);
+}
+
+// Hemisphere/Quadrants MIDI input queue; latency in core ticks
+FLASHMEM
+static void debug_menu_midi_ingest() {
+  const auto &ingest = HS::frame.MIDIState.ingest;
+  graphics.setPrintPos(2, 12);
+  graphics.printf("Rx %lu drop %lu", ingest.received, ingest.dropped);
+  graphics.setPrintPos(2, 22);
+  graphics.printf("Depth %u max %lu/%u", ingest.readable(), ingest.max_depth, HS::MIDI_INGEST_SIZE);
+  graphics.setPrintPos(2, 32);
+  graphics.printf("Lat %lu avg %lu max", ingest.mean_latency(), ingest.max_latency);
 }
 
 FLASHMEM
@@ -370,6 +414,24 @@ static void debug_menu_app() {
   }
 }
 
+#ifdef APPLET_PROFILING
+FLASHMEM
+static void debug_menu_applets() {
+  using namespace HS::Profiler;
+  graphics.setPrintPos(2, 12);
+  graphics.print("       slot ctrl/max view");
+  const int count = min(entry_count(), 4);
+  for (int i = 0; i < count; ++i) {
+    const Entry &e = entry(i);
+    graphics.setPrintPos(2, 22 + i * 10);
+    graphics.printf("%-8.8s%u %3lu/%3lu %4lu", e.name, e.slot,
+                    debug::cycles_to_us(e.phase[CONTROLLER].cycles.value()),
+                    debug::cycles_to_us(e.phase[CONTROLLER].cycles.max_value()),
+                    debug::cycles_to_us(e.phase[VIEW].cycles.value()));
+  }
+}
+#endif
+
 struct DebugMenu {
   const char *title;
   void (*display_fn)();
@@ -384,6 +446,11 @@ static const DebugMenu debug_menus[] = {
 #endif
   { "VERS", debug_menu_version },
   { "GFX", debug_menu_gfx },
+  { "MIDI IN", debug_menu_midi_ingest },
+  { "TASKS", debug_menu_tasks },
+#ifdef APPLET_PROFILING
+  { "APPLETS (us)", debug_menu_applets },
+#endif
   { "ADC", debug_menu_adc },
 #ifdef OC_DEBUG_ADC_STATS
   { "ADC min/max", debug_menu_adc2 },
@@ -77,11 +77,9 @@ void InputDesc::set_printf(const char *fmt, ...)
   }
 }
 
-static void IOFrameToChannel(DAC_CHANNEL channel, const IOFrame *ioframe, const IOSettings *io_settings) 
+static int32_t IOFrameToDAC(DAC_CHANNEL channel, int32_t value, OutputMode mode, const IOSettings *io_settings)
 {
-  DEBUG_PIN_SCOPE(OC_GPIO_DEBUG_PIN1);
-  auto value = ioframe->outputs.values[channel];
-  switch(ioframe->outputs.modes[channel]) {
+  switch(mode) {
     case OUTPUT_MODE_PITCH:
       value = DAC::PitchToScaledDAC(channel,
                   value, io_settings->get_output_scaling(channel),
@@ -91,11 +89,12 @@ static void IOFrameToChannel(DAC_CHANNEL channel, const IOFrame *ioframe, const
     case OUTPUT_MODE_UNI:   value += DAC::get_zero_offset(channel); break;
     case OUTPUT_MODE_RAW:   break;
   }
-  DAC::set(channel, value);
+  return value;
 }
 
 /*static*/ void IO::Write(IOFrame *ioframe, const IOSettings *io_settings) 
 {
+  DEBUG_PIN_SCOPE(OC_GPIO_DEBUG_PIN1);
   const DAC_CHANNEL chan[DAC_CHANNEL_COUNT] = {
     DAC_CHANNEL_A, DAC_CHANNEL_B, DAC_CHANNEL_C, DAC_CHANNEL_D,
 #ifdef ARDUINO_TEENSY41
@@ -103,9 +102,14 @@ static void IOFrameToChannel(DAC_CHANNEL channel, const IOFrame *ioframe, const
 #endif
   };
 
+  // Convert the whole frame, then hand it to the DAC in one go
+  int32_t values[DAC_CHANNEL_COUNT];
   for (int i = 0; i < DAC_CHANNEL_COUNT; ++i) {
-    IOFrameToChannel(chan[i], ioframe, io_settings);
+    const DAC_CHANNEL channel = chan[i];
+    values[i] = IOFrameToDAC(channel, ioframe->outputs.values[channel],
+                             ioframe->outputs.modes[channel], io_settings);
   }
+  DAC::set(chan, values);
 }
 
 /*static*/ int32_t IO::pitch_rel_to_abs(int32_t pitch) {
@@ -0,0 +1,180 @@
+/* Scala scale library
+ *
+ * Index of the .scl files on the SD card, kept on LittleFS. See
+ * OC_scale_library.h
+ */
+#ifdef __IMXRT1062__
+#include "OC_scale_library.h"
+#include "HSUtils.h"
+
+namespace OC {
+
+ScaleLibrary scale_library;
+
+// File format, little-endian:
+//   "SCIX", 16-bit version, 16-bit entry count, 16-bit entry size, 16-bit reserved
+//   entries, each an Entry as laid out in RAM
+static const char MAGIC[] = "SCIX";
+static const char * const TEMPFILE = "SCALES.TMP";
+
+static void put_u16(uint8_t *buf, uint16_t value) {
+  buf[0] = value & 0xff;
+  buf[1] = value >> 8;
+}
+static uint16_t get_u16(const uint8_t *buf) {
+  return uint16_t(buf[0]) | uint16_t(buf[1]) << 8;
+}
+
+static bool write_header(File &file, size_t count) {
+  uint8_t buf[ScaleLibrary::HEADER_SIZE];
+  memcpy(buf, MAGIC, 4);
+  put_u16(buf + 4, ScaleLibrary::VERSION);
+  put_u16(buf + 6, count);
+  put_u16(buf + 8, sizeof(ScaleLibrary::Entry));
+  put_u16(buf + 10, 0);
+  return file.seek(0) && file.write(buf, sizeof(buf)) == sizeof(buf);
+}
+
+static bool is_scala_file(const char *name) {
+  const size_t n = strlen(name);
+  return n > 4 && name[n - 4] == '.'
+    && (name[n - 3] | 0x20) == 's' && (name[n - 2] | 0x20) == 'c' && (name[n - 1] | 0x20) == 'l';
+}
+
+void ScaleLibrary::Entry::CopyTo(Scale &scale) const {
+  scale.num_notes = num_notes < 2 ? 2 : num_notes > kMaxScaleLength ? kMaxScaleLength : num_notes;
+  scale.span = span;
+  memcpy(scale.notes, notes, sizeof(notes));
+}
+
+bool ScaleLibrary::Open(FS &fs) {
+  fs_ = &fs;
+  count_ = 0;
+  if (index_) index_.close();
+
+  index_ = fs.open(filename_);
+  if (!index_) return false;
+
+  uint8_t header[HEADER_SIZE];
+  if (index_.read(header, HEADER_SIZE) != HEADER_SIZE || memcmp(header, MAGIC, 4)
+      || get_u16(header + 4) != VERSION || get_u16(header + 8) != sizeof(Entry)) {
+    SERIAL_PRINTLN("ScaleLibrary: bad header in %s\n", filename_);
+    index_.close();
+    return false;
+  }
+
+  // a short file has lost its tail; keep what's there
+  const size_t count = get_u16(header + 6);
+  const size_t available = (index_.size() - HEADER_SIZE) / sizeof(Entry);
+  count_ = count < available ? count : available;
+  SERIAL_PRINTLN("ScaleLibrary: %u scales in %s\n", count_, filename_);
+  return true;
+}
+
+FLASHMEM
+bool ScaleLibrary::StartIndexing(FS &source, const char *dir, FS &fs) {
+  if (indexing_) {
+    dir_.close();
+    temp_.close();
+    indexing_ = false;
+  }
+  fs_ = &fs;
+  pending_ = 0;
+
+  dir_ = source.open(dir);
+  if (!dir_ || !dir_.isDirectory()) {
+    SERIAL_PRINTLN("ScaleLibrary: no directory %s\n", dir);
+    dir_.close();
+    return false;
+  }
+
+  fs.remove(TEMPFILE);
+  temp_ = fs.open(TEMPFILE, FILE_WRITE_BEGIN);
+  if (!temp_ || !write_header(temp_, 0)) {
+    HS::PokePopup(HS::MESSAGE_POPUP, "File ERROR !!");
+    dir_.close();
+    temp_.close();
+    return false;
+  }
+
+  indexing_ = true;
+  return true;
+}
+
+FLASHMEM
+bool ScaleLibrary::Poll() {
+  if (!indexing_) return false;
+
+  // Other files are only a name check, so skip over them in the same call
+  for (;;) {
+    File file = dir_.openNextFile();
+    if (!file) {
+      FinishIndexing();
+      return false;
+    }
+    if (file.isDirectory() || !is_scala_file(file.name())) {
+      file.close();
+      continue;
+    }
+
+    Entry entry;
+    memset(&entry, 0, sizeof(entry));
+    Scale scale;
+    const bool loaded = Scales::LoadScala(scale, file, entry.name);
+    if (loaded) {
+      if (!entry.name[0]) {
+        // "NAME.SCL" -> "NAME"
+        strncpy(entry.name, file.name(), NAME_LENGTH - 1);
+        char *ext = strrchr(entry.name, '.');
+        if (ext) *ext = '\0';
+      }
+      entry.num_notes = scale.num_notes;
+      entry.span = scale.span;
+      memcpy(entry.notes, scale.notes, scale.num_notes * sizeof(scale.notes[0]));
+    } else {
+      SERIAL_PRINTLN("ScaleLibrary: skipping %s\n", file.name());
+    }
+    file.close();
+
+    if (!loaded) return true;
+    if (pending_ >= 0xffff || temp_.write(&entry, sizeof(entry)) != sizeof(entry)) {
+      HS::PokePopup(HS::MESSAGE_POPUP, "Write ERROR !!");
+      FinishIndexing();
+      return false;
+    }
+    ++pending_;
+    return true;
+  }
+}
+
+void ScaleLibrary::FinishIndexing() {
+  dir_.close();
+  indexing_ = false;
+
+  const bool success = write_header(temp_, pending_);
+  temp_.close();
+  if (!success) {
+    fs_->remove(TEMPFILE);
+    return;
+  }
+
+  if (index_) index_.close();
+  fs_->remove(filename_);
+  fs_->rename(TEMPFILE, filename_);
+  Open(*fs_);
+}
+
+bool ScaleLibrary::Read(size_t index, Entry &entry) {
+  if (index >= count_ || !index_) return false;
+  return index_.seek(entry_offset(index)) && index_.read(&entry, sizeof(entry)) == sizeof(entry);
+}
+
+bool ScaleLibrary::Load(size_t index, Scale &scale) {
+  Entry entry;
+  if (!Read(index, entry)) return false;
+  entry.CopyTo(scale);
+  return true;
+}
+
+} // namespace OC
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+
+#ifdef __IMXRT1062__
+#include "OC_scales.h"
+#include "PhzConfig.h"
+
+namespace OC {
+
+  // A directory of Scala files, indexed once into a file of fixed-size
+  // entries on LittleFS. Reading a scale is then a seek and a read of its
+  // entry, without going back to the card.
+  //
+  // Indexing runs in the background: Poll() parses one file per call, into
+  // a temporary file that replaces the index when it's complete, so the old
+  // index stays usable until then.
+  class ScaleLibrary {
+  public:
+    static constexpr size_t NAME_LENGTH = util::ScalaParser::kNameLength;
+
+    struct Entry {
+      char name[NAME_LENGTH]; // description, or file name if there is none
+      uint8_t num_notes;
+      uint8_t reserved;
+      int16_t span;
+      int16_t notes[kMaxScaleLength];
+
+      void CopyTo(Scale &scale) const;
+    };
+    static_assert(sizeof(Entry) == 60, "scale index entry size mismatch");
+
+    ScaleLibrary(const char *filename = "SCALES.IDX") : filename_(filename) { }
+
+    // Opens the index; false if there is none yet, or it's damaged
+    bool Open(FS &fs = PhzConfig::myfs);
+    // Starts (re)indexing the .scl files in dir; the index is written to the
+    // filesystem given to Open(), or fs
+    bool StartIndexing(FS &source, const char *dir = "/SCALES", FS &fs = PhzConfig::myfs);
+    // Indexes the next file; @return true while there's more to do
+    bool Poll();
+
+    bool indexing() const { return indexing_; }
+    size_t indexed() const { return pending_; }
+    size_t size() const { return count_; }
+
+    bool Read(size_t index, Entry &entry);
+    bool Load(size_t index, Scale &scale);
+
+    // File layout
+    static constexpr uint32_t HEADER_SIZE = 12;
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t entry_offset(size_t index) {
+      return HEADER_SIZE + index * sizeof(Entry);
+    }
+
+  private:
+    const char *filename_;
+    FS *fs_ = nullptr;
+    File index_;
+    size_t count_ = 0;
+
+    File dir_;
+    File temp_;
+    size_t pending_ = 0;
+    bool indexing_ = false;
+
+    void FinishIndexing();
+  };
+
+  extern ScaleLibrary scale_library;
+
+}
+#endif
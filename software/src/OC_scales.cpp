@@ -45,60 +45,27 @@ void Scales::SaveToScala(Scale &scale, File &file) {
     int decimal = (scale.notes[i] * 100 * 10000 / 128) % 10000;
     file.printf("%d.%04d\n", cents, decimal);
   }
+  // ...and the span is the last one
+  file.printf("%d.%04d\n", scale.span * 100 / 128, (scale.span * 100 * 10000 / 128) % 10000);
 
   // TA-DA!! it's that easy.
 }
 
 FLASHMEM
-void Scales::LoadScala(Scale &scale, File &file) {
-  if (!file.available()) return;
-  String buf = file.readStringUntil('\n'); // grab the first line
-
-  // maybe it's a comment
-  while (buf.charAt(0) == '!') {
-    if (!file.available()) return;
-    buf = file.readStringUntil('\n');
+bool Scales::LoadScala(Scale &scale, File &file, char *name) {
+  util::ScalaParser parser;
+  char buf[64];
+  size_t n;
+  while ((n = file.read(buf, sizeof(buf))) > 0) {
+    if (!parser.Parse(buf, n)) break;
   }
-  // found the first non-comment - description. skip it.
-  do {
-    if (!file.available()) return;
-    buf = file.readStringUntil('\n');
-  } while (buf.charAt(0) == '!'); // skip other comments
-
-  // next line - number of notes
-  scale.num_notes = buf.toInt();
-  CONSTRAIN(scale.num_notes, 2, 16);
-
-  bool largespan = false;
-  scale.notes[0] = 0;
-  // start at one because 0.0 is implicit
-  for (size_t i = 1; i < scale.num_notes; ++i) {
-    do {
-      if (!file.available()) return;
-      buf = file.readStringUntil('\n');
-    } while (buf.charAt(0) == '!'); // skip comments
+  if (!parser.Finish()) return false;
 
-    // a note, either a decimal or fraction
-    // so we look for either '.' or '/' inside
-    float notef = buf.toFloat();
-    int dividx = buf.indexOf('/');
-    if (dividx > 0) {
-      int numer = buf.substring(0,dividx).toInt();
-      int denom = buf.substring(dividx+1).toInt();
-      notef = 1200.0 * (static_cast<float>(numer) / static_cast<float>(denom)) - 1200.0f;
-    }
-
-    // from cents to CV values (128 per semitone)
-    notef += 0.001; // just trying not to round down
-    int pitch = notef * 128 / 100;
-    CONSTRAIN(pitch, 1, 12 * 128 * 2); // max span... two octaves?
-    scale.notes[i] = pitch;
-
-    if (pitch > (12 << 7)) largespan = true;
-  }
-  // either one or two octaves
-  // if you want more, hack it in yourself :P
-  scale.span = (12 << 7) * (1+largespan);
+  scale.num_notes = parser.num_notes();
+  scale.span = parser.span();
+  memcpy(scale.notes, parser.notes(), scale.num_notes * sizeof(scale.notes[0]));
+  if (name) strcpy(name, parser.name());
+  return true;
 }
 
 PROGMEM
@@ -5,6 +5,7 @@
 #include "FS.h"
 #include "src/extern/braids_quantizer.h"
 #include "src/extern/braids_quantizer_scales.h"
+#include "util/util_scala.h"
 
 // Common scales and stuff
 namespace OC {
@@ -33,7 +34,9 @@ public:
   static constexpr int NUM_SCALES = SCALE_USER_COUNT + braids::kNumScales;
 
   static void SaveToScala(Scale &scale, File &file);
-  static void LoadScala(Scale &scale, File &file);
+  // @return false if the file isn't a complete scale; scale is unchanged.
+  // name, if given, gets the description (util::ScalaParser::kNameLength)
+  static bool LoadScala(Scale &scale, File &file, char *name = nullptr);
 };
 
 extern const char *const scale_names[];
@@ -1,4 +1,5 @@
 #include "OC_strings.h"
+#include "OC_config.h"
 
 namespace OC {
 
@@ -353,7 +354,8 @@ namespace OC {
 
   // \sa OC_config.h -> kMaxTriggerDelayTicks
   const uint8_t trigger_delay_ticks[kNumDelayTimes] = {
-    0, 2, 4, 6, 8, 16, 33, 66
+    0, OC_CORE_TICKS_US(120), OC_CORE_TICKS_US(240), OC_CORE_TICKS_US(360),
+    OC_CORE_TICKS_US(480), OC_CORE_TICKS_US(960), OC_CORE_TICKS_US(1980), OC_CORE_TICKS_US(3960)
   };
 
  
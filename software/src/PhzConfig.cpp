@@ -7,6 +7,7 @@
 #ifdef __IMXRT1062__
 #include "PhzConfig.h"
 #include "HSUtils.h"
+#include "OC_core.h"
 #include "util/util_misc.h"
 #include "usb_desc.h"
 
@@ -18,14 +19,33 @@ namespace PhzConfig {
 
 LittleFS_Program myfs;
 File dataFile;
-ConfigMap cfg_store;
-ConfigMap data_store;
+DMAMEM ConfigMap cfg_store;
+DMAMEM DataMap data_store;
 
 // Specify size to use of onboard Teensy Program Flash chip.
 // the maximum flash available for LittleFS is 960 blocks of 1024 bytes
 static constexpr uint32_t diskSize = 1024 * 512;
 // custom file format header
 static constexpr uint32_t HEADER_SIZE = 12;
+static constexpr size_t RECORD_SIZE = sizeof(KEY) + sizeof(VALUE);
+static_assert(RECORD_SIZE == 10, "config data size mismatch");
+
+// File format: a series of chunks, each a 12-byte header (2-byte signature,
+// 16-bit record count, 64-bit XOR of values) followed by 10-byte records.
+// Later chunks override earlier ones, so journal saves just append chunks of
+// changed records ("PZ"/"PX") and deleted keys ("Pz"/"Px").
+static const char SIG_CONFIG[] = "PZ";
+static const char SIG_DATA[] = "PX";
+static const char SIG_CONFIG_DEL[] = "Pz";
+static const char SIG_DATA_DEL[] = "Px";
+
+// Which file the stores were last loaded from or saved to, for journaling
+static struct {
+  char filename[64];
+  FS *fs;
+  size_t file_records; // total records in the file, live or stale
+  bool full_write; // journal can't represent the change, e.g. clear_config()
+} journal;
 
 FLASHMEM
 void Init()
@@ -60,24 +80,57 @@ void Init()
   */
 }
 
+// A save queued by defer_save(); filename[0] == 0 when there is none
+static struct {
+  char filename[64];
+  FS *fs;
+} pending_save;
+
+static bool save_pending(const char* filename, FS &fs) {
+  return pending_save.filename[0] && pending_save.fs == &fs
+    && !strncmp(pending_save.filename, filename, sizeof(pending_save.filename));
+}
+
+bool flush_save() {
+  if (!pending_save.filename[0]) return true;
+  char filename[sizeof(pending_save.filename)];
+  memcpy(filename, pending_save.filename, sizeof(filename));
+  pending_save.filename[0] = 0;
+  return save_config(filename, *pending_save.fs);
+}
+
+bool defer_save(const char* filename, FS &fs) {
+  if (save_pending(filename, fs)) return true;
+  flush_save(); // the store is about to belong to another file
+
+  strncpy(pending_save.filename, filename, sizeof(pending_save.filename) - 1);
+  pending_save.filename[sizeof(pending_save.filename) - 1] = 0;
+  pending_save.fs = &fs;
+  if (OC::CORE::DeferTask([]() { flush_save(); }, OC::CORE::TASK_STORAGE))
+    return true;
+  return flush_save(); // queue full, save it now
+}
+
 void clear_config() {
+  flush_save();
   cfg_store.clear();
   data_store.clear();
+  journal.full_write = true;
+}
+
+static void store_full() {
+  SERIAL_PRINTLN("PhzConfig: store full!");
+  HS::PokePopup(HS::MESSAGE_POPUP, "Config FULL !!");
 }
 
 void setValue(KEY key, VALUE value)
 {
-  cfg_store[key] = value;
+  if (!cfg_store.insert_or_assign(key, value)) store_full();
 }
 
 bool getValue(KEY key, VALUE &value)
 {
-  auto thing = cfg_store.find(key);
-  if (thing != cfg_store.end()) {
-    value = thing->second;
-    return true;
-  }
-  return false;
+  return cfg_store.find(key, value);
 }
 
 void deleteKey(KEY key) {
@@ -85,66 +138,155 @@ void deleteKey(KEY key) {
 }
 
 void setData(KEY key, VALUE value) {
-  data_store[key] = value;
+  if (!data_store.insert_or_assign(key, value)) store_full();
 }
 bool getData(KEY key, VALUE &value) {
-  auto thing = data_store.find(key);
-  if (thing != data_store.end()) {
-    value = thing->second;
-    return true;
-  }
-  return false;
+  return data_store.find(key, value);
 }
 void deleteData(KEY key) {
   data_store.erase(key);
 }
 
-size_t save_chunk(const size_t offset, const char* sig, ConfigMap &store) {
-  size_t record_count = 0;
-  size_t bytes_written = 0;
-
-  // 12-byte header:
-  char header_buf[HEADER_SIZE] = {
-    sig[0], sig[1], // signature
-    0, 0, // record count
-    0, 0, 0, 0, 0, 0, 0, 0, // checksum
-  };
+static void pack_header(uint8_t *buf, const char *sig, size_t count, uint64_t checksum) {
+  buf[0] = sig[0];
+  buf[1] = sig[1];
+  buf[2] = count & 0xff;
+  buf[3] = (count >> 8) & 0xff;
+  for (int i = 0; i < 8; ++i) buf[4 + i] = (checksum >> (i * 8)) & 0xff;
+}
 
-  dataFile.seek(offset);
-  dataFile.write(header_buf, HEADER_SIZE);
+static void pack_record(uint8_t *buf, KEY key, VALUE value) {
+  buf[0] = key & 0xff;
+  buf[1] = key >> 8;
+  for (int i = 0; i < 8; ++i) buf[2 + i] = (value >> (i * 8)) & 0xff;
+}
 
+// Writes one chunk of records at the current file position.
+// @return number of records written, or -1 on error
+template <class Store>
+static int save_chunk(const char* sig, const Store &store, bool dirty_only) {
+  size_t record_count = 0;
   uint64_t checksum = 0;
-  for (auto &i : store)
-  {
-    checksum ^= i.second;
-    int result = dataFile.write((const uint8_t*)&i.first, sizeof(i.first)) +
-                dataFile.write((const uint8_t*)&i.second, sizeof(i.second));
-    if (result != (sizeof(i.first) + sizeof(i.second))) {
+  for (size_t i = 0; i < store.size(); ++i) {
+    if (dirty_only && !store.dirty_at(i)) continue;
+    checksum ^= store.value_at(i);
+    ++record_count;
+  }
+  if (dirty_only && !record_count) return 0;
+  if (record_count > 0xffff) return -1;
+
+  uint8_t buf[HEADER_SIZE];
+  pack_header(buf, sig, record_count, checksum);
+  if (dataFile.write(buf, HEADER_SIZE) != HEADER_SIZE) return -1;
+
+  for (size_t i = 0; i < store.size(); ++i) {
+    if (dirty_only && !store.dirty_at(i)) continue;
+    pack_record(buf, store.key_at(i), store.value_at(i));
+    const size_t result = dataFile.write(buf, RECORD_SIZE);
+    if (result != RECORD_SIZE) {
       // something went wrong
       SERIAL_PRINTLN("!! ERROR while writing file !!\n   Result = %d\n", result);
-      return 0;
+      return -1;
     }
-    bytes_written += result;
+  }
+
+  SERIAL_PRINTLN("%c%c: Records written = %u\n", sig[0], sig[1], record_count);
+  SERIAL_PRINTLN("Checksum: %lx%lx\n",
+      (uint32_t)checksum, (uint32_t)(checksum >> 32));
+
+  return record_count;
+}
+
+// Deleted keys go in their own chunk; the key doubles as the value so the
+// checksum still covers them.
+template <class Store>
+static int save_deletes(const char* sig, const Store &store) {
+  const size_t record_count = store.deleted_count();
+  if (!record_count) return 0;
+
+  uint64_t checksum = 0;
+  for (size_t i = 0; i < record_count; ++i) checksum ^= store.deleted_at(i);
+
+  uint8_t buf[HEADER_SIZE];
+  pack_header(buf, sig, record_count, checksum);
+  if (dataFile.write(buf, HEADER_SIZE) != HEADER_SIZE) return -1;
+
+  for (size_t i = 0; i < record_count; ++i) {
+    pack_record(buf, store.deleted_at(i), store.deleted_at(i));
+    if (dataFile.write(buf, RECORD_SIZE) != RECORD_SIZE) return -1;
+  }
+  return record_count;
+}
+
+static bool journal_matches(const char* filename, FS &fs) {
+  return journal.fs == &fs && !strncmp(journal.filename, filename, sizeof(journal.filename));
+}
+
+static void journal_reset(const char* filename, FS &fs, size_t file_records) {
+  strncpy(journal.filename, filename, sizeof(journal.filename) - 1);
+  journal.filename[sizeof(journal.filename) - 1] = 0;
+  journal.fs = &fs;
+  journal.file_records = file_records;
+  journal.full_write = false;
+  cfg_store.mark_clean();
+  data_store.mark_clean();
+}
 
-    record_count += 1;
+// Append changed records to the existing file.
+// @return false if that didn't work out and a full rewrite is needed
+static bool append_journal(const char* filename, FS &fs) {
+  const size_t pending = cfg_store.dirty_count() + cfg_store.deleted_count()
+    + data_store.dirty_count() + data_store.deleted_count();
+  if (!pending) {
+    SERIAL_PRINTLN("PhzConfig: %s unchanged\n", filename);
+    return true;
   }
 
-  if (dataFile.seek(offset + 2)) {
-    dataFile.write((const uint8_t*)&record_count, 2);
-    dataFile.write((const uint8_t*)&checksum, 8);
+  const size_t live = cfg_store.size() + data_store.size();
+  if (journal.file_records + pending > live + JOURNAL_SLACK) {
+    SERIAL_PRINTLN("PhzConfig: compacting %s\n", filename);
+    return false;
   }
 
-  SERIAL_PRINTLN("Records written = %u\n", record_count);
-  SERIAL_PRINTLN("Bytes written = %u\n", bytes_written);
-  SERIAL_PRINTLN("Checksum: %lx%lx\n",
-      (uint32_t)checksum, (uint32_t)(checksum >> 32));
+  dataFile = fs.open(filename, FILE_WRITE);
+  if (!dataFile) return false;
+  const size_t start = dataFile.size();
+  dataFile.seek(start);
+
+  int written = 0, n;
+  if ((n = save_chunk(SIG_CONFIG, cfg_store, true)) >= 0) written += n;
+  if (n >= 0 && (n = save_deletes(SIG_CONFIG_DEL, cfg_store)) >= 0) written += n;
+  if (n >= 0 && (n = save_chunk(SIG_DATA, data_store, true)) >= 0) written += n;
+  if (n >= 0 && (n = save_deletes(SIG_DATA_DEL, data_store)) >= 0) written += n;
+
+  if (n < 0) {
+    // drop the partial chunk; a rewrite follows
+    dataFile.truncate(start);
+    dataFile.close();
+    return false;
+  }
+  dataFile.close();
 
-  return offset + HEADER_SIZE + bytes_written;
+  SERIAL_PRINTLN("PhzConfig: appended %d records to %s\n", written, filename);
+  journal_reset(filename, fs, journal.file_records + written);
+  return true;
 }
+
 bool save_config(const char* filename, FS &fs)
 {
     SERIAL_PRINTLN("\nSaving Config: %s\n", filename);
 
+    if (save_pending(filename, fs))
+      pending_save.filename[0] = 0; // saving it now
+    else
+      flush_save();
+
+    if (journal_matches(filename, fs) && !journal.full_write
+        && !cfg_store.deletes_overflowed() && !data_store.deletes_overflowed()
+        && fs.exists(filename)) {
+      if (append_journal(filename, fs)) return true;
+    }
+
     const char* const TEMPFILE = "PEWPEW.TMP";
     bool success = true;
 
@@ -155,12 +297,13 @@ bool save_config(const char* filename, FS &fs)
     fs.remove(TEMPFILE);
     dataFile = fs.open(TEMPFILE, FILE_WRITE_BEGIN);
     if (dataFile) {
-      size_t sz  = save_chunk( 0, "PZ",  cfg_store);
-      if (sz) sz = save_chunk(sz, "PX", data_store);
-      if (sz) { // success!
+      const int n = save_chunk(SIG_CONFIG, cfg_store, false);
+      if (n >= 0 && save_chunk(SIG_DATA, data_store, false) >= 0) { // success!
         dataFile.close();
       } else {
+        dataFile.close();
         HS::PokePopup(HS::MESSAGE_POPUP, "Write ERROR !!");
+        success = false;
       }
     } else {
       SERIAL_PRINTLN("PhzConfig: Error opening %s\n", filename);
@@ -175,81 +318,68 @@ bool save_config(const char* filename, FS &fs)
         HS::PokePopup(HS::MESSAGE_POPUP, "TempFile ERR !!");
     }
 
+    if (success)
+      journal_reset(filename, fs, cfg_store.size() + data_store.size());
+
     return success;
 }
 
-bool load_chunk(uint8_t *buf, const char *sig, ConfigMap &store) {
-  // quick signature check
-  if (buf[0] != sig[0] || buf[1] != sig[1]) return false;
+// Reads one chunk's records after its header. The records are checked
+// against the header before any are applied, so a chunk torn by a power loss
+// mid-append is skipped entirely.
+// @return records applied, or -1 if the chunk is incomplete or corrupt
+static int load_chunk(const uint8_t *header) {
+  const size_t expected_record_count = uint16_t(header[2]) | uint16_t(header[3]) << 8;
+  uint64_t expected_checksum = 0;
+  for (int i = 0; i < 8; ++i) expected_checksum |= (uint64_t)header[4 + i] << (i * 8);
 
-  size_t record_count = 0;
-  size_t expected_record_count = uint16_t(buf[2]) | uint16_t(buf[3]) << 8;
-  uint64_t expected_checksum =
-          (uint64_t)buf[4] |
-          (uint64_t)buf[5] << 8 |
-          (uint64_t)buf[6] << 16 |
-          (uint64_t)buf[7] << 24 |
-          (uint64_t)buf[8] << 32 |
-          (uint64_t)buf[9] << 40 |
-          (uint64_t)buf[10] << 48 |
-          (uint64_t)buf[11] << 56;
-  uint64_t computed_checksum = 0;
+  const size_t start = dataFile.position();
+  if (dataFile.available() < int(expected_record_count * RECORD_SIZE)) return -1;
 
-  size_t pos = 0;
-  while (dataFile.available()) {
-    uint8_t n = dataFile.read();
-    buf[pos++] = n;
-
-    static_assert(sizeof(KEY) + sizeof(VALUE) == 10, "config data size mismatch");
-    if (pos >= (sizeof(KEY) + sizeof(VALUE))) {
-      store.insert_or_assign(
-          (uint16_t)buf[0] |
-          (uint16_t)buf[1] << 8,
-
-          (uint64_t)buf[2] |
-          (uint64_t)buf[3] << 8 |
-          (uint64_t)buf[4] << 16 |
-          (uint64_t)buf[5] << 24 |
-          (uint64_t)buf[6] << 32 |
-          (uint64_t)buf[7] << 40 |
-          (uint64_t)buf[8] << 48 |
-          (uint64_t)buf[9] << 56
-          );
-
-      computed_checksum ^=
-          (uint64_t)buf[2] |
-          (uint64_t)buf[3] << 8 |
-          (uint64_t)buf[4] << 16 |
-          (uint64_t)buf[5] << 24 |
-          (uint64_t)buf[6] << 32 |
-          (uint64_t)buf[7] << 40 |
-          (uint64_t)buf[8] << 48 |
-          (uint64_t)buf[9] << 56;
-
-      ++record_count;
-      pos = 0;
-
-      // Multiple chunks can be packed in series in one file
-      if (record_count == expected_record_count) break;
-    }
+  uint8_t buf[RECORD_SIZE];
+  uint64_t computed_checksum = 0;
+  for (size_t r = 0; r < expected_record_count; ++r) {
+    dataFile.read(buf, RECORD_SIZE);
+    for (int i = 0; i < 8; ++i) computed_checksum ^= (uint64_t)buf[2 + i] << (i * 8);
   }
-  SERIAL_PRINTLN("Loaded %u Records. (expected %u)\n", record_count, expected_record_count);
+
+  SERIAL_PRINTLN("%c%c: Loaded %u Records.\n", header[0], header[1], expected_record_count);
   SERIAL_PRINTLN("Checksum: %s (actual: %lx%lx)\n",
       (computed_checksum == expected_checksum)? "OK" : "ERROR",
       (uint32_t)computed_checksum, (uint32_t)(computed_checksum >> 32));
-  SERIAL_PRINTLN("(File header checksum: %lx%lx)\n",
-      (uint32_t)expected_checksum, (uint32_t)(expected_checksum >> 32));
-
-  if (computed_checksum != expected_checksum)
-    HS::PokePopup(HS::MESSAGE_POPUP, "Corrupt File!!");
+  if (computed_checksum != expected_checksum) return -1;
+
+  dataFile.seek(start);
+  for (size_t r = 0; r < expected_record_count; ++r) {
+    dataFile.read(buf, RECORD_SIZE);
+    const KEY key = (uint16_t)buf[0] | (uint16_t)buf[1] << 8;
+    VALUE value = 0;
+    for (int i = 0; i < 8; ++i) value |= (uint64_t)buf[2 + i] << (i * 8);
+
+    if (header[0] != 'P') continue;
+    switch (header[1]) {
+      case 'Z': if (!cfg_store.insert_or_assign(key, value, false)) store_full(); break;
+      case 'X': if (!data_store.insert_or_assign(key, value, false)) store_full(); break;
+      case 'z': cfg_store.erase(key, false); break;
+      case 'x': data_store.erase(key, false); break;
+    }
+  }
+  return expected_record_count;
+}
 
-  return (computed_checksum == expected_checksum);
+static bool known_signature(const uint8_t *header) {
+  for (const char *sig : { SIG_CONFIG, SIG_DATA, SIG_CONFIG_DEL, SIG_DATA_DEL }) {
+    if (header[0] == sig[0] && header[1] == sig[1]) return true;
+  }
+  return false;
 }
 
 bool load_config(const char* filename, FS &fs)
 {
+  flush_save();
   cfg_store.clear();
   data_store.clear();
+  journal.fs = nullptr;
 
   SERIAL_PRINTLN("\nLoading Config: %s\n", filename);
   dataFile = fs.open(filename);
@@ -258,30 +388,37 @@ bool load_config(const char* filename, FS &fs)
     return false;
   }
 
-  uint8_t buf[12];
-  size_t pos = 0;
+  uint8_t header[HEADER_SIZE];
+  size_t chunks = 0;
+  size_t file_records = 0;
+  bool torn = false;
 
-  do {
+  while (dataFile.available()) {
     // read in header
-    pos = 0;
-    while (dataFile.available() && pos < HEADER_SIZE) {
-      uint8_t n = dataFile.read();
-      buf[pos++] = n;
+    if (dataFile.read(header, HEADER_SIZE) != HEADER_SIZE || !known_signature(header)) {
+      SERIAL_PRINTLN("PhzConfig: Bad signature... %x %x", header[0], header[1]);
+      torn = true;
+      break;
     }
-
-    // check for every chunk signature
-    const bool has_config = load_chunk(buf, "PZ", cfg_store);
-    const bool has_data = load_chunk(buf, "PX", data_store);
-
-    if (!has_config && !has_data) {
-      SERIAL_PRINTLN("PhzConfig: Bad signature... %x %x", buf[0], buf[1]);
-      dataFile.close();
-      return false; // no bueno
+    const int n = load_chunk(header);
+    if (n < 0) {
+      torn = true;
+      break;
     }
+    file_records += n;
+    ++chunks;
+  }
+  dataFile.close();
 
-  } while (dataFile.available());
+  if (torn) {
+    if (!chunks) return false; // no bueno
+    // Earlier chunks are intact; the tail was likely an interrupted append.
+    // Keep what we have and rewrite the file on the next save.
+    HS::PokePopup(HS::MESSAGE_POPUP, "Corrupt File!!");
+  }
 
-  dataFile.close();
+  journal_reset(filename, fs, file_records);
+  journal.full_write = torn;
   return true; // everything was fine!
 }
 
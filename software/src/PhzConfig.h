@@ -3,14 +3,132 @@
 #ifdef __IMXRT1062__
 #include <LittleFS.h>
 #include <SD.h>
-#include <unordered_map>
 
 extern bool SDcard_Ready;
 
 namespace PhzConfig {
   using KEY = uint16_t;
   using VALUE = uint64_t;
-  using ConfigMap = std::unordered_map<KEY, VALUE>;
+
+  // Sorted flat arrays with binary search lookups, in a fixed arena.
+  // Keys changed or deleted since the last save are tracked, so a save can
+  // append just those to the file instead of rewriting it.
+  template <size_t Capacity, size_t MaxDeleted = 64>
+  class ConfigStore {
+  public:
+    ConfigStore() { clear(); }
+
+    void clear() {
+      count_ = 0;
+      deleted_count_ = 0;
+      deletes_overflowed_ = false;
+    }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    static constexpr size_t capacity() { return Capacity; }
+
+    bool find(KEY key, VALUE &value) const {
+      const size_t i = lower_bound(key);
+      if (i < count_ && keys_[i] == key) {
+        value = values_[i];
+        return true;
+      }
+      return false;
+    }
+
+    // @return false if the store is full; dirty = false when loading from file
+    bool insert_or_assign(KEY key, VALUE value, bool dirty = true) {
+      const size_t i = lower_bound(key);
+      if (i < count_ && keys_[i] == key) {
+        if (values_[i] != value) {
+          values_[i] = value;
+          dirty_[i] |= dirty;
+        }
+        return true;
+      }
+      if (count_ >= Capacity) return false;
+
+      const size_t tail = count_ - i;
+      memmove(&keys_[i + 1], &keys_[i], tail * sizeof(KEY));
+      memmove(&values_[i + 1], &values_[i], tail * sizeof(VALUE));
+      memmove(&dirty_[i + 1], &dirty_[i], tail * sizeof(dirty_[0]));
+      keys_[i] = key;
+      values_[i] = value;
+      dirty_[i] = dirty;
+      ++count_;
+      if (dirty) unmark_deleted(key);
+      return true;
+    }
+
+    void erase(KEY key, bool dirty = true) {
+      const size_t i = lower_bound(key);
+      if (i >= count_ || keys_[i] != key) return;
+
+      const size_t tail = count_ - i - 1;
+      memmove(&keys_[i], &keys_[i + 1], tail * sizeof(KEY));
+      memmove(&values_[i], &values_[i + 1], tail * sizeof(VALUE));
+      memmove(&dirty_[i], &dirty_[i + 1], tail * sizeof(dirty_[0]));
+      --count_;
+
+      if (!dirty) return;
+      if (deleted_count_ < MaxDeleted)
+        deleted_[deleted_count_++] = key;
+      else
+        deletes_overflowed_ = true; // only a full rewrite can drop it now
+    }
+
+    KEY key_at(size_t i) const { return keys_[i]; }
+    VALUE value_at(size_t i) const { return values_[i]; }
+    bool dirty_at(size_t i) const { return dirty_[i]; }
+
+    size_t dirty_count() const {
+      size_t n = 0;
+      for (size_t i = 0; i < count_; ++i) n += dirty_[i];
+      return n;
+    }
+    size_t deleted_count() const { return deleted_count_; }
+    KEY deleted_at(size_t i) const { return deleted_[i]; }
+    bool deletes_overflowed() const { return deletes_overflowed_; }
+
+    void mark_clean() {
+      memset(dirty_, 0, count_ * sizeof(dirty_[0]));
+      deleted_count_ = 0;
+      deletes_overflowed_ = false;
+    }
+
+  private:
+    size_t lower_bound(KEY key) const {
+      size_t lo = 0, hi = count_;
+      while (lo < hi) {
+        const size_t mid = (lo + hi) >> 1;
+        if (keys_[mid] < key) lo = mid + 1;
+        else hi = mid;
+      }
+      return lo;
+    }
+
+    void unmark_deleted(KEY key) {
+      for (size_t i = 0; i < deleted_count_; ++i) {
+        if (deleted_[i] == key) {
+          deleted_[i] = deleted_[--deleted_count_];
+          return;
+        }
+      }
+    }
+
+    KEY keys_[Capacity];
+    VALUE values_[Capacity];
+    uint8_t dirty_[Capacity];
+    KEY deleted_[MaxDeleted];
+    size_t count_;
+    size_t deleted_count_;
+    bool deletes_overflowed_;
+  };
+
+  // Quadrants banks use ~1500 keys; applet data is per-slot
+  using ConfigMap = ConfigStore<4096>;
+  using DataMap = ConfigStore<512>;
 
   const char * const CONFIG_FILENAME = "GLOBALS.CFG";
 
@@ -23,6 +141,19 @@ namespace PhzConfig {
   bool save_config(const char* filename = CONFIG_FILENAME, FS &fs = myfs);
   void clear_config();
 
+  // Queues save_config() as a TASK_STORAGE task, so a flash write doesn't
+  // stall the UI. Repeated saves of one file coalesce, and a pending save is
+  // written before the store is loaded, cleared or saved elsewhere, so it
+  // always writes what the caller had set up.
+  // @return false if it had to save right away and that failed
+  bool defer_save(const char* filename = CONFIG_FILENAME, FS &fs = myfs);
+  // Writes a pending defer_save() now
+  bool flush_save();
+
+  // Saves append changed keys to the file loaded/saved last, until the
+  // journal grows past this many stale records and the file is rewritten
+  static constexpr size_t JOURNAL_SLACK = 256;
+
   void setValue(KEY key, VALUE value);
   bool getValue(KEY key, VALUE &value);
   void deleteKey(KEY key);
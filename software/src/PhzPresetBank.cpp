@@ -0,0 +1,230 @@
+/* Phazerville Preset Bank
+ *
+ * Indexed, fixed-slot preset file. See PhzPresetBank.h
+ */
+#ifdef __IMXRT1062__
+#include "PhzPresetBank.h"
+#include "HSUtils.h"
+#include "OC_core.h"
+
+namespace PhzConfig {
+
+// File format, little-endian:
+//   "PZIX", 16-bit version, 16-bit slot count, 16-bit slot size, 16-bit reserved
+//   32-bit file offset of each slot
+//   slots, each a PresetBlob as laid out in RAM
+// Offsets are fixed when the file is written whole; Save() only seeks to one.
+static const char MAGIC[] = "PZIX";
+
+static void put_u16(uint8_t *buf, uint16_t value) {
+  buf[0] = value & 0xff;
+  buf[1] = value >> 8;
+}
+static uint16_t get_u16(const uint8_t *buf) {
+  return uint16_t(buf[0]) | uint16_t(buf[1]) << 8;
+}
+static uint32_t get_u32(const uint8_t *buf) {
+  return uint32_t(get_u16(buf)) | uint32_t(get_u16(buf + 2)) << 16;
+}
+
+// Rotate-XOR over the 32-bit words, so zero-filled or shifted data from an
+// interrupted write doesn't pass
+uint32_t PresetBlob::compute_checksum() const {
+  uint32_t sum = present ^ 0x505a4958;
+  const uint32_t *words = reinterpret_cast<const uint32_t *>(values);
+  for (size_t i = 0; i < sizeof(values) / sizeof(uint32_t); ++i)
+    sum = ((sum << 5) | (sum >> 27)) ^ words[i];
+  return sum;
+}
+
+bool PresetBank::Load(FS &fs) {
+  FlushSaves();
+  for (size_t i = 0; i < count_; ++i) slots_[i].clear();
+  loaded_ = true;
+  rewrite_ = true;
+
+  File file = fs.open(filename_);
+  if (!file) {
+    SERIAL_PRINTLN("PresetBank: no %s\n", filename_);
+    return false;
+  }
+
+  uint8_t header[HEADER_SIZE];
+  if (file.read(header, HEADER_SIZE) != HEADER_SIZE || memcmp(header, MAGIC, 4)
+      || get_u16(header + 4) != VERSION || get_u16(header + 8) != sizeof(PresetBlob)) {
+    SERIAL_PRINTLN("PresetBank: bad header in %s\n", filename_);
+    file.close();
+    KeepUnreadable(fs);
+    return false;
+  }
+
+  const size_t file_count = get_u16(header + 6);
+  const size_t n = file_count < count_ ? file_count : count_;
+  size_t corrupt = 0;
+
+  for (size_t i = 0; i < n; ++i) {
+    uint8_t entry[sizeof(uint32_t)];
+    file.seek(HEADER_SIZE + i * sizeof(entry));
+    if (file.read(entry, sizeof(entry)) != sizeof(entry)) break;
+
+    PresetBlob &slot = slots_[i];
+    if (!file.seek(get_u32(entry))
+        || file.read(&slot, sizeof(slot)) != sizeof(slot)
+        || !slot.intact()) {
+      slot.clear();
+      ++corrupt;
+    }
+  }
+  file.close();
+
+  SERIAL_PRINTLN("PresetBank: loaded %u presets from %s\n", n, filename_);
+  if (corrupt) {
+    // the damaged slots are empty now; they're rewritten when next saved
+    SERIAL_PRINTLN("PresetBank: %u corrupt presets\n", corrupt);
+    HS::PokePopup(HS::MESSAGE_POPUP, "Corrupt File!!");
+  }
+
+  rewrite_ = (file_count != count_);
+  return true;
+}
+
+// Written by another firmware version, or damaged: move it aside rather than
+// let the next save replace it
+void PresetBank::KeepUnreadable(FS &fs) {
+  char backup[32];
+  strncpy(backup, filename_, sizeof(backup) - 5);
+  backup[sizeof(backup) - 5] = '\0';
+  char *ext = strrchr(backup, '.');
+  strcpy(ext ? ext : backup + strlen(backup), ".OLD");
+
+  fs.remove(backup);
+  if (fs.rename(filename_, backup))
+    SERIAL_PRINTLN("PresetBank: kept %s as %s\n", filename_, backup);
+}
+
+bool PresetBank::Save(size_t index, FS &fs) {
+  if (index >= count_) return false;
+  if (rewrite_ || !fs.exists(filename_)) return SaveAll(fs);
+
+  slots_[index].seal();
+
+  File file = fs.open(filename_, FILE_WRITE);
+  if (!file) {
+    SERIAL_PRINTLN("PresetBank: Error opening %s\n", filename_);
+    HS::PokePopup(HS::MESSAGE_POPUP, "File ERROR !!");
+    return false;
+  }
+
+  uint8_t entry[sizeof(uint32_t)];
+  bool success = file.seek(HEADER_SIZE + index * sizeof(entry))
+    && file.read(entry, sizeof(entry)) == sizeof(entry)
+    && file.seek(get_u32(entry))
+    && file.write(&slots_[index], sizeof(PresetBlob)) == sizeof(PresetBlob);
+  file.close();
+
+  if (!success) {
+    HS::PokePopup(HS::MESSAGE_POPUP, "Write ERROR !!");
+    return false;
+  }
+  SERIAL_PRINTLN("PresetBank: saved preset %u to %s\n", index, filename_);
+  return true;
+}
+
+bool PresetBank::Assign(size_t index, const PresetBlob &preset) {
+  PresetBlob &slot = slots_[index];
+  if (!rewrite_ && slot.present == preset.present
+      && !memcmp(slot.values, preset.values, sizeof(slot.values))) {
+    SERIAL_PRINTLN("PresetBank: preset %u unchanged\n", index);
+    return false;
+  }
+  memcpy(&slot, &preset, sizeof(slot));
+  return true;
+}
+
+bool PresetBank::Store(size_t index, const PresetBlob &preset, FS &fs) {
+  if (index >= count_) return false;
+  return !Assign(index, preset) || Save(index, fs);
+}
+
+bool PresetBank::DeferSave(size_t index, FS &fs) {
+  if (index >= count_) return false;
+  if (index >= 64) return Save(index, fs); // beyond the pending mask
+  if (pending_ && pending_fs_ != &fs) FlushSaves();
+
+  const bool queued = pending_ != 0;
+  pending_ |= uint64_t(1) << index;
+  pending_fs_ = &fs;
+  if (queued || OC::CORE::DeferTask([this]() { FlushSaves(); }, OC::CORE::TASK_STORAGE))
+    return true;
+  return FlushSaves(); // queue full, save it now
+}
+
+bool PresetBank::DeferStore(size_t index, const PresetBlob &preset, FS &fs) {
+  if (index >= count_) return false;
+  return !Assign(index, preset) || DeferSave(index, fs);
+}
+
+bool PresetBank::FlushSaves() {
+  if (!pending_) return true;
+  FS &fs = *pending_fs_;
+  if (rewrite_ || !fs.exists(filename_)) {
+    pending_ = 0;
+    return SaveAll(fs);
+  }
+
+  bool success = true;
+  while (pending_) {
+    const size_t index = __builtin_ctzll(pending_);
+    pending_ &= pending_ - 1;
+    success &= Save(index, fs);
+  }
+  return success;
+}
+
+bool PresetBank::SaveAll(FS &fs) {
+  SERIAL_PRINTLN("\nPresetBank: writing %s\n", filename_);
+
+  const char* const TEMPFILE = "PEWPEW.TMP";
+  fs.remove(TEMPFILE);
+  File file = fs.open(TEMPFILE, FILE_WRITE_BEGIN);
+  if (!file) {
+    HS::PokePopup(HS::MESSAGE_POPUP, "File ERROR !!");
+    return false;
+  }
+
+  uint8_t buf[HEADER_SIZE];
+  memcpy(buf, MAGIC, 4);
+  put_u16(buf + 4, VERSION);
+  put_u16(buf + 6, count_);
+  put_u16(buf + 8, sizeof(PresetBlob));
+  put_u16(buf + 10, 0);
+  bool success = file.write(buf, HEADER_SIZE) == HEADER_SIZE;
+
+  for (size_t i = 0; success && i < count_; ++i) {
+    const uint32_t offset = slot_offset(count_, i);
+    put_u16(buf, offset & 0xffff);
+    put_u16(buf + 2, offset >> 16);
+    success = file.write(buf, sizeof(uint32_t)) == sizeof(uint32_t);
+  }
+  for (size_t i = 0; success && i < count_; ++i) {
+    slots_[i].seal();
+    success = file.write(&slots_[i], sizeof(PresetBlob)) == sizeof(PresetBlob);
+  }
+  file.close();
+
+  if (success) {
+    fs.remove(filename_);
+    success = fs.rename(TEMPFILE, filename_);
+  }
+  if (!success) {
+    HS::PokePopup(HS::MESSAGE_POPUP, "Write ERROR !!");
+    return false;
+  }
+
+  loaded_ = true;
+  rewrite_ = false;
+  return true;
+}
+
+} // namespace PhzConfig
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+#ifdef __IMXRT1062__
+#include "PhzConfig.h"
+
+namespace PhzConfig {
+
+  // One preset's values, addressed by the lower bits of their keys
+  struct PresetBlob {
+    static constexpr size_t KEYS = 32;
+
+    uint32_t present;  // bitmask of keys that are set; 0 = empty preset
+    uint32_t checksum; // see seal()
+    VALUE values[KEYS];
+
+    void clear() { memset(this, 0, sizeof(*this)); }
+    bool empty() const { return !present; }
+
+    bool get(size_t key, VALUE &value) const {
+      if (key >= KEYS || !(present & (1u << key))) return false;
+      value = values[key];
+      return true;
+    }
+    void set(size_t key, VALUE value) {
+      if (key >= KEYS) return;
+      present |= 1u << key;
+      values[key] = value;
+    }
+
+    uint32_t compute_checksum() const;
+    void seal() { checksum = compute_checksum(); }
+    bool intact() const { return checksum == compute_checksum(); }
+  };
+  static_assert(sizeof(PresetBlob) == 264, "preset slot size mismatch");
+
+  // Indexed preset container: a fixed header and offset table, then one
+  // fixed-size slot per preset, so a single preset is read or rewritten in
+  // place without touching the others.
+  //
+  // Load() prefetches every slot into RAM; after that, recall is just a read
+  // of the slot and only Save() goes to the file.
+  class PresetBank {
+  public:
+    PresetBank(const char *filename, PresetBlob *slots, size_t count)
+    : filename_(filename), slots_(slots), count_(count), loaded_(false), rewrite_(true),
+      pending_(0), pending_fs_(nullptr) { }
+
+    // @return false if the file is missing or unreadable; slots are then empty.
+    // An unreadable file is renamed to .OLD, so saving doesn't replace it.
+    bool Load(FS &fs = myfs);
+    // Writes one slot in place, or the whole file if it doesn't match yet
+    bool Save(size_t index, FS &fs = myfs);
+    // Copies a preset into its slot and saves it, if it changed
+    bool Store(size_t index, const PresetBlob &preset, FS &fs = myfs);
+    // Like Save() and Store(), but the write is queued as a TASK_STORAGE
+    // task; slots queued before it runs are written together
+    bool DeferSave(size_t index, FS &fs = myfs);
+    bool DeferStore(size_t index, const PresetBlob &preset, FS &fs = myfs);
+    // Writes the slots queued by DeferSave() now
+    bool FlushSaves();
+    // Rewrites the whole file from RAM
+    bool SaveAll(FS &fs = myfs);
+
+    bool loaded() const { return loaded_; }
+    size_t size() const { return count_; }
+    PresetBlob &operator[](size_t index) { return slots_[index]; }
+    const PresetBlob &operator[](size_t index) const { return slots_[index]; }
+
+    // File layout
+    static constexpr uint32_t HEADER_SIZE = 12;
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t slot_offset(size_t count, size_t index) {
+      return HEADER_SIZE + count * sizeof(uint32_t) + index * sizeof(PresetBlob);
+    }
+
+  private:
+    void KeepUnreadable(FS &fs);
+    // @return true if the preset differs from the slot, which now holds it
+    bool Assign(size_t index, const PresetBlob &preset);
+
+    const char *filename_;
+    PresetBlob *slots_;
+    size_t count_;
+    bool loaded_;
+    bool rewrite_; // file missing or laid out for a different count
+    uint64_t pending_; // slots queued by DeferSave()
+    FS *pending_fs_;
+  };
+
+}
+#endif
@@ -22,7 +22,7 @@
 #define _HEM_ADEG_H_
 
 #define HEM_ADEG_MAX_VALUE 255
-#define HEM_ADEG_MAX_TICKS 33333
+#define HEM_ADEG_MAX_TICKS OC_CORE_TICKS_MS(2000)
 
 class ADEG : public HemisphereApplet {
 public:
@@ -102,11 +102,11 @@ public:
     void OnEncoderMove(int direction) {
         if (cursor == 0) {
             attack = constrain(attack + direction, 0, HEM_ADEG_MAX_VALUE);
-            last_ms_value = Proportion(attack, HEM_ADEG_MAX_VALUE, HEM_ADEG_MAX_TICKS) / 17;
+            last_ms_value = Proportion(attack, HEM_ADEG_MAX_VALUE, HEM_ADEG_MAX_TICKS) / HEMISPHERE_CLOCK_TICKS;
         }
         else {
             decay = constrain(decay + direction, 0, HEM_ADEG_MAX_VALUE);
-            last_ms_value = Proportion(decay, HEM_ADEG_MAX_VALUE, HEM_ADEG_MAX_TICKS) / 17;
+            last_ms_value = Proportion(decay, HEM_ADEG_MAX_VALUE, HEM_ADEG_MAX_TICKS) / HEMISPHERE_CLOCK_TICKS;
         }
         last_change_ticks = OC::CORE::ticks;
     }
@@ -166,7 +166,7 @@ private:
         gfxRect(1, 15, ProportionCV(ViewOut(0), 62), 6);
 
         // Change indicator, if necessary
-        if (OC::CORE::ticks - last_change_ticks < 20000) {
+        if (OC::CORE::ticks - last_change_ticks < OC_CORE_TICKS_MS(1200)) {
             gfxPrint(15, 43, last_ms_value);
             gfxPrint("ms");
         }
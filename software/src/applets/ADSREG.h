@@ -42,10 +42,10 @@ public:
     static constexpr int DISPLAY_HEIGHT = 30;
 
     // About four seconds
-    static constexpr int MAX_TICKS_AD = 33333;
+    static constexpr int MAX_TICKS_AD = OC_CORE_TICKS_MS(2000);
 
     // About eight seconds
-    static constexpr int MAX_TICKS_R = 133333;
+    static constexpr int MAX_TICKS_R = OC_CORE_TICKS_MS(8000);
 
     static constexpr int STAGE_MAX_VALUE = 255;
     static constexpr int NUM_CHANNELS = 2;
@@ -312,7 +312,7 @@ private:
         } else {
           int ms_value = adsr.setting[stage]
                        * ((stage == RELEASE_STAGE)? MAX_TICKS_R : MAX_TICKS_AD)
-                       / STAGE_MAX_VALUE / 17;
+                       / STAGE_MAX_VALUE / HEMISPHERE_CLOCK_TICKS;
           gfxPrint(ms_value);
           gfxPrint("ms");
         }
@@ -63,7 +63,7 @@ public:
         if (Clock(0)) {
             if (clocked) {
                 // Get a tempo, if this is the second tick or later since the last clock
-                spacing = (ticks_since_clock / number) / 17;
+                spacing = (ticks_since_clock / number) / HEMISPHERE_CLOCK_TICKS;
                 ticks_since_clock = 0;
             } else clocked = 1;
 
@@ -100,7 +100,7 @@ public:
                 modded_spacing = constrain(modded_spacing, HEM_BURST_SPACING_MIN, HEM_BURST_SPACING_MAX);
                 ClockOut(0);
                 burst_count++;
-                if (--bursts_to_go > 0) burst_countdown = modded_spacing * 17; // Reset for next burst
+                if (--bursts_to_go > 0) burst_countdown = modded_spacing * HEMISPHERE_CLOCK_TICKS; // Reset for next burst
                 else GateOut(1, 0); // Turn off the gate
             }
         }
@@ -112,7 +112,7 @@ public:
         // Number is not being changed via CV, fire the set of bursts right away. This is done so that
         // the applet can adapt to contexts that involve (1) the need to accurately interpret rapidly-
         // changing CV values or (2) the need for tight timing when Number is static-ish.
-        bool number_is_changing = (OC::CORE::ticks - last_number_cv_tick < 80000);
+        bool number_is_changing = (OC::CORE::ticks - last_number_cv_tick < OC_CORE_TICKS_MS(4800));
         bool btrig = Clock(1) && (random(100) >= prob);
         if (btrig && number_is_changing) StartADCLag();
 
@@ -122,7 +122,7 @@ public:
             ClockOut(0);
             GateOut(1, 1);
             bursts_to_go = number - 1;
-            burst_countdown = effective_spacing * 17;
+            burst_countdown = effective_spacing * HEMISPHERE_CLOCK_TICKS;
             burst_count = 1;
         }
     }
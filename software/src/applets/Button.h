@@ -31,7 +31,7 @@ public:
         trigger_countdown = 0;
     }
 
-	/* Run during the interrupt service routine, 16667 times per second */
+	/* Run during the interrupt service routine, OC_CORE_ISR_FREQ times per second */
     void Controller() {
         ForEachChannel(ch) {
             // Check physical trigger input to emulate button press (ignore forwarding)
@@ -58,7 +58,7 @@ public:
 	/* Called when the encoder button for this hemisphere is pressed */
     void OnButtonPress() {
         PressButton(channel);
-        trigger_countdown = 1667; // Trigger display countdown
+        trigger_countdown = OC_CORE_TICKS_MS(100); // Trigger display countdown
     }
 
 	/* Called when the encoder for this hemisphere is rotated
@@ -104,7 +104,7 @@ public:
         if (clock_m.IsRunning() && clock_m.MIDITock()) {
           OC::CORE::DeferTask([](){
             usbMIDI.sendRealTime(usbMIDI.Clock);
-          });
+          }, OC::CORE::TASK_REALTIME);
         }
 
         // 4 internal clock flashers
@@ -143,7 +143,7 @@ public:
       }
     }
     void View() {
-      if (OC::CORE::ticks - view_tick > 1000) {
+      if (OC::CORE::ticks - view_tick > OC_CORE_TICKS_MS(60)) {
         slide_anim = SLIDEOUT_TIME;
       }
       view_tick = OC::CORE::ticks;
@@ -134,7 +134,7 @@ public:
               usbHostMIDI[1].sendRealTime(usbMIDI.Clock);
             if (~midi_clktx_disable & mMaskSerial)
               MIDI1.sendRealTime(midi::MidiType(usbMIDI.Clock));
-          });
+          }, OC::CORE::TASK_REALTIME);
         }
 
         // 8 internal clock flashers
@@ -172,7 +172,7 @@ public:
       }
     }
     void View() {
-      if (OC::CORE::ticks - view_tick > 1000) {
+      if (OC::CORE::ticks - view_tick > OC_CORE_TICKS_MS(60)) {
         slide_anim = SLIDEOUT_TIME;
       }
       view_tick = OC::CORE::ticks;
@@ -42,7 +42,7 @@ public:
                 Modulate(p_mod[ch], ch, 0, 100);
                 if (random(1, 100) <= p_mod[ch]) {
                     ClockOut(ch);
-                    trigger_countdown[ch] = 1667;
+                    trigger_countdown[ch] = OC_CORE_TICKS_MS(100);
                 }
             }
 
@@ -94,6 +94,11 @@ public:
     );
   }
 
+  uint32_t InputSources() {
+    return sources[0][0].dac_mask() | sources[0][1].dac_mask()
+      | sources[1][0].dac_mask() | sources[1][1].dac_mask();
+  }
+
 protected:
   void SetHelp() {
     //                    "-------" <-- Label size guide
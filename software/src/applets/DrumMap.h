@@ -26,9 +26,9 @@
 #include "../grids_resources.h"
 #endif
 
-#define HEM_DRUMMAP_PULSE_ANIMATION_TICKS 1000
-#define HEM_DRUMMAP_VALUE_ANIMATION_TICKS 16000
-#define HEM_DRUMMAP_AUTO_RESET_TICKS 30000
+#define HEM_DRUMMAP_PULSE_ANIMATION_TICKS OC_CORE_TICKS_MS(60)
+#define HEM_DRUMMAP_VALUE_ANIMATION_TICKS OC_CORE_TICKS_MS(960)
+#define HEM_DRUMMAP_AUTO_RESET_TICKS OC_CORE_TICKS_MS(1800)
 
 class DrumMap : public HemisphereApplet {
 public:
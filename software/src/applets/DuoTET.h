@@ -275,6 +275,12 @@ class DuoTET : public HemisphereApplet {
         genScale();
     }
 
+    uint32_t InputSources() {
+        uint32_t mask = 0;
+        for (int i = 0; i < DUOTET_PARAM_LAST; ++i) mask |= cv_inputs[i].dac_mask();
+        return mask;
+    }
+
 protected:
 
   void SetHelp() {
@@ -1,4 +1,4 @@
-#define GOL_ABS(X) (X < 0 ? -X : X)
+#include "../util/util_life.h"
 
 class GameOfLife : public HemisphereApplet {
 public:
@@ -9,7 +9,7 @@ public:
     const uint8_t* applet_icon() { return PhzIcons::gameOfLife; }
 
     void Start() {
-        for (int i = 0; i < 80; i++) board[i] = 0;
+        board.Clear();
         weight = 30;
         tx = 0;
         ty = 0;
@@ -50,7 +50,7 @@ public:
     }
 
     void OnButtonPress() {
-        for (int i = 0; i < 80; i++) board[i] = 0;
+        board.Clear();
     }
 
     void OnEncoderMove(int direction) {
@@ -82,7 +82,7 @@ protected:
   }
 
 private:
-    uint64_t board[80]; // 64x40 board
+    util::LifeBoard<40> board; // 64x40 board
     int weight; // Weight of each cell
     int global_density; // Count of all live cells
     int local_density; // Count of cells in the vicinity of the Traveler
@@ -92,12 +92,10 @@ private:
     void DrawBoard() {
         for (int y = 0; y < 40; y++)
         {
-            for (int b = 0; b < 2; b++)
-            {
-                for (int c = 0; c < 32; c++)
-                {
-                    if ((board[(y * 2) + b] >> c) & 0x01) gfxPixel(c + (32 * b), y + 22);
-                }
+            uint64_t row = board.row(y);
+            while (row) {
+                gfxPixel(__builtin_ctzll(row), y + 22);
+                row &= row - 1;
             }
         }
     }
@@ -116,76 +114,12 @@ private:
     }
 
     void ProcessGameBoard(int tx, int ty) {
-        uint64_t next_gen[80];
-        global_density = 0;
-        local_density = 0;
-        for (int y = 0; y < 40; y++)
-        {
-            next_gen[y * 2] = 0; // Clear next generation board
-            next_gen[y * 2 + 1] = 0;
-            for (int x = 0; x < 64; x++)
-            {
-                bool live = ValueAtCell(x, y);
-                int ln = CountLiveNeighborsAt(x, y);
-
-                // 1: Any live cell with fewer than two live neighbours dies (referred to as underpopulation or exposure).
-                // 2: Any live cell with more than three live neighbours dies (referred to as overpopulation or overcrowding).
-                // Nothing to do to observe these rules, since we start with an empty board
-
-                // 3: Any live cell with two or three live neighbours lives, unchanged, to the next generation.
-                // 4: Any dead cell with exactly three live neighbours will come to life.
-                if (((ln == 2 || ln == 3) && live) || (ln == 3 && !live)) {
-                    int i = y * 2;
-                    int xb = x;
-                    if (x > 31) {
-                        i += 1;
-                        xb -= 32;
-                    }
-                    next_gen[i] = next_gen[i] | (0x01 << xb);
-                    global_density++;
-
-                    if (GOL_ABS(tx - x) < 8 && GOL_ABS(ty - y) < 8) local_density++;
-                }
-            }
-        }
-
-        memcpy(&board, &next_gen, sizeof(next_gen));
-    }
-
-    int CountLiveNeighborsAt(int x, int y) {
-        int count = 0;
-        for (int nx = -1; nx < 2; nx++)
-        {
-            for (int ny = -1; ny < 2; ny++)
-            {
-                if (!(nx == 0 && ny == 0)) count += ValueAtCell(x + nx, y + ny);
-            }
-         }
-        return count;
-    }
-
-    bool ValueAtCell(int x, int y) {
-        // Toroid operation
-        if (x > 63) x -= 64;
-        if (x < 0) x += 64;
-        if (y > 39) y -= 40;
-        if (y < 0) y += 40;
-
-        int i = y * 2;
-        if (x > 31) {
-            i += 1;
-            x -= 32;
-        }
-        return ((board[i] >> x) & 0x01);
+        // Conway's rules, on a board that wraps at the edges
+        global_density = board.Step();
+        local_density = board.PopulationIn(tx - 7, ty - 7, tx + 7, ty + 7);
     }
 
     void AddToBoard(int x, int y) {
-        int i = y * 2;
-        int xb = x;
-        if (x > 31) {
-            i += 1;
-            xb -= 32;
-        }
-        board[i] = board[i] | (0x01 << xb);
+        board.Set(x, y);
     }
 };
@@ -116,7 +116,7 @@ private:
             gfxPrint(1, y, time[ch]);
             gfxPrint("ms");
 
-            if (OC::CORE::ticks - last_gate[ch] < 1667) gfxBitmap(54, y, 8, CLOCK_ICON);
+            if (OC::CORE::ticks - last_gate[ch] < OC_CORE_TICKS_MS(100)) gfxBitmap(54, y, 8, CLOCK_ICON);
         }
         gfxCursor(0, 23 + (cursor * 25), 63);
     }
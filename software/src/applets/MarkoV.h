@@ -126,7 +126,7 @@ public:
     static constexpr int      NUM_STATES       = 10;
     static constexpr int      NUM_PROFILES     = 5;
     static constexpr int      HISTORY_SIZE     = 8;
-    static constexpr uint32_t LONG_PRESS_TICKS = 5000;
+    static constexpr uint32_t LONG_PRESS_TICKS = OC_CORE_TICKS_MS(300);
     // CV units per state step: spans root(0) to octave(9) across 10 states
     static constexpr int      STATE_CV_STEP    = ONE_OCTAVE / 7;
 
@@ -130,7 +130,7 @@ public:
     static constexpr int      NUM_STATES       = 8;
     static constexpr int      NUM_PROFILES     = 4;
     static constexpr int      HISTORY_SIZE     = 8;
-    static constexpr uint32_t LONG_PRESS_TICKS = 5000;
+    static constexpr uint32_t LONG_PRESS_TICKS = OC_CORE_TICKS_MS(300);
     static constexpr int      MAX_SCHED        = 4; // max sub-triggers per beat
 
     // Cursor positions
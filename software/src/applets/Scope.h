@@ -18,7 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#define SCOPE_CURRENT_SETTING_TIMEOUT 50001
+#define SCOPE_CURRENT_SETTING_TIMEOUT OC_CORE_TICKS_MS(3000)
 const uint8_t HEM_PPQN_VALUES[] = {1, 2, 4, 8, 16, 24};
 
 class Scope : public HemisphereApplet {
@@ -52,7 +52,7 @@ public:
             int this_tick = OC::CORE::ticks;
             int time = this_tick - last_bpm_tick;
             last_bpm_tick = this_tick;
-            bpm = 1000000 / time;
+            bpm = OC_CORE_TICKS_PER_MINUTE / time;
             if (bpm > 9999) bpm = 9999;
         }
 
@@ -180,7 +180,7 @@ private:
         gfxPrint(bpm / 4);
         gfxLine(0, 24, 63, 24);
 
-        if (OC::CORE::ticks - last_bpm_tick < 1666) gfxBitmap(1, 15, 8, CLOCK_ICON);
+        if (OC::CORE::ticks - last_bpm_tick < OC_CORE_TICKS_MS(100)) gfxBitmap(1, 15, 8, CLOCK_ICON);
     }
 
     void DrawCurrentSetting() {
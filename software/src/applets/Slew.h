@@ -19,7 +19,7 @@
 // SOFTWARE.
 
 #define HEM_SLEW_MAX_VALUE 200
-#define HEM_SLEW_MAX_TICKS 64000
+#define HEM_SLEW_MAX_TICKS OC_CORE_TICKS_MS(3840)
 
 class Slew : public HemisphereApplet {
 public:
@@ -76,11 +76,11 @@ public:
     void OnEncoderMove(int direction) {
         if (cursor == 0) {
             rise = constrain(rise + direction, 0, HEM_SLEW_MAX_VALUE);
-            last_ms_value = Proportion(rise, HEM_SLEW_MAX_VALUE, HEM_SLEW_MAX_TICKS) / 17;
+            last_ms_value = Proportion(rise, HEM_SLEW_MAX_VALUE, HEM_SLEW_MAX_TICKS) / HEMISPHERE_CLOCK_TICKS;
         }
         else {
             fall = constrain(fall + direction, 0, HEM_SLEW_MAX_VALUE);
-            last_ms_value = Proportion(fall, HEM_SLEW_MAX_VALUE, HEM_SLEW_MAX_TICKS) / 17;
+            last_ms_value = Proportion(fall, HEM_SLEW_MAX_VALUE, HEM_SLEW_MAX_TICKS) / HEMISPHERE_CLOCK_TICKS;
         }
         last_change_ticks = OC::CORE::ticks;
     }
@@ -139,7 +139,7 @@ private:
         }
 
         // Change indicator, if necessary
-        if (OC::CORE::ticks - last_change_ticks < 20000) {
+        if (OC::CORE::ticks - last_change_ticks < OC_CORE_TICKS_MS(1200)) {
             gfxPrint(15, 43, last_ms_value);
             gfxPrint("ms");
         }
@@ -77,9 +77,9 @@ public:
       Out(0, pitch);
       ClockOut(1);
 
-      last_note_dur = 17 * spacing;
+      last_note_dur = HEMISPHERE_CLOCK_TICKS * spacing;
       if (!qmod)
-        Modulate(last_note_dur, 1, 17 * HEM_BURST_SPACING_MIN, 17 * HEM_BURST_SPACING_MAX);
+        Modulate(last_note_dur, 1, HEMISPHERE_CLOCK_TICKS * HEM_BURST_SPACING_MIN, HEMISPHERE_CLOCK_TICKS * HEM_BURST_SPACING_MAX);
 
       countdown += last_note_dur;
       index += inc;
@@ -19,7 +19,7 @@
 // SOFTWARE.
 
 // How fast the axon pulses when active
-#define HEM_TLN_ACTIVE_TICKS 1500
+#define HEM_TLN_ACTIVE_TICKS OC_CORE_TICKS_MS(90)
 
 class TLNeuron : public HemisphereApplet {
 public:
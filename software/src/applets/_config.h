@@ -140,7 +140,17 @@ using namespace HS;
 
 #include "AppletRegistry.h"
 
-constexpr Registry reg = Registry<HemisphereApplet, HS::APPLET_SLOTS
+// Applets live in fixed per-slot buffers on T4.x; define APPLET_HEAP to
+// allocate them with new instead
+#if defined(__IMXRT1062__) && !defined(APPLET_HEAP)
+template <class T, size_t Slots, typename... Declarations>
+using AppletRegistry = ArenaRegistry<T, Slots, Declarations...>;
+#else
+template <class T, size_t Slots, typename... Declarations>
+using AppletRegistry = Registry<T, Slots, Declarations...>;
+#endif
+
+constexpr AppletRegistry<HemisphereApplet, HS::APPLET_SLOTS
     , DeclareApplet<ADSREG, 8, CAT_MODULATOR>
     , DeclareApplet<ADEG, 34, CAT_MODULATOR>
     , DeclareApplet<MiniASR, 47, CAT_MODULATOR | CAT_QUANTIZER>
@@ -262,7 +272,7 @@ constexpr Registry reg = Registry<HemisphereApplet, HS::APPLET_SLOTS
     , DeclareApplet<WTVCO, 67, CAT_OTHER>
 #endif
     , DeclareApplet<Xfader, 33, CAT_UTILITY>
->{};
+> reg{};
 
 
 namespace HS {
@@ -224,7 +224,7 @@ private:
     int last_icon_ticks[2];
 
     void DrawMonitor() {
-        if ((OC::CORE::ticks - frame.MIDIState.last_msg_tick) < 100) {
+        if ((OC::CORE::ticks - frame.MIDIState.last_msg_tick) < OC_CORE_TICKS_MS(6)) {
             // reset icon display timers
             if (frame.MIDIState.mapping[map_index[0]].get_channel() == frame.MIDIState.last_midi_channel)
                 last_icon_ticks[0] = OC::CORE::ticks;
@@ -232,7 +232,7 @@ private:
                 last_icon_ticks[1] = OC::CORE::ticks;
         }
 
-        if (OC::CORE::ticks - last_icon_ticks[io_page] < 4000) // Ch midi activity
+        if (OC::CORE::ticks - last_icon_ticks[io_page] < OC_CORE_TICKS_MS(240)) // Ch midi activity
             gfxIcon(54, 13, MIDI_ICON);
     }
 
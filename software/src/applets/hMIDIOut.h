@@ -341,7 +341,7 @@ private:
     }
 
     void DrawMonitor() {
-        if (OC::CORE::ticks - last_tick < 4000) {
+        if (OC::CORE::ticks - last_tick < OC_CORE_TICKS_MS(240)) {
             if (hemisphere & 1)
                 gfxIcon( 9, 1, MIDI_ICON);
             else
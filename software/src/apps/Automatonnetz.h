@@ -84,7 +84,7 @@ const char *clock_fraction_names[] = {
 
 static constexpr uint32_t TRIGGER_MASK_GRID = OC::DIGITAL_INPUT_1_MASK;
 static constexpr uint32_t TRIGGER_MASK_ARP = OC::DIGITAL_INPUT_2_MASK;
-static constexpr uint32_t kTriggerOutTicks = 1000U / OC_CORE_TIMER_RATE;
+static constexpr uint32_t kTriggerOutTicks = OC_CORE_TICKS_MS(1);
 
 enum CellSettings {
   CELL_SETTING_TRANSFORM,
@@ -216,7 +216,7 @@ public:
     void StoreData() {
         PhzConfig::setValue(SETUP_KEY, active_setup);
         StoreSetup();
-        PhzConfig::save_config("CAPTAIN.DAT");
+        PhzConfig::defer_save("CAPTAIN.DAT");
     }
     void Resume() {
         PhzConfig::load_config("CAPTAIN.DAT");
@@ -405,17 +405,14 @@ public:
         }
 
         // Pack the data and send it out
-        UnpackedData unpacked;
-        unpacked.set_data(40, V);
-        PackedData packed = unpacked.pack();
-        SendSysEx(packed, 'M');
+        SendSysEx(V, MIDI_PARAMETER_COUNT, 'M');
     }
 
     void OnReceiveSysEx() {
         // Since only one Setup is coming, use the currently-selected setup to determine
         // where to stash it.
         uint8_t V[MIDI_PARAMETER_COUNT];
-        if (ExtractSysExData(V, 'M')) {
+        if (ExtractSysExData(V, 'M', sizeof(V))) {
             for (int i = 0; i < MIDI_PARAMETER_COUNT; i++)
             {
                 int p = (int)V[i];
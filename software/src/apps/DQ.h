@@ -166,7 +166,7 @@ class DQ_QuantizerChannel
 public:
 
   static constexpr uint8_t PULSEW_MAX = 255;
-  static constexpr uint32_t TICKS_TO_MS = 43691;
+  static constexpr uint32_t TICKS_PER_MS = (uint64_t(1000000) << 16) / OC_CORE_ISR_PERIOD_NS; // 16.16 fixed point
 
   // ScaleEditorEventHandler
   int get_scale(int slot_index) const final {
@@ -784,9 +784,7 @@ public:
           // recalculate (in ticks), if new pulsewidth setting:
           if (prev_pulsewidth_ != _pulsewidth || ! ticks_) {
             if (!_gates) {
-              int32_t _fraction = signed_multiply_32x16b(TICKS_TO_MS, static_cast<int32_t>(_pulsewidth)); // = * 0.6667f
-              _fraction = signed_saturate_rshift(_fraction, 16, 0);
-              pulse_width_in_ticks_  = (_pulsewidth << 4) + _fraction;
+              pulse_width_in_ticks_ = (uint64_t(TICKS_PER_MS) * _pulsewidth) >> 16;
             } else {
               // put out gates/half duty cycle:
               pulse_width_in_ticks_ = channel_frequency_in_ticks_ >> 1;
@@ -142,16 +142,23 @@ public:
 
     void OnSendSysEx() {
         SendTuringMachineLibrary();
-        SendOutputAssignments();
-        SendSong();
+        SendSong(true);
     }
 
     void OnReceiveSysEx() {
+        // settings_ stands in for the whole song, and a message may carry only part of it
+        SaveToEEPROMStage();
+        if (ExtractSysExSettings(settings_, 'S')) {
+            LoadFromEEPROMStage(true);
+            return;
+        }
+
         uint8_t V[48];
         if (ExtractSysExData(V, 'T')) {
             char type = V[0]; // Type of Enigma data:r=Register, s=Song step, c=Song Config, 1=single TM
             if (type == 'r') ReceiveTuringMachine(V);
             if (type == 's') ReceiveSongSteps(V);
+            // Output assignments and track settings from older firmware
             if (type == 't') ReceiveTrackSettings(V);
             if (type == 'o') ReceiveOutputAssignments(V);
             if (type == '1') {
@@ -180,8 +187,7 @@ public:
 
     void OnLeftButtonLongPress() {
         if (mode == ENIGMA_MODE_LIBRARY) SendTuringMachineLibrary();
-        if (mode == ENIGMA_MODE_ASSIGN) SendOutputAssignments();
-        if (mode >= ENIGMA_MODE_SONG) SendSong();
+        if (mode >= ENIGMA_MODE_ASSIGN) SendSong();
     }
 
     // Right button sets the parameter for the data type
@@ -310,6 +316,7 @@ private:
     bool last_assign_audition; // Temporarily save the old audition state during playback
     uint16_t track_step[100]; // List of steps in the current track
     uint16_t total_steps = 0; // Total number of song_step[] entries used; index of the next step
+    uint32_t sysex_hashes[SysExSettingsChunks<EnigmaSettings>()] = {}; // see SendSong()
     uint8_t last_track_step_index = 0; // For adding the next step
     uint16_t help_countdown = 0; // Display help screen for this many more ticks
     uint16_t help_time = ENIGMA_INITIAL_HELP_TIME; // Starting time for help, per mode
@@ -960,7 +967,7 @@ private:
     void DismissHelp() {
         uint16_t help_seen_for = help_time - help_countdown;
         help_time = help_seen_for;
-        if (help_time < 16667) help_time = 0; // If dismissed within 1 second, stop showing help
+        if (help_time < OC_CORE_TICKS_MS(1000)) help_time = 0; // If dismissed within 1 second, stop showing help
         help_countdown = 0;
     }
 
@@ -980,10 +987,7 @@ private:
             V[ix++] = static_cast<uint8_t>((reg >> 8) & 0xfff);  // High Byte
             V[ix++] = len;
             V[ix++] = favorite;
-            UnpackedData unpacked;
-            unpacked.set_data(ix, V);
-            PackedData packed = unpacked.pack();
-            SendSysEx(packed, 'T');
+            SendSysEx(V, ix, 'T');
         }
     }
 
@@ -1000,65 +1004,38 @@ private:
         V[ix++] = static_cast<uint8_t>((reg >> 8) & 0xfff);  // High Byte
         V[ix++] = len;
         V[ix++] = favorite;
-        UnpackedData unpacked;
-        unpacked.set_data(ix, V);
-        PackedData packed = unpacked.pack();
-        SendSysEx(packed, 'T');
+        SendSysEx(V, ix, 'T');
     }
 
-    void SendSong() {
-        uint8_t V[48];
-        uint8_t ix;
+    /* Output assignments, track settings and the song's first 32 steps go out
+     * as the EnigmaSettings values ('S'). With changed_only, only messages
+     * whose values changed since the last send. Steps past those follow as
+     * song step pages ('T', 's').
+     */
+    void SendSong(bool changed_only = false) {
+        SaveToEEPROMStage();
+        if (!changed_only) memset(sysex_hashes, 0, sizeof(sysex_hashes));
+        SendSysExSettings(settings_, 'S', sysex_hashes);
 
-        // Send song data
-        ix = 0;
-        uint8_t pages = (total_steps / 8) + 1;
-        for (int p = 0; p < pages; p++)
+        uint8_t V[48];
+        uint8_t pages = (total_steps + 7) / 8;
+        for (int p = 4; p < pages; p++)
         {
+            uint8_t ix = 0;
             V[ix++] = 's'; // Indicates a song step page is being sent
             V[ix++] = p; // Page number
             V[ix++] = static_cast<uint8_t>(total_steps & 0xff); // Total steps, low byte
             V[ix++] = static_cast<uint8_t>((total_steps >> 8) & 0xff); // Total steps, high byte
-            for (int s = 0; s < 10; s++)
+            for (int s = 0; s < 8; s++)
             {
-                uint8_t ssi = (p * 8) + s;
+                uint16_t ssi = (p * 8) + s;
                 V[ix++] = song_step[ssi].tk;
                 V[ix++] = song_step[ssi].pr;
                 V[ix++] = song_step[ssi].re;
                 V[ix++] = song_step[ssi].tr;
             }
-            UnpackedData unpacked;
-            unpacked.set_data(ix, V);
-            PackedData packed = unpacked.pack();
-            SendSysEx(packed, 'T');
-        }
-
-        // Send track settings
-        ix = 0;
-        V[ix++] = 't'; // Indicates a set of output assignments
-        for (int t = 0; t < 4; t++) V[ix++] = track[t].data;
-        UnpackedData unpacked;
-        unpacked.set_data(ix, V);
-        PackedData packed = unpacked.pack();
-        SendSysEx(packed, 'T');
-
-    }
-
-    void SendOutputAssignments() {
-        uint8_t V[48];
-        uint8_t ix = 0;
-        V[ix++] = 'o'; // Indicates a set of output assignments
-        for (int o = 0; o < 4; o++)
-        {
-            V[ix++] = output[o].tk;
-            V[ix++] = output[o].ty;
-            V[ix++] = output[o].sc;
-            V[ix++] = output[o].mc;
+            SendSysEx(V, ix, 'T');
         }
-        UnpackedData unpacked;
-        unpacked.set_data(ix, V);
-        PackedData packed = unpacked.pack();
-        SendSysEx(packed, 'T');
     }
 
     void ReceiveTuringMachine(uint8_t *V) {
@@ -1141,7 +1118,9 @@ private:
           settings_.apply_value(ix++, track[t].data);
     }
 
-    void LoadFromEEPROMStage() {
+    // received: the values came in over SysEx, so the song length is as sent
+    // (for songs that fit in the stored steps), and an empty song is kept
+    void LoadFromEEPROMStage(bool received = false) {
         uint8_t ix = 0;
 
         // Outputs
@@ -1155,7 +1134,7 @@ private:
 
         // Song length
         uint8_t song_steps = settings_.get_value(ix++);
-        if (song_steps > total_steps) total_steps = song_steps;
+        if (song_steps > total_steps || (received && song_steps < 32)) total_steps = song_steps;
 
         // Song Steps
         for (int s = 0; s < 32; s++)
@@ -1170,7 +1149,7 @@ private:
         for (int t = 0; t < 4; t++) track[t].data = settings_.get_value(ix++);
 
         // Reset everything if there's no data (meaning, song steps is 0)
-        if (song_steps == 0) Start();
+        if (song_steps == 0 && !received) Start();
 
         // Clear track list
         else BuildTrackStepList(0);
@@ -35,8 +35,11 @@
 #include "HSicons.h"
 #include "HSMIDI.h"
 #include "HSClockManager.h"
+#include "HSProfiler.h"
+#include "HSPatchGraph.h"
 #ifdef __IMXRT1062__
 #include "PhzConfig.h"
+#include "PhzPresetBank.h"
 #endif
 
 // The settings specify the selected applets, and 64 bits of data for each applet,
@@ -65,9 +68,11 @@ enum HEMISPHERE_SETTINGS {
 };
 
 #ifdef __IMXRT1062__
-// TODO: consider separate, smaller files - this could get slow
 static constexpr int HEM_NR_OF_PRESETS = 50;
+// Globals shared by all presets; presets themselves used to live here too
 static const char* const PRESET_FILENAME = "HEM_PRESETS.DAT";
+// Indexed preset bank, one fixed slot per preset
+static const char* const PRESET_BANK_FILENAME = "HEM_PRESETS.IDX";
 #elif defined(MOAR_PRESETS)
 static constexpr int HEM_NR_OF_PRESETS = 16;
 #elif defined(CUSTOM_BUILD) && !defined(PEWPEWPEW)
@@ -80,6 +85,9 @@ static constexpr int HEM_NR_OF_PRESETS = 8;
  * - conveniently store/recall multiple configurations
  */
 #ifdef __IMXRT1062__
+// Prefetched at boot, so recall doesn't touch the filesystem
+DMAMEM PhzConfig::PresetBlob hem_preset_slots[HEM_NR_OF_PRESETS];
+PhzConfig::PresetBank hem_preset_bank(PRESET_BANK_FILENAME, hem_preset_slots, HEM_NR_OF_PRESETS);
 #else
 class HemispherePreset : public SystemExclusiveHandler,
     public settings::SettingsBase<HemispherePreset, HEMISPHERE_SETTINGS_COUNT> {
@@ -88,9 +96,8 @@ public:
         return (h == LEFT_HEMISPHERE) ? values_[HEMISPHERE_SELECTED_LEFT_ID]
                                       : values_[HEMISPHERE_SELECTED_RIGHT_ID];
     }
-    HemisphereApplet* GetApplet(int h) {
-      int idx = HS::get_applet_index_by_id( GetAppletId(h) );
-      return HS::get_applet(idx, h);
+    int GetAppletIndex(int h) {
+      return HS::get_applet_index_by_id( GetAppletId(h) );
     }
     void SetAppletId(int h, int id) {
         apply_value(h, id);
@@ -287,6 +294,8 @@ public:
         // This loads only from LFS, assuming Hemisphere is only used on T40 without SD cards...
         if (PhzConfig::load_config(PRESET_FILENAME))
           LoadGlobals();
+        if (!hem_preset_bank.loaded() && !hem_preset_bank.Load())
+          MigratePresets();
 
         if (preset_id < 0)
           LoadFromPreset(0);
@@ -296,6 +305,7 @@ public:
 #endif
     }
     void Suspend() {
+        HS::frame.ClearPatching();
 #ifdef __IMXRT1062__
         if (HS::auto_save_enabled)
             StoreToPreset(preset_id);
@@ -391,46 +401,47 @@ public:
 
     void StoreToPreset(int id, bool skip_eeprom = false) {
 #ifdef __IMXRT1062__
-        uint16_t preset_key = id << 9;
+        PhzConfig::PresetBlob preset;
+        preset.clear();
 
         // clock data
         clock_data = ClockSetup_instance.OnDataRequest();
-        PhzConfig::setValue(preset_key | CLOCK_DATA_KEY, clock_data);
+        preset.set(CLOCK_DATA_KEY, clock_data);
 
         // vague globals
         global_data = ClockSetup_instance.GetGlobals();
-        PhzConfig::setValue(preset_key | GLOBALS_KEY, global_data);
+        preset.set(GLOBALS_KEY, global_data);
 
         uint64_t data = 0;
         // Input Mappings
         data = PackPackables(HS::trigmap[0], HS::trigmap[1]);
-        PhzConfig::setValue(preset_key | TRIGMAP_KEY, data);
+        preset.set(TRIGMAP_KEY, data);
         data = PackPackables(HS::trigmap[2], HS::trigmap[3]);
-        PhzConfig::setValue(preset_key | (TRIGMAP_KEY + 1), data);
+        preset.set(TRIGMAP_KEY + 1, data);
 
         data = PackPackables(HS::cvmap[0], HS::cvmap[1], HS::cvmap[2], HS::cvmap[3]);
-        PhzConfig::setValue(preset_key | CVMAP_KEY, data);
+        preset.set(CVMAP_KEY, data);
 
         data = 0;
         for (size_t i = 0; i < DAC_CHANNEL_COUNT; ++i) {
           Pack(data, PackLocation{i*8, 8}, HS::frame.clockinskip[i]);
         }
-        PhzConfig::setValue(preset_key | INSKIP_KEY, data);
+        preset.set(INSKIP_KEY, data);
         data = 0;
         for (size_t i = 0; i < DAC_CHANNEL_COUNT; ++i) {
           Pack(data, PackLocation{i*8, 8}, HS::frame.clockoutskip[i]);
         }
-        PhzConfig::setValue(preset_key | OUTSKIP_KEY, data);
+        preset.set(OUTSKIP_KEY, data);
         data = 0;
         for (size_t i = 0; i < DAC_CHANNEL_COUNT; ++i) {
           Pack(data, PackLocation{i*8, 8}, HS::frame.output_slew[i]);
         }
-        PhzConfig::setValue(preset_key | OUTSLEW_KEY, data);
+        preset.set(OUTSLEW_KEY, data);
         data = 0;
         for (size_t i = 0; i < DAC_CHANNEL_COUNT; ++i) {
           Pack(data, PackLocation{i*8, 8}, static_cast<uint8_t>(HS::frame.output_atten[i]));
         }
-        PhzConfig::setValue(preset_key | OUTATTEN_KEY, data);
+        preset.set(OUTATTEN_KEY, data);
 
         data = 0;
         for (size_t h = 0; h < 2; h++)
@@ -440,11 +451,11 @@ public:
 
             // applet data
             applet_data[h] = HS::get_applet(index, h)->OnDataRequest();
-            PhzConfig::setValue(preset_key | (APPLET_L_DATA_KEY + h), applet_data[h]);
+            preset.set(APPLET_L_DATA_KEY + h, applet_data[h]);
         }
 
         // applet ids, and maybe some other stuff?
-        PhzConfig::setValue(preset_key | APPLET_METADATA_KEY, data);
+        preset.set(APPLET_METADATA_KEY, data);
 
         // -- Globals (per file) --
         PhzConfig::setValue(FILTERMASK1_KEY, HS::hidden_applets[0]);
@@ -490,7 +501,10 @@ public:
           }
         }
 
-        if (PhzConfig::save_config(PRESET_FILENAME))
+        // only this preset's slot is rewritten, and only if it changed;
+        // both writes happen later from the storage task queue
+        bool success = hem_preset_bank.DeferStore(id, preset);
+        if (PhzConfig::defer_save(PRESET_FILENAME) && success)
           PokePopup(HS::MESSAGE_POPUP, HS::PRESET_SAVED);
 #else
         StoreToPreset( (HemispherePreset*)(hem_presets + id), skip_eeprom );
@@ -500,12 +514,12 @@ public:
     void LoadFromPreset(int id) {
         preset_id = id;
 #ifdef __IMXRT1062__
-        // T4.x uses a LittleFS file via PhzConfig
-        uint16_t preset_key = id << 9;
+        // T4.x uses the preset bank, read from LittleFS at boot
+        const PhzConfig::PresetBlob &preset = hem_preset_bank[id];
         uint64_t data;
 
         // applet ids + misc
-        if (!PhzConfig::getValue(preset_key | APPLET_METADATA_KEY, data)) return;
+        if (!preset.get(APPLET_METADATA_KEY, data)) return;
         if (!data) return;
 
         for (size_t h = 0; h < 2; h++)
@@ -513,27 +527,27 @@ public:
             int index = HS::get_applet_index_by_id( Unpack(data, PackLocation{h*8, 8}) );
 
             // applet data
-            PhzConfig::getValue(preset_key | (APPLET_L_DATA_KEY + h), applet_data[h]);
+            preset.get(APPLET_L_DATA_KEY + h, applet_data[h]);
             SetApplet(HEM_SIDE(h), index);
             HS::get_applet(index, h)->OnDataReceive(applet_data[h]);
         }
 
         // clock data
-        if (!PhzConfig::getValue(preset_key | CLOCK_DATA_KEY, clock_data)) return;
+        if (!preset.get(CLOCK_DATA_KEY, clock_data)) return;
         ClockSetup_instance.OnDataReceive(clock_data);
         // if the first key exists, we are assuming the rest are present...
 
         // vague globals
-        PhzConfig::getValue(preset_key | GLOBALS_KEY, global_data);
+        preset.get(GLOBALS_KEY, global_data);
         ClockSetup_instance.SetGlobals(global_data);
 
         // Input Mappings
 
-        if (PhzConfig::getValue(preset_key | TRIGMAP_KEY, data)) {
+        if (preset.get(TRIGMAP_KEY, data)) {
           UnpackPackables(data, HS::trigmap[0], HS::trigmap[1]);
-          PhzConfig::getValue(preset_key | (TRIGMAP_KEY + 1), data);
+          preset.get(TRIGMAP_KEY + 1, data);
           UnpackPackables(data, HS::trigmap[2], HS::trigmap[3]);
-        } else if (PhzConfig::getValue(preset_key | OLD_TRIGMAP_KEY, data)) {
+        } else if (preset.get(OLD_TRIGMAP_KEY, data)) {
           // migrate from v1.x
           uint16_t mapdata[4];
           UnpackPackables(data, mapdata[0], mapdata[1], mapdata[2], mapdata[3]);
@@ -543,10 +557,10 @@ public:
           HS::trigmap[3].Unpack(mapdata[3]);
         }
 
-        if (PhzConfig::getValue(preset_key | CVMAP_KEY, data)) {
+        if (preset.get(CVMAP_KEY, data)) {
           UnpackPackables(data, HS::cvmap[0], HS::cvmap[1], HS::cvmap[2], HS::cvmap[3]);
 
-          PhzConfig::getValue(preset_key | OUTSKIP_KEY, data);
+          preset.get(OUTSKIP_KEY, data);
           for (size_t i = 0; i < DAC_CHANNEL_COUNT; ++i)
           {
             HS::frame.clockoutskip[i] = Unpack(data, PackLocation{i*8, 8});
@@ -554,19 +568,19 @@ public:
         }
 
         data = 0;
-        PhzConfig::getValue(preset_key | INSKIP_KEY, data);
+        preset.get(INSKIP_KEY, data);
         for (size_t i = 0; i < DAC_CHANNEL_COUNT; ++i)
         {
           HS::frame.clockinskip[i] = Unpack(data, PackLocation{i*8, 8});
         }
 
-        PhzConfig::getValue(preset_key | OUTSLEW_KEY, data);
+        preset.get(OUTSLEW_KEY, data);
         for (size_t i = 0; i < DAC_CHANNEL_COUNT; ++i)
         {
           HS::frame.output_slew[i] = Unpack(data, PackLocation{i*8, 8});
         }
 
-        const bool has_output_atten = PhzConfig::getValue(preset_key | OUTATTEN_KEY, data);
+        const bool has_output_atten = preset.get(OUTATTEN_KEY, data);
         for (size_t i = 0; i < DAC_CHANNEL_COUNT; ++i)
         {
           HS::frame.output_atten[i] = has_output_atten ? Unpack(data, PackLocation{i*8, 8}) : 60;
@@ -596,6 +610,33 @@ public:
         PokePopup(PRESET_POPUP);
     }
 
+#ifdef __IMXRT1062__
+    // Presets used to be stored in PRESET_FILENAME along with the globals,
+    // keyed by (id << 9 | key). Move them to the preset bank, then drop them
+    // from the old file so it only holds globals.
+    void MigratePresets() {
+        static_assert(TRIGMAP_KEY + 1 < PhzConfig::PresetBlob::KEYS, "preset keys don't fit a PresetBlob");
+
+        bool found = false;
+        for (int id = 0; id < HEM_NR_OF_PRESETS; ++id) {
+          for (size_t key = 0; key < PhzConfig::PresetBlob::KEYS; ++key) {
+            uint64_t data;
+            if (PhzConfig::getValue(id << 9 | key, data)) {
+              hem_preset_bank[id].set(key, data);
+              found = true;
+            }
+          }
+        }
+        if (!found || !hem_preset_bank.SaveAll()) return;
+
+        for (int id = 0; id < HEM_NR_OF_PRESETS; ++id) {
+          for (size_t key = 0; key < PhzConfig::PresetBlob::KEYS; ++key)
+            PhzConfig::deleteKey(id << 9 | key);
+        }
+        PhzConfig::save_config(PRESET_FILENAME);
+    }
+#endif
+
     void LoadGlobals() {
         // --- Global stuff ---
         // (per file, not per preset)
@@ -651,7 +692,7 @@ public:
     void QueuePresetLoad(int slot) {
       if (HS::clock_m.IsRunning()) {
         queued_preset = slot;
-        HS::clock_m.BeatSync([this]() { ProcessQueue(); });
+        HS::clock_m.BeatSync([](void *app) { static_cast<AppHemisphere *>(app)->ProcessQueue(); }, this);
       } else
         LoadFromPreset(slot);
     }
@@ -693,10 +734,12 @@ public:
         if (index == my_applet[hemisphere]) return;
         /*noInterrupts();*/
         int oldidx = my_applet[hemisphere];
+        // fetch the old applet first, so the new one doesn't displace it
+        HemisphereApplet* old_ = (oldidx >= 0 && oldidx < HEMISPHERE_AVAILABLE_APPLETS)
+          ? HS::get_applet(oldidx, hemisphere) : nullptr;
         HS::get_applet(index, hemisphere)->BaseStart(hemisphere);
         next_applet[hemisphere] = my_applet[hemisphere] = index;
-        if (oldidx >= 0 && oldidx < HEMISPHERE_AVAILABLE_APPLETS)
-          HS::get_applet(oldidx, hemisphere)->Unload();
+        if (old_) old_->Unload();
         /*interrupts();*/
     }
     void ChangeApplet(HEM_SIDE h, int dir) {
@@ -725,7 +768,7 @@ public:
                 //continue;
             }
 
-            f.MIDIState.ProcessMIDIMsg({device.getChannel(), message, data1, data2});
+            f.MIDIState.QueueMIDIMsg({device.getChannel(), message, data1, data2});
         }
         if (load_slot >= 0 && load_slot < HEM_NR_OF_PRESETS) {
             QueuePresetLoad(load_slot);
@@ -734,7 +777,7 @@ public:
 
     void mainloop() {
         timeout = 0;
-        // top-level MIDI-to-CV handling - alters frame outputs
+        // top-level MIDI-to-CV handling - queued here, applied in BaseController()
         ProcessMIDI(usbMIDI);
     }
 
@@ -754,21 +797,49 @@ public:
           if (jump_trig_.is_clock()) ProcessQueue();
         }
 
-        // execute Applets
-        for (int h = 0; h < 2; h++)
+        // execute Applets, each after any it's patched from
+        HemisphereApplet *applets[2] = {
+          HS::get_applet(my_applet[0], LEFT_HEMISPHERE),
+          HS::get_applet(my_applet[1], RIGHT_HEMISPHERE)
+        };
+        const uint32_t deferred_clocks = HS::frame.deferred_clocks;
+        UpdatePatchGraph(applets);
+        for (int i = 0; i < 2; i++)
         {
-            int index = my_applet[h];
+            const int h = patch_graph.order[i];
+            HemisphereApplet *applet = applets[h];
+            for (int ch = h * 2; ch < h * 2 + 2; ++ch) {
+                if (deferred_clocks & (1u << ch)) HS::frame.ProcessClock(ch);
+            }
 
             if (HS::clock_m.auto_reset)
-                HS::get_applet(index, h)->Reset();
+                applet->Reset();
 
-            HS::get_applet(index, h)->Controller();
+            HS_PROFILE_APPLET(CONTROLLER, applet, h);
+            applet->Controller();
+            HS::frame.PushOutputs(h * 2);
         }
         HS::clock_m.auto_reset = false;
 
         HemisphereApplet::ProcessCursors();
     }
 
+    // Rebuilds the evaluation order when patches between applets change.
+    // Trigger inputs patched from an applet are clocked after it runs,
+    // starting next tick.
+    void UpdatePatchGraph(HemisphereApplet *applets[2]) {
+        uint8_t reads[2];
+        uint32_t deferred = 0;
+        for (int h = 0; h < 2; h++) {
+            reads[h] = patch_graph.SlotMask(applets[h]->BaseInputSources());
+            for (int ch = h * 2; ch < h * 2 + 2; ++ch) {
+                if (patch_graph.SlotMask(HS::trigmap[ch].dac_mask())) deferred |= (1u << ch);
+            }
+        }
+        patch_graph.Update(reads);
+        HS::frame.deferred_clocks = deferred;
+    }
+
     void DrawFullScreen() const {
       int index = my_applet[zoom_slot];
 
@@ -1157,6 +1228,7 @@ private:
     int preset_cursor = 0;
     int my_applet[2]; // Indexes to applets
     int next_applet[2]; // queued from UI thread, handled by Controller
+    HS::PatchGraph<2> patch_graph;
     uint64_t clock_data, global_data, applet_data[2]; // cache of applet data
     bool clock_setup;
     int config_cursor = 0;
@@ -1308,11 +1380,8 @@ private:
     }
     void DeletePreset(int id) {
 #ifdef __IMXRT1062__
-      uint16_t preset_key = id << 9;
-      // non-global values are all 0-99 in the enum
-      for (int i = 0; i < 100; ++i) {
-        PhzConfig::deleteKey(preset_key | i);
-      }
+      hem_preset_bank[id].clear();
+      hem_preset_bank.DeferSave(id);
 #else
       hem_presets[id].SetAppletId(0, 0);
 #endif
@@ -1458,6 +1527,11 @@ private:
 
         gfxLine(64, 11, 64, 63);
 
+        // applets in a feedback loop
+        for (int h = 0; h < 2; ++h) {
+          if (patch_graph.is_cyclic(h)) gfxIcon(55 + h*64, 13, LOOP_ICON);
+        }
+
         switch (config_cursor) {
         case TRIGMAP1:
         case TRIGMAP2:
@@ -1560,23 +1634,20 @@ private:
     bool isValidPreset(int id) {
 #ifdef __IMXRT1062__
       uint64_t data;
-      return PhzConfig::getValue(id << 9 | APPLET_METADATA_KEY, data);
+      return hem_preset_bank[id].get(APPLET_METADATA_KEY, data);
 #else
       return hem_presets[id].is_valid();
 #endif
     }
 
-    HemisphereApplet* GetApplet(int id, size_t h) const {
-        // TODO: names and icons should be static... then again,
-        //       using get_applet() will make sure applets are available
-        //       as soon as presets are enumerated
+    // names and icons are static, so this doesn't need an applet instance
+    int GetAppletIndex(int id, size_t h) const {
 #ifdef __IMXRT1062__
         uint64_t data = 0;
-        PhzConfig::getValue(id << 9 | APPLET_METADATA_KEY, data);
-        int idx = HS::get_applet_index_by_id( Unpack(data, PackLocation{h*8, 8}) );
-        return HS::get_applet(idx, h);
+        hem_preset_bank[id].get(APPLET_METADATA_KEY, data);
+        return HS::get_applet_index_by_id( Unpack(data, PackLocation{h*8, 8}) );
 #else
-        return hem_presets[id].GetApplet(h);
+        return hem_presets[id].GetAppletIndex(h);
 #endif
     }
     void DrawPresetSelector() const {
@@ -1599,11 +1670,11 @@ private:
             if (!isValidPreset(i))
                 gfxPrint(18, y, "(empty)");
             else {
-                gfxIcon(18, y, GetApplet(i, 0)->applet_icon());
-                gfxPrint(26, y, GetApplet(i, 0)->applet_name());
+                gfxIcon(18, y, HS::get_applet_icon(GetAppletIndex(i, 0)));
+                gfxPrint(26, y, HS::get_applet_name(GetAppletIndex(i, 0)));
                 gfxPrint(", ");
-                gfxPrint(GetApplet(i, 1)->applet_name());
-                gfxIcon(120, y, GetApplet(i, 1)->applet_icon(), true);
+                gfxPrint(HS::get_applet_name(GetAppletIndex(i, 1)));
+                gfxIcon(120, y, HS::get_applet_icon(GetAppletIndex(i, 1)), true);
             }
 
             y += 10;
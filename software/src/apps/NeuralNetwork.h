@@ -53,6 +53,29 @@ class NNSettings : public settings::SettingsBase<NNSettings, NN_SETTING_LAST>
 };
 SETTINGS_ARRAY_DEFINE(NNSettings);
 
+// One setup as it goes out over SysEx: six neurons, then four output assignments
+#define NN_SYSEX_NEURON \
+  {0, 0, LogicGate::TL_NEURON, "Ty", NULL, settings::STORAGE_TYPE_U4}, \
+  {0, 0, LG_MAX_SOURCE, "S1", NULL, settings::STORAGE_TYPE_U4}, \
+  {0, 0, LG_MAX_SOURCE, "S2", NULL, settings::STORAGE_TYPE_U4}, \
+  {0, 0, LG_MAX_SOURCE, "S3", NULL, settings::STORAGE_TYPE_U4}, \
+  {0, -9, 9, "W1", NULL, settings::STORAGE_TYPE_I8}, \
+  {0, -9, 9, "W2", NULL, settings::STORAGE_TYPE_I8}, \
+  {0, -9, 9, "W3", NULL, settings::STORAGE_TYPE_I8}, \
+  {0, -27, 27, "Th", NULL, settings::STORAGE_TYPE_I8},
+#define NN_SYSEX_OUTPUT {0, 0, 5, "Out", NULL, settings::STORAGE_TYPE_U4},
+
+class NNSetupSettings : public settings::SettingsBase<NNSetupSettings, 6 * 8 + 4>
+{
+  // 38 bytes, so a setup fits in one message
+  SETTINGS_ARRAY_DECLARE() {{
+    NN_SYSEX_NEURON NN_SYSEX_NEURON NN_SYSEX_NEURON
+    NN_SYSEX_NEURON NN_SYSEX_NEURON NN_SYSEX_NEURON
+    NN_SYSEX_OUTPUT NN_SYSEX_OUTPUT NN_SYSEX_OUTPUT NN_SYSEX_OUTPUT
+  }};
+};
+SETTINGS_ARRAY_DEFINE(NNSetupSettings);
+
 OC_APP_CLASS(AppNeuralNetwork, TWOCCS("NN"), "Neural Network", "Neural Net"),
   public HSApplication, public SystemExclusiveHandler
 {
@@ -110,72 +133,23 @@ public:
     // Public access to save method
     void OnSaveSettings() {SaveToEEPROMStage();}
 
+    static_assert(NNSetupSettings::storageSize() + NNSetupSettings::kChunkHeaderSize
+                  <= kSysExSettingsMaxBytes, "NN setup takes more than one message");
+
     /* Send the current setup via SysEx */
     void OnSendSysEx() {
-        uint8_t V[39];
-        int ix = 0;
-
-        ix = 0;
-        for (uint8_t n = 0; n < 6; n++)
-        {
-            uint8_t ni = (setup * 6) + n;
-
-            // Encode a neuron
-            V[ix++] = (neuron[ni].type << 4) | neuron[ni].source1;
-            V[ix++] = (neuron[ni].source2 << 4) | neuron[ni].source3;
-            V[ix++] = neuron[ni].weight1 + 128;
-            V[ix++] = neuron[ni].weight2 + 128;
-            V[ix++] = neuron[ni].weight3 + 128;
-            V[ix++] = neuron[ni].threshold + 128;
-        }
-
-        // Encode the output assignments
-        uint8_t o = (setup * 4);
-        V[ix++] = (output_neuron[o] << 4) | output_neuron[o + 1];
-        V[ix++] = (output_neuron[o + 2] << 4) | output_neuron[o + 3];
-
-        UnpackedData unpacked;
-        unpacked.set_data(ix, V);
-        PackedData packed = unpacked.pack();
-        SendSysEx(packed, 'N');
+        NNSetupSettings values{};
+        GetSetup(values);
+        SendSysExSettings(values, 'N');
     }
 
     void OnReceiveSysEx() {
         // Since only one Setup is coming, use the currently-selected setup to determine
-        // where to stash it.
-        uint8_t V[39];
-        if (ExtractSysExData(V, 'N')) {
-            int ix = 0;
-            uint8_t b = 0;
-
-            // Decode neurons
-            for (uint8_t n = 0; n < 6; n++)
-            {
-                uint8_t ni = (setup * 6) + n;
-                b = V[ix++]; // Type and source 1
-                neuron[ni].type = (b >> 4) & 0x0f;
-                neuron[ni].source1 = b & 0x0f;
-                b = V[ix++]; // Source 2 and source 3
-                neuron[ni].source2 = (b >> 4) & 0x0f;
-                neuron[ni].source3 = b & 0x0f;
-                neuron[ni].weight1 = static_cast<int>(V[ix++] - 128);
-                neuron[ni].weight2 = static_cast<int>(V[ix++] - 128);
-                neuron[ni].weight3 = static_cast<int>(V[ix++] - 128);
-                neuron[ni].threshold = static_cast<int>(V[ix++] - 128);
-                neuron[ni].state = 0;
-                neuron[ni].source_state = 0;
-            }
-
-            // Decode output assignments
-            uint8_t o = (setup * 4);
-            b = V[ix++]; // Output 1 and 2
-            output_neuron[o] = (b >> 4) & 0x0f;
-            output_neuron[o + 1] = b & 0x0f;
-            b = V[ix++]; // Output 3 and 4
-            output_neuron[o + 2] = (b >> 4) & 0x0f;
-            output_neuron[o + 3] = b & 0x0f;
-        }
-
+        // where to stash it. A message may carry only part of the setup, so start
+        // from what's there.
+        NNSetupSettings values{};
+        GetSetup(values);
+        if (ExtractSysExSettings(values, 'N')) SetSetup(values);
     }
 
     /* Perform a copy or sysex dump */
@@ -428,6 +402,42 @@ private:
         return source_state;
     }
 
+    void GetSetup(NNSetupSettings &values) const {
+        int ix = 0;
+        for (uint8_t n = 0; n < 6; n++)
+        {
+            const LogicGate &gate = neuron[(setup * 6) + n];
+            values.apply_value(ix++, gate.type);
+            values.apply_value(ix++, gate.source1);
+            values.apply_value(ix++, gate.source2);
+            values.apply_value(ix++, gate.source3);
+            values.apply_value(ix++, gate.weight1);
+            values.apply_value(ix++, gate.weight2);
+            values.apply_value(ix++, gate.weight3);
+            values.apply_value(ix++, gate.threshold);
+        }
+        for (uint8_t o = 0; o < 4; o++) values.apply_value(ix++, output_neuron[(setup * 4) + o]);
+    }
+
+    void SetSetup(const NNSetupSettings &values) {
+        int ix = 0;
+        for (uint8_t n = 0; n < 6; n++)
+        {
+            LogicGate &gate = neuron[(setup * 6) + n];
+            gate.type = values.get_value(ix++);
+            gate.source1 = values.get_value(ix++);
+            gate.source2 = values.get_value(ix++);
+            gate.source3 = values.get_value(ix++);
+            gate.weight1 = values.get_value(ix++);
+            gate.weight2 = values.get_value(ix++);
+            gate.weight3 = values.get_value(ix++);
+            gate.threshold = values.get_value(ix++);
+            gate.state = 0;
+            gate.source_state = 0;
+        }
+        for (uint8_t o = 0; o < 4; o++) output_neuron[(setup * 4) + o] = values.get_value(ix++);
+    }
+
     /* The system settings are just bytes. Move them into the instance variables here */
     void LoadFromEEPROMStage() {
         uint8_t ix = 0;
@@ -187,7 +187,7 @@ public:
   static constexpr size_t kMaxDelayedTriggers = 24; 
 
   struct DelayedTrigger {
-    uint32_t delay;
+    uint32_t delay; // ticks
     uint32_t time_left;
 
     inline void Activate(uint32_t t) {
@@ -591,7 +591,7 @@ public:
     if (triggered) {
       TriggerDelayMode delay_mode = get_trigger_delay_mode();
       // uint32_t delay = get_trigger_delay_ms() * 1000U;
-      uint32_t delay = static_cast<uint32_t>(s[CV_MAPPING_DELAY_MSEC] * 1000U);
+      uint32_t delay = OC_CORE_TICKS_US(static_cast<uint32_t>(s[CV_MAPPING_DELAY_MSEC] * 1000U));
       if (delay_mode && delay) {
         triggered = false;
         if (TRIGGER_DELAY_QUEUE == delay_mode) {
@@ -710,8 +710,8 @@ private:
       DelayedTrigger &trigger = delayed_triggers_[i];
       uint32_t time_left = trigger.time_left;
       if (time_left) {
-        if (time_left > OC_CORE_TIMER_RATE) {
-          time_left -= OC_CORE_TIMER_RATE;
+        if (time_left > 1) {
+          --time_left;
           if (time_left < min_time_left) {
             min_time_left = time_left;
             delayed_triggers_next_ = i;
@@ -51,9 +51,9 @@ public:
   // Length of audio bloops upon bounce
   static constexpr int BEEP_PITCH = 800;
   static constexpr int BOOP_PITCH = 400;
-  static constexpr int BEEP_LEN = 17 * 110; // 17 ticks == 1ms
-  static constexpr int BOOP_LEN = 17 * 90;
-  static constexpr int CRASH_LEN = 17 * 200;
+  static constexpr int BEEP_LEN = OC_CORE_TICKS_MS(110);
+  static constexpr int BOOP_LEN = OC_CORE_TICKS_MS(90);
+  static constexpr int CRASH_LEN = OC_CORE_TICKS_MS(200);
   static constexpr int BEEP_TICKS = OC_CORE_ISR_FREQ / BEEP_PITCH;
   static constexpr int BOOP_TICKS = OC_CORE_ISR_FREQ / BOOP_PITCH;
 
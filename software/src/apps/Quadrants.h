@@ -38,6 +38,8 @@
 #include "HSicons.h"
 #include "HSMIDI.h"
 #include "HSClockManager.h"
+#include "HSProfiler.h"
+#include "HSPatchGraph.h"
 
 #include "PackingUtils.h"
 #include "PhzConfig.h"
@@ -97,6 +99,7 @@ public:
         for (auto& env : HS::env_) env.reset();
     }
     void Suspend() {
+        HS::frame.ClearPatching();
         if (preset_id >= 0) {
             if (HS::auto_save_enabled)
               StoreToPreset(preset_id);
@@ -325,9 +328,9 @@ public:
 
         bool success = false;
         if (SDcard_Ready)
-          success = PhzConfig::save_config(bank_filename, SD);
+          success = PhzConfig::defer_save(bank_filename, SD);
         else
-          success = PhzConfig::save_config(bank_filename);
+          success = PhzConfig::defer_save(bank_filename);
 
         if (success)
           PokePopup(HS::MESSAGE_POPUP, HS::PRESET_SAVED);
@@ -487,7 +490,7 @@ public:
     void QueuePresetLoad(int id) {
       if (HS::clock_m.IsRunning()) {
         queued_preset = id;
-        HS::clock_m.BeatSync( [this](){ ProcessQueue(); } );
+        HS::clock_m.BeatSync( [](void *app){ static_cast<AppQuadrants *>(app)->ProcessQueue(); }, this );
       }
       else
         LoadFromPreset(id);
@@ -573,11 +576,11 @@ public:
             case midi::Clock:
             case midi::Start:
             case midi::Stop:
-              if (clkrx) f.MIDIState.ProcessMIDIMsg(msg); // receive it
+              if (clkrx) f.MIDIState.QueueMIDIMsg(msg); // receive it
                 break;
 
             default:
-              if (msgrx && (msg.message >> 4) != 0xF) f.MIDIState.ProcessMIDIMsg(msg); // receive it
+              if (msgrx && (msg.message >> 4) != 0xF) f.MIDIState.QueueMIDIMsg(msg); // receive it
                 break;
           }
 
@@ -591,7 +594,7 @@ public:
 
     void mainloop() {
         timeout = 0;
-        // top-level MIDI-to-CV handling - alters frame outputs
+        // top-level MIDI-to-CV handling - queued here, applied in BaseController()
         ProcessMIDI(usbMIDI);
         ProcessMIDI(usbHostMIDI[0]);
         ProcessMIDI(usbHostMIDI[1]);
@@ -613,19 +616,44 @@ public:
           if (jump_trig_.is_clock()) ProcessQueue();
         }
 
-        // execute Applets
-        for (int h = 0; h < APPLET_SLOTS; h++)
+        // execute Applets, each after any it's patched from
+        const uint32_t deferred_clocks = HS::frame.deferred_clocks;
+        UpdatePatchGraph();
+        for (int i = 0; i < APPLET_SLOTS; i++)
         {
+            const int h = patch_graph.order[i];
+            for (int ch = h * 2; ch < h * 2 + 2; ++ch) {
+                if (deferred_clocks & (1u << ch)) HS::frame.ProcessClock(ch);
+            }
+
             if (HS::clock_m.auto_reset)
                 active_applet[h]->Reset();
 
+            HS_PROFILE_APPLET(CONTROLLER, active_applet[h], h);
             active_applet[h]->Controller();
+            HS::frame.PushOutputs(h * 2);
         }
         audio_app.Controller();
         HemisphereApplet::ProcessCursors();
         HS::clock_m.auto_reset = false;
     }
 
+    // Rebuilds the evaluation order when patches between applets change.
+    // Trigger inputs patched from an applet are clocked after it runs,
+    // starting next tick.
+    void UpdatePatchGraph() {
+        uint8_t reads[APPLET_SLOTS];
+        uint32_t deferred = 0;
+        for (int h = 0; h < APPLET_SLOTS; h++) {
+            reads[h] = patch_graph.SlotMask(active_applet[h]->BaseInputSources());
+            for (int ch = h * 2; ch < h * 2 + 2; ++ch) {
+                if (patch_graph.SlotMask(HS::trigmap[ch].dac_mask())) deferred |= (1u << ch);
+            }
+        }
+        patch_graph.Update(reads);
+        HS::frame.deferred_clocks = deferred;
+    }
+
     void DrawFullScreen() const {
       if (select_mode == zoom_slot) {
         showhide_cursor.Scroll(next_applet_index[zoom_slot] - showhide_cursor.cursor_pos());
@@ -1107,6 +1135,7 @@ private:
                       // Left side: 0,2
                       // Right side: 1,3
     int next_applet_index[4]; // queued from UI thread, handled by Controller
+    HS::PatchGraph<APPLET_SLOTS> patch_graph;
     uint64_t clock_data, global_data, applet_data[4]; // cache of applet data
     bool view_slot[2] = {0, 0}; // Two applets on each side, only one visible at a time
     int config_cursor = LOAD_PRESET;
@@ -1601,6 +1630,12 @@ private:
           gfxPrint(4 + ch*32, 54, HS::cvmap[ch + 4].InputName() );
         }
 
+        // applets in a feedback loop
+        for (int h = 0; h < APPLET_SLOTS; ++h) {
+          if (patch_graph.is_cyclic(h))
+            gfxIcon(55 + (h % 2)*64, 13 + (h / 2)*26, LOOP_ICON);
+        }
+
         gfxDottedLine(63, 11, 63, 63); // vert
         gfxDottedLine(0, 38, 127, 38); // horiz
 
@@ -1696,11 +1731,11 @@ private:
       uint64_t data;
       return PhzConfig::getValue(id << 11 | APPLET_METADATA_KEY, data);
     }
-    HemisphereApplet* GetApplet(int id, size_t h) const {
+    // names and icons are static, so this doesn't need an applet instance
+    int GetAppletIndex(int id, size_t h) const {
         uint64_t data = 0;
         PhzConfig::getValue(id << 11 | APPLET_METADATA_KEY, data);
-        int idx = HS::get_applet_index_by_id( Unpack(data, PackLocation{h*8, 8}) );
-        return HS::get_applet(idx, HEM_SIDE(h));
+        return HS::get_applet_index_by_id( Unpack(data, PackLocation{h*8, 8}) );
     }
     void DrawPresetSelector() const {
         const char * const hdrtxt[] = { "DEL!", "Load", "Save", "???" };
@@ -1731,11 +1766,11 @@ private:
             if (!isValidPreset(i))
                 gfxPrint(18, y, "(empty)");
             else {
-                gfxIcon(18, y, GetApplet(i, LEFT_HEMISPHERE)->applet_icon());
-                gfxPrint(26, y, GetApplet(i, LEFT_HEMISPHERE)->applet_name());
+                gfxIcon(18, y, HS::get_applet_icon(GetAppletIndex(i, LEFT_HEMISPHERE)));
+                gfxPrint(26, y, HS::get_applet_name(GetAppletIndex(i, LEFT_HEMISPHERE)));
                 gfxPrint(", ");
-                gfxPrint(GetApplet(i, RIGHT_HEMISPHERE)->applet_name());
-                gfxIcon(120, y, GetApplet(i, RIGHT_HEMISPHERE)->applet_icon(), true);
+                gfxPrint(HS::get_applet_name(GetAppletIndex(i, RIGHT_HEMISPHERE)));
+                gfxIcon(120, y, HS::get_applet_icon(GetAppletIndex(i, RIGHT_HEMISPHERE)), true);
             }
 
             y += 10;
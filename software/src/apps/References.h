@@ -473,8 +473,8 @@ public:
     int octave = get_octave();
     int range = get_range();
     if (range) {
-      rate_phase_ += OC_CORE_TIMER_RATE;
-      if (rate_phase_ >= get_rate() * 1000000UL) {
+      ++rate_phase_;
+      if (rate_phase_ >= get_rate() * OC_CORE_ISR_FREQ) {
         rate_phase_ = 0;
         mod_offset_ = 1 - mod_offset_;
       }
@@ -606,6 +606,7 @@ public:
         calibration_mode = true;
     }
     void Reflash() {
+      OC::CORE::FlushTasks(); // pending saves, before the reboot
       uint32_t start = millis();
       while(millis() < start + SETTINGS_SAVE_TIMEOUT_MS) {
         GRAPHICS_BEGIN_FRAME(true);
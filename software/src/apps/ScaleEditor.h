@@ -23,6 +23,7 @@
 #include "OC_apps.h"
 #include "OC_ui.h"
 #include "OC_scales.h"
+#include "OC_scale_library.h"
 #include "HSApplication.h"
 #include "HSMIDI.h"
 #include "SegmentDisplay.h"
@@ -67,35 +68,24 @@ public:
 
     /* Send SysEx on app suspend and when the left encoder is pressed */
     void OnSendSysEx() { // Left Enc Push
-        uint8_t V[35];
-        int ix = 0;
-
-        // Encode span
-        uint16_t span = static_cast<uint16_t>(OC::user_scales[current_scale].span);
-        V[ix++] = span & 0xff; // Low byte
-        V[ix++] = (span >> 8) & 0xff; // High byte
-
-        // Encode length
-        V[ix++] = static_cast<uint8_t>(OC::user_scales[current_scale].num_notes);
+        uint8_t sysex[SYSEX_DATA_MAX_SIZE];
+        util::SysExPacker packer = BeginSysEx(sysex, 'E');
 
-        // Encode values
+        // Encode span, length, and values, low byte first
+        packer.Write<uint16_t>(OC::user_scales[current_scale].span);
+        packer.Write<uint8_t>(OC::user_scales[current_scale].num_notes);
         for (int i = 0; i < 16; i++)
         {
-            uint16_t note = static_cast<uint16_t>(OC::user_scales[current_scale].notes[i]);
-            V[ix++] = note & 0xff; // Low
-            V[ix++] = (note >> 8) & 0xff; // High
+            packer.Write<uint16_t>(OC::user_scales[current_scale].notes[i]);
         }
 
-        UnpackedData unpacked;
-        unpacked.set_data(ix, V);
-        PackedData packed = unpacked.pack();
-        SendSysEx(packed, 'E');
+        EndSysEx(sysex, packer);
     }
 
     /* Send SysEx on app suspend and when the left encoder is pressed */
     void OnReceiveSysEx() {
         uint8_t V[35];
-        if (ExtractSysExData(V, 'E')) {
+        if (ExtractSysExData(V, 'E', sizeof(V))) {
             int ix = 0;
 
             // Decode span
@@ -137,6 +127,13 @@ public:
         else OnSendSysEx();
     }
 
+    void OnImportLongPress() {
+#ifdef __IMXRT1062__
+        // pick up new or changed Scala files
+        if (SDcard_Ready) OC::scale_library.StartIndexing(SD);
+#endif
+    }
+
     void OnRightButtonPress() {
         if (import_mode) ImportScale();
         else ToggleLengthSet();
@@ -169,7 +166,7 @@ private:
     int8_t cursor;
     int8_t current_scale;
     int8_t current_note;
-    int8_t current_import_scale;
+    int current_import_scale; // Scala library scales follow the built-in ones
     int undo_value;
     bool length_set_mode;
     bool import_mode;
@@ -177,6 +174,9 @@ private:
     int octave;
     SegmentDisplay segment{SegmentSize::BIG_SEGMENTS};
     SegmentDisplay tinynumbers{SegmentSize::TINY_SEGMENTS};
+#ifdef __IMXRT1062__
+    OC::ScaleLibrary::Entry import_entry;
+#endif
 
     void DrawInterface() const {
         // The interface is a spreadsheet-like 4x4 grid, with each
@@ -223,6 +223,19 @@ private:
 
     void DrawImportScreen() const {
         gfxPrint(0, 15, "Import");
+#ifdef __IMXRT1062__
+        if (OC::scale_library.indexing()) {
+            gfxPrint(48, 15, "Scan ");
+            gfxPrint(int(OC::scale_library.indexed()));
+        }
+        if (current_import_scale >= OC::Scales::NUM_SCALES) {
+            gfxPrint(0, 25, "Scala ");
+            gfxPrint(current_import_scale - OC::Scales::NUM_SCALES + 1);
+            gfxPrint("/");
+            gfxPrint(int(OC::scale_library.size()));
+            gfxPrint(0, 35, import_entry.name);
+        } else
+#endif
         gfxPrint(0, 35, OC::scale_names[current_import_scale]);
         gfxCursor(0, 43, 127);
 
@@ -273,9 +286,17 @@ private:
     }
 
     void ChangeImport(int direction) {
-      current_import_scale = constrain(
-        current_import_scale + direction, 0, OC::Scales::NUM_SCALES - 1
-      );
+      int last = OC::Scales::NUM_SCALES - 1;
+#ifdef __IMXRT1062__
+      last += OC::scale_library.size();
+#endif
+      current_import_scale = constrain(current_import_scale + direction, 0, last);
+#ifdef __IMXRT1062__
+      // one entry read per step, so browsing hundreds of scales is cheap
+      if (current_import_scale >= OC::Scales::NUM_SCALES
+          && !OC::scale_library.Read(current_import_scale - OC::Scales::NUM_SCALES, import_entry))
+        current_import_scale = OC::Scales::NUM_SCALES - 1;
+#endif
     }
 
     void ChangeLength(int direction) {
@@ -322,8 +343,15 @@ private:
     }
 
     void ImportScale() {
-        OC::Scale source = OC::Scales::GetScale(current_import_scale);
-        memcpy(&OC::user_scales[current_scale], &source, sizeof(source));
+#ifdef __IMXRT1062__
+        if (current_import_scale >= OC::Scales::NUM_SCALES) {
+            import_entry.CopyTo(OC::user_scales[current_scale]);
+        } else
+#endif
+        {
+            OC::Scale source = OC::Scales::GetScale(current_import_scale);
+            memcpy(&OC::user_scales[current_scale], &source, sizeof(source));
+        }
         HS::q_engine[0].quantizer.Configure(OC::Scales::GetScale(current_scale), 0xffff);
         QuantizeCurrent();
         import_mode = 0;
@@ -394,8 +422,11 @@ void AppScaleEditor::HandleButtonEvent(const UI::Event &event) {
     // For right encoder, only handle press (long press is reserved)
     if (event.control == OC::CONTROL_BUTTON_R && event.type == UI::EVENT_BUTTON_PRESS) OnRightButtonPress();
 
-    // For up button, handle only press (long press is reserved)
-    if (event.control == OC::CONTROL_BUTTON_A && event.type == UI::EVENT_BUTTON_PRESS) OnDownButtonPress();
+    // For up button, handle press, and long press while importing
+    if (event.control == OC::CONTROL_BUTTON_A) {
+        if (event.type == UI::EVENT_BUTTON_PRESS) OnDownButtonPress();
+        if (event.type == UI::EVENT_BUTTON_LONG_PRESS && import_mode) OnImportLongPress();
+    }
 
     // For down button, handle press and long press
     if (event.control == OC::CONTROL_BUTTON_B) {
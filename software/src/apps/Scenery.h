@@ -118,7 +118,7 @@ struct ScenePreset {
       }
     }
     valid = true;
-    PhzConfig::save_config(SCENERY_SAVEFILE);
+    PhzConfig::defer_save(SCENERY_SAVEFILE);
   }
 };
 #else // Teensy 3.2 uses EEPROM
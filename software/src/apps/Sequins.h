@@ -44,10 +44,10 @@ static constexpr uint8_t MULT_BY_ONE = 19; // default multiplication
 static constexpr uint8_t PULSEW_MAX = 255; // max pulse width [ms]
 
 static constexpr uint32_t SCALE_PULSEWIDTH = 58982; // 0.9 for signed_multiply_32x16b
-static constexpr uint32_t TICKS_TO_MS = 43691; // 0.6667f : fraction, if TU_CORE_TIMER_RATE = 60 us : 65536U * ((1000 / TU_CORE_TIMER_RATE) - 16)
+static constexpr uint32_t TICKS_PER_MS = (uint64_t(1000000) << 16) / OC_CORE_ISR_PERIOD_NS; // 16.16 fixed point
 static constexpr uint32_t TICK_JITTER = 0xFFFFFFF;  // 1/16 : threshold/double triggers reject -> ext_frequency_in_ticks_
 static constexpr uint32_t TICK_SCALE  = 0xC0000000; // 0.75 for signed_multiply_32x32
-static constexpr uint32_t COPYTIMEOUT = 200000; // in ticks
+static constexpr uint32_t COPYTIMEOUT = OC_CORE_TICKS_MS(12000); // in ticks
 
 void SEQ_leftButton();
 void SEQ_leftButtonLong();
@@ -893,7 +893,7 @@ public:
 
   bool update_timeout() {
     // wait for ~ 1.5 sec
-    return (subticks_ > 30000) ? true : false;
+    return (subticks_ > OC_CORE_TICKS_MS(1800)) ? true : false;
   }
 
   /* main channel update below: */
@@ -1272,9 +1272,7 @@ public:
             // recalculate (in ticks), if new pulsewidth setting:
             if (prev_pulsewidth_ != _pulsewidth || ! subticks_) {
                 if (!_gates || _we_cannot_echo) {
-                  int32_t _fraction = signed_multiply_32x16b(TICKS_TO_MS, static_cast<int32_t>(_pulsewidth)); // = * 0.6667f
-                  _fraction = signed_saturate_rshift(_fraction, 16, 0);
-                  pulse_width_in_ticks_  = (_pulsewidth << 4) + _fraction;
+                  pulse_width_in_ticks_ = (uint64_t(TICKS_PER_MS) * _pulsewidth) >> 16;
                 }
                 else { // put out gates/half duty cycle:
                   pulse_width_in_ticks_ = channel_frequency_in_ticks_ >> 1;
@@ -43,7 +43,7 @@
 
 #define DT_CV_TIMELINE 0
 #define DT_PROBABILITY_TIMELINE 1
-#define DT_SETUP_SCREEN_TIMEOUT 166667
+#define DT_SETUP_SCREEN_TIMEOUT OC_CORE_TICKS_MS(10000)
 
 enum {
     DT_LENGTH,
@@ -280,10 +280,7 @@ public:
                 V[ix++] = cv & 0xff; // Low byte
                 V[ix++] = (cv >> 8) & 0xff; // High byte
             }
-            UnpackedData unpacked;
-            unpacked.set_data(ix, V);
-            PackedData packed = unpacked.pack();
-            SendSysEx(packed, 'D');
+            SendSysEx(V, ix, 'D');
         }
 
         // Send a fifth page containing metadata
@@ -293,10 +290,7 @@ public:
         V[ix++] = static_cast<char>(index());
         V[ix++] = static_cast<char>(scale());
         V[ix++] = static_cast<char>(root());
-        UnpackedData unpacked;
-        unpacked.set_data(ix, V);
-        PackedData packed = unpacked.pack();
-        SendSysEx(packed, 'D');
+        SendSysEx(V, ix, 'D');
     }
 
     void OnReceiveSysEx() {
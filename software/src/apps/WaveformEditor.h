@@ -97,7 +97,7 @@ public:
     }
 
     void OnSendSysEx() { // Left Enc Push
-        uint8_t V[33];
+        uint8_t sysex[SYSEX_DATA_MAX_SIZE];
 
         // There are 64 waveform segments, each containing two bytes. These will be
         // sent in four groups of 16 segments, for 32 bytes per segment. Each SysEx
@@ -105,25 +105,21 @@ public:
         // number.
         for (int gr = 0; gr < 4; gr++)
         {
-            int ix = 0;
-            V[ix++] = gr; // Add the group number, for future decoding
+            util::SysExPacker packer = BeginSysEx(sysex, 'W');
+            packer.Write<uint8_t>(gr); // Add the group number, for future decoding
             for (int s = 0; s < 16; s++)
             {
                 int seg_ix = (gr * 4) + s; // Segment index
-                V[ix++] = HS::user_waveforms[seg_ix].level;
-                V[ix++] = HS::user_waveforms[seg_ix].time;
+                packer.Write<uint8_t>(HS::user_waveforms[seg_ix].level);
+                packer.Write<uint8_t>(HS::user_waveforms[seg_ix].time);
             }
-
-            UnpackedData unpacked;
-            unpacked.set_data(ix, V);
-            PackedData packed = unpacked.pack();
-            SendSysEx(packed, 'W');
+            EndSysEx(sysex, packer);
         }
     }
 
     void OnReceiveSysEx() {
         uint8_t V[35];
-        if (ExtractSysExData(V, 'W')) {
+        if (ExtractSysExData(V, 'W', sizeof(V))) {
             int ix = 0;
             int gr = V[ix++];
             for (int s = 0; s < 16; s++)
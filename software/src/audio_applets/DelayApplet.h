@@ -39,7 +39,7 @@ public:
   void Controller() {
     clock_count++;
     if (clock_source.Clock()) {
-      clock_base_secs = clock_count / 16666.0f;
+      clock_base_secs = clock_count / float(OC_CORE_ISR_FREQ);
       clock_count = 0;
     }
 
@@ -378,8 +378,9 @@ protected:
 
 private:
   // Uses 1MB of psram and gives just under 12 secs of delay time.
+  // Both this and the no-psram fallback are powers of two.
   static const size_t DELAY_LENGTH = 1024 * 512;
-  using DelayStream = AudioDelayExt<9>;
+  using DelayStream = AudioDelayExt<9, 8, 2048, true>;
 
   enum Cursor {
     CLOCK_SOURCE,
@@ -10,6 +10,7 @@ public:
   void Start() override {
     interp_stream.Acquire();
     interp_stream.Method(static_cast<InterpolationMethod>(method));
+    interp_stream.Adaptive(true);
 
     for (int c = 0; c < Channels; c++) {
       PatchCable(interp_stream, 0, mixer[c], 0);
@@ -51,6 +52,9 @@ public:
       case INTERPOLATION_LINEAR:
         gfxPrint("Lin");
         break;
+      case INTERPOLATION_SINC:
+        gfxPrint("Snc");
+        break;
       case INTERPOLATION_HERMITE:
       default:
         gfxPrint("Spl");
@@ -100,7 +104,7 @@ public:
         input.ChangeSource(direction);
         break;
       case 1:
-        method = constrain(method + direction, 0, 2);
+        method = constrain(method + direction, 0, 3);
         interp_stream.Method(static_cast<InterpolationMethod>(method));
         break;
       case 2:
@@ -121,7 +125,7 @@ public:
     UnpackPackables(data[0], pack(gain), pack<1>(ac_couple), pack<2>(method));
     UnpackPackables(data[1], input, gain_cv);
     CONSTRAIN(gain, LVL_MIN_DB, LVL_MAX_DB);
-    CONSTRAIN(method, 0, 2);
+    CONSTRAIN(method, 0, 3);
   }
 
   AudioStream* InputStream() override {
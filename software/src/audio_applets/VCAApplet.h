@@ -14,6 +14,8 @@ public:
     // Less CPU than hermite, but I couldn't hear the difference whereas I could
     // with ZOH
     cv_stream.Method(INTERPOLATION_LINEAR);
+    // Track the core clock, so level changes don't glitch when it drifts
+    cv_stream.Adaptive(true);
     cv_stream.Acquire();
     for (int i = 0; i < Channels; i++) {
       PatchCable(input, i, vcas[i], 0);
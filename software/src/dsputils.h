@@ -87,8 +87,8 @@ static const float EQUAL_POWER_EQUAL_MIX[]{
 };
 
 // From https://signalsmith-audio.co.uk/writing/2021/cheap-energy-crossfade/
-// Could use a LUT, but meh
-inline void EqualPowerFade(float& fade_out, float& fade_in, float t) {
+// constexpr so DspTables can build its crossfade tables from it
+constexpr void EqualPowerFade(float& fade_out, float& fade_in, float t) {
   float mt = 1.0f - t;
   float a = t * mt;
   float b = a * (1.0f + 1.4186f * a);
@@ -31,7 +31,7 @@
 
 namespace display {
 
-extern FrameBuffer<SH1106_128x64_Driver::kFrameSize, 2> frame_buffer;
+extern FrameBuffer<SH1106_128x64_Driver::kFrameSize, 2, SH1106_128x64_Driver::kNumPages> frame_buffer;
 extern PagedDisplayDriver<SH1106_128x64_Driver> driver;
 
 void Init();
@@ -39,6 +39,14 @@ void AdjustOffset(uint8_t offset);
 void SetFlipMode(bool flip180);
 void SetContrast(uint8_t contrast);
 
+// Transfer statistics; identical frames count as all pages skipped
+static inline uint32_t pages_sent() {
+  return driver.pages_sent();
+}
+static inline uint32_t pages_skipped() {
+  return driver.pages_skipped() + frame_buffer.frames_skipped() * SH1106_128x64_Driver::kNumPages;
+}
+
 static inline void Flush() __attribute__((always_inline));
 static inline void Flush() {
 	if (driver.Flush())
@@ -51,7 +59,7 @@ static inline void Update() {
     driver.Update();
   } else {
     if (frame_buffer.readable())
-      driver.Begin(frame_buffer.readable_frame());
+      driver.Begin(frame_buffer.readable_frame(), frame_buffer.readable_dirty_mask());
   }
 }
 
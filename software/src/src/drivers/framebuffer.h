@@ -13,12 +13,21 @@
 // but allows a new frame to be written while the old one is being
 // transferred.
 // See https://gist.github.com/patrickdowling/0029f58fb20e63d7db9d
-
-template <size_t frame_size, size_t frames>
+//
+// Each written frame is compared page-by-page against the previous one, so the
+// driver only needs to transfer pages that changed; a frame identical to the
+// previous one isn't queued at all. Since the previous frame is either still
+// queued or was the last one transferred, it's always what the display shows
+// before the new one.
+
+template <size_t frame_size, size_t frames, size_t pages = 8>
 class FrameBuffer {
 public:
 
   static const size_t kFrameSize = frame_size;
+  static const size_t kPageSize = frame_size / pages;
+  static_assert(frames >= 2, "Dirty tracking needs the previous frame");
+  static_assert(pages <= 32, "Dirty mask is 32 bits");
 
   FrameBuffer() { }
 
@@ -29,6 +38,14 @@ public:
     write_ptr_ = read_ptr_ = 0;
     capture_on_next_write = false;
     capture_is_valid = false;
+    frames_skipped_ = 0;
+    invalidate();
+  }
+
+  // Force all pages of the next frame to be transferred, e.g. after the
+  // display RAM was changed behind our back
+  void invalidate() {
+    force_full_frame_ = true;
   }
 
   size_t writeable() const {
@@ -44,6 +61,11 @@ public:
     return frame_buffers_[read_ptr_ % frames];
   }
 
+  // @return bitmask of pages in readable frame that changed
+  uint32_t readable_dirty_mask() const {
+    return dirty_mask_[read_ptr_ % frames];
+  }
+
   // @return next writeable frame (assumes one exists)
   uint8_t *writeable_frame() {
     return frame_buffers_[write_ptr_ % frames];
@@ -59,7 +81,21 @@ public:
       memcpy(capture_memory_, frame_buffers_[write_ptr_ % frames], kFrameSize);
       capture_is_valid = true;
     }
-    ++write_ptr_;
+
+    const size_t write_ptr = write_ptr_;
+    const uint32_t dirty = diff_pages(frame_buffers_[write_ptr % frames],
+                                      frame_buffers_[(write_ptr - 1) % frames]);
+    if (!dirty) {
+      ++frames_skipped_;
+      return; // slot is re-used for next frame
+    }
+    dirty_mask_[write_ptr % frames] = dirty;
+    write_ptr_ = write_ptr + 1;
+  }
+
+  // Frames not queued because they were identical to the previous one
+  uint32_t frames_skipped() const {
+    return frames_skipped_;
   }
 
   void capture_request() {
@@ -71,9 +107,26 @@ public:
   void capture_retire() {
     capture_is_valid = false;
   }
+  void capture_cancel() {
+    capture_on_next_write = false;
+    capture_is_valid = false;
+  }
 
 private:
 
+  uint32_t diff_pages(const uint8_t *frame, const uint8_t *prev) {
+    if (force_full_frame_) {
+      force_full_frame_ = false;
+      return (uint32_t)(((uint64_t)1 << pages) - 1);
+    }
+    uint32_t dirty = 0;
+    for (size_t p = 0; p < pages; ++p) {
+      if (memcmp(frame + p * kPageSize, prev + p * kPageSize, kPageSize))
+        dirty |= 1 << p;
+    }
+    return dirty;
+  }
+
   uint8_t frame_memory_[kFrameSize * frames] __attribute__ ((aligned (4)));
   uint8_t capture_memory_[kFrameSize] __attribute__ ((aligned (4)));
   uint8_t *frame_buffers_[frames];
@@ -82,6 +135,9 @@ private:
   volatile size_t read_ptr_;
   volatile bool capture_on_next_write;
   volatile bool capture_is_valid;
+  volatile bool force_full_frame_;
+  uint32_t dirty_mask_[frames];
+  uint32_t frames_skipped_;
 
   DISALLOW_COPY_AND_ASSIGN(FrameBuffer);
 };
@@ -7,6 +7,7 @@
 // In theory parts of the transfer may be done via DMA and the page memory
 // will have to be valid until that completes, so the ::Flush call is used
 // to determine if cleanup is necessary.
+// Pages not set in the dirty mask passed to ::Begin are skipped.
 template <typename display_driver>
 class PagedDisplayDriver {
 public:
@@ -19,21 +20,33 @@ public:
 
     current_page_index_ = 0;
     current_page_data_ = NULL;
+    dirty_mask_ = 0;
+    pages_sent_ = pages_skipped_ = 0;
   }
 
-  void Begin(const uint8_t *frame) {
+  void Begin(const uint8_t *frame, uint32_t dirty_mask = 0xffffffff) {
     current_page_data_ = frame;
     current_page_index_ = 0;
+    dirty_mask_ = dirty_mask;
   }
 
   void Update() {
     uint_fast8_t page = current_page_index_;
     const uint8_t *data = current_page_data_;
 
+    while (page < display_driver::kNumPages && !(dirty_mask_ & (1 << page))) {
+      ++page;
+      data += display_driver::kPageSize;
+      ++pages_skipped_;
+    }
+
     if (page < display_driver::kNumPages && display_driver::SendPage(page, data)) {
-      current_page_index_ = page + 1;
-      current_page_data_ = data + display_driver::kPageSize;
+      ++page;
+      data += display_driver::kPageSize;
+      ++pages_sent_;
     }
+    current_page_index_ = page;
+    current_page_data_ = data;
   }
 
   bool Flush() {
@@ -51,9 +64,20 @@ public:
     return NULL != current_page_data_;
   }
 
+  uint32_t pages_sent() const {
+    return pages_sent_;
+  }
+
+  uint32_t pages_skipped() const {
+    return pages_skipped_;
+  }
+
 private:
   uint_fast8_t current_page_index_;
   const uint8_t *current_page_data_;
+  uint32_t dirty_mask_;
+  uint32_t pages_sent_;
+  uint32_t pages_skipped_;
 
   DISALLOW_COPY_AND_ASSIGN(PagedDisplayDriver);
 };
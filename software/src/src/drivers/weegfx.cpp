@@ -529,10 +529,10 @@ void Graphics::print(uint16_t value, unsigned width)
   print(str);
 }
 
-void Graphics::print(uint32_t value, size_t width)
+void Graphics::print(uint32_t value, unsigned width)
 {
   char *str = itos<uint32_t, false>(value, print_buf, sizeof(print_buf));
-  while (str > print_buf && (size_t)(str - print_buf) >= sizeof(print_buf) - width) *--str = ' ';
+  while (str > print_buf && (unsigned)(str - print_buf) >= sizeof(print_buf) - width) *--str = ' ';
   print(str);
 }
 
@@ -53,6 +53,43 @@ void Quantizer::Init() {
   octave_constraint_max_ = 0;
 }
 
+void Quantizer::BuildTable() {
+  // The bucket candidates are only exact if the notes are sorted; user scales
+  // normally are, anything else falls back to the full scan.
+  table_valid_ = false;
+  if (span_ <= 0 || span_ > INT16_MAX) return;
+  for (int i = 1; i < num_notes_; ++i) {
+    if (notes_[i] < notes_[i - 1]) return;
+  }
+
+  bucket_shift_ = 0;
+  while ((span_ >> bucket_shift_) >= kMaxBuckets) ++bucket_shift_;
+
+  int16_t distance;
+  const int num_buckets = (span_ >> bucket_shift_) + 1;
+  for (int b = 0; b < num_buckets; ++b) {
+    const int16_t lo = b << bucket_shift_;
+    const int16_t hi = std::min<int32_t>(((b + 1) << bucket_shift_) - 1, span_);
+    const int16_t first = NearestNote(lo, 0, num_notes_ - 1, distance);
+    const int16_t last = NearestNote(hi, 0, num_notes_ - 1, distance);
+    buckets_[b] = first | (last << 4);
+  }
+  table_valid_ = true;
+}
+
+int16_t Quantizer::NearestNote(int16_t rel_pitch, int16_t first, int16_t last, int16_t &best_distance) const {
+  best_distance = 16384;
+  int16_t q = -1;
+  for (int16_t i = first; i <= last; i++) {
+    int16_t distance = abs(rel_pitch - notes_[i]);
+    if (distance < best_distance) {
+      best_distance = distance;
+      q = i;
+    }
+  }
+  return q;
+}
+
 int32_t Quantizer::Process(int32_t pitch, int32_t root, int32_t transpose) {
   if (!enabled_) {
     return pitch;
@@ -73,16 +110,17 @@ int32_t Quantizer::Process(int32_t pitch, int32_t root, int32_t transpose) {
     int16_t octave = pitch / span_ - (pitch < 0 ? 1 : 0);
     int16_t rel_pitch = pitch - span_ * octave;
 
-    int16_t best_distance = 16384;
-    int16_t q = -1;
-    for (int16_t i = 0; i < num_notes_; i++) {
-      int16_t distance = abs(rel_pitch - notes_[i]);
-      if (distance < best_distance) {
-        best_distance = distance;
-        q = i;
-      }
+    int16_t first = 0;
+    int16_t last = num_notes_ - 1;
+    if (table_valid_ && rel_pitch >= 0 && rel_pitch <= span_) {
+      const uint8_t bucket = buckets_[rel_pitch >> bucket_shift_];
+      first = bucket & 0xf;
+      last = bucket >> 4;
     }
 
+    int16_t best_distance;
+    int16_t q = NearestNote(rel_pitch, first, last, best_distance);
+
     if (abs(pitch - (octave + 1) * span_ - notes_[0]) < best_distance) {
       octave++;
       q = 0;
@@ -106,12 +144,14 @@ int32_t Quantizer::Process(int32_t pitch, int32_t root, int32_t transpose) {
         (NEIGHBOR_WEIGHT * next_boundary_ + CUR_WEIGHT * codeword_) >> 4;
 
     // apply transpose after setting boundaries
-    q += transpose;
-    octave += q / num_notes_;
-    q %= num_notes_;
-    if (q < 0) {
-      q += num_notes_;
-      octave--;
+    if (transpose) {
+      q += transpose;
+      octave += q / num_notes_;
+      q %= num_notes_;
+      if (q < 0) {
+        q += num_notes_;
+        octave--;
+      }
     }
 
     // apply octave constraint
@@ -34,6 +34,9 @@
 #ifndef BRAIDS_QUANTIZER_H_
 #define BRAIDS_QUANTIZER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 #include "../../util/util_macros.h"
 
 namespace braids {
@@ -54,7 +57,7 @@ enum OctaveConstraint {
 void SortScale(Scale &);
 class Quantizer {
  public:
-  Quantizer() {}
+  Quantizer() : span_(0), num_notes_(0), table_valid_(false) {}
   ~Quantizer() {}
 
   void Init();
@@ -66,13 +69,22 @@ class Quantizer {
   int32_t Process(int32_t pitch, int32_t root, int32_t transpose);
 
   void Configure(const Scale& scale, uint16_t mask = 0xffff) {
-    num_notes_ = 0;
+    int16_t notes[16];
+    uint8_t num_notes = 0;
     for (uint16_t i = 0; i < scale.num_notes; i++) {
-      if (mask & 1) notes_[num_notes_++] = scale.notes[i];
+      if (mask & 1) notes[num_notes++] = scale.notes[i];
       mask >>= 1;
     }
-    span_ = scale.span;
+    // Configure is called liberally from the UI; only rebuild on change
+    const bool changed = num_notes != num_notes_ || scale.span != span_ ||
+        memcmp(notes, notes_, num_notes * sizeof(int16_t));
+    if (changed) {
+      memcpy(notes_, notes, num_notes * sizeof(int16_t));
+      num_notes_ = num_notes;
+      span_ = scale.span;
+    }
     enabled_ = notes_ != NULL && num_notes_ != 0 && span_ != 0;
+    if (changed && enabled_) BuildTable();
   }
 
   bool enabled() const {
@@ -100,6 +112,14 @@ class Quantizer {
   int16_t ConstrainOctave(int16_t octave) const;
 
  private:
+  // The nearest note is a non-decreasing function of the pitch within the
+  // octave (for sorted notes), so each bucket of the [0, span] range only has
+  // to consider the notes nearest to its first and last pitch.
+  static constexpr int kMaxBuckets = 32;
+
+  void BuildTable();
+  int16_t NearestNote(int16_t rel_pitch, int16_t first, int16_t last, int16_t &best_distance) const;
+
   bool enabled_;
   int32_t codeword_;
   int32_t transpose_;
@@ -115,6 +135,10 @@ class Quantizer {
   uint16_t note_number_;
   bool requantize_;
 
+  bool table_valid_;
+  uint8_t bucket_shift_;
+  uint8_t buckets_[kMaxBuckets]; // first | last << 4
+
   DISALLOW_COPY_AND_ASSIGN(Quantizer);
 };
 
@@ -1528,24 +1528,8 @@ const uint32_t lut_increments_slow[] = {
 };
 */
 
-// phase_lut(13)
-const uint32_t lut_increments_med[] = {
-       3460, 3475, 3491, 3506, 3521, 3537, 3553, 3568, 3584, 3600, 3615,
-       3631, 3647, 3663, 3679, 3696, 3712, 3728, 3745, 3761, 3778, 3794,
-       3811, 3828, 3844, 3861, 3878, 3895, 3912, 3930, 3947, 3964, 3982,
-       3999, 4017, 4034, 4052, 4070, 4088, 4106, 4124, 4142, 4160, 4179,
-       4197, 4215, 4234, 4253, 4271, 4290, 4309, 4328, 4347, 4366, 4385,
-       4404, 4424, 4443, 4463, 4482, 4502, 4522, 4542, 4562, 4582, 4602,
-       4622, 4643, 4663, 4683, 4704, 4725, 4746, 4766, 4787, 4808, 4830,
-       4851, 4872, 4894, 4915, 4937, 4958, 4980, 5002, 5024, 5046, 5068,
-       5091, 5113, 5135, 5158, 5181, 5203, 5226, 5249, 5272, 5296, 5319,
-       5342, 5366, 5389, 5413, 5437, 5461, 5485, 5509, 5533, 5557, 5582,
-       5606, 5631, 5656, 5681, 5706, 5731, 5756, 5781, 5807, 5832, 5858,
-       5884, 5909, 5935, 5962, 5988, 6014, 6040, 6067, 6094, 6121, 6147,
-       6174, 6202, 6229, 6256, 6284, 6311, 6339, 6367, 6395, 6423, 6451,
-       6480, 6508, 6537, 6566, 6594, 6623, 6653, 6682, 6711, 6741, 6770,
-       6800, 6830, 6860, 6890, 6920
-};
+// phase_lut(13): lut_increments_med is generated at compile time, see
+// frames_resources.h
 
 /*
 // phase_lut(12)
@@ -35,6 +35,8 @@
 
 
 #include <stdint.h>
+#include "../../OC_config.h"
+#include "../../util/util_constexpr_math.h"
 
 
 
@@ -59,7 +61,7 @@ extern const uint8_t* wt_table[];
 // extern const uint16_t lut_exponential[];
 // extern const uint32_t lut_increments_vslow[];
 // extern const uint32_t lut_increments_slow[];
-extern const uint32_t lut_increments_med[];
+// lut_increments_med is generated below
 // extern const uint32_t lut_increments_fast[];
 // extern const uint32_t lut_increments_vfast[];
 extern const uint8_t wt_lfo_waveforms[];
@@ -91,6 +93,20 @@ extern const uint8_t wt_lfo_waveforms[];
 #define WT_LFO_WAVEFORMS 0
 #define WT_LFO_WAVEFORMS_SIZE 4626
 
+// phase_lut() from frames_resources.cpp: one octave of phase increments from
+// 110 Hz * 2^-octave. Generated at compile time for the core ISR rate; the
+// checked-in tables were made for 16667 Hz.
+constexpr uint32_t PhaseIncrement(size_t i, int octave, double sample_rate) {
+  const double frequency = 110 * util::cmath::exp2(i / 158.0 - octave);
+  return static_cast<uint32_t>(util::cmath::round(frequency / sample_rate * 4294967296.0));
+}
+
+struct IncrementsMedAtCoreRate {
+  static constexpr uint32_t at(size_t i) { return PhaseIncrement(i, 13, 16667.0 * OC_CORE_ISR_RATE_SCALE); }
+};
+
+static constexpr auto &lut_increments_med = util::ConstexprTable<IncrementsMedAtCoreRate, LUT_INCREMENTS_MED_SIZE>::values;
+
 }  // namespace frames
 
 #endif  // FRAMES_RESOURCES_H_
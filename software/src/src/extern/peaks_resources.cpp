@@ -111,73 +111,8 @@ const uint16_t lut_delay_times[] = {
 };
 */
 
-const uint16_t lut_gravity[] = {
-   33140,  31065,  29132,  27330,
-   25650,  24084,  22621,  21256,
-   19981,  18790,  17676,  16634,
-   15660,  14748,  13894,  13094,
-   12344,  11642,  10983,  10365,
-    9785,   9240,   8729,   8249,
-    7797,   7373,   6973,   6598,
-    6244,   5912,   5598,   5303,
-    5025,   4763,   4516,   4283,
-    4063,   3855,   3659,   3474,
-    3299,   3134,   2978,   2830,
-    2690,   2558,   2433,   2315,
-    2203,   2097,   1996,   1901,
-    1811,   1725,   1644,   1567,
-    1494,   1425,   1359,   1297,
-    1237,   1181,   1127,   1077,
-    1028,    982,    938,    897,
-     857,    820,    784,    750,
-     717,    686,    657,    629,
-     602,    576,    552,    529,
-     506,    485,    465,    446,
-     427,    410,    393,    377,
-     362,    347,    333,    320,
-     307,    295,    283,    272,
-     261,    251,    241,    232,
-     223,    214,    206,    198,
-     191,    183,    176,    170,
-     163,    157,    151,    146,
-     140,    135,    130,    125,
-     121,    116,    112,    108,
-     104,    100,     97,     93,
-      90,     87,     84,     81,
-      78,     75,     73,     70,
-      68,     65,     63,     61,
-      59,     57,     55,     53,
-      51,     50,     48,     46,
-      45,     43,     42,     40,
-      39,     38,     37,     35,
-      34,     33,     32,     31,
-      30,     29,     28,     27,
-      26,     25,     25,     24,
-      23,     22,     22,     21,
-      20,     20,     19,     19,
-      18,     17,     17,     16,
-      16,     15,     15,     14,
-      14,     14,     13,     13,
-      12,     12,     12,     11,
-      11,     11,     10,     10,
-      10,      9,      9,      9,
-       9,      8,      8,      8,
-       8,      7,      7,      7,
-       7,      7,      6,      6,
-       6,      6,      6,      5,
-       5,      5,      5,      5,
-       5,      5,      4,      4,
-       4,      4,      4,      4,
-       4,      4,      3,      3,
-       3,      3,      3,      3,
-       3,      3,      3,      3,
-       3,      2,      2,      2,
-       2,      2,      2,      2,
-       2,      2,      2,      2,
-       2,      2,      2,      2,
-       2,      2,      1,      1,
-       1,
-};
+// lut_gravity is generated at compile time, see peaks_resources.h
+
 const uint16_t lut_env_linear[] = {
        0,    257,    514,    771,
     1028,   1285,   1542,   1799,
@@ -1284,73 +1219,7 @@ const uint32_t lut_lfo_increments[] = {
 };
 */
 
-const uint32_t lut_env_increments[] = {
-  515416692, 467165981, 424136651, 385689885,
-  351273767, 320410310, 292684581, 267735574,
-  245248504, 224948313, 206594161, 189974741,
-  174904307, 161219269, 148775289, 137444789,
-  127114809, 117685165, 109066861, 101180711,
-  93956148, 87330196, 81246566, 75654875,
-  70509966, 65771309, 61402477, 57370692,
-  53646419, 50203015, 47016415, 44064857,
-  41328639, 38789905, 36432455, 34241573,
-  32203878, 30307191, 28540417, 26893434,
-  25357006, 23922691, 22582767, 21330168,
-  20158417, 19061577, 18034198, 17071272,
-  16168198, 15320740, 14524999, 13777381,
-  13074574, 12413517, 11791388, 11205574,
-  10653662, 10133417, 9642769, 9179800,
-  8742730, 8329909, 7939804, 7570990,
-  7222144, 6892032, 6579509, 6283506,
-  6003027, 5737145, 5484993, 5245763,
-  5018701, 4803099, 4598299, 4403683,
-  4218675, 4042732, 3875349, 3716050,
-  3564389, 3419950, 3282340, 3151190,
-  3026155, 2906909, 2793146, 2684578,
-  2580936, 2481963, 2387420, 2297081,
-  2210732, 2128171, 2049210, 1973669,
-  1901379, 1832181, 1765922, 1702462,
-  1641664, 1583401, 1527554, 1474006,
-  1422650, 1373384, 1326111, 1280738,
-  1237178, 1195349, 1155172, 1116572,
-  1079479, 1043825, 1009547, 976584,
-  944879, 914376, 885024, 856772,
-  829575, 803386, 778163, 753866,
-  730455, 707894, 686147, 665181,
-  644964, 625465, 606654, 588506,
-  570991, 554086, 537766, 522008,
-  506790, 492090, 477889, 464167,
-  450906, 438088, 425695, 413713,
-  402124, 390916, 380073, 369581,
-  359428, 349601, 340089, 330879,
-  321960, 313323, 304957, 296852,
-  288999, 281389, 274014, 266864,
-  259933, 253212, 246694, 240373,
-  234241, 228293, 222520, 216919,
-  211483, 206206, 201083, 196109,
-  191278, 186587, 182031, 177605,
-  173305, 169126, 165066, 161119,
-  157283, 153554, 149928, 146403,
-  142974, 139639, 136396, 133240,
-  130170, 127183, 124276, 121447,
-  118693, 116012, 113402, 110861,
-  108387, 105977, 103630, 101343,
-   99116,  96946,  94832,  92771,
-   90763,  88806,  86898,  85039,
-   83225,  81458,  79734,  78052,
-   76413,  74813,  73253,  71731,
-   70246,  68797,  67383,  66002,
-   64655,  63341,  62057,  60804,
-   59581,  58386,  57220,  56080,
-   54968,  53881,  52819,  51782,
-   50769,  49778,  48811,  47865,
-   46941,  46038,  45155,  44293,
-   43449,  42624,  41817,  41029,
-   40258,  39503,  38766,  38044,
-   37338,  36648,  35972,  35311,
-   34665,  34032,  33412,  32806,
-   32213,
-};
+// lut_env_increments is generated at compile time, see peaks_resources.h
 
 /*
 const uint32_t lut_oscillator_increments[] = {
@@ -36,6 +36,8 @@
 
 //#include "stmlib/stmlib.h"
 #include <stdint.h>
+#include "../../OC_config.h"
+#include "../../util/util_constexpr_math.h"
 
 
 namespace peaks {
@@ -49,7 +51,7 @@ extern const uint16_t* lookup_table_table[];
 // extern const uint32_t* lookup_table_32_table[];
 
 // extern const uint16_t lut_delay_times[];
-extern const uint16_t lut_gravity[];
+// lut_gravity is generated below
 extern const uint16_t lut_env_linear[];
 extern const uint16_t lut_env_expo[];
 extern const uint16_t lut_env_quartic[];
@@ -66,7 +68,7 @@ extern const uint16_t lut_env_sinefold[];
 // extern const uint16_t lut_svf_damp[];
 // extern const uint16_t lut_svf_scale[];
 // extern const uint32_t lut_lfo_increments[];
-extern const uint32_t lut_env_increments[];
+// lut_env_increments is generated below
 // extern const uint32_t lut_oscillator_increments[];
 #define STR_DUMMY 0  // dummy
 // #define LUT_DELAY_TIMES 0
@@ -110,6 +112,46 @@ extern const uint32_t lut_env_increments[];
 // #define LUT_OSCILLATOR_INCREMENTS 2
 // #define LUT_OSCILLATOR_INCREMENTS_SIZE 97
 
+// The rate-dependent tables are generated at compile time for the core ISR
+// rate, with the formulas from res/peaks_lookup_tables.py.
+
+// Envelope segment increments, 0.5ms to 8s on an x^0.175 curve
+constexpr uint32_t EnvIncrement(size_t i, double sample_rate) {
+  constexpr double excursion = 4294967296.0;
+  constexpr double gamma = 0.175;
+  const double min_increment = excursion / (8.0 * sample_rate);
+  const double max_increment = excursion / (0.0005 * sample_rate);
+  const double start = util::cmath::pow(max_increment, -gamma);
+  const double stop = util::cmath::pow(min_increment, -gamma);
+  const double step = (stop - start) / (LUT_ENV_INCREMENTS_SIZE - 1);
+  const double rate = i == LUT_ENV_INCREMENTS_SIZE - 1 ? stop : i * step + start;
+  return static_cast<uint32_t>(util::cmath::pow(rate, -1 / gamma));
+}
+
+// Bouncing balls gravity, 15ms to 2s fall times. The checked-in table was
+// generated for Peaks' 48kHz rather than the core rate, and the applets are
+// tuned to that, so it keeps 48kHz as its reference.
+constexpr uint16_t Gravity(size_t i, double sample_rate) {
+  constexpr double gamma = 0.2;
+  const double start = util::cmath::pow(0.015, gamma);
+  const double stop = util::cmath::pow(2.0, gamma);
+  const double step = (stop - start) / (LUT_GRAVITY_SIZE - 1);
+  const double t = util::cmath::pow(i == LUT_GRAVITY_SIZE - 1 ? stop : i * step + start, 1 / gamma);
+  const double x = t * sample_rate / (2 * 65536.0);
+  return static_cast<uint16_t>(static_cast<int64_t>(1.0 / (x * x)));
+}
+
+struct EnvIncrementsAtCoreRate {
+  static constexpr uint32_t at(size_t i) { return EnvIncrement(i, OC_CORE_ISR_FREQ); }
+};
+struct GravityAtCoreRate {
+  static constexpr uint16_t at(size_t i) { return Gravity(i, 48000.0 * OC_CORE_ISR_RATE_SCALE); }
+};
+
+static constexpr auto &lut_env_increments =
+  util::ConstexprTable<EnvIncrementsAtCoreRate, LUT_ENV_INCREMENTS_SIZE>::values;
+static constexpr auto &lut_gravity = util::ConstexprTable<GravityAtCoreRate, LUT_GRAVITY_SIZE>::values;
+
 }  // namespace peaks
 
 #endif  // PEAKS_RESOURCES_H_
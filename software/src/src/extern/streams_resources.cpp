@@ -1357,74 +1357,7 @@ const uint32_t lut_log2[] = {
   589824,
 };
 */
-PROGMEM
-const uint32_t lut_lorenz_rate[] = {
-       3,      3,      3,      4,
-       4,      4,      4,      4,
-       5,      5,      5,      5,
-       6,      6,      6,      7,
-       7,      7,      8,      8,
-       8,      9,      9,     10,
-      10,     11,     11,     12,
-      12,     13,     13,     14,
-      15,     15,     16,     17,
-      18,     18,     19,     20,
-      21,     22,     23,     24,
-      25,     27,     28,     29,
-      30,     32,     33,     35,
-      36,     38,     40,     42,
-      44,     46,     48,     50,
-      52,     55,     57,     60,
-      63,     66,     69,     72,
-      75,     78,     82,     86,
-      90,     94,     98,    103,
-     107,    112,    118,    123,
-     129,    135,    141,    147,
-     154,    161,    168,    176,
-     184,    193,    201,    211,
-     220,    230,    241,    252,
-     263,    275,    288,    301,
-     315,    329,    344,    360,
-     377,    394,    412,    431,
-     451,    471,    493,    515,
-     539,    563,    589,    616,
-     644,    674,    705,    737,
-     770,    806,    843,    881,
-     921,    963,   1007,   1054,
-    1102,   1152,   1205,   1260,
-    1317,   1378,   1441,   1506,
-    1575,   1647,   1722,   1801,
-    1883,   1970,   2060,   2154,
-    2252,   2355,   2463,   2575,
-    2693,   2816,   2945,   3079,
-    3220,   3367,   3521,   3682,
-    3850,   4026,   4210,   4402,
-    4603,   4814,   5034,   5264,
-    5504,   5756,   6019,   6294,
-    6581,   6882,   7196,   7525,
-    7869,   8229,   8605,   8998,
-    9409,   9839,  10288,  10758,
-   11250,  11764,  12302,  12864,
-   13451,  14066,  14709,  15381,
-   16083,  16818,  17587,  18390,
-   19230,  20109,  21028,  21989,
-   22993,  24044,  25142,  26291,
-   27492,  28748,  30062,  31435,
-   32872,  34374,  35944,  37586,
-   39304,  41099,  42977,  44941,
-   46994,  49141,  51386,  53734,
-   56189,  58756,  61441,  64248,
-   67184,  70253,  73463,  76819,
-   80329,  83999,  87837,  91850,
-   96047, 100435, 105024, 109822,
-  114840, 120087, 125573, 131310,
-  137310, 143583, 150144, 157003,
-  164177, 171678, 179521, 187723,
-  196300, 205269, 214647, 224454,
-  234709, 245433, 256646, 268372,
-  280634, 293455, 306863, 320883,
-  335544,
-};
+// lut_lorenz_rate is generated at compile time, see streams_resources.h
 
 
 // const uint32_t* lookup_table_32_table[] = {
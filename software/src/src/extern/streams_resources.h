@@ -35,7 +35,9 @@
 
 
 // #include "stmlib/stmlib.h"
-
+#include <stdint.h>
+#include "../../OC_config.h"
+#include "../../util/util_constexpr_math.h"
 
 
 namespace streams {
@@ -65,7 +67,7 @@ extern const char* string_table[];
 //extern const uint32_t lut_lp_coefficients[];
 //extern const uint32_t lut_exp2[];
 //extern const uint32_t lut_log2[];
-extern const uint32_t lut_lorenz_rate[];
+// lut_lorenz_rate is generated below
 //#define STR_DUMMY 0  // dummy
 //#define WAV_GOMPERTZ 0
 //#define WAV_GOMPERTZ_SIZE 1025
@@ -100,6 +102,20 @@ extern const uint32_t lut_lorenz_rate[];
 #define LUT_LORENZ_RATE 4
 #define LUT_LORENZ_RATE_SIZE 257
 
+// Lorenz integration step, exponential over 16.5 octaves up to 2^24 / 50 at
+// the stock core rate. Generated at compile time for the core ISR rate, so the
+// attractor runs at the same speed at any rate.
+constexpr uint32_t LorenzRate(size_t i, double rate_scale) {
+  const double octaves = -(256.0 - i) * 16.5 / 256;
+  return static_cast<uint32_t>(16777216.0 / 50 * util::cmath::exp2(octaves) / rate_scale);
+}
+
+struct LorenzRateAtCoreRate {
+  static constexpr uint32_t at(size_t i) { return LorenzRate(i, OC_CORE_ISR_RATE_SCALE); }
+};
+
+static constexpr auto &lut_lorenz_rate = util::ConstexprTable<LorenzRateAtCoreRate, LUT_LORENZ_RATE_SIZE>::values;
+
 }  // namespace streams
 
 #endif  // STREAMS_RESOURCES_H_
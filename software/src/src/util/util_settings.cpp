@@ -35,14 +35,16 @@ struct StreamState {
   const ValueAttributes *attributes;
 };
 
-void flush_nibbles(StreamState &stream_state, util::StreamBufferWriter &stream_writer) {
+template <typename Writer>
+void flush_nibbles(StreamState &stream_state, Writer &stream_writer) {
   if (stream_state.nibbles) {
-    stream_writer.Write<uint8_t>(stream_state.nibbles & 0xff);
+    stream_writer.template Write<uint8_t>(stream_state.nibbles & 0xff);
     stream_state.nibbles = 0;
   }
 }
 
-void write_nibble(StreamState &stream_state, util::StreamBufferWriter &stream_writer, int value) {
+template <typename Writer>
+void write_nibble(StreamState &stream_state, Writer &stream_writer, int value) {
   if (stream_state.nibbles) {
     stream_state.nibbles |= (value & 0x0f);
     flush_nibbles(stream_state, stream_writer);
@@ -53,34 +55,35 @@ void write_nibble(StreamState &stream_state, util::StreamBufferWriter &stream_wr
   }
 }
 
-template <typename storage_type>
-void write_value(StreamState &stream_state, util::StreamBufferWriter &stream_writer, int value) {
+template <typename storage_type, typename Writer>
+void write_value(StreamState &stream_state, Writer &stream_writer, int value) {
   flush_nibbles(stream_state, stream_writer);
   stream_writer.Write(static_cast<storage_type>(value));
 }
 
-int read_nibble(StreamState &stream_state, util::StreamBufferReader &stream_reader) {
+template <typename Reader>
+int read_nibble(StreamState &stream_state, Reader &stream_reader) {
   uint8_t value;
   if (stream_state.nibbles) {
     value = stream_state.nibbles & 0x0f;
     stream_state.nibbles = 0;
   } else {
-    value = stream_reader.Read<uint8_t>();
+    value = stream_reader.template Read<uint8_t>();
     stream_state.nibbles = kNibbleValid | value;
     value >>= 4;
   }
   return value;
 }
 
-template <typename storage_type>
-int read_value(StreamState &stream_state, util::StreamBufferReader &stream_reader) {
+template <typename storage_type, typename Reader>
+int read_value(StreamState &stream_state, Reader &stream_reader) {
   stream_state.nibbles = 0;
-  storage_type value = stream_reader.Read<storage_type>();
+  storage_type value = stream_reader.template Read<storage_type>();
   return static_cast<int>(value);
 }
 
-/*static*/
-size_t SettingsRW::Write(const int values[], const ValueAttributes attributes[], size_t num_values, util::StreamBufferWriter &stream_writer)
+template <typename Writer>
+size_t write_values(const int values[], const ValueAttributes attributes[], size_t num_values, Writer &stream_writer)
 {
   auto stream_state = StreamState{attributes};
   for (size_t v = 0; v < num_values; ++v) {
@@ -100,8 +103,8 @@ size_t SettingsRW::Write(const int values[], const ValueAttributes attributes[],
   return stream_writer.written();
 }
 
-/*static*/
-size_t SettingsRW::Read(int values[], const ValueAttributes attributes[], size_t num_values, util::StreamBufferReader &stream_reader)
+template <typename Reader>
+size_t read_values(int values[], const ValueAttributes attributes[], size_t num_values, Reader &stream_reader)
 {
   auto stream_state = StreamState{attributes};
   for (size_t v = 0; v < num_values; ++v) {
@@ -122,5 +125,68 @@ size_t SettingsRW::Read(int values[], const ValueAttributes attributes[], size_t
   }
   return stream_reader.read();
 }
-  
+
+/*static*/
+size_t SettingsRW::Write(const int values[], const ValueAttributes attributes[], size_t num_values, util::StreamBufferWriter &stream_writer)
+{
+  return write_values(values, attributes, num_values, stream_writer);
+}
+
+/*static*/
+size_t SettingsRW::Write(const int values[], const ValueAttributes attributes[], size_t num_values, util::SysExPacker &packer)
+{
+  return write_values(values, attributes, num_values, packer);
+}
+
+/*static*/
+size_t SettingsRW::Read(int values[], const ValueAttributes attributes[], size_t num_values, util::StreamBufferReader &stream_reader)
+{
+  return read_values(values, attributes, num_values, stream_reader);
+}
+
+/*static*/
+size_t SettingsRW::Read(int values[], const ValueAttributes attributes[], size_t num_values, util::SysExUnpacker &unpacker)
+{
+  return read_values(values, attributes, num_values, unpacker);
+}
+
+/*static*/
+size_t SettingsRW::StorageSize(const ValueAttributes attributes[], size_t num_values)
+{
+  Nibbler nibbler;
+  for (size_t v = 0; v < num_values; ++v)
+    nibbler = nibbler.add(attributes[v].storage_type);
+  return (nibbler.value + 4) >> 3;
+}
+
+/*static*/
+size_t SettingsRW::ChunkLength(const ValueAttributes attributes[], size_t num_values, size_t max_bytes)
+{
+  Nibbler nibbler;
+  size_t v = 0;
+  for (; v < num_values; ++v) {
+    const Nibbler next = nibbler.add(attributes[v].storage_type);
+    if (((next.value + 4) >> 3) > max_bytes)
+      break;
+    nibbler = next;
+  }
+  return v;
+}
+
+/*static*/
+uint32_t SettingsRW::Hash(const int values[], size_t num_values)
+{
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (size_t v = 0; v < num_values; ++v) {
+    uint32_t value = static_cast<uint32_t>(values[v]);
+    for (int b = 0; b < 4; ++b, value >>= 8) {
+      hash ^= value & 0xff;
+      hash *= 16777619u;
+    }
+  }
+  return hash;
+}
+
+
 } // settings
@@ -1,8 +1,19 @@
 #pragma once
 #include <stdint.h>
+#include "OC_config.h"
+#include "util/util_constexpr_math.h"
+
+// Resolution of the pitch -> phase increment table; 4 (16/128 semitone) is
+// 97 entries and is what the stock firmware uses
+#ifndef TIDESLITE_INCREMENTS_STEP_BITS
+#define TIDESLITE_INCREMENTS_STEP_BITS 4
+#endif
+static_assert(TIDESLITE_INCREMENTS_STEP_BITS >= 1 && TIDESLITE_INCREMENTS_STEP_BITS <= 9,
+              "TIDESLITE_INCREMENTS_STEP_BITS out of range");
 
-static constexpr int LUT_INCREMENTS_SIZE = 97;
 static constexpr int16_t kOctave = 12 * 128;
+static constexpr int kIncrementsStepBits = TIDESLITE_INCREMENTS_STEP_BITS;
+static constexpr int LUT_INCREMENTS_SIZE = (kOctave >> kIncrementsStepBits) + 1;
 static constexpr uint16_t kSlopeBits = 12;
 
 enum TidesLiteFlagBitMask { FLAG_EOA = 1, FLAG_EOR = 2 };
@@ -13,47 +24,26 @@ struct TidesLiteSample {
   uint8_t flags;
 };
 
-/*
-import numpy as np
-
-sample_rate = 16666
-
-excursion = float(1 << 32)
+// Phase increments for one octave from C-1, one entry per
+// 2^TIDESLITE_INCREMENTS_STEP_BITS pitch units (1/128 semitone). Generated at
+// compile time for the core ISR rate, like the Python this replaced:
+//
+//   notes = np.arange(0 * 128.0, 12 * 128.0 + 16, 16) / 128.0
+//   pitches = a4_pitch * 2 **((notes - a4_midi) / 12)
+//   increments = excursion / sample_rate * pitches
+//   increments.astype(int)
+constexpr uint32_t TidesLiteIncrement(size_t i, double sample_rate) {
+  const double note = (i << kIncrementsStepBits) / 128.0;
+  const double pitch = 440.0 * util::cmath::exp2((note - 69) / 12);
+  return static_cast<uint32_t>(4294967296.0 / sample_rate * pitch);
+}
 
-a4_midi = 69
-a4_pitch = 440.0
-notes = np.arange(0 * 128.0, 12 * 128.0 + 16, 16) / 128.0
-pitches = a4_pitch * 2 **((notes - a4_midi) / 12)
-increments = excursion / sample_rate * pitches
+struct TidesLiteIncrementsAtCoreRate {
+  static constexpr uint32_t at(size_t i) { return TidesLiteIncrement(i, OC_CORE_ISR_FREQ); }
+};
 
-increments.astype(int)
-*/
-// TODO: The Python code -> hardcoded numbers could be replaced with a
-// `constexpr` function that returns the lut and stores it in the `constexpr`
-// global instead. The tough thing is most of the floating point math stuff is
-// not `constexpr`. So we'd need `constexpr` versions. There's probably a
-// library out there, though writing a `constexpr` version based on Taylor
-// series expansion wouldn't be too hard. Would have to just set the iterations
-// high enough to equal or exceed the precision of the standard library
-// functions. The upshot of this would be we could base the calculations off our
-// sample rate constants or whatever. Alternatively, looks like a lot of the
-// standard library functions will become `constexpr` in c++26... so I guess we
-// could do it if we ever update to that...
-
-constexpr uint32_t lut_increments[]
-  = {2106971, 2122239, 2137618, 2153108, 2168710, 2184425, 2200255, 2216199,
-     2232258, 2248434, 2264727, 2281138, 2297668, 2314318, 2331089, 2347981,
-     2364995, 2382133, 2399395, 2416782, 2434295, 2451935, 2469702, 2487599,
-     2505625, 2523782, 2542070, 2560491, 2579046, 2597734, 2616559, 2635519,
-     2654617, 2673854, 2693230, 2712746, 2732404, 2752204, 2772147, 2792235,
-     2812469, 2832850, 2853377, 2874054, 2894881, 2915858, 2936988, 2958270,
-     2979707, 3001300, 3023048, 3044954, 3067019, 3089244, 3111630, 3134178,
-     3156890, 3179766, 3202808, 3226017, 3249394, 3272940, 3296657, 3320546,
-     3344608, 3368845, 3393257, 3417846, 3442613, 3467560, 3492687, 3517996,
-     3543489, 3569167, 3595031, 3621082, 3647321, 3673751, 3700373, 3727187,
-     3754196, 3781401, 3808802, 3836402, 3864202, 3892204, 3920409, 3948818,
-     3977432, 4006254, 4035285, 4064527, 4093980, 4123647, 4153528, 4183626,
-     4213943};
+static constexpr auto &lut_increments =
+  util::ConstexprTable<TidesLiteIncrementsAtCoreRate, LUT_INCREMENTS_SIZE>::values;
 
 /*
 import numpy
@@ -162,9 +152,10 @@ constexpr uint32_t ComputePhaseIncrement(int16_t pitch) {
     ++num_shifts;
   }
   // Lookup phase increment
-  uint32_t a = lut_increments[pitch >> 4];
-  uint32_t b = lut_increments[(pitch >> 4) + 1];
-  uint32_t phase_increment = a + ((b - a) * (pitch & 0xf) >> 4);
+  uint32_t a = lut_increments[pitch >> kIncrementsStepBits];
+  uint32_t b = lut_increments[(pitch >> kIncrementsStepBits) + 1];
+  uint32_t phase_increment =
+    a + ((b - a) * (pitch & ((1 << kIncrementsStepBits) - 1)) >> kIncrementsStepBits);
   // Compensate for downsampling
   return num_shifts >= 0 ? phase_increment << num_shifts
                          : phase_increment >> -num_shifts;
@@ -200,7 +191,7 @@ constexpr int16_t ComputePitch(uint32_t phase_increment) {
       i = k;
     }
   }
-  pitch += (i << 4);
+  pitch += (i << kIncrementsStepBits);
   return pitch;
 }
 
@@ -0,0 +1,202 @@
+#ifndef UTIL_BUDDY_ARENA_H_
+#define UTIL_BUDDY_ARENA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace util {
+
+// Allocator for large, long-lived buffers in a fixed region, e.g. audio
+// effect buffers in PSRAM that come and go as applets are swapped.
+//
+// The region is split into ChunkBytes chunks and managed as a buddy system:
+// free space is kept in power-of-two size classes of chunks, and a freed
+// block merges with its buddy whenever both are free. So the free space
+// can't break up into pieces smaller than what was actually freed, which is
+// what happens to a general-purpose heap with buffers of many sizes. An
+// allocation takes the smallest block that fits and gives the unused tail
+// back, so a 1.4MB buffer costs 1.4MB rather than 2MB.
+//
+// Allocations are charged to an owner (e.g. an audio slot) with a budget.
+// Memory comes back zero-filled. Freed chunks are only marked dirty, and
+// clearing them is left for the next allocation that reuses them. Chunks
+// that were never used since Init() aren't cleared again.
+//
+// Bookkeeping lives in the object, not in the region, so the region is
+// only written when a buffer is zeroed.
+template <size_t ChunkBytes, size_t MaxChunks, uint8_t Owners>
+class BuddyArena {
+public:
+  static_assert(ChunkBytes && !(ChunkBytes & (ChunkBytes - 1)), "ChunkBytes must be a power of two");
+  static_assert(MaxChunks <= 0x8000, "Allocation lengths are 16 bit");
+  static constexpr size_t kChunkBytes = ChunkBytes;
+  static constexpr uint8_t kUnowned = Owners; // No budget
+
+  // Bytes actually set aside for an allocation of bytes
+  static constexpr size_t AllocationSize(size_t bytes) {
+    return bytes ? (bytes + ChunkBytes - 1) / ChunkBytes * ChunkBytes : ChunkBytes;
+  }
+
+  // zeroed: the region is already 0-filled, so the first use of each chunk
+  // needs no clearing
+  void Init(void *base, size_t bytes, bool zeroed = false) {
+    base_ = static_cast<uint8_t *>(base);
+    chunks_ = base_ ? bytes / ChunkBytes : 0;
+    if (chunks_ > MaxChunks) chunks_ = MaxChunks;
+    memset(free_order_, 0, sizeof(free_order_));
+    memset(length_, 0, sizeof(length_));
+    memset(owner_, 0, sizeof(owner_));
+    memset(dirty_, zeroed ? 0 : 0xff, sizeof(dirty_));
+    memset(used_, 0, sizeof(used_));
+    for (auto &budget : budget_) budget = SIZE_MAX;
+    FreeRange(0, chunks_);
+  }
+
+  // Zero-filled memory for at least bytes, or nullptr if the owner's budget
+  // or the free space won't cover it
+  void *Allocate(size_t bytes, uint8_t owner = kUnowned) {
+    if (owner > kUnowned) owner = kUnowned;
+    const size_t n = AllocationSize(bytes) / ChunkBytes;
+    if (n > chunks_) return nullptr;
+    if (owner != kUnowned && used_[owner] + n * ChunkBytes > budget_[owner]) return nullptr;
+
+    uint8_t order = 0;
+    while ((size_t(1) << order) < n) ++order;
+
+    // Smallest free block that fits, lowest address first
+    size_t start = chunks_;
+    uint8_t block_order = 0xff;
+    for (size_t i = 0; i < chunks_; ++i) {
+      const uint8_t o = free_order_[i];
+      if (o && o - 1 >= order && o - 1 < block_order) {
+        start = i;
+        block_order = o - 1;
+        if (block_order == order) break;
+      }
+    }
+    if (start == chunks_) return nullptr;
+
+    free_order_[start] = 0;
+    // Split down to size, then hand the unused tail back
+    while (block_order > order) {
+      --block_order;
+      free_order_[start + (size_t(1) << block_order)] = block_order + 1;
+    }
+    FreeRange(start + n, (size_t(1) << order) - n);
+
+    length_[start] = n;
+    owner_[start] = owner;
+    used_[owner] += n * ChunkBytes;
+    Clear(start, n);
+    return base_ + start * ChunkBytes;
+  }
+
+  void Free(void *p) {
+    if (!Owns(p)) return;
+    const size_t start = (static_cast<uint8_t *>(p) - base_) / ChunkBytes;
+    const size_t n = length_[start];
+    if (!n) return;
+    length_[start] = 0;
+    used_[owner_[start]] -= n * ChunkBytes;
+    for (size_t i = start; i < start + n; ++i) dirty_[i / 8] |= 1 << (i % 8);
+    FreeRange(start, n);
+  }
+
+  bool Owns(const void *p) const {
+    const uint8_t *b = static_cast<const uint8_t *>(p);
+    return base_ && b >= base_ && b < base_ + chunks_ * ChunkBytes;
+  }
+
+  void set_budget(uint8_t owner, size_t bytes) {
+    if (owner < kUnowned) budget_[owner] = bytes;
+  }
+
+  size_t budget(uint8_t owner) const {
+    return owner < kUnowned ? budget_[owner] : SIZE_MAX;
+  }
+
+  size_t used(uint8_t owner) const {
+    return owner <= kUnowned ? used_[owner] : 0;
+  }
+
+  size_t capacity() const {
+    return chunks_ * ChunkBytes;
+  }
+
+  size_t used() const {
+    size_t total = 0;
+    for (size_t u : used_) total += u;
+    return total;
+  }
+
+  size_t available() const {
+    return capacity() - used();
+  }
+
+  // Largest single allocation that would currently succeed, budgets aside
+  size_t largest_available() const {
+    uint8_t largest = 0;
+    for (size_t i = 0; i < chunks_; ++i) {
+      if (free_order_[i] > largest) largest = free_order_[i];
+    }
+    return largest ? (size_t(ChunkBytes) << (largest - 1)) : 0;
+  }
+
+private:
+  uint8_t *base_ = nullptr;
+  size_t chunks_ = 0;
+  // Per chunk: order + 1 if it starts a free block, 0 otherwise
+  uint8_t free_order_[MaxChunks];
+  // Per chunk: length in chunks if it starts an allocation, 0 otherwise
+  uint16_t length_[MaxChunks];
+  uint8_t owner_[MaxChunks];
+  uint8_t dirty_[(MaxChunks + 7) / 8];
+  size_t used_[Owners + 1];
+  size_t budget_[Owners];
+
+  // Free [start, start + n) as the aligned power-of-two blocks it's made of
+  void FreeRange(size_t start, size_t n) {
+    while (n) {
+      uint8_t order = 0;
+      while (!(start & (size_t(1) << order)) && (size_t(2) << order) <= n) ++order;
+      FreeBlock(start, order);
+      start += size_t(1) << order;
+      n -= size_t(1) << order;
+    }
+  }
+
+  void FreeBlock(size_t start, uint8_t order) {
+    for (;;) {
+      const size_t size = size_t(1) << order;
+      const size_t buddy = start ^ size;
+      if (buddy + size > chunks_ || free_order_[buddy] != order + 1) break;
+      free_order_[buddy] = 0;
+      if (buddy < start) start = buddy;
+      ++order;
+    }
+    free_order_[start] = order + 1;
+  }
+
+  // Zero the dirty chunks of [start, start + n), a run at a time
+  void Clear(size_t start, size_t n) {
+    size_t i = start;
+    const size_t end = start + n;
+    while (i < end) {
+      if (!(dirty_[i / 8] & (1 << (i % 8)))) {
+        ++i;
+        continue;
+      }
+      const size_t run = i;
+      while (i < end && (dirty_[i / 8] & (1 << (i % 8)))) {
+        dirty_[i / 8] &= ~(1 << (i % 8));
+        ++i;
+      }
+      memset(base_ + run * ChunkBytes, 0, (i - run) * ChunkBytes);
+    }
+  }
+};
+
+} // namespace util
+
+#endif // UTIL_BUDDY_ARENA_H_
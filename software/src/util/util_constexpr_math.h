@@ -0,0 +1,157 @@
+#ifndef UTIL_CONSTEXPR_MATH_H_
+#define UTIL_CONSTEXPR_MATH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+// Double precision math that can run at compile time, for generating lookup
+// tables from the configured sample rate instead of checking in numbers from
+// a Python script. Only +-*/ and comparisons are used, in a fixed order, and
+// the compiler evaluates those exactly as IEEE doubles, so a table comes out
+// the same on every host and target. Accuracy is within a couple of ulp of
+// libm over the ranges tables use; this isn't meant for runtime code.
+namespace util {
+namespace cmath {
+
+static constexpr double kLn2 = 0.693147180559945309417232121458176568;
+static constexpr double kLn2Hi = 6.93147180369123816490e-01; // upper 32 bits
+static constexpr double kLn2Lo = 1.90821492927058770002e-10;
+static constexpr double kPi = 3.14159265358979323846264338327950288;
+static constexpr double kPiOver2Hi = 1.57079632673412561417e+00; // upper 33 bits
+static constexpr double kPiOver2Lo = 6.07710050650619224932e-11;
+
+constexpr double floor(double x) {
+  const double t = static_cast<double>(static_cast<int64_t>(x));
+  return t > x ? t - 1.0 : t;
+}
+
+// numpy.round(), i.e. ties to even
+constexpr double round(double x) {
+  const double f = floor(x);
+  const double d = x - f;
+  if (d > 0.5) return f + 1.0;
+  if (d < 0.5) return f;
+  return static_cast<int64_t>(f) % 2 ? f + 1.0 : f;
+}
+
+// x * 2^n, exact
+constexpr double ldexp(double x, int n) {
+  for (; n > 0; --n) x *= 2.0;
+  for (; n < 0; ++n) x *= 0.5;
+  return x;
+}
+
+constexpr double exp(double x) {
+  // x = k * ln2 + r, |r| <= ln2 / 2
+  const int k = static_cast<int>(floor(x / kLn2 + 0.5));
+  const double r = (x - k * kLn2Hi) - k * kLn2Lo;
+  double sum = 1.0, term = 1.0;
+  for (int n = 1; n < 24; ++n) {
+    term *= r / n;
+    sum += term;
+  }
+  return ldexp(sum, k);
+}
+
+constexpr double exp2(double x) {
+  const double k = floor(x + 0.5);
+  return ldexp(exp((x - k) * kLn2), static_cast<int>(k));
+}
+
+// Natural log, x > 0
+constexpr double log(double x) {
+  // x = m * 2^e, sqrt(1/2) <= m < sqrt(2)
+  int e = 0;
+  while (x >= 1.4142135623730951) {
+    x *= 0.5;
+    ++e;
+  }
+  while (x < 0.7071067811865476) {
+    x *= 2.0;
+    --e;
+  }
+  // log(m) = 2 * atanh(s), s = (m - 1) / (m + 1), |s| < 0.172
+  const double s = (x - 1.0) / (x + 1.0);
+  const double s2 = s * s;
+  double sum = 0.0, power = s;
+  for (int n = 1; n < 40; n += 2) {
+    sum += power / n;
+    power *= s2;
+  }
+  return (e * kLn2Hi + 2.0 * sum) + e * kLn2Lo;
+}
+
+constexpr double log2(double x) {
+  return log(x) / kLn2;
+}
+
+// x^y, x > 0
+constexpr double pow(double x, double y) {
+  return exp(y * log(x));
+}
+
+namespace internal {
+
+// Taylor series around 0, good for |x| <= pi / 4
+constexpr double sin_kernel(double x) {
+  const double x2 = x * x;
+  double sum = x, term = x;
+  for (int n = 2; n < 30; n += 2) {
+    term *= -x2 / (n * (n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+constexpr double cos_kernel(double x) {
+  const double x2 = x * x;
+  double sum = 1.0, term = 1.0;
+  for (int n = 1; n < 30; n += 2) {
+    term *= -x2 / (n * (n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+// sin(x + quadrants * pi / 2), reducing x to |r| <= pi / 4 first
+constexpr double sin_quadrant(double x, int quadrants) {
+  const double q = floor(x / (kPi / 2) + 0.5);
+  const double r = (x - q * kPiOver2Hi) - q * kPiOver2Lo;
+  switch ((static_cast<int64_t>(q) + quadrants) & 3) {
+    case 0: return sin_kernel(r);
+    case 1: return cos_kernel(r);
+    case 2: return -sin_kernel(r);
+    default: return -cos_kernel(r);
+  }
+}
+
+} // namespace internal
+
+// For the few periods table generators need; precision drops with |x|
+constexpr double sin(double x) {
+  return internal::sin_quadrant(x, 0);
+}
+
+constexpr double cos(double x) {
+  return internal::sin_quadrant(x, 1);
+}
+
+} // namespace cmath
+
+// A lookup table filled at compile time: Generator::at(i) gives entry i.
+// The table is a plain array, so it can be indexed, interpolated and put in
+// pointer tables like a checked-in one.
+template <typename Generator, size_t Size, typename = std::make_index_sequence<Size>>
+struct ConstexprTable;
+
+template <typename Generator, size_t Size, size_t... I>
+struct ConstexprTable<Generator, Size, std::index_sequence<I...>> {
+  using value_type = decltype(Generator::at(0));
+  static constexpr size_t size = Size;
+  static constexpr value_type values[Size] = { Generator::at(I)... };
+};
+
+} // namespace util
+
+#endif // UTIL_CONSTEXPR_MATH_H_
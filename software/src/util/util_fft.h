@@ -0,0 +1,93 @@
+#ifndef UTIL_FFT_H_
+#define UTIL_FFT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "util_constexpr_math.h"
+
+namespace util {
+
+namespace internal {
+
+template <size_t N>
+struct FFTCos {
+  static constexpr float at(size_t i) {
+    return static_cast<float>(cmath::cos(2.0 * cmath::kPi * i / N));
+  }
+};
+
+template <size_t N>
+struct FFTSin {
+  static constexpr float at(size_t i) {
+    return static_cast<float>(cmath::sin(2.0 * cmath::kPi * i / N));
+  }
+};
+
+} // namespace internal
+
+// In-place radix-2 complex FFT of N points, N a power of two, on split real
+// and imaginary arrays. The twiddle factors are generated at compile time.
+// Neither direction scales; Forward then Inverse multiplies by N.
+template <size_t N>
+class FFT {
+public:
+  static_assert(N >= 2 && !(N & (N - 1)), "N must be a power of two");
+  static constexpr size_t size = N;
+
+  static void Forward(float *re, float *im) {
+    Transform(re, im, -1.0f);
+  }
+
+  static void Inverse(float *re, float *im) {
+    Transform(re, im, 1.0f);
+  }
+
+private:
+  using Cos = ConstexprTable<internal::FFTCos<N>, N / 2>;
+  using Sin = ConstexprTable<internal::FFTSin<N>, N / 2>;
+
+  static void Transform(float *re, float *im, float sign) {
+    // Bit reversal permutation
+    for (size_t i = 1, j = 0; i < N; ++i) {
+      size_t bit = N >> 1;
+      for (; j & bit; bit >>= 1) j ^= bit;
+      j |= bit;
+      if (i < j) {
+        float t = re[i]; re[i] = re[j]; re[j] = t;
+        t = im[i]; im[i] = im[j]; im[j] = t;
+      }
+    }
+
+    // First stage has no twiddles
+    for (size_t i = 0; i < N; i += 2) {
+      const float r = re[i + 1], m = im[i + 1];
+      re[i + 1] = re[i] - r;
+      im[i + 1] = im[i] - m;
+      re[i] += r;
+      im[i] += m;
+    }
+
+    for (size_t half = 2; half < N; half <<= 1) {
+      const size_t stride = N / (half << 1);
+      // Butterflies of a group are contiguous, so walk them in order
+      for (size_t i = 0; i < N; i += half << 1) {
+        float *r0 = re + i, *m0 = im + i;
+        float *r1 = r0 + half, *m1 = m0 + half;
+        for (size_t k = 0; k < half; ++k) {
+          const float wr = Cos::values[k * stride];
+          const float wi = sign * Sin::values[k * stride];
+          const float r = r1[k] * wr - m1[k] * wi;
+          const float m = r1[k] * wi + m1[k] * wr;
+          r1[k] = r0[k] - r;
+          m1[k] = m0[k] - m;
+          r0[k] += r;
+          m0[k] += m;
+        }
+      }
+    }
+  }
+};
+
+} // namespace util
+
+#endif // UTIL_FFT_H_
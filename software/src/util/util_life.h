@@ -0,0 +1,150 @@
+#ifndef UTIL_LIFE_H_
+#define UTIL_LIFE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace util {
+
+// Outer-totalistic cellular automaton rule ("B3/S23"): bit n of birth is set
+// if a dead cell with n live neighbours comes alive, bit n of survive if a
+// live cell with n neighbours stays alive.
+struct LifeRule {
+  uint16_t birth;
+  uint16_t survive;
+
+  static constexpr LifeRule Conway() { return { 1 << 3, (1 << 2) | (1 << 3) }; }
+  static constexpr LifeRule HighLife() { return { (1 << 3) | (1 << 6), (1 << 2) | (1 << 3) }; }
+  static constexpr LifeRule Seeds() { return { 1 << 2, 0 }; }
+  static constexpr LifeRule DayAndNight() {
+    return { (1 << 3) | (1 << 6) | (1 << 7) | (1 << 8),
+             (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8) };
+  }
+};
+
+// A 64 x Rows toroidal board, one uint64_t per row, that steps a whole
+// generation a row at a time with bitwise adders: the eight neighbour counts
+// of all 64 cells in a row are summed in parallel into four bit planes, and
+// the rule is applied to the planes. Bit x of row y is the cell at (x, y).
+template <size_t Rows>
+class LifeBoard {
+public:
+  static constexpr int kWidth = 64;
+  static constexpr int kHeight = Rows;
+
+  void Clear() {
+    for (size_t y = 0; y < Rows; ++y) rows_[y] = 0;
+  }
+
+  void SetRule(LifeRule rule) { rule_ = rule; }
+  LifeRule rule() const { return rule_; }
+
+  void Set(int x, int y, bool live = true) {
+    const uint64_t bit = uint64_t(1) << x;
+    rows_[y] = live ? rows_[y] | bit : rows_[y] & ~bit;
+  }
+
+  bool Get(int x, int y) const { return (rows_[y] >> x) & 1; }
+  uint64_t row(int y) const { return rows_[y]; }
+
+  // Advances one generation, returns the new population
+  uint32_t Step() {
+    // Row 0 is overwritten first but is the row below the last one
+    const uint64_t first = rows_[0];
+    uint64_t above = rows_[Rows - 1];
+    uint64_t above_sum, above_carry;
+    ThreeCells(above, above_sum, above_carry);
+    uint64_t sum, carry;
+    ThreeCells(first, sum, carry);
+
+    uint32_t population = 0;
+    for (size_t y = 0; y < Rows; ++y) {
+      const uint64_t row = rows_[y];
+      const uint64_t below = y + 1 < Rows ? rows_[y + 1] : first;
+      uint64_t below_sum, below_carry;
+      ThreeCells(below, below_sum, below_carry);
+
+      // Left and right neighbours in this row; the cell itself isn't counted
+      const uint64_t left = Rotate(row, 1), right = Rotate(row, kWidth - 1);
+      const uint64_t mid_sum = left ^ right, mid_carry = left & right;
+
+      // count = ones + 2 * twos, each from three rows of partial sums
+      uint64_t ones, ones_carry, twos, twos_carry;
+      FullAdd(above_sum, mid_sum, below_sum, ones, ones_carry);
+      FullAdd(above_carry, mid_carry, below_carry, twos, twos_carry);
+      const uint64_t b0 = ones;
+      const uint64_t b1 = ones_carry ^ twos;
+      const uint64_t b2 = twos_carry ^ (ones_carry & twos);
+      const uint64_t b3 = twos_carry & ones_carry & twos;
+
+      const uint64_t next = Apply(row, b0, b1, b2, b3);
+      rows_[y] = next;
+      population += __builtin_popcountll(next);
+
+      above_sum = sum;
+      above_carry = carry;
+      sum = below_sum;
+      carry = below_carry;
+    }
+    return population;
+  }
+
+  uint32_t Population() const {
+    uint32_t population = 0;
+    for (size_t y = 0; y < Rows; ++y) population += __builtin_popcountll(rows_[y]);
+    return population;
+  }
+
+  // Live cells in the rectangle [x0, x1] x [y0, y1], clipped to the board
+  // (no wrapping)
+  uint32_t PopulationIn(int x0, int y0, int x1, int y1) const {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > kWidth - 1) x1 = kWidth - 1;
+    if (y1 > kHeight - 1) y1 = kHeight - 1;
+    if (x0 > x1 || y0 > y1) return 0;
+
+    const uint64_t mask = (~uint64_t(0) >> (kWidth - 1 - x1)) & (~uint64_t(0) << x0);
+    uint32_t population = 0;
+    for (int y = y0; y <= y1; ++y) population += __builtin_popcountll(rows_[y] & mask);
+    return population;
+  }
+
+private:
+  uint64_t rows_[Rows] = {};
+  LifeRule rule_ = LifeRule::Conway();
+
+  static uint64_t Rotate(uint64_t row, int n) {
+    return (row << n) | (row >> (kWidth - n));
+  }
+
+  static void FullAdd(uint64_t a, uint64_t b, uint64_t c, uint64_t &sum, uint64_t &carry) {
+    const uint64_t ab = a ^ b;
+    sum = ab ^ c;
+    carry = (a & b) | (ab & c);
+  }
+
+  // Sum of each cell and its left and right neighbours, 0-3
+  static void ThreeCells(uint64_t row, uint64_t &sum, uint64_t &carry) {
+    FullAdd(Rotate(row, 1), row, Rotate(row, kWidth - 1), sum, carry);
+  }
+
+  uint64_t Apply(uint64_t row, uint64_t b0, uint64_t b1, uint64_t b2, uint64_t b3) const {
+    uint16_t counts = rule_.birth | rule_.survive;
+    uint64_t next = 0;
+    while (counts) {
+      const int n = __builtin_ctz(counts);
+      counts &= counts - 1;
+      const uint64_t match = (n & 1 ? b0 : ~b0) & (n & 2 ? b1 : ~b1) &
+                             (n & 4 ? b2 : ~b2) & (n & 8 ? b3 : ~b3);
+      const uint64_t born = (rule_.birth >> n) & 1 ? ~row : 0;
+      const uint64_t stays = (rule_.survive >> n) & 1 ? row : 0;
+      next |= match & (born | stays);
+    }
+    return next;
+  }
+};
+
+} // namespace util
+
+#endif // UTIL_LIFE_H_
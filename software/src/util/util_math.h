@@ -74,48 +74,75 @@ constexpr int Atten(int8_t att) {
 
 inline int32_t SSAT16(int32_t value) __attribute__((always_inline));
 inline int32_t SSAT16(int32_t value) {
+#ifdef __arm__
   int32_t result;
   __asm("ssat %0, %1, %2" : "=r" (result) : "I" (16),  "r" (value));
   return result;
+#else
+  return value < -32768 ? -32768 : (value > 32767 ? 32767 : value);
+#endif
 }
 
 inline uint32_t USAT16(uint32_t value) __attribute__((always_inline));
 inline uint32_t USAT16(uint32_t value) {
+#ifdef __arm__
   uint32_t result;
   __asm("usat %0, %1, %2" : "=r" (result) : "I" (16), "r" (value));
   return result;
+#else
+  // usat treats the operand as signed
+  return int32_t(value) < 0 ? 0 : (value > 65535 ? 65535 : value);
+#endif
 }
 
 inline uint32_t USAT16(int32_t value) __attribute__((always_inline));
 inline uint32_t USAT16(int32_t value) {
+#ifdef __arm__
   uint32_t result;
   __asm("usat %0, %1, %2" : "=r" (result) : "I" (16), "r" (value));
   return result;
+#else
+  return value < 0 ? 0 : (value > 65535 ? 65535 : value);
+#endif
 }
 
 static inline uint32_t multiply_u32xu32_rshift24(uint32_t a, uint32_t b) __attribute__((always_inline));
 static inline uint32_t multiply_u32xu32_rshift24(uint32_t a, uint32_t b)
 {
+#ifdef __arm__
   uint32_t lo, hi;
   asm volatile("umull %0, %1, %2, %3" : "=r" (lo), "=r" (hi) : "r" (a), "r" (b));
   return (lo >> 24) | (hi << 8);
+#else
+  return (uint32_t)(((uint64_t)a * b) >> 24);
+#endif
 }
 
 static inline uint32_t multiply_u32xu32_rshift(uint32_t a, uint32_t b, uint32_t shift) __attribute__((always_inline));
 static inline uint32_t multiply_u32xu32_rshift(uint32_t a, uint32_t b, uint32_t shift)
 {
+#ifdef __arm__
   uint32_t lo, hi;
   asm volatile("umull %0, %1, %2, %3" : "=r" (lo), "=r" (hi) : "r" (a), "r" (b));
   return (lo >> shift) | (hi << (32 - shift));
+#else
+  return (uint32_t)(((uint64_t)a * b) >> shift);
+#endif
 }
 
 
 static inline uint32_t uhadd16(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline uint32_t uhadd16(uint32_t a, uint32_t b)
 {
+#ifdef __arm__
   uint32_t out;
   asm volatile("uhadd16 %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
   return out;
+#else
+  uint32_t lo = ((a & 0xffff) + (b & 0xffff)) >> 1;
+  uint32_t hi = ((a >> 16) + (b >> 16)) >> 1;
+  return (hi << 16) | lo;
+#endif
 }
 
 template <typename T, T smoothing>
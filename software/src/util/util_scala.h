@@ -0,0 +1,193 @@
+#ifndef UTIL_SCALA_H_
+#define UTIL_SCALA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+namespace util {
+
+// Streaming parser for Scala tuning files (.scl, see
+// https://www.huygens-fokker.org/scala/scl_format.html). Bytes are fed as
+// they're read, in chunks of any size, and only one line is buffered, so a
+// file can be parsed straight from a small read buffer without allocating.
+//
+// Pitches come out in 1/128 semitone, as used by braids::Scale. The first
+// kMaxNotes - 1 pitches are kept (the implicit 0 is notes()[0]), and the
+// last one, the period, becomes the span.
+class ScalaParser {
+public:
+  static constexpr size_t kMaxNotes = 16;
+  static constexpr size_t kNameLength = 24; // including terminator
+  static constexpr size_t kLineLength = 48; // longer lines are truncated
+  static constexpr int16_t kMinSpan = 12 << 7;
+  static constexpr int16_t kMaxSpan = 24 << 7;
+
+  ScalaParser() { Reset(); }
+
+  void Reset() {
+    state_ = STATE_DESCRIPTION;
+    line_length_ = 0;
+    name_[0] = '\0';
+    count_ = 0;
+    num_notes_ = 0;
+    pitches_ = 0;
+    period_ = 0;
+    notes_[0] = 0;
+  }
+
+  // @return false once everything has been read; the rest can be skipped
+  bool Parse(const char *data, size_t length) {
+    for (size_t i = 0; i < length && state_ != STATE_DONE; ++i) Parse(data[i]);
+    return state_ != STATE_DONE;
+  }
+
+  void Parse(char c) {
+    if (c == '\n') {
+      line_[line_length_] = '\0';
+      ParseLine();
+      line_length_ = 0;
+    } else if (c != '\r' && line_length_ < kLineLength - 1) {
+      line_[line_length_++] = c;
+    }
+  }
+
+  // Call at the end of the file, for a last line without a newline.
+  // @return true if there was a pitch for every note
+  bool Finish() {
+    if (line_length_) Parse('\n');
+    return num_notes_ && pitches_ >= num_notes_ - 1;
+  }
+
+  // The description line, truncated
+  const char *name() const { return name_; }
+  // Notes including the implicit 0, at least 2
+  size_t num_notes() const { return num_notes_; }
+  const int16_t *notes() const { return notes_; }
+
+  // The period, or one or two octaves if the file stops before it (as
+  // files written by O_C before it saved the period do)
+  int16_t span() const {
+    if (period_) return period_ < kMinSpan ? kMinSpan : period_ > kMaxSpan ? kMaxSpan : period_;
+    for (size_t i = 1; i < num_notes_; ++i) {
+      if (notes_[i] > kMinSpan) return kMaxSpan;
+    }
+    return kMinSpan;
+  }
+
+private:
+  enum State {
+    STATE_DESCRIPTION,
+    STATE_COUNT,
+    STATE_PITCHES,
+    STATE_DONE,
+  };
+
+  State state_;
+  char line_[kLineLength];
+  size_t line_length_;
+  char name_[kNameLength];
+  size_t count_;     // pitches in the file
+  size_t num_notes_; // kept
+  size_t pitches_;   // read so far
+  int16_t period_;
+  int16_t notes_[kMaxNotes];
+
+  void ParseLine() {
+    if (line_[0] == '!') return;
+
+    switch (state_) {
+      case STATE_DESCRIPTION: {
+        // may be empty; leading spaces are kept, trailing ones aren't
+        size_t n = 0;
+        while (n < kNameLength - 1 && line_[n]) {
+          name_[n] = line_[n];
+          ++n;
+        }
+        while (n && name_[n - 1] == ' ') --n;
+        name_[n] = '\0';
+        state_ = STATE_COUNT;
+        break;
+      }
+      case STATE_COUNT: {
+        float value;
+        if (!ParseNumber(line_, value, nullptr) || value < 1.0f) {
+          state_ = STATE_DONE;
+          break;
+        }
+        count_ = static_cast<size_t>(value);
+        num_notes_ = count_ < 2 ? 2 : count_ > kMaxNotes ? kMaxNotes : count_;
+        state_ = STATE_PITCHES;
+        break;
+      }
+      case STATE_PITCHES: {
+        int16_t pitch;
+        if (!ParsePitch(line_, pitch)) {
+          state_ = STATE_DONE;
+          break;
+        }
+        ++pitches_;
+        if (pitches_ < num_notes_) notes_[pitches_] = pitch;
+        if (pitches_ == count_) {
+          period_ = pitch;
+          state_ = STATE_DONE;
+        }
+        break;
+      }
+      case STATE_DONE:
+      default:
+        break;
+    }
+  }
+
+  // A pitch is in cents if it has a decimal point, otherwise it's a ratio,
+  // with or without a denominator. Anything after it is ignored.
+  static bool ParsePitch(const char *s, int16_t &pitch) {
+    float value;
+    bool cents;
+    s = ParseNumber(s, value, &cents);
+    if (!s) return false;
+    if (!cents) {
+      if (*s == '/') {
+        float denominator;
+        if (!ParseNumber(s + 1, denominator, nullptr) || denominator <= 0.0f) return false;
+        value /= denominator;
+      }
+      if (value <= 0.0f) return false;
+      value = 1200.0f * log2f(value);
+    }
+
+    // cents to 1/128 semitone
+    int32_t p = static_cast<int32_t>(lroundf(value * 128.0f / 100.0f));
+    pitch = p < 1 ? 1 : p > kMaxSpan ? kMaxSpan : p;
+    return true;
+  }
+
+  // Leading blanks, an optional sign, then digits with an optional decimal
+  // point, which is reported in *decimal (if given; otherwise the number
+  // stops there). @return where the number ends, or nullptr without digits
+  static const char *ParseNumber(const char *s, float &value, bool *decimal) {
+    while (*s == ' ' || *s == '\t') ++s;
+    const bool negative = *s == '-';
+    if (*s == '-' || *s == '+') ++s;
+
+    value = 0.0f;
+    bool digits = false;
+    for (; *s >= '0' && *s <= '9'; ++s, digits = true) value = value * 10.0f + (*s - '0');
+    if (decimal) {
+      *decimal = *s == '.';
+      if (*decimal) {
+        float scale = 0.1f;
+        for (++s; *s >= '0' && *s <= '9'; ++s, digits = true, scale *= 0.1f)
+          value += (*s - '0') * scale;
+      }
+    }
+    if (!digits) return nullptr;
+    if (negative) value = -value;
+    return s;
+  }
+};
+
+} // namespace util
+
+#endif // UTIL_SCALA_H_
@@ -0,0 +1,156 @@
+#ifndef UTIL_SCREENSTREAM_H_
+#define UTIL_SCREENSTREAM_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "util_macros.h"
+
+namespace util {
+
+// Compressed binary packets of display frames, for streaming the screen over
+// USB serial. Decoder/viewer: software/res/screenstream.py
+//
+// Packet layout:
+//   0xFE 'S'    sync
+//   type        'K' = keyframe, payload is the RLE'd frame
+//               'D' = delta, payload is the RLE'd XOR with the previous frame
+//   sequence    8 bits, increments per packet so gaps are detectable
+//   length      16 bits LE, payload size
+//   payload
+//   checksum    Fletcher-16 of type..payload, 16 bits LE
+//
+// RLE control bytes: 0x00-0x7f = that +1 literal bytes follow,
+//                    0x80-0xff = next byte repeated (that - 0x80 + 2) times
+//
+// A frame identical to the last one sent produces no packet, so the stream
+// rate follows how much the screen actually changes.
+template <size_t frame_size>
+class ScreenStreamEncoder {
+public:
+  static constexpr uint8_t kSync0 = 0xfe;
+  static constexpr uint8_t kSync1 = 'S';
+  static constexpr uint8_t kKeyframe = 'K';
+  static constexpr uint8_t kDelta = 'D';
+
+  static constexpr size_t kHeaderSize = 6;
+  static constexpr size_t kChecksumSize = 2;
+  static constexpr size_t kMaxPayloadSize = frame_size + (frame_size + 127) / 128;
+  static constexpr size_t kMaxPacketSize = kHeaderSize + kMaxPayloadSize + kChecksumSize;
+  // A viewer that missed packets catches up by the next keyframe
+  static constexpr uint8_t kKeyframeInterval = 64;
+
+  ScreenStreamEncoder() { }
+
+  void Init() {
+    memset(previous_, 0, sizeof(previous_));
+    sequence_ = 0;
+    since_keyframe_ = 0;
+    RequestKeyframe();
+  }
+
+  void RequestKeyframe() {
+    keyframe_ = true;
+  }
+
+  // @return packet size, or 0 if the frame is unchanged
+  size_t Encode(const uint8_t *frame, uint8_t *packet) {
+    uint8_t *payload = packet + kHeaderSize;
+    uint8_t type = kKeyframe;
+    size_t length;
+
+    auto key = [frame](size_t i) { return frame[i]; };
+    const uint8_t *previous = previous_;
+    auto delta = [frame, previous](size_t i) { return uint8_t(frame[i] ^ previous[i]); };
+
+    if (keyframe_ || since_keyframe_ >= kKeyframeInterval) {
+      length = Rle(payload, key);
+    } else {
+      if (!memcmp(frame, previous_, frame_size)) return 0;
+      length = Rle(payload, delta);
+      type = kDelta;
+      // a mostly-changed screen can be smaller as a keyframe
+      if (length > frame_size / 2) {
+        const size_t key_length = Rle(payload, key);
+        if (key_length < length) {
+          length = key_length;
+          type = kKeyframe;
+        } else {
+          Rle(payload, delta);
+        }
+      }
+    }
+
+    if (type == kKeyframe) {
+      keyframe_ = false;
+      since_keyframe_ = 0;
+    } else {
+      ++since_keyframe_;
+    }
+    memcpy(previous_, frame, frame_size);
+
+    packet[0] = kSync0;
+    packet[1] = kSync1;
+    packet[2] = type;
+    packet[3] = sequence_++;
+    packet[4] = length & 0xff;
+    packet[5] = length >> 8;
+    const uint16_t checksum = Fletcher16(packet + 2, kHeaderSize - 2 + length);
+    packet[kHeaderSize + length] = checksum & 0xff;
+    packet[kHeaderSize + length + 1] = checksum >> 8;
+    return kHeaderSize + length + kChecksumSize;
+  }
+
+  static uint16_t Fletcher16(const uint8_t *data, size_t length) {
+    uint16_t sum1 = 0, sum2 = 0;
+    while (length--) {
+      sum1 = (sum1 + *data++) % 255;
+      sum2 = (sum2 + sum1) % 255;
+    }
+    return sum2 << 8 | sum1;
+  }
+
+  // @return encoded size, at most kMaxPayloadSize
+  template <typename ByteAt>
+  static size_t Rle(uint8_t *out, ByteAt byte_at) {
+    uint8_t *dst = out;
+    size_t i = 0;
+    while (i < frame_size) {
+      const uint8_t value = byte_at(i);
+      size_t run = 1;
+      while (i + run < frame_size && run < 129 && byte_at(i + run) == value)
+        ++run;
+      if (run >= 3) {
+        *dst++ = 0x80 + (run - 2);
+        *dst++ = value;
+        i += run;
+        continue;
+      }
+
+      // literals until the next run of 3+
+      uint8_t *control = dst++;
+      size_t count = 0;
+      while (i < frame_size && count < 128) {
+        const uint8_t b = byte_at(i);
+        if (i + 2 < frame_size && b == byte_at(i + 1) && b == byte_at(i + 2))
+          break;
+        *dst++ = b;
+        ++i;
+        ++count;
+      }
+      *control = count - 1;
+    }
+    return dst - out;
+  }
+
+private:
+  uint8_t previous_[frame_size];
+  uint8_t sequence_;
+  uint8_t since_keyframe_;
+  bool keyframe_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScreenStreamEncoder);
+};
+
+}; // namespace util
+
+#endif // UTIL_SCREENSTREAM_H_
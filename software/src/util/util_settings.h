@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include <string.h>
 #include "util_stream_buffer.h"
+#include "util_sysex.h"
 #include "util_misc.h"
 
 namespace settings {
@@ -119,10 +120,24 @@ constexpr size_t StorageSize() {
 // Implement the actual reading and writing of settings as external functions.
 // This reduces some template bloat by avoiding a separate Save/Restore
 // implementation for each class derived from SettingsBase.
+//
+// The SysEx variants pack straight into (or unpack straight out of) a SysEx
+// payload with no intermediate copy. Any run of values can be written on its
+// own, so large value arrays can be sent in pieces: ChunkLength() says how
+// many values starting at a given one fit into a message, and Hash() lets a
+// sender skip pieces that haven't changed since they were last sent.
 class SettingsRW {
 public:
   static size_t Write(const int values[], const ValueAttributes attributes[], size_t num_valyes, util::StreamBufferWriter &stream_writer);
   static size_t Read(int values[], const ValueAttributes attributes[], size_t num_values, util::StreamBufferReader &stream_reader);
+  static size_t Write(const int values[], const ValueAttributes attributes[], size_t num_values, util::SysExPacker &packer);
+  static size_t Read(int values[], const ValueAttributes attributes[], size_t num_values, util::SysExUnpacker &unpacker);
+
+  // Bytes needed to store the values, same as calc_storage_size
+  static size_t StorageSize(const ValueAttributes attributes[], size_t num_values);
+  // Number of values (at most num_values) that can be stored in max_bytes
+  static size_t ChunkLength(const ValueAttributes attributes[], size_t num_values, size_t max_bytes);
+  static uint32_t Hash(const int values[], size_t num_values);
 };
 
 // Provide a very simple "settings" base.
@@ -205,6 +220,46 @@ public:
     return StorageSize<clazz>();
   }
 
+  // A run of values sent as one SysEx message (see SendSysExSettings in
+  // HSMIDI.h): the index of the first value (two bytes), the number of values,
+  // then the values in their storage types.
+  static constexpr size_t kChunkHeaderSize = 3;
+
+  // Number of values from first on that fit into a message of max_bytes;
+  // 0 once first is past the end
+  static size_t ChunkLength(size_t first, size_t max_bytes) {
+    if (first >= num_settings || max_bytes < kChunkHeaderSize) return 0;
+    return SettingsRW::ChunkLength(clazz::value_attributes_array.data() + first,
+                                   num_settings - first, max_bytes - kChunkHeaderSize);
+  }
+
+  uint32_t ChunkHash(size_t first, size_t count) const {
+    return SettingsRW::Hash(values_.data() + first, count);
+  }
+
+  void SaveChunk(size_t first, size_t count, util::SysExPacker &packer) const {
+    packer.Write<uint16_t>(first);
+    packer.Write<uint8_t>(count);
+    SettingsRW::Write(values_.data() + first,
+                      clazz::value_attributes_array.data() + first,
+                      count, packer);
+  }
+
+  // Values from outside are clamped like apply_value()
+  // @return false if the chunk is truncated or doesn't fit these settings
+  bool RestoreChunk(util::SysExUnpacker &unpacker) {
+    const size_t first = unpacker.Read<uint16_t>();
+    const size_t count = unpacker.Read<uint8_t>();
+    const ValueAttributes *attributes = clazz::value_attributes_array.data() + first;
+    if (unpacker.underflow() || first + count > num_settings
+        || unpacker.available() < SettingsRW::StorageSize(attributes, count))
+      return false;
+    SettingsRW::Read(values_.data() + first, attributes, count, unpacker);
+    for (size_t i = first; i < first + count; ++i)
+      values_[i] = clamp_value(i, values_[i]);
+    return true;
+  }
+
 protected:
 
   ValueArray values_;
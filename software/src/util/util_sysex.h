@@ -0,0 +1,191 @@
+#ifndef UTIL_SYSEX_H_
+#define UTIL_SYSEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cstring>
+#include <type_traits>
+#ifdef TESTING
+#include <vector>
+#endif
+
+namespace util {
+
+// Streaming versions of the 7-bit packing used for Hemisphere SysEx (see
+// _SysExData in HSMIDI.h): data goes out in 8-byte packets, a leading byte
+// holding bit 7 of the next seven bytes, then those bytes with bit 7 cleared.
+//
+// SysExPacker writes straight into the caller's buffer (e.g. the payload part
+// of a SysEx frame); the leading byte's slot is reserved when a packet starts
+// and filled in as bytes arrive, so there's no intermediate copy and the
+// output is complete after every Write(). It has the same Write/available/
+// overflow interface as StreamBufferWriter so it can be used as a settings
+// stream.
+class SysExPacker {
+public:
+  static constexpr size_t kPacketSize = 8;
+
+  // Packed size of n data bytes
+  static constexpr size_t PackedSize(size_t n) {
+    return n / 7 * kPacketSize + (n % 7 ? n % 7 + 1 : 0);
+  }
+
+  SysExPacker(void *buffer, size_t buffer_length)
+  : begin_(static_cast<uint8_t *>(buffer))
+  , cursor_(begin_)
+  , end_(begin_ + buffer_length)
+  { }
+
+#ifdef TESTING
+  explicit SysExPacker(std::vector<uint8_t> &v)
+  : SysExPacker(v.data(), v.size())
+  { }
+#endif
+
+  void WriteByte(uint8_t c) {
+    if (!pos_) {
+      packbyte_ = cursor_++;
+      *packbyte_ = 0;
+    }
+    if (c & 0x80) *packbyte_ |= 1 << pos_;
+    *cursor_++ = c & 0x7f;
+    if (++pos_ == 7) pos_ = 0;
+  }
+
+  template <typename T>
+  void Write(const T &t) {
+    static_assert(std::is_pod<T>::value, "POD expected");
+    if (sizeof(T) > available()) {
+      overflow_ = true;
+    } else {
+      const uint8_t *src = reinterpret_cast<const uint8_t *>(&t);
+      for (size_t i = 0; i < sizeof(T); ++i) WriteByte(src[i]);
+    }
+  }
+
+  void Write(const void *data, size_t length) {
+    if (length > available()) {
+      overflow_ = true;
+    } else {
+      const uint8_t *src = static_cast<const uint8_t *>(data);
+      while (length--) WriteByte(*src++);
+    }
+  }
+
+  // Packed bytes in the buffer
+  size_t written() const {
+    return cursor_ - begin_;
+  }
+
+  // Data bytes that still fit
+  size_t available() const {
+    size_t room = end_ - cursor_;
+    size_t n = 0;
+    if (pos_) {
+      n = room < 7u - pos_ ? room : 7u - pos_;
+      room -= n;
+    }
+    return n + room / kPacketSize * 7 + (room % kPacketSize ? room % kPacketSize - 1 : 0);
+  }
+
+  bool overflow() const {
+    return overflow_;
+  }
+
+private:
+  uint8_t *begin_;
+  uint8_t *cursor_;
+  uint8_t *end_;
+  uint8_t *packbyte_ = nullptr;
+  uint8_t pos_ = 0; // Position in current packet
+  bool overflow_ = false;
+};
+
+// Reads data bytes back out of packed SysEx data in place. Stops at the end
+// of the buffer or an end-of-exclusive (0xf7) byte, whichever comes first, so
+// it can be pointed at the payload of a received frame directly.
+class SysExUnpacker {
+public:
+  SysExUnpacker(const void *buffer, size_t buffer_length)
+  : begin_(static_cast<const uint8_t *>(buffer))
+  , cursor_(begin_)
+  , end_(begin_ + buffer_length)
+  {
+    const void *eox = memchr(begin_, 0xf7, buffer_length);
+    if (eox) end_ = static_cast<const uint8_t *>(eox);
+  }
+
+#ifdef TESTING
+  explicit SysExUnpacker(const std::vector<uint8_t> &v)
+  : SysExUnpacker(v.data(), v.size())
+  { }
+#endif
+
+  uint8_t ReadByte() {
+    if (!pos_) packbyte_ = *cursor_++;
+    uint8_t c = *cursor_++;
+    if (packbyte_ & (1 << pos_)) c |= 0x80;
+    if (++pos_ == 7) pos_ = 0;
+    return c;
+  }
+
+  template <typename T>
+  T Read() {
+    static_assert(std::is_integral<T>::value, "Integral type expected");
+    T t = 0;
+    return Read(t);
+  }
+
+  template <typename T>
+  T& Read(T &t) {
+    static_assert(std::is_pod<T>::value, "POD expected");
+    if (sizeof(T) > available()) {
+      cursor_ = end_;
+      underflow_ = true;
+    } else {
+      uint8_t *dst = reinterpret_cast<uint8_t *>(&t);
+      for (size_t i = 0; i < sizeof(T); ++i) dst[i] = ReadByte();
+    }
+    return t;
+  }
+
+  size_t Read(void *data, size_t length) {
+    if (length > available()) length = available();
+    uint8_t *dst = static_cast<uint8_t *>(data);
+    for (size_t i = 0; i < length; ++i) dst[i] = ReadByte();
+    return length;
+  }
+
+  // Packed bytes consumed
+  size_t read() const {
+    return cursor_ - begin_;
+  }
+
+  // Data bytes left
+  size_t available() const {
+    size_t room = end_ - cursor_;
+    size_t n = 0;
+    if (pos_) {
+      n = room < 7u - pos_ ? room : 7u - pos_;
+      room -= n;
+    }
+    return n + room / SysExPacker::kPacketSize * 7 +
+        (room % SysExPacker::kPacketSize ? room % SysExPacker::kPacketSize - 1 : 0);
+  }
+
+  bool underflow() const {
+    return underflow_;
+  }
+
+private:
+  const uint8_t *begin_;
+  const uint8_t *cursor_;
+  const uint8_t *end_;
+  uint8_t packbyte_ = 0;
+  uint8_t pos_ = 0;
+  bool underflow_ = false;
+};
+
+} // namespace util
+
+#endif // UTIL_SYSEX_H_
@@ -0,0 +1,128 @@
+#ifndef UTIL_TASK_QUEUE_H_
+#define UTIL_TASK_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace util {
+
+// A deferred function call that lives in-place: the callable is copied into
+// a fixed buffer instead of the heap, so tasks can be created in an ISR and
+// stored in a static queue. Anything that fits works (function pointers,
+// lambdas capturing a pointer or so), as long as it's trivially copyable,
+// which is checked at compile time.
+template <size_t Size>
+class InplaceTask {
+public:
+  InplaceTask() = default;
+
+  template <typename F, typename Fn = typename std::decay<F>::type,
+            typename = typename std::enable_if<!std::is_same<Fn, InplaceTask>::value>::type>
+  InplaceTask(F &&f) {
+    static_assert(sizeof(Fn) <= Size, "Task captures too much; capture a pointer instead");
+    static_assert(alignof(Fn) <= alignof(Storage), "Task alignment");
+    static_assert(std::is_trivially_copyable<Fn>::value && std::is_trivially_destructible<Fn>::value,
+                  "Tasks are copied as plain data");
+    new (&storage_) Fn(std::forward<F>(f));
+    invoke_ = [](void *fn) { (*static_cast<Fn *>(fn))(); };
+  }
+
+  void operator()() { invoke_(&storage_); }
+  explicit operator bool() const { return invoke_ != nullptr; }
+
+private:
+  struct alignas(void *) Storage {
+    uint8_t bytes[Size];
+  };
+  Storage storage_;
+  void (*invoke_)(void *) = nullptr;
+};
+
+// Bounded multi-producer single-consumer queue. Push() never blocks or
+// allocates, and can be called from any context, including ISRs that
+// interrupt another Push(); a full queue drops the item and counts it.
+// Pop() must only be called from one context.
+//
+// Each cell carries a sequence number telling producers and the consumer
+// whose turn it is (the bounded queue by Dmitry Vyukov), so a producer
+// interrupted between claiming a cell and filling it only holds back the
+// consumer, not other producers.
+//
+// Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class MPSCQueue {
+public:
+  static_assert(Capacity && !(Capacity & (Capacity - 1)), "Capacity must be a power of two");
+  static_assert(std::is_trivially_copyable<T>::value, "Queue items are copied as plain data");
+
+  MPSCQueue() {
+    for (size_t i = 0; i < Capacity; ++i) cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  bool Push(const T &value) {
+    uint32_t pos = head_.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &cells_[pos & (Capacity - 1)];
+      const int32_t diff = cell->sequence.load(std::memory_order_acquire) - pos;
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = value;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    const uint32_t depth = pos + 1 - tail_.load(std::memory_order_relaxed);
+    uint32_t peak = peak_.load(std::memory_order_relaxed);
+    while (depth > peak && !peak_.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) { }
+    return true;
+  }
+
+  bool Pop(T &value) {
+    const uint32_t pos = tail_.load(std::memory_order_relaxed);
+    Cell &cell = cells_[pos & (Capacity - 1)];
+    if (int32_t(cell.sequence.load(std::memory_order_acquire) - (pos + 1)) < 0)
+      return false; // empty, or the next item is still being written
+    value = cell.value;
+    cell.sequence.store(pos + Capacity, std::memory_order_release);
+    tail_.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Approximate while producers are active
+  size_t size() const {
+    return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+  }
+
+  uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+  uint32_t peak() const { return peak_.load(std::memory_order_relaxed); }
+  void ResetStats() {
+    dropped_.store(0, std::memory_order_relaxed);
+    peak_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  struct Cell {
+    std::atomic<uint32_t> sequence;
+    T value;
+  };
+
+  Cell cells_[Capacity];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+  std::atomic<uint32_t> dropped_{0};
+  std::atomic<uint32_t> peak_{0};
+};
+
+} // namespace util
+
+#endif // UTIL_TASK_QUEUE_H_
@@ -22,6 +22,7 @@
 #define HS_VECTOR_OSCILLATOR
 
 #include "../util/util_math.h"
+#include "../OC_config.h"
 
 namespace HS {
 
@@ -62,6 +63,8 @@ using VOSegment = HS::VOSegment;
 
 class VectorOscillator {
 public:
+    // core ISR rate in centihertz
+    static constexpr uint32_t kSampleRateCentiHz = (100000000000ULL + OC_CORE_ISR_PERIOD_NS / 2) / OC_CORE_ISR_PERIOD_NS;
     /* Oscillator defaults to cycling. Turn off cycling for EGs, etc */
     void Cycle(bool cycle_ = 1) {cycle = cycle_;}
 
@@ -107,7 +110,7 @@ public:
 
     /* frequency is centihertz (e.g., 440 Hz is 44000) */
     void SetFrequency(uint32_t frequency_) {
-        SetPhaseIncrement(0xffffffff / 1666667 * frequency_);
+        SetPhaseIncrement(0xffffffff / kSampleRateCentiHz * frequency_);
     }
 
     void SetPhaseIncrement(uint32_t phase_inc) {
@@ -154,6 +157,43 @@ public:
         return rescale(update_current());
     }
 
+    /* Fills out[] with the next n values; the same as calling Next() n times.
+     *
+     * Within a segment, the segment phase is stepped by a precomputed quotient
+     * and remainder of the phase increment, so the per-sample work is adds and
+     * compares. Entering a segment takes the same path as Next(). Envelopes
+     * (non-cycling or sustaining) change state per sample and just use Next().
+     */
+    void Render(int32_t *out, size_t n) {
+        if (!cycle || sustain || sustained || !validate()) {
+            while (n--) *out++ = Next();
+            return;
+        }
+        if (!n) return;
+
+        eoc = 0;
+        phase += phase_increment;
+        *out++ = rescale(update_current());
+        RenderSegment seg = enter_segment();
+
+        while (--n) {
+            const uint32_t old_phase = phase;
+            phase += phase_increment;
+            if (phase >= old_phase && phase <= seg.end) {
+                seg.quotient += seg.inc_quotient;
+                seg.remainder += seg.inc_remainder;
+                if (seg.remainder >= seg.span) {
+                    seg.remainder -= seg.span;
+                    ++seg.quotient;
+                }
+                *out++ = rescale(InterpLinear16(seg.from, seg.to, seg.quotient));
+            } else {
+                *out++ = rescale(update_current());
+                seg = enter_segment();
+            }
+        }
+    }
+
     /* Get the value of the waveform at a specific phase. Degrees are expressed in tenths of a degree */
     int32_t Phase(int degrees) const {
         uint32_t phase = 0xffffffff / 3600 * degrees;
@@ -194,6 +234,33 @@ private:
     uint16_t scale; // The maximum (and minimum negative) output for this Oscillator
     int16_t offset = 0; // Amount added to each voltage output (e.g., to make it unipolar)
 
+    // Current segment, as Render() steps through it
+    struct RenderSegment {
+        uint32_t end; // last phase in the segment
+        uint32_t span; // phase units per step of segment phase
+        uint32_t quotient, remainder; // segment phase = (phase - start) / span
+        uint32_t inc_quotient, inc_remainder; // phase_increment / span
+        int16_t from, to;
+    };
+
+    // Same boundaries and divisor as find_segment(), for the segment that
+    // update_current() just settled on
+    RenderSegment enter_segment() const {
+        RenderSegment seg;
+        const uint32_t start = time_unit * segment_time;
+        seg.end = segment_index == segment_count - 1
+            ? 0xffffffff
+            : start + time_unit * segments[segment_index].time;
+        seg.span = 1 + ((seg.end - start) >> 16);
+        seg.quotient = (phase - start) / seg.span;
+        seg.remainder = (phase - start) - seg.quotient * seg.span;
+        seg.inc_quotient = phase_increment / seg.span;
+        seg.inc_remainder = phase_increment - seg.inc_quotient * seg.span;
+        seg.from = segment_start_level;
+        seg.to = (segments[segment_index].level - 128) * 255;
+        return seg;
+    }
+
     /*
      * The Oscillator can only oscillate if the following conditions are true:
      *     (1) The frequency must be greater than 0
@@ -247,7 +314,10 @@ private:
                 segment_start = 0;
             }
             start_phase = time_unit * segment_start;
-            end_phase = start_phase + time_unit * segments[segment].time;
+            // the last segment runs to the end, or a phase past time_unit * total_time never settles
+            end_phase = segment == segment_count - 1
+                ? 0xffffffff
+                : start_phase + time_unit * segments[segment].time;
         }
         // 1 + so denominator is guaranteed to be greater so we don't hit 65536
         segment_phase = ((phase - start_phase) / (1 + ((end_phase - start_phase) >> 16)));
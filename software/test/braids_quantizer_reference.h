@@ -0,0 +1,132 @@
+#ifndef BRAIDS_QUANTIZER_REFERENCE_H_
+#define BRAIDS_QUANTIZER_REFERENCE_H_
+
+// Verbatim copy of the linear-scan braids::Quantizer::Process, kept as the
+// reference for bit-exactness tests and benchmarks of the table-driven version.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "braids_quantizer.h"
+
+class ReferenceQuantizer {
+public:
+  void Init() {
+    enabled_ = true;
+    codeword_ = 0;
+    transpose_ = 0;
+    previous_boundary_ = 0;
+    next_boundary_ = 0;
+    octave_constraint_ = braids::OCTAVE_CONSTRAINT_OFF;
+    octave_constraint_min_ = 0;
+    octave_constraint_max_ = 0;
+    requantize_ = false;
+  }
+
+  void Configure(const braids::Scale& scale, uint16_t mask = 0xffff) {
+    num_notes_ = 0;
+    for (uint16_t i = 0; i < scale.num_notes; i++) {
+      if (mask & 1) notes_[num_notes_++] = scale.notes[i];
+      mask >>= 1;
+    }
+    span_ = scale.span;
+    enabled_ = num_notes_ != 0 && span_ != 0;
+  }
+
+  void ConfigureOctaveConstraint(uint8_t octave_constraint, int octave_constraint_len) {
+    octave_constraint_ = octave_constraint;
+    if (octave_constraint == braids::OCTAVE_CONSTRAINT_DOWN) {
+      octave_constraint_min_ = -octave_constraint_len;
+      octave_constraint_max_ = 0;
+    } else {
+      octave_constraint_min_ = 0;
+      octave_constraint_max_ = octave_constraint_len;
+    }
+  }
+
+  void Requantize() { requantize_ = true; }
+  uint16_t GetLatestNoteNumber() { return note_number_; }
+
+  int32_t Process(int32_t pitch, int32_t root, int32_t transpose) {
+    if (!enabled_) {
+      return pitch;
+    }
+
+    pitch -= root;
+    pitch -= ((12 << 7) << 1);
+
+    if (!requantize_ && pitch >= previous_boundary_ && pitch <= next_boundary_ && transpose == transpose_) {
+      pitch = codeword_;
+    } else {
+      requantize_ = false;
+      int16_t octave = pitch / span_ - (pitch < 0 ? 1 : 0);
+      int16_t rel_pitch = pitch - span_ * octave;
+
+      int16_t best_distance = 16384;
+      int16_t q = -1;
+      for (int16_t i = 0; i < num_notes_; i++) {
+        int16_t distance = abs(rel_pitch - notes_[i]);
+        if (distance < best_distance) {
+          best_distance = distance;
+          q = i;
+        }
+      }
+
+      if (abs(pitch - (octave + 1) * span_ - notes_[0]) < best_distance) {
+        octave++;
+        q = 0;
+      } else if (abs(pitch - (octave - 1) * span_ - notes_[num_notes_ - 1]) <= best_distance) {
+        octave--;
+        q = num_notes_ - 1;
+      }
+
+      codeword_ = notes_[q] + octave * span_;
+      previous_boundary_ = q == 0
+        ? notes_[num_notes_ - 1] + (octave - 1) * span_
+        : notes_[q - 1] + octave * span_;
+      previous_boundary_ = (10 * previous_boundary_ + 6 * codeword_) >> 4;
+
+      next_boundary_ = q == num_notes_ - 1
+        ? notes_[0] + (octave + 1) * span_
+        : notes_[q + 1] + octave * span_;
+      next_boundary_ = (10 * next_boundary_ + 6 * codeword_) >> 4;
+
+      q += transpose;
+      octave += q / num_notes_;
+      q %= num_notes_;
+      if (q < 0) {
+        q += num_notes_;
+        octave--;
+      }
+
+      if (octave_constraint_) {
+        CONSTRAIN(octave, octave_constraint_min_, octave_constraint_max_);
+      }
+
+      note_number_ = (octave + 2) * num_notes_ + q + 64;
+      codeword_ = notes_[q] + octave * span_;
+
+      transpose_ = transpose;
+      pitch = codeword_;
+    }
+    pitch += root;
+    pitch += ((12 << 7) << 1);
+    return pitch;
+  }
+
+private:
+  bool enabled_ = false;
+  int32_t codeword_ = 0;
+  int32_t transpose_ = 0;
+  int32_t previous_boundary_ = 0;
+  int32_t next_boundary_ = 0;
+  int32_t span_ = 0;
+  int16_t notes_[16] = { 0 };
+  uint8_t num_notes_ = 0;
+  uint8_t octave_constraint_ = 0;
+  int octave_constraint_min_ = 0;
+  int octave_constraint_max_ = 0;
+  uint16_t note_number_ = 0;
+  bool requantize_ = false;
+};
+
+#endif // BRAIDS_QUANTIZER_REFERENCE_H_
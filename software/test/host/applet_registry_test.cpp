@@ -0,0 +1,116 @@
+// Host tests for the fixed-storage applet registry: applets are constructed
+// in place, switching keeps the previous applet alive, and the third applet
+// in a slot replaces the least recently used one.
+
+// Applet registry and app container, which the firmware archive refers to
+#include "OC_apps.cpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+struct Base {
+  virtual ~Base() = default;
+  virtual int value() const = 0;
+};
+
+int constructed = 0;
+int destroyed = 0;
+
+template <int N, size_t Bytes>
+struct Toy : public Base {
+  Toy() { ++constructed; }
+  ~Toy() { ++destroyed; }
+  int value() const override { return N; }
+  static constexpr const char* applet_name_() { return "Toy"; }
+  static constexpr const uint8_t* applet_icon_() { return nullptr; }
+  uint8_t payload[Bytes] = {};
+};
+
+using Small = Toy<1, 8>;
+using Medium = Toy<2, 100>;
+using Large = Toy<3, 300>;
+
+constexpr ArenaRegistry<Base, 2
+  , DeclareApplet<Small, 10, 0>
+  , DeclareApplet<Medium, 20, 0>
+  , DeclareApplet<Large, 30, 0>
+> toys{};
+
+class ArenaRegistryTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    constructed = destroyed = 0;
+  }
+};
+
+TEST_F(ArenaRegistryTest, SizedForLargest) {
+  EXPECT_EQ(sizeof(Large), toys.MaxSize);
+  EXPECT_GE(toys.BufferSize, sizeof(Large));
+  EXPECT_EQ(0U, toys.BufferSize % toys.MaxAlign);
+  EXPECT_EQ(sizeof(Small), toys.getSizes()[0]);
+  EXPECT_EQ(sizeof(Medium), toys.getSizes()[1]);
+}
+
+TEST_F(ArenaRegistryTest, ConstructsInPlace) {
+  Base *a = toys.get(30, 1);
+  ASSERT_NE(nullptr, a);
+  EXPECT_EQ(3, a->value());
+  EXPECT_EQ(1, constructed);
+
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(a);
+  const uint8_t *begin = &toys.arena[0][0][0];
+  EXPECT_GE(p, begin);
+  EXPECT_LT(p, begin + sizeof(toys.arena));
+
+  EXPECT_EQ(a, toys.get(30, 1));
+  EXPECT_EQ(1, constructed);
+  EXPECT_EQ(nullptr, toys.get(99, 1));
+}
+
+TEST_F(ArenaRegistryTest, SwitchingReplacesLeastRecent) {
+  Base *a = toys.get(10, 0);
+  Base *b = toys.get(20, 0);
+  EXPECT_NE(a, b);
+  EXPECT_EQ(1, a->value()); // still alive, for Unload()
+
+  // back to the first one: no reconstruction
+  EXPECT_EQ(a, toys.get(10, 0));
+
+  // the third evicts the second, which is no longer in use
+  const int before = destroyed;
+  Base *c = toys.get(30, 0);
+  EXPECT_EQ(b, c);
+  EXPECT_EQ(before + 1, destroyed);
+  EXPECT_EQ(3, c->value());
+  EXPECT_EQ(1, toys.get(10, 0)->value());
+}
+
+TEST_F(ArenaRegistryTest, SlotsAreIndependent) {
+  Base *left = toys.get(20, 0);
+  Base *right = toys.get(20, 1);
+  EXPECT_NE(left, right);
+  toys.get(10, 1);
+  toys.get(30, 1);
+  EXPECT_EQ(left, toys.get(20, 0));
+  EXPECT_EQ(2, left->value());
+}
+
+// every applet in the firmware registry can be built in a slot buffer
+TEST(AppletArena, AllAppletsConstruct) {
+  for (int i = 0; i < HS::HEMISPHERE_AVAILABLE_APPLETS; ++i) {
+    for (int h = 0; h < HS::APPLET_SLOTS; ++h) {
+      HemisphereApplet *applet = HS::get_applet(i, HEM_SIDE(h));
+      ASSERT_NE(nullptr, applet);
+      EXPECT_STREQ(HS::get_applet_name(i), applet->applet_name());
+      EXPECT_EQ(applet, HS::get_applet(i, HEM_SIDE(h)));
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,39 @@
+// Per-applet RAM report for the Hemisphere applet registry, largest first.
+// With the fixed-storage registry every slot reserves room for the largest
+// applet twice, so that one sets the cost for all of them.
+//
+// Sizes are from the host compiler with the T4.0 configuration; pointers are
+// 8 bytes here instead of 4, so treat them as an upper bound.
+
+// Applet registry and app container, which the firmware archive refers to
+#include "OC_apps.cpp"
+
+#include <algorithm>
+#include <stdio.h>
+
+int main(int, char **) {
+  const auto sizes = reg.getSizes();
+  const auto names = reg.getNames();
+  const auto ids = reg.getIds();
+
+  std::array<size_t, sizes.size()> order;
+  for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return sizes[a] > sizes[b];
+  });
+
+  size_t total = 0;
+  printf("%8s  %5s  %s\n", "bytes", "id", "applet");
+  for (size_t i : order) {
+    printf("%8zu  %5llu  %s\n", sizes[i], (unsigned long long)ids[i], names[i]);
+    total += sizes[i];
+  }
+
+  printf("\n%zu applets, %zu slots\n", sizes.size(), size_t(HS::APPLET_SLOTS));
+  printf("largest %zu bytes (budget %d), all %zu bytes\n", reg.MaxSize, APPLET_ARENA_BUDGET, total);
+#ifndef APPLET_HEAP
+  printf("arena: %zu bytes (%zu slots x %zu buffers x %zu)\n", sizeof(reg.arena),
+         size_t(HS::APPLET_SLOTS), reg.Buffers, reg.BufferSize);
+#endif
+  return 0;
+}
@@ -0,0 +1,101 @@
+// Benchmark for AudioBuffer interpolated reads, set up like DelayApplet's
+// stereo delay: two channels of 8 modulated taps reading a 512K-sample
+// buffer in ChunkSize chunks. ReadInterp() per sample on the plain buffer
+// (the old AudioDelayExt path) against ReadInterpBlock() on the power-of-two
+// buffer. Outputs are compared; any mismatch fails the run.
+//
+// Usage: audio_buffer_bench [BLOCKS] [CHUNK]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include <Arduino.h>
+#include "Audio/AudioBuffer.h"
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+static const size_t kBufferLength = 1024 * 512;
+static const int kChannels = 2;
+static const int kTaps = 8;
+
+template <bool PowerOfTwo>
+struct Channel {
+  std::vector<int16_t> storage;
+  AudioBuffer<int16_t, PowerOfTwo> buffer;
+
+  Channel() : storage(kBufferLength), buffer(storage.data(), kBufferLength) {
+    uint32_t seed = 1;
+    for (size_t i = 0; i < kBufferLength; ++i) {
+      seed = seed * 1664525u + 1013904223u;
+      buffer.WriteSample(int16_t(seed >> 16));
+    }
+  }
+};
+
+// Per-tap delay in samples, slowly modulated: 10ms to ~5s
+static float TapDelay(int tap, size_t sample) {
+  return 441.0f * (1 + tap * 13) + 30.0f * sinf(sample * 0.0001f * (tap + 1));
+}
+
+int main(int argc, char **argv) {
+  const size_t blocks = argc > 1 ? strtoul(argv[1], nullptr, 0) : 2000;
+  const size_t chunk = argc > 2 ? strtoul(argv[2], nullptr, 0) : 8;
+  const size_t samples = blocks * AUDIO_BLOCK_SAMPLES;
+
+  Channel<false> plain[kChannels];
+  Channel<true> pow2[kChannels];
+
+  // Read positions are computed up front so only the reads are timed
+  std::vector<float> positions(size_t(kTaps) * samples);
+  for (int tap = 0; tap < kTaps; ++tap) {
+    for (size_t s = 0; s < samples; ++s) {
+      positions[tap * samples + s] = TapDelay(tap, s) - (s % chunk);
+    }
+  }
+  std::vector<float> out_sample(kChannels * kTaps * samples), out_block(out_sample.size());
+
+  uint64_t best[2] = { UINT64_MAX, UINT64_MAX };
+  for (int pass = 0; pass < 5; ++pass) {
+    uint64_t t0 = now_ns();
+    for (int ch = 0; ch < kChannels; ++ch) {
+      for (int tap = 0; tap < kTaps; ++tap) {
+        const float *pos = &positions[tap * samples];
+        float *out = &out_sample[(ch * kTaps + tap) * samples];
+        for (size_t s = 0; s < samples; ++s) out[s] = plain[ch].buffer.ReadInterp(pos[s]);
+      }
+    }
+    uint64_t t1 = now_ns();
+    for (int ch = 0; ch < kChannels; ++ch) {
+      for (int tap = 0; tap < kTaps; ++tap) {
+        const float *pos = &positions[tap * samples];
+        float *out = &out_block[(ch * kTaps + tap) * samples];
+        for (size_t s = 0; s < samples; s += chunk) {
+          pow2[ch].buffer.ReadInterpBlock(pos + s, out + s, std::min(chunk, samples - s));
+        }
+      }
+    }
+    uint64_t t2 = now_ns();
+    if (t1 - t0 < best[0]) best[0] = t1 - t0;
+    if (t2 - t1 < best[1]) best[1] = t2 - t1;
+  }
+
+  for (size_t i = 0; i < out_sample.size(); ++i) {
+    if (out_sample[i] != out_block[i]) {
+      printf("MISMATCH at %zu: %f != %f\n", i, out_sample[i], out_block[i]);
+      return 1;
+    }
+  }
+
+  const double reads = double(kChannels) * kTaps * samples;
+  printf("%d ch x %d taps, %zu samples, chunk %zu\n", kChannels, kTaps, samples, chunk);
+  printf("%-28s %8.2f ns/read\n", "ReadInterp (% wrap)", best[0] / reads);
+  printf("%-28s %8.2f ns/read\n", "ReadInterpBlock (pow2 mask)", best[1] / reads);
+  printf("%-28s %8.2fx\n", "speedup", double(best[0]) / best[1]);
+  return 0;
+}
@@ -0,0 +1,212 @@
+// Host implementations of the Arduino/Teensy runtime plus stub drivers for the
+// hardware that the core ISR pipeline touches (ADC, digital inputs, display).
+// See host_hal.h and include/Arduino.h.
+
+#include <time.h>
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <SD.h>
+#include <SPI.h>
+
+#include "OC_ADC.h"
+#include "OC_io.h"
+#include "OC_digital_inputs.h"
+#include "src/drivers/SH1106_128x64_driver.h"
+#include "src/drivers/FreqMeasure/OC_FreqMeasure.h"
+#include "host_hal.h"
+
+// -- Arduino globals
+HostSerial Serial;
+HostMIDIDevice usbMIDI;
+SPIClass SPI, SPI1;
+SDClass SD;
+EEPROMClass EEPROM;
+CrashReportClass CrashReport;
+host::Registers host::registers;
+
+// Main.cpp globals
+uint_fast8_t MENU_REDRAW = true;
+volatile bool OC::CORE::app_isr_enabled = false;
+volatile bool OC::CORE::display_update_enabled = false;
+volatile bool OC::CORE::app_loop_enabled = false;
+volatile uint32_t OC::CORE::ticks = 0;
+
+// Linker symbols used by the free RAM/stack estimates
+char _ebss[16], _heap_end[16], *__brkval = _heap_end, _estack;
+char _extram_start[16], _extram_end[16];
+
+namespace host {
+
+InputState inputs;
+DisplayStats display_stats;
+
+static uint64_t now_us = 0;
+
+void advance_time_us(uint32_t us) {
+  now_us += us;
+}
+
+}; // namespace host
+
+// -- Timing
+uint32_t millis() { return host::now_us / 1000; }
+uint32_t micros() { return host::now_us; }
+void delay(uint32_t ms) { host::now_us += uint64_t(ms) * 1000; }
+void delayMicroseconds(uint32_t us) { host::now_us += us; }
+void yield() { }
+
+uint32_t host_cycle_count() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t ns = uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+  return uint32_t(ns * (F_CPU / 1000000) / 1000);
+}
+
+// -- Random; xorshift32 so runs are reproducible for a given seed
+static uint32_t random_state = 0x12345678;
+
+void randomSeed(uint32_t seed) {
+  if (seed) random_state = seed;
+}
+
+static uint32_t random_next() {
+  uint32_t x = random_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return random_state = x;
+}
+
+int32_t random(int32_t howbig) {
+  return howbig > 0 ? int32_t(random_next() % uint32_t(howbig)) : 0;
+}
+
+int32_t random(int32_t howsmall, int32_t howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+// -- GPIO; trigger inputs are active low, everything else idles high (pullups)
+void pinMode(uint8_t, uint8_t) { }
+void digitalWrite(uint8_t, uint8_t) { }
+uint8_t digitalRead(uint8_t pin) {
+  const uint8_t tr[] = { TR1, TR2, TR3, TR4 };
+  for (int i = 0; i < 4; ++i) {
+    if (pin == tr[i]) return (host::inputs.gates & (1 << i)) ? LOW : HIGH;
+  }
+  return HIGH;
+}
+int analogRead(uint8_t) { return 0; }
+void analogWrite(uint8_t, int) { }
+void analogReadResolution(unsigned int) { }
+void analogWriteResolution(unsigned int) { }
+void attachInterrupt(uint8_t, void (*)(void), int) { }
+void detachInterrupt(uint8_t) { }
+
+extern "C" void _reboot_Teensyduino_() { exit(0); }
+
+// -- Memory
+extern "C" {
+void *extmem_malloc(size_t size) { return malloc(size); }
+void *extmem_calloc(size_t nmemb, size_t size) { return calloc(nmemb, size); }
+void extmem_free(void *ptr) { free(ptr); }
+void *extmem_realloc(void *ptr, size_t size) { return realloc(ptr, size); }
+}
+
+uint8_t *host_eeprom_data() {
+  static uint8_t data[E2END + 1];
+  return data;
+}
+
+// -- ADC stub: converts host::inputs.cv to scan-resolution samples
+ADC_CHANNEL ADC_CHANNEL_1=0, ADC_CHANNEL_2=1, ADC_CHANNEL_3=2, ADC_CHANNEL_4=3;
+
+namespace OC {
+
+/*static*/ ADC::CalibrationData *ADC::calibration_data_;
+/*static*/ uint32_t ADC::raw_[ADC_CHANNEL_COUNT];
+/*static*/ uint32_t ADC::smoothed_[ADC_CHANNEL_COUNT];
+
+/*static*/ void ADC::Init(CalibrationData *calibration_data, bool) {
+  calibration_data_ = calibration_data;
+  std::fill(raw_, raw_ + ADC_CHANNEL_COUNT, 0);
+  std::fill(smoothed_, smoothed_ + ADC_CHANNEL_COUNT, 0);
+}
+
+/*static*/ void ADC::Init_DMA() { }
+/*static*/ void ADC::DMA_ISR() { }
+
+/*static*/ void ADC::Read(IOFrame *ioframe) {
+  for (int channel = 0; channel < ADC_CHANNEL_COUNT; ++channel) {
+    ioframe->cv.values[channel] = value(static_cast<ADC_CHANNEL>(channel));
+    ioframe->cv.pitch_values[channel] = value_to_pitch( ioframe->cv.values[channel] );
+  }
+}
+
+static uint32_t volts_to_sample(const ADC::CalibrationData *cal, int channel, float volts) {
+  // Inverse of ADC::value() and value_to_pitch(): 1V = 12 * 128 pitch units
+  const int32_t value = int32_t(volts * (12 << 7) * 4096.0f / cal->pitch_cv_scale);
+  const int32_t counts = constrain(int32_t(cal->offset[channel]) - value, 0, 4095);
+  return uint32_t(counts) << (ADC::kAdcScanResolution - ADC::kAdcResolution);
+}
+
+/*static*/ void ADC::Scan_DMA() {
+  // same 3:1 rate limit as the T4 DMA path
+  static int ratelimit = 0;
+  if (++ratelimit < 3) return;
+  ratelimit = 0;
+  if (!calibration_data_) return;
+
+  update<ADC_CHANNEL_1>(volts_to_sample(calibration_data_, ADC_CHANNEL_1, host::inputs.cv[0]));
+  update<ADC_CHANNEL_2>(volts_to_sample(calibration_data_, ADC_CHANNEL_2, host::inputs.cv[1]));
+  update<ADC_CHANNEL_3>(volts_to_sample(calibration_data_, ADC_CHANNEL_3, host::inputs.cv[2]));
+  update<ADC_CHANNEL_4>(volts_to_sample(calibration_data_, ADC_CHANNEL_4, host::inputs.cv[3]));
+}
+
+/*static*/ void ADC::CalibratePitch(int32_t c2, int32_t c4) {
+  if (c2 < c4) {
+    int32_t scale = (24 * 128 * 4096L) / (c4 - c2);
+    calibration_data_->pitch_cv_scale = scale;
+  }
+}
+
+float ADC::Read_ID_Voltage() { return 0; }
+
+// -- Digital inputs stub: edges are derived from successive host::inputs.gates
+/*static*/ uint32_t DigitalInputs::rising_edges_ = 0;
+/*static*/ uint32_t DigitalInputs::raised_mask_ = 0;
+/*static*/ IMXRT_GPIO_t *DigitalInputs::port[DIGITAL_INPUT_LAST];
+/*static*/ uint32_t DigitalInputs::bitmask[DIGITAL_INPUT_LAST];
+
+void DigitalInputs::Init() {
+  rising_edges_ = raised_mask_ = 0;
+}
+
+void DigitalInputs::Scan() {
+  const uint32_t gates = host::inputs.gates & ((1 << DIGITAL_INPUT_LAST) - 1);
+  rising_edges_ = gates & ~raised_mask_;
+  raised_mask_ = gates;
+}
+
+}; // namespace OC
+
+// -- Display stub: pages are accepted immediately
+void SH1106_128x64_Driver::Init() { }
+void SH1106_128x64_Driver::Clear() { }
+void SH1106_128x64_Driver::Flush() { }
+bool SH1106_128x64_Driver::SendPage(uint_fast8_t, const uint8_t *) {
+  ++host::display_stats.pages_sent;
+  return true;
+}
+void SH1106_128x64_Driver::SPI_send(void *, size_t) { }
+void SH1106_128x64_Driver::AdjustOffset(uint8_t) { }
+void SH1106_128x64_Driver::ChangeSpeed(uint32_t) { }
+void SH1106_128x64_Driver::SetFlipMode(bool) { }
+void SH1106_128x64_Driver::SetContrast(uint8_t) { }
+
+// -- FreqMeasure stub: never reports a period
+FreqMeasureClass FreqMeasure;
+FreqMeasureClass *FreqMeasureClass::pin_inst[4];
+void FreqMeasureClass::begin(uint8_t) { running = true; }
+uint8_t FreqMeasureClass::available() { return 0; }
+uint32_t FreqMeasureClass::read() { return 0; }
+void FreqMeasureClass::end() { running = false; }
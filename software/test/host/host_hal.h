@@ -0,0 +1,36 @@
+// Host-side hardware abstraction for running the core ISR pipeline off-target.
+//
+// The ADC, digital input and display drivers are replaced by stubs in
+// host_hal.cpp; the harness drives them through host::inputs, which the stubs
+// sample in ADC::Scan_DMA and DigitalInputs::Scan exactly where the hardware
+// would have been read.
+
+#ifndef HOST_HAL_H_
+#define HOST_HAL_H_
+
+#include <stdint.h>
+#include "OC_config.h"
+
+namespace host {
+
+struct InputState {
+  float cv[ADC_CHANNEL_COUNT]; // volts at the CV jacks
+  uint32_t gates;              // bit n = TRn+1 high
+};
+
+extern InputState inputs;
+
+// Counters for the stubbed display driver
+struct DisplayStats {
+  uint32_t pages_sent;
+};
+
+extern DisplayStats display_stats;
+
+// Advance the emulated millis()/micros() clock; the harness calls this once per
+// simulated ISR tick so time-based app logic sees realistic intervals.
+void advance_time_us(uint32_t us);
+
+}; // namespace host
+
+#endif // HOST_HAL_H_
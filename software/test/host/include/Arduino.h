@@ -0,0 +1,165 @@
+// Minimal Arduino/Teensyduino surface for building firmware sources on a
+// desktop host. Only what the core pipeline (IOFrame, apps, applets) touches
+// is provided; hardware access is redirected to plain memory.
+//
+// This is NOT an emulator: register writes land in dummy variables, GPIO reads
+// come from host_hal.cpp, and timing functions are backed by the host clock.
+
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <utility>
+
+#ifndef F_CPU
+#define F_CPU 600000000
+#endif
+#ifndef F_BUS
+#define F_BUS 150000000
+#endif
+#ifndef F_CPU_ACTUAL
+#define F_CPU_ACTUAL F_CPU
+#endif
+
+#define FASTRUN
+#define FLASHMEM
+#define PROGMEM
+#define DMAMEM
+#define EXTMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+#define CHANGE 4
+#define FALLING 2
+#define RISING 3
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+// Teensyduino's min/max accept mixed argument types
+template <class A, class B>
+constexpr auto min(A &&a, B &&b) -> decltype(a < b ? std::forward<A>(a) : std::forward<B>(b)) {
+  return a < b ? std::forward<A>(a) : std::forward<B>(b);
+}
+template <class A, class B>
+constexpr auto max(A &&a, B &&b) -> decltype(a < b ? std::forward<A>(a) : std::forward<B>(b)) {
+  return a >= b ? std::forward<A>(a) : std::forward<B>(b);
+}
+
+#ifndef constrain
+template <typename T, typename L, typename H>
+constexpr auto constrain(T x, L lo, H hi) -> decltype(x + lo + hi) {
+  return (x < lo) ? lo : ((x > hi) ? hi : x);
+}
+#endif
+#define sq(x) ((x)*(x))
+#define radians(deg) ((deg)*DEG_TO_RAD)
+#define degrees(rad) ((rad)*RAD_TO_DEG)
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+template <typename T> static inline T map(T x, T in_min, T in_max, T out_min, T out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// --- timing, backed by the host clock (see host_hal.cpp) ---
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// Emulated DWT cycle counter, scaled to F_CPU
+uint32_t host_cycle_count();
+
+// --- random ---
+int32_t random(int32_t howbig);
+int32_t random(int32_t howsmall, int32_t howbig);
+void randomSeed(uint32_t seed);
+
+// --- GPIO ---
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+uint8_t digitalRead(uint8_t pin);
+static inline void digitalWriteFast(uint8_t pin, uint8_t val) { digitalWrite(pin, val); }
+static inline uint8_t digitalReadFast(uint8_t pin) { return digitalRead(pin); }
+static inline void digitalToggleFast(uint8_t) { }
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+void analogReadResolution(unsigned int bits);
+void analogWriteResolution(unsigned int bits);
+void attachInterrupt(uint8_t pin, void (*function)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+#define digitalPinToInterrupt(p) (p)
+#define NVIC_SET_PRIORITY(irq, prio) do { } while (0)
+#define NVIC_ENABLE_IRQ(irq) do { } while (0)
+#define NVIC_DISABLE_IRQ(irq) do { } while (0)
+
+// --- interrupts; the host harness is single-threaded ---
+static inline void __disable_irq() { }
+static inline void __enable_irq() { }
+static inline void noInterrupts() { }
+static inline void interrupts() { }
+static inline uint32_t __LDREXW(volatile uint32_t *addr) { return *addr; }
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr) { *addr = value; return 0; }
+static inline void __CLREX() { }
+#define __DMB() do { } while (0)
+#define __DSB() do { } while (0)
+#define __ISB() do { } while (0)
+
+#include "imxrt.h"
+#include "WString.h"
+#include "Print.h"
+#include "elapsedMillis.h"
+#include "IntervalTimer.h"
+#include "usb_midi.h"
+
+// --- memory ---
+extern "C" {
+void *extmem_malloc(size_t size);
+void *extmem_calloc(size_t nmemb, size_t size);
+void extmem_free(void *ptr);
+void *extmem_realloc(void *ptr, size_t size);
+}
+static inline void arm_dcache_flush(void *, uint32_t) { }
+static inline void arm_dcache_delete(void *, uint32_t) { }
+static inline void arm_dcache_flush_delete(void *, uint32_t) { }
+
+struct CrashReportClass {
+  explicit operator bool() const { return false; }
+};
+extern CrashReportClass CrashReport;
+
+#endif // HOST_ARDUINO_H_
@@ -0,0 +1,19 @@
+#ifndef HOST_AUDIO_H_
+#define HOST_AUDIO_H_
+
+#include <stdint.h>
+
+// Just the Teensy Audio library definitions the buffer/DSP headers in
+// src/Audio need; AudioStream and the effects themselves aren't available.
+#define AUDIO_BLOCK_SAMPLES 128
+#define AUDIO_SAMPLE_RATE_EXACT 44117.64706f
+#define AUDIO_SAMPLE_RATE AUDIO_SAMPLE_RATE_EXACT
+
+typedef struct audio_block_struct {
+  uint8_t ref_count;
+  uint8_t reserved1;
+  uint16_t memory_pool_index;
+  int16_t data[AUDIO_BLOCK_SAMPLES];
+} audio_block_t;
+
+#endif // HOST_AUDIO_H_
@@ -0,0 +1,16 @@
+#ifndef HOST_DMACHANNEL_H_
+#define HOST_DMACHANNEL_H_
+
+#include "Arduino.h"
+
+class DMAChannel {
+public:
+  void begin(bool = false) { }
+  void enable() { }
+  void disable() { }
+  bool complete() { return true; }
+  void clearComplete() { }
+  void clearInterrupt() { }
+};
+
+#endif // HOST_DMACHANNEL_H_
@@ -0,0 +1,59 @@
+#ifndef HOST_EEPROM_H_
+#define HOST_EEPROM_H_
+
+#include "Arduino.h"
+#include <string.h>
+
+#ifndef E2END
+#if defined(ARDUINO_TEENSY40)
+#define E2END 0xBFF
+#elif defined(ARDUINO_TEENSY41)
+#define E2END 0x10BB
+#else
+#define E2END 0x7FF
+#endif
+#endif
+
+// Emulated EEPROM, zero-filled at startup.
+uint8_t *host_eeprom_data();
+
+struct EERef {
+  EERef(int index) : index(index) { }
+  operator uint8_t() const { return host_eeprom_data()[index]; }
+  EERef &operator=(uint8_t in) { host_eeprom_data()[index] = in; return *this; }
+  EERef &update(uint8_t in) { return *this = in; }
+  int index;
+};
+
+struct EEPtr {
+  EEPtr(int index) : index(index) { }
+  operator int() const { return index; }
+  EEPtr &operator=(int in) { index = in; return *this; }
+  EERef operator*() { return index; }
+  EEPtr &operator++() { ++index; return *this; }
+  EEPtr operator++(int) { EEPtr ptr = *this; ++index; return ptr; }
+  int index;
+};
+
+class EEPROMClass {
+public:
+  uint8_t read(int idx) { return host_eeprom_data()[idx]; }
+  void write(int idx, uint8_t val) { host_eeprom_data()[idx] = val; }
+  void update(int idx, uint8_t val) { host_eeprom_data()[idx] = val; }
+  uint16_t length() { return E2END + 1; }
+  template <typename T> T &get(int idx, T &t) { memcpy(&t, host_eeprom_data() + idx, sizeof(T)); return t; }
+  template <typename T> const T &put(int idx, const T &t) { memcpy(host_eeprom_data() + idx, &t, sizeof(T)); return t; }
+};
+
+extern EEPROMClass EEPROM;
+
+static inline void eeprom_read_block(void *buf, const void *addr, uint32_t len) {
+  for (uint32_t i = 0; i < len; ++i)
+    ((uint8_t *)buf)[i] = EEPROM.read((int)(uintptr_t)addr + i);
+}
+static inline void eeprom_write_block(const void *buf, void *addr, uint32_t len) {
+  for (uint32_t i = 0; i < len; ++i)
+    EEPROM.write((int)(uintptr_t)addr + i, ((const uint8_t *)buf)[i]);
+}
+
+#endif // HOST_EEPROM_H_
@@ -0,0 +1,167 @@
+#ifndef HOST_FS_H_
+#define HOST_FS_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+#define FILE_READ 0
+#define FILE_WRITE 1
+#define FILE_WRITE_BEGIN 2
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+// In-memory filesystem with the Teensy FS/File API. Directories are implied
+// by path prefixes; good enough for config/preset round-trips in host tests.
+namespace host {
+using FileData = std::vector<uint8_t>;
+using FileTable = std::map<std::string, std::shared_ptr<FileData>>;
+}; // namespace host
+
+class File : public Print {
+public:
+  File() { }
+  File(std::shared_ptr<host::FileData> data, const std::string &path, uint8_t mode)
+  : data_(data), path_(path), pos_(mode == FILE_WRITE ? data->size() : 0) {
+    if (mode == FILE_WRITE_BEGIN) pos_ = 0;
+  }
+  File(host::FileTable *table, const std::string &dir)
+  : table_(table), path_(dir), is_dir_(true) {
+    if (table_) iter_ = table_->lower_bound(path_);
+  }
+
+  explicit operator bool() const { return data_ != nullptr || is_dir_; }
+
+  int available() { return data_ ? (int)(data_->size() - pos_) : 0; }
+  int read() { return (data_ && pos_ < data_->size()) ? (*data_)[pos_++] : -1; }
+  int peek() { return (data_ && pos_ < data_->size()) ? (*data_)[pos_] : -1; }
+  size_t read(void *buf, size_t n) {
+    if (!data_) return 0;
+    n = std::min(n, data_->size() - pos_);
+    memcpy(buf, data_->data() + pos_, n);
+    pos_ += n;
+    return n;
+  }
+  size_t write(uint8_t b) override { return write(&b, 1); }
+  size_t write(const uint8_t *buf, size_t n) override { return write((const void *)buf, n); }
+  using Print::write;
+  size_t write(const void *buf, size_t n) {
+    if (!data_) return 0;
+    if (pos_ + n > data_->size()) data_->resize(pos_ + n);
+    memcpy(data_->data() + pos_, buf, n);
+    pos_ += n;
+    return n;
+  }
+
+  bool seek(uint64_t pos, int mode = SeekSet) {
+    if (!data_) return false;
+    if (mode == SeekCur) pos += pos_;
+    else if (mode == SeekEnd) pos += data_->size();
+    if (pos > data_->size()) return false;
+    pos_ = pos;
+    return true;
+  }
+  uint64_t position() const { return pos_; }
+  uint64_t size() const { return data_ ? data_->size() : 0; }
+  bool truncate(uint64_t size = 0) {
+    if (!data_) return false;
+    data_->resize(size);
+    if (pos_ > size) pos_ = size;
+    return true;
+  }
+  void flush() { }
+  void close() { data_ = nullptr; is_dir_ = false; }
+
+  const char *name() const {
+    size_t slash = path_.rfind('/');
+    return path_.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+  }
+  bool isDirectory() const { return is_dir_; }
+  File openNextFile(uint8_t = FILE_READ) {
+    if (!is_dir_ || !table_) return File();
+    while (iter_ != table_->end() && iter_->first.compare(0, path_.size(), path_) == 0) {
+      auto entry = iter_++;
+      if (entry->first.find('/', path_.size()) != std::string::npos) continue;
+      return File(entry->second, entry->first, FILE_READ);
+    }
+    return File();
+  }
+  void rewindDirectory() { if (table_) iter_ = table_->lower_bound(path_); }
+
+  String readStringUntil(char terminator) {
+    String s;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) s += (char)c;
+    return s;
+  }
+
+private:
+  std::shared_ptr<host::FileData> data_;
+  host::FileTable *table_ = nullptr;
+  host::FileTable::iterator iter_;
+  std::string path_;
+  size_t pos_ = 0;
+  bool is_dir_ = false;
+};
+
+class FS {
+public:
+  virtual ~FS() { }
+
+  File open(const char *filename, uint8_t mode = FILE_READ) {
+    std::string path = normalize(filename);
+    if (path.empty() || path.back() == '/') return File(&files_, path);
+    auto it = files_.find(path);
+    if (it == files_.end()) {
+      if (mode == FILE_READ) {
+        // might be a directory
+        std::string dir = path + '/';
+        auto d = files_.lower_bound(dir);
+        if (d != files_.end() && d->first.compare(0, dir.size(), dir) == 0)
+          return File(&files_, dir);
+        return File();
+      }
+      it = files_.emplace(path, std::make_shared<host::FileData>()).first;
+    }
+    return File(it->second, path, mode);
+  }
+  bool exists(const char *filename) { return files_.count(normalize(filename)) > 0; }
+  bool remove(const char *filename) { return files_.erase(normalize(filename)) > 0; }
+  bool rename(const char *oldname, const char *newname) {
+    auto it = files_.find(normalize(oldname));
+    if (it == files_.end()) return false;
+    auto data = it->second;
+    files_.erase(it);
+    files_[normalize(newname)] = data;
+    return true;
+  }
+  bool mkdir(const char *) { return true; }
+  bool rmdir(const char *) { return true; }
+  uint64_t usedSize() {
+    uint64_t used = 0;
+    for (auto &f : files_) used += f.second->size();
+    return used;
+  }
+  uint64_t totalSize() { return total_size_; }
+  bool format() { files_.clear(); return true; }
+  bool mediaPresent() { return true; }
+
+  // Host-only introspection for tests
+  host::FileTable &files() { return files_; }
+
+protected:
+  static std::string normalize(const char *filename) {
+    std::string path = filename ? filename : "";
+    while (!path.empty() && path.front() == '/') path.erase(0, 1);
+    return path;
+  }
+
+  host::FileTable files_;
+  uint64_t total_size_ = 0;
+};
+
+#endif // HOST_FS_H_
@@ -0,0 +1,17 @@
+#ifndef HOST_INTERVALTIMER_H_
+#define HOST_INTERVALTIMER_H_
+
+#include <stdint.h>
+
+// Timers never fire on the host; the harness calls ISRs explicitly.
+class IntervalTimer {
+public:
+  bool begin(void (*funct)(), uint32_t) { funct_ = funct; return true; }
+  void priority(uint8_t) { }
+  void end() { funct_ = nullptr; }
+  void update(uint32_t) { }
+private:
+  void (*funct_)() = nullptr;
+};
+
+#endif // HOST_INTERVALTIMER_H_
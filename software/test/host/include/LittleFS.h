@@ -0,0 +1,14 @@
+#ifndef HOST_LITTLEFS_H_
+#define HOST_LITTLEFS_H_
+
+#include "FS.h"
+
+class LittleFS_Program : public FS {
+public:
+  bool begin(uint32_t size) { total_size_ = size; return true; }
+  bool quickFormat() { return format(); }
+};
+
+class LittleFS_RAM : public LittleFS_Program { };
+
+#endif // HOST_LITTLEFS_H_
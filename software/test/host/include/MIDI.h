@@ -0,0 +1,34 @@
+#ifndef HOST_MIDI_H_
+#define HOST_MIDI_H_
+
+#include "usb_midi.h"
+
+#define MIDI_CHANNEL_OMNI 0
+#define MIDI_CREATE_INSTANCE(Type, SerialPort, Name) \
+  midi::MidiInterface<midi::SerialMIDI<Type> > Name;
+
+class HardwareSerial { };
+
+namespace midi {
+
+enum MidiType : uint8_t {
+  InvalidType = 0x00, NoteOff = 0x80, NoteOn = 0x90, AfterTouchPoly = 0xA0,
+  ControlChange = 0xB0, ProgramChange = 0xC0, AfterTouchChannel = 0xD0,
+  PitchBend = 0xE0, SystemExclusive = 0xF0, TimeCodeQuarterFrame = 0xF1,
+  SongPosition = 0xF2, SongSelect = 0xF3, TuneRequest = 0xF6, Clock = 0xF8,
+  Start = 0xFA, Continue = 0xFB, Stop = 0xFC, ActiveSensing = 0xFE,
+  SystemReset = 0xFF,
+};
+
+template <class SerialPort> class SerialMIDI { };
+
+template <class Transport> class MidiInterface : public HostMIDIDevice {
+public:
+  void sendRealTime(MidiType t) { HostMIDIDevice::sendRealTime(t); }
+  using HostMIDIDevice::send;
+  void send(MidiType t, uint8_t d1, uint8_t d2, uint8_t ch) { HostMIDIDevice::send(t, d1, d2, ch); }
+};
+
+}; // namespace midi
+
+#endif // HOST_MIDI_H_
@@ -0,0 +1,66 @@
+#ifndef HOST_PRINT_H_
+#define HOST_PRINT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+// Output sink with the Arduino Print API. The host Serial writes to stderr so
+// harness results on stdout stay machine-readable.
+class Print {
+public:
+  virtual ~Print() { }
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t *buf, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buf++);
+    return n;
+  }
+  size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+  size_t write(const char *buf, size_t size) { return write((const uint8_t *)buf, size); }
+
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int n, int base = 10) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = 10) { return print((unsigned long)n, base); }
+  size_t print(long n, int base = 10) {
+    if (base == 10) return printf("%ld", n);
+    return print((unsigned long)n, base);
+  }
+  size_t print(unsigned long n, int base = 10) {
+    return base == 16 ? printf("%lX", n) : printf("%lu", n);
+  }
+  size_t print(unsigned char n, int base = 10) { return print((unsigned long)n, base); }
+  size_t print(double n, int digits = 2) { return printf("%.*f", digits, n); }
+
+  template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+  template <typename T> size_t println(T v, int base) { size_t n = print(v, base); return n + println(); }
+  size_t println() { return write('\n'); }
+
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n < 0) return 0;
+    return write((const uint8_t *)buf, (size_t)n < sizeof(buf) ? n : sizeof(buf) - 1);
+  }
+};
+
+class HostSerial : public Print {
+public:
+  void begin(uint32_t) { }
+  explicit operator bool() const { return false; }
+  int available() { return 0; }
+  int read() { return -1; }
+  void flush() { fflush(stderr); }
+  size_t write(uint8_t b) override { return fputc(b, stderr) == EOF ? 0 : 1; }
+  using Print::write;
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_PRINT_H_
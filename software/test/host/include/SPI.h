@@ -0,0 +1,30 @@
+#ifndef HOST_SPI_H_
+#define HOST_SPI_H_
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+#define MSBFIRST 1
+#define LSBFIRST 0
+
+struct SPISettings {
+  SPISettings() { }
+  SPISettings(uint32_t, uint8_t, uint8_t) { }
+};
+
+class SPIClass {
+public:
+  void begin() { }
+  void beginTransaction(SPISettings) { }
+  void endTransaction() { }
+  uint8_t transfer(uint8_t) { return 0; }
+  uint16_t transfer16(uint16_t) { return 0; }
+  void transfer(const void *, void *, size_t) { }
+};
+
+extern SPIClass SPI, SPI1;
+
+#endif // HOST_SPI_H_
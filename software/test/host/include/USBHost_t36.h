@@ -0,0 +1,20 @@
+#ifndef HOST_USBHOST_T36_H_
+#define HOST_USBHOST_T36_H_
+
+#include "usb_midi.h"
+
+class USBHost {
+public:
+  void begin() { }
+  void Task() { }
+};
+class USBHub {
+public:
+  USBHub(USBHost &) { }
+};
+class MIDIDevice_BigBuffer : public HostMIDIDevice {
+public:
+  MIDIDevice_BigBuffer(USBHost &) { }
+};
+
+#endif // HOST_USBHOST_T36_H_
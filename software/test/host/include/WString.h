@@ -0,0 +1,34 @@
+#ifndef HOST_WSTRING_H_
+#define HOST_WSTRING_H_
+
+#include <string>
+#include <stdlib.h>
+
+// Just enough of Arduino's String for the few call sites that use it.
+class String : public std::string {
+public:
+  String() { }
+  String(const char *s) : std::string(s ? s : "") { }
+  String(const std::string &s) : std::string(s) { }
+  String(int v) : std::string(std::to_string(v)) { }
+
+  int indexOf(char c) const { auto p = find(c); return p == npos ? -1 : (int)p; }
+  int indexOf(const char *s) const { auto p = find(s); return p == npos ? -1 : (int)p; }
+  String substring(size_t from) const { return from < size() ? String(substr(from)) : String(); }
+  String substring(size_t from, size_t to) const {
+    return from < size() ? String(substr(from, to > from ? to - from : 0)) : String();
+  }
+  void trim() {
+    size_t b = find_first_not_of(" \t\r\n");
+    size_t e = find_last_not_of(" \t\r\n");
+    if (b == npos) clear();
+    else *this = substr(b, e - b + 1);
+  }
+  bool startsWith(const char *s) const { return rfind(s, 0) == 0; }
+  float toFloat() const { return strtof(c_str(), nullptr); }
+  long toInt() const { return strtol(c_str(), nullptr, 10); }
+  unsigned int length() const { return size(); }
+  char charAt(size_t i) const { return i < size() ? (*this)[i] : 0; }
+};
+
+#endif // HOST_WSTRING_H_
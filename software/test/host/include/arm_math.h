@@ -0,0 +1,16 @@
+#ifndef HOST_ARM_MATH_H_
+#define HOST_ARM_MATH_H_
+
+#include <math.h>
+#include <stdint.h>
+
+// Reference (not bit-exact) versions of the CMSIS-DSP calls used by the
+// control-rate code paths.
+typedef float float32_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+static inline float32_t arm_sin_f32(float32_t x) { return sinf(x); }
+static inline float32_t arm_cos_f32(float32_t x) { return cosf(x); }
+
+#endif // HOST_ARM_MATH_H_
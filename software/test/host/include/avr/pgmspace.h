@@ -0,0 +1,4 @@
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+#include <Arduino.h>
+#endif
@@ -0,0 +1,9 @@
+#ifndef HOST_AVR_FUNCTIONS_H_
+#define HOST_AVR_FUNCTIONS_H_
+
+#include <stdint.h>
+
+uint8_t eeprom_read_byte(const uint8_t *addr);
+void eeprom_write_byte(uint8_t *addr, uint8_t value);
+
+#endif // HOST_AVR_FUNCTIONS_H_
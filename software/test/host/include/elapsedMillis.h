@@ -0,0 +1,33 @@
+#ifndef HOST_ELAPSEDMILLIS_H_
+#define HOST_ELAPSEDMILLIS_H_
+
+#include <stdint.h>
+
+uint32_t millis();
+uint32_t micros();
+
+class elapsedMillis {
+public:
+  elapsedMillis() : ms_(millis()) { }
+  elapsedMillis(uint32_t val) : ms_(millis() - val) { }
+  operator uint32_t() const { return millis() - ms_; }
+  elapsedMillis &operator=(uint32_t val) { ms_ = millis() - val; return *this; }
+  elapsedMillis &operator-=(uint32_t val) { ms_ += val; return *this; }
+  elapsedMillis &operator+=(uint32_t val) { ms_ -= val; return *this; }
+private:
+  uint32_t ms_;
+};
+
+class elapsedMicros {
+public:
+  elapsedMicros() : us_(micros()) { }
+  elapsedMicros(uint32_t val) : us_(micros() - val) { }
+  operator uint32_t() const { return micros() - us_; }
+  elapsedMicros &operator=(uint32_t val) { us_ = micros() - val; return *this; }
+  elapsedMicros &operator-=(uint32_t val) { us_ += val; return *this; }
+  elapsedMicros &operator+=(uint32_t val) { us_ -= val; return *this; }
+private:
+  uint32_t us_;
+};
+
+#endif // HOST_ELAPSEDMILLIS_H_
@@ -0,0 +1,66 @@
+// Host stand-ins for the i.MX RT1062 peripheral registers referenced from
+// firmware headers. Each one is an ordinary variable so that inline driver code
+// (e.g. DAC8565::WriteChannelX) compiles and costs roughly a store.
+
+#ifndef HOST_IMXRT_H_
+#define HOST_IMXRT_H_
+
+#include <stdint.h>
+
+namespace host {
+struct Registers {
+  volatile uint32_t LPSPI4_TCR, LPSPI4_TDR, LPSPI4_SR, LPSPI4_FSR, LPSPI4_CR;
+  volatile uint32_t LPSPI3_TCR, LPSPI3_TDR, LPSPI3_SR, LPSPI3_FSR, LPSPI3_CR;
+  volatile uint32_t IOMUXC_SW_MUX_CTL_PAD_GPIO_B0_00;
+  volatile uint32_t IOMUXC_SW_MUX_CTL_PAD_GPIO_B0_01;
+  volatile uint32_t IOMUXC_SW_PAD_CTL_PAD_GPIO_B0_01;
+  volatile uint32_t ARM_DEMCR, ARM_DWT_CTRL;
+  volatile uint32_t SCB_AIRCR;
+};
+extern Registers registers;
+}; // namespace host
+
+#define LPSPI4_TCR host::registers.LPSPI4_TCR
+#define LPSPI4_TDR host::registers.LPSPI4_TDR
+#define LPSPI4_SR host::registers.LPSPI4_SR
+#define LPSPI4_FSR host::registers.LPSPI4_FSR
+#define LPSPI4_CR host::registers.LPSPI4_CR
+#define LPSPI3_TCR host::registers.LPSPI3_TCR
+#define LPSPI3_TDR host::registers.LPSPI3_TDR
+#define LPSPI3_SR host::registers.LPSPI3_SR
+#define LPSPI3_FSR host::registers.LPSPI3_FSR
+#define LPSPI3_CR host::registers.LPSPI3_CR
+#define IOMUXC_SW_MUX_CTL_PAD_GPIO_B0_00 host::registers.IOMUXC_SW_MUX_CTL_PAD_GPIO_B0_00
+#define IOMUXC_SW_MUX_CTL_PAD_GPIO_B0_01 host::registers.IOMUXC_SW_MUX_CTL_PAD_GPIO_B0_01
+#define IOMUXC_SW_PAD_CTL_PAD_GPIO_B0_01 host::registers.IOMUXC_SW_PAD_CTL_PAD_GPIO_B0_01
+#define SCB_AIRCR host::registers.SCB_AIRCR
+
+#define LPSPI_TCR_FRAMESZ(n) ((uint32_t)(((n) & 0xFFF) << 0))
+#define LPSPI_TCR_PCS(n) ((uint32_t)(((n) & 0x03) << 24))
+#define LPSPI_TCR_RXMSK ((uint32_t)(1 << 19))
+#define LPSPI_TCR_TXMSK ((uint32_t)(1 << 18))
+#define LPSPI_TCR_CONT ((uint32_t)(1 << 21))
+#define LPSPI_SR_TCF ((uint32_t)(1 << 10))
+#define LPSPI_SR_FCF ((uint32_t)(1 << 9))
+#define LPSPI_SR_MBF ((uint32_t)(1 << 24))
+
+#define ARM_DEMCR host::registers.ARM_DEMCR
+#define ARM_DEMCR_TRCENA (1 << 24)
+#define ARM_DWT_CTRL host::registers.ARM_DWT_CTRL
+#define ARM_DWT_CTRL_CYCCNTENA (1 << 0)
+#define ARM_DWT_CYCCNT (host_cycle_count())
+
+typedef struct {
+  volatile uint32_t DR, GDIR, PSR, ICR1, ICR2, IMR, ISR, EDGE_SEL;
+  volatile uint32_t DR_SET, DR_CLEAR, DR_TOGGLE;
+} IMXRT_GPIO_t;
+
+typedef struct { volatile uint32_t dummy[64]; } IMXRT_FLEXPWM_t;
+typedef struct { volatile uint32_t dummy[64]; } IMXRT_TMR_t;
+typedef int IRQ_NUMBER_t;
+
+#ifndef F_BUS_ACTUAL
+#define F_BUS_ACTUAL F_BUS
+#endif
+
+#endif // HOST_IMXRT_H_
@@ -0,0 +1,7 @@
+#ifndef HOST_SMALLOC_H_
+#define HOST_SMALLOC_H_
+
+// extmem_* are declared in the Arduino shim and implemented in host_hal.cpp
+#include "Arduino.h"
+
+#endif // HOST_SMALLOC_H_
@@ -0,0 +1,3 @@
+#ifndef HOST_USB_DESC_H_
+#define HOST_USB_DESC_H_
+#endif
@@ -0,0 +1,74 @@
+#ifndef HOST_USB_MIDI_H_
+#define HOST_USB_MIDI_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Stand-in for Teensyduino's usbMIDI (and the USB host / serial MIDI ports,
+// which share this interface). Received messages come from a small FIFO that
+// the host harness fills; sent messages are only counted.
+class HostMIDIDevice {
+public:
+  enum {
+    InvalidType = 0x00, NoteOff = 0x80, NoteOn = 0x90, AfterTouchPoly = 0xA0,
+    ControlChange = 0xB0, ProgramChange = 0xC0, AfterTouchChannel = 0xD0,
+    PitchBend = 0xE0, SystemExclusive = 0xF0, TimeCodeQuarterFrame = 0xF1,
+    SongPosition = 0xF2, SongSelect = 0xF3, TuneRequest = 0xF6, Clock = 0xF8,
+    Start = 0xFA, Continue = 0xFB, Stop = 0xFC, ActiveSensing = 0xFE,
+    SystemReset = 0xFF
+  };
+
+  static constexpr size_t kQueueSize = 256;
+
+  // Harness side: queue a message to be returned by read(). Channel is 1-16.
+  bool inject(uint8_t type, uint8_t data1, uint8_t data2, uint8_t channel) {
+    size_t next = (head_ + 1) % kQueueSize;
+    if (next == tail_) return false;
+    queue_[head_] = { type, data1, data2, channel };
+    head_ = next;
+    return true;
+  }
+  size_t pending() const { return (head_ + kQueueSize - tail_) % kQueueSize; }
+
+  void begin(int = 0) { }
+  bool read(uint8_t = 0) {
+    if (head_ == tail_) return false;
+    current_ = queue_[tail_];
+    tail_ = (tail_ + 1) % kQueueSize;
+    return true;
+  }
+  uint8_t getType() const { return current_.type; }
+  uint8_t getChannel() const { return current_.channel; }
+  uint8_t getData1() const { return current_.data1; }
+  uint8_t getData2() const { return current_.data2; }
+  uint8_t *getSysExArray() { return sysex_; }
+  uint16_t getSysExArrayLength() const { return 0; }
+
+  void send(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t = 0) { ++sent_; }
+  void sendNoteOn(uint8_t, uint8_t, uint8_t, uint8_t = 0) { ++sent_; }
+  void sendNoteOff(uint8_t, uint8_t, uint8_t, uint8_t = 0) { ++sent_; }
+  void sendControlChange(uint8_t, uint8_t, uint8_t, uint8_t = 0) { ++sent_; }
+  void sendPitchBend(int, uint8_t, uint8_t = 0) { ++sent_; }
+  void sendAfterTouch(uint8_t, uint8_t, uint8_t = 0) { ++sent_; }
+  void sendAfterTouchPoly(uint8_t, uint8_t, uint8_t, uint8_t = 0) { ++sent_; }
+  void sendProgramChange(uint8_t, uint8_t, uint8_t = 0) { ++sent_; }
+  void sendRealTime(uint8_t, uint8_t = 0) { ++sent_; }
+  void sendSysEx(uint32_t, const uint8_t *, bool = false, uint8_t = 0) { ++sent_; }
+  void send_now() { }
+  void turnThruOn() { }
+  void turnThruOff() { }
+
+  uint32_t sent_count() const { return sent_; }
+
+private:
+  struct Message { uint8_t type, data1, data2, channel; };
+  Message queue_[kQueueSize];
+  size_t head_ = 0, tail_ = 0;
+  Message current_ = { 0, 0, 0, 0 };
+  uint8_t sysex_[4] = { 0 };
+  uint32_t sent_ = 0;
+};
+
+extern HostMIDIDevice usbMIDI;
+
+#endif // HOST_USB_MIDI_H_
@@ -0,0 +1,347 @@
+// Host-native cycle-budget benchmark for the core ISR pipeline.
+//
+// Builds the T4.0 firmware configuration against the stubs in host_hal.cpp,
+// runs the same sequence as CORE_timer_ISR() in Main.cpp for every tick of a
+// replayed (or synthetic) input stream, and reports per-tick p50/p99/max.
+// Cycle counts are host nanoseconds scaled to F_CPU, so they are only
+// meaningful relative to each other -- use them to compare builds, apps and
+// applet pairs, not as absolute Teensy numbers.
+//
+// Usage: isr_bench [-a APP] [-l APPLET] [-r APPLET] [-n TICKS] [-f FRAMES]
+//                  [-w WARMUP] [-c CSV] [--list]
+//
+//   APP     two-character app id, e.g. HS (Hemisphere), AS (ASR)
+//   APPLET  Hemisphere applet name or numeric id
+//   FRAMES  input replay file, one line per run of ticks:
+//             <ticks> <cv1> <cv2> <cv3> <cv4> <gates> [<status> <d1> <d2>]...
+//           CVs are in volts, gates is a TR1-TR4 bitmask, MIDI messages are
+//           queued on the first tick of the line. '#' starts a comment. The
+//           file loops until TICKS have run.
+//   CSV     optional file receiving the raw per-tick cycle counts
+
+// The app container and AppHemisphere live in OC_apps.cpp; pull it in whole
+// so the harness can pick apps and applets without widening the firmware API.
+#include "OC_apps.cpp"
+
+#include <strings.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "OC_ADC.h"
+#include "OC_DAC.h"
+#include "OC_calibration.h"
+#include "OC_digital_inputs.h"
+#include "src/drivers/display.h"
+#include "host_hal.h"
+
+static OC::IOFrame io_frame;
+
+// Same body as CORE_timer_ISR(), minus the debug pin
+static void core_isr_tick() {
+  using namespace OC;
+
+  display::Flush();
+  DAC::Update();
+  display::Update();
+
+  OC::ADC::Scan_DMA();
+
+  DigitalInputs::Scan();
+
+  ++CORE::ticks;
+  if (CORE::app_isr_enabled) {
+    OC::app_switcher.Process(&io_frame);
+  }
+}
+
+namespace {
+
+struct MidiMessage {
+  uint8_t status, data1, data2;
+};
+
+struct InputFrame {
+  uint32_t ticks;
+  float cv[ADC_CHANNEL_COUNT];
+  uint32_t gates;
+  std::vector<MidiMessage> midi;
+};
+
+bool LoadFrames(const char *path, std::vector<InputFrame> &frames) {
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+
+  char line[512];
+  while (fgets(line, sizeof(line), f)) {
+    char *comment = strchr(line, '#');
+    if (comment) *comment = '\0';
+
+    InputFrame frame = {};
+    char *p = line;
+    int n = 0;
+    if (sscanf(p, "%u%n", &frame.ticks, &n) != 1) continue;
+    p += n;
+    for (int i = 0; i < 4; ++i) {
+      n = 0;
+      sscanf(p, "%f%n", &frame.cv[i], &n);
+      p += n;
+    }
+    n = 0;
+    sscanf(p, "%i%n", &frame.gates, &n);
+    p += n;
+
+    unsigned status, d1, d2;
+    while (sscanf(p, "%i %i %i%n", &status, &d1, &d2, &n) == 3) {
+      frame.midi.push_back({ uint8_t(status), uint8_t(d1), uint8_t(d2) });
+      p += n;
+    }
+    if (frame.ticks) frames.push_back(frame);
+  }
+  fclose(f);
+  return !frames.empty();
+}
+
+// Default stimulus: a 120 BPM clock on TR1, TR2 at half speed, a slow ramp on
+// CV1, a faster triangle on CV2 and a note on/off pair every beat on channel 1.
+void SyntheticFrames(std::vector<InputFrame> &frames) {
+  const uint32_t beat = OC_CORE_ISR_FREQ / 2;
+  const uint32_t pulse = OC_CORE_ISR_FREQ / 200; // 5ms
+  const int steps = 16;
+  for (int beat_idx = 0; beat_idx < 8; ++beat_idx) {
+    for (int s = 0; s < steps; ++s) {
+      InputFrame frame = {};
+      const uint32_t t0 = s * beat / steps;
+      const uint32_t t1 = (s + 1) * beat / steps;
+      frame.ticks = t1 - t0;
+      frame.cv[0] = -3.0f + 9.0f * float(beat_idx * steps + s) / (8 * steps);
+      frame.cv[1] = 2.5f * (1.0f - fabsf(float(2 * s - steps) / steps));
+      if (s == 0) {
+        frame.gates = 1 | ((beat_idx & 1) ? 0 : 2);
+        frame.midi.push_back({ 0x90, uint8_t(48 + beat_idx * 3), 100 });
+      } else if (s == steps / 2) {
+        frame.midi.push_back({ 0x80, uint8_t(48 + beat_idx * 3), 0 });
+      }
+      if (s == 0 && frame.ticks > pulse) {
+        // split the gate-high segment off the rest of the step
+        InputFrame low = frame;
+        low.gates = 0;
+        low.midi.clear();
+        low.ticks = frame.ticks - pulse;
+        frame.ticks = pulse;
+        frames.push_back(frame);
+        frames.push_back(low);
+      } else {
+        frames.push_back(frame);
+      }
+    }
+  }
+}
+
+int FindApplet(const char *name) {
+  char *end = nullptr;
+  unsigned long id = strtoul(name, &end, 0);
+  if (end && *end == '\0') {
+    for (int i = 0; i < HS::HEMISPHERE_AVAILABLE_APPLETS; ++i)
+      if (HS::appletIds[i] == id) return i;
+    return -1;
+  }
+  for (int i = 0; i < HS::HEMISPHERE_AVAILABLE_APPLETS; ++i) {
+    if (!strcasecmp(HS::get_applet_name(i), name)) return i;
+  }
+  return -1;
+}
+
+void ListAppsAndApplets() {
+  printf("Apps:\n");
+  for (size_t i = 0; i < OC::app_container.num_apps(); ++i) {
+    OC::AppBase *app = OC::app_container[i];
+    printf("  %c%c  %s\n", app->id() >> 8, app->id() & 0xff, app->name());
+  }
+  printf("Hemisphere applets:\n");
+  for (int i = 0; i < HS::HEMISPHERE_AVAILABLE_APPLETS; ++i)
+    printf("  %-4llu %s\n", (unsigned long long)HS::appletIds[i], HS::get_applet_name(i));
+}
+
+uint32_t Percentile(const std::vector<uint32_t> &sorted, double p) {
+  if (sorted.empty()) return 0;
+  size_t idx = size_t(p * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+void Usage() {
+  fprintf(stderr, "usage: isr_bench [-a APP] [-l APPLET] [-r APPLET] [-n TICKS] "
+                  "[-f FRAMES] [-w WARMUP] [-c CSV] [--list]\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const char *app_name = "HS";
+  const char *applet_name[2] = { nullptr, nullptr };
+  const char *frames_path = nullptr;
+  const char *csv_path = nullptr;
+  uint32_t num_ticks = 10 * OC_CORE_ISR_FREQ;
+  uint32_t warmup_ticks = OC_CORE_ISR_FREQ / 10;
+  bool list = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--list") list = true;
+    else if (arg == "-a" && has_value) app_name = argv[++i];
+    else if (arg == "-l" && has_value) applet_name[0] = argv[++i];
+    else if (arg == "-r" && has_value) applet_name[1] = argv[++i];
+    else if (arg == "-n" && has_value) num_ticks = strtoul(argv[++i], nullptr, 0);
+    else if (arg == "-w" && has_value) warmup_ticks = strtoul(argv[++i], nullptr, 0);
+    else if (arg == "-f" && has_value) frames_path = argv[++i];
+    else if (arg == "-c" && has_value) csv_path = argv[++i];
+    else { Usage(); return 2; }
+  }
+
+  if (list) {
+    ListAppsAndApplets();
+    return 0;
+  }
+
+  if (strlen(app_name) != 2) {
+    fprintf(stderr, "App id must be two characters, e.g. HS\n");
+    return 2;
+  }
+  const uint16_t app_id = TWOCCS(app_name);
+
+  std::vector<InputFrame> frames;
+  if (frames_path) {
+    if (!LoadFrames(frames_path, frames)) {
+      fprintf(stderr, "Failed to load input frames from %s\n", frames_path);
+      return 1;
+    }
+  } else {
+    SyntheticFrames(frames);
+  }
+
+  // -- Same order as setup() in Main.cpp, minus the UI and splash screens
+  OC::DigitalInputs::Init();
+  OC::calibration_load();
+  OC::ADC::Init(&OC::calibration_data.adc);
+  OC::ADC::Init_DMA();
+  OC::DAC::Init(&OC::calibration_data.dac, &OC::global_settings.autotune_calibration_data);
+  display::Init();
+  io_frame.Reset();
+
+  PhzConfig::Init();
+  // Pre-seed valid metadata so AppSwitcher::Init selects the app and does not
+  // wait for a reset confirmation.
+  uint64_t metadata = 0;
+  Pack(metadata, PackLocation{0, 16}, app_id);
+  Pack(metadata, PackLocation{17, 1}, 1);
+  PhzConfig::setValue(OC::METADATA_KEY, metadata);
+
+  OC::app_switcher.Init(false);
+  OC::AppBase *app = OC::app_switcher.current_app();
+  if (app->id() != app_id) {
+    fprintf(stderr, "App %s not found; try --list\n", app_name);
+    return 1;
+  }
+  app->DispatchAppEvent(OC::APP_EVENT_RESUME);
+
+#ifndef NO_HEMISPHERE
+  if (app_id == AppHemisphere::kAppId) {
+    AppHemisphere *hemisphere = static_cast<AppHemisphere *>(app);
+    for (int h = 0; h < 2; ++h) {
+      if (!applet_name[h]) continue;
+      int index = FindApplet(applet_name[h]);
+      if (index < 0) {
+        fprintf(stderr, "Applet %s not found; try --list\n", applet_name[h]);
+        return 1;
+      }
+      hemisphere->SetApplet(HEM_SIDE(h), index);
+    }
+  }
+#endif
+
+  OC::CORE::app_isr_enabled = true;
+  OC::CORE::app_loop_enabled = true;
+
+  std::vector<uint32_t> cycles;
+  cycles.reserve(num_ticks);
+
+  const uint32_t tick_us = OC_CORE_TIMER_RATE;
+  size_t frame_idx = 0;
+  uint32_t frame_ticks = 0;
+  for (uint32_t tick = 0; tick < warmup_ticks + num_ticks; ++tick) {
+    const InputFrame &frame = frames[frame_idx];
+    if (frame_ticks == 0) {
+      std::copy(frame.cv, frame.cv + ADC_CHANNEL_COUNT, host::inputs.cv);
+      host::inputs.gates = frame.gates;
+      for (const MidiMessage &m : frame.midi)
+        usbMIDI.inject(m.status & 0xf0, m.data1, m.data2, (m.status & 0x0f) + 1);
+    }
+    if (++frame_ticks >= frame.ticks) {
+      frame_ticks = 0;
+      frame_idx = (frame_idx + 1) % frames.size();
+    }
+
+    const uint32_t start = ARM_DWT_CYCCNT;
+    core_isr_tick();
+    const uint32_t elapsed = ARM_DWT_CYCCNT - start;
+    if (tick >= warmup_ticks)
+      cycles.push_back(elapsed);
+
+    host::advance_time_us(tick_us);
+
+    // Stand-in for loop(): MIDI ingest, deferred tasks, periodic redraw
+    if (OC::CORE::app_loop_enabled)
+      app->DispatchLoop();
+    OC::CORE::FlushTasks();
+    if (!(tick & 0x3ff)) {
+      GRAPHICS_BEGIN_FRAME(false);
+      app->Draw(OC::UI_MODE_MENU);
+      GRAPHICS_END_FRAME();
+    }
+  }
+
+  if (csv_path) {
+    FILE *csv = fopen(csv_path, "w");
+    if (csv) {
+      fprintf(csv, "tick,cycles\n");
+      for (size_t i = 0; i < cycles.size(); ++i)
+        fprintf(csv, "%zu,%u\n", i, cycles[i]);
+      fclose(csv);
+    }
+  }
+
+  std::vector<uint32_t> sorted(cycles);
+  std::sort(sorted.begin(), sorted.end());
+  const uint32_t budget = F_CPU / OC_CORE_ISR_FREQ;
+  const double cycles_per_us = F_CPU / 1000000.0;
+  const uint32_t p50 = Percentile(sorted, 0.50);
+  const uint32_t p99 = Percentile(sorted, 0.99);
+  const uint32_t max = sorted.empty() ? 0 : sorted.back();
+  size_t over_budget = std::count_if(sorted.begin(), sorted.end(),
+                                     [budget](uint32_t c) { return c > budget; });
+
+  printf("app: %s (%c%c)\n", app->name(), app_id >> 8, app_id & 0xff);
+#ifndef NO_HEMISPHERE
+  if (app_id == AppHemisphere::kAppId) {
+    printf("applets: %s | %s\n",
+           applet_name[0] ? HS::get_applet_name(FindApplet(applet_name[0])) : "(preset)",
+           applet_name[1] ? HS::get_applet_name(FindApplet(applet_name[1])) : "(preset)");
+  }
+#endif
+  printf("ticks: %zu @ %u Hz (budget %u cycles / %.2f us)\n",
+         cycles.size(), (unsigned)OC_CORE_ISR_FREQ, budget, budget / cycles_per_us);
+  printf("%-4s %10s %10s %8s\n", "", "cycles", "us", "budget%");
+  for (auto stat : { std::make_pair("p50", p50), std::make_pair("p99", p99), std::make_pair("max", max) }) {
+    printf("%-4s %10u %10.2f %7.1f%%\n", stat.first, stat.second,
+           stat.second / cycles_per_us, 100.0 * stat.second / budget);
+  }
+  printf("over budget: %zu\n", over_budget);
+  printf("display pages sent: %u, skipped: %lu\n", host::display_stats.pages_sent,
+         (unsigned long)display::pages_skipped());
+#ifdef APPLET_PROFILING
+  HS::Profiler::Dump();
+#endif
+
+  return 0;
+}
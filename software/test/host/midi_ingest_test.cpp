@@ -0,0 +1,226 @@
+// Host tests for the MIDI ingest queue: dense MIDI streams replayed through
+// the queue and MIDIFrame::ProcessMIDIMsg end up in the same state as when
+// every message is processed on arrival, the ISR never takes more than
+// MIDI_INGEST_PER_TICK per tick, and the counters add up.
+
+// Applet registry and app container, which the firmware archive refers to
+#include "OC_apps.cpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using HS::MIDIMessage;
+using HS::MIDIMapSettings;
+
+struct TimedMessage {
+  uint32_t tick;
+  MIDIMessage msg;
+};
+
+std::unique_ptr<HS::MIDIFrame> MakeFrame() {
+  std::unique_ptr<HS::MIDIFrame> f(new HS::MIDIFrame());
+  f->Init();
+  f->mapping[0].SetPitch(MIDIMapSettings::NOTE_MONO);
+  f->mapping[1].SetGate(MIDIMapSettings::GATE_MONO);
+  f->mapping[2].SetCC(1);
+  f->mapping[3].SetModulator(MIDIMapSettings::MOD_BEND);
+  f->mapping[4].SetModulator(MIDIMapSettings::MOD_VEL_MONO);
+  f->mapping[5].SetCC(74);
+  f->mapping[6].SetPitch(MIDIMapSettings::NOTE_MAX);
+  f->mapping[7].SetGate(MIDIMapSettings::GATE_RUN);
+  for (int i = 0; i < 8; ++i) f->mapping[i].SetChannel(0);
+  f->UpdateMidiChannelFilter();
+  f->UpdateMaxPolyphony();
+  return f;
+}
+
+// Bursts of clock, CC, bend and notes on channel 1, the way a sequencer
+// with a busy automation lane sends them: up to 24 messages arriving in the
+// same tick, several thousand per second overall.
+std::vector<TimedMessage> DenseStream(int bursts, uint32_t seed) {
+  std::vector<TimedMessage> stream;
+  uint32_t tick = 100;
+  uint8_t held = 0;
+  auto rnd = [&seed]() {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+  };
+
+  stream.push_back({tick, {1, midi::Start, 0, 0}});
+  for (int b = 0; b < bursts; ++b) {
+    const int count = 1 + rnd() % 24;
+    for (int i = 0; i < count; ++i) {
+      MIDIMessage msg;
+      switch (rnd() % 6) {
+        case 0: msg = {1, midi::Clock, 0, 0}; break;
+        case 1: msg = {1, midi::ControlChange, 1, uint8_t(rnd() % 128)}; break;
+        case 2: msg = {1, midi::ControlChange, 74, uint8_t(rnd() % 128)}; break;
+        case 3: {
+          const uint16_t bend = rnd() % 16384;
+          msg = {1, midi::PitchBend, uint8_t(bend & 0x7f), uint8_t(bend >> 7)};
+          break;
+        }
+        default:
+          if (held) {
+            msg = {1, midi::NoteOff, held, 0};
+            held = 0;
+          } else {
+            held = 36 + rnd() % 48;
+            msg = {1, midi::NoteOn, held, uint8_t(1 + rnd() % 127)};
+          }
+          break;
+      }
+      stream.push_back({tick, msg});
+    }
+    tick += 10 + rnd() % 100; // ~0.6 to 6.6ms apart
+  }
+  return stream;
+}
+
+void ExpectSameState(const HS::MIDIFrame &expected, const HS::MIDIFrame &actual) {
+  for (int i = 0; i < HS::MIDIMAP_MAX; ++i) {
+    EXPECT_EQ(expected.mapping[i].output, actual.mapping[i].output) << "mapping " << i;
+    EXPECT_EQ(expected.mapping[i].pitch_bend, actual.mapping[i].pitch_bend) << "mapping " << i;
+  }
+  EXPECT_EQ(expected.clock_count, actual.clock_count);
+  EXPECT_EQ(expected.clock_run, actual.clock_run);
+}
+
+// Feeds the stream tick by tick, the main loop pushing what arrived and the
+// ISR draining; returns the number of ticks it took to empty the queue.
+template <typename Queue, typename F>
+uint32_t Replay(Queue &queue, const std::vector<TimedMessage> &stream, F &&process,
+                size_t *max_per_tick = nullptr) {
+  size_t next = 0;
+  uint32_t tick = stream.front().tick;
+  while (next < stream.size() || queue.readable()) {
+    while (next < stream.size() && stream[next].tick == tick) {
+      queue.Push(stream[next].msg, stream[next].tick);
+      ++next;
+    }
+    const size_t n = queue.Drain(tick, HS::MIDI_INGEST_PER_TICK, process);
+    if (max_per_tick && n > *max_per_tick) *max_per_tick = n;
+    ++tick;
+  }
+  return tick;
+}
+
+TEST(MIDIIngest, DenseStreamMatchesDirectProcessing) {
+  for (uint32_t seed : {1u, 7u, 12345u}) {
+    const auto stream = DenseStream(400, seed);
+    auto direct = MakeFrame();
+    auto queued = MakeFrame();
+
+    for (const auto &m : stream) direct->ProcessMIDIMsg(m.msg);
+
+    size_t max_per_tick = 0;
+    Replay(queued->ingest, stream, [&](const MIDIMessage &msg) {
+      queued->ProcessMIDIMsg(msg);
+    }, &max_per_tick);
+
+    ExpectSameState(*direct, *queued);
+    EXPECT_EQ(stream.size(), queued->ingest.received);
+    EXPECT_EQ(stream.size(), queued->ingest.processed);
+    EXPECT_EQ(0U, queued->ingest.dropped);
+    EXPECT_LE(max_per_tick, HS::MIDI_INGEST_PER_TICK);
+  }
+}
+
+TEST(MIDIIngest, ProcessQueuedMIDIAppliesToFrame) {
+  auto f = MakeFrame();
+  EXPECT_TRUE(f->QueueMIDIMsg({1, midi::NoteOn, 60, 100}));
+  EXPECT_EQ(0, f->mapping[1].output);
+  f->ProcessQueuedMIDI(OC::CORE::ticks);
+  EXPECT_NE(0, f->mapping[1].output);
+  EXPECT_EQ(0U, f->ingest.readable());
+}
+
+TEST(MIDIIngest, BurstIsSpreadOverTicks) {
+  HS::MIDIIngestQueue<MIDIMessage, 64> queue;
+  std::vector<uint8_t> order;
+  for (int i = 0; i < 30; ++i) queue.Push({1, midi::ControlChange, 1, uint8_t(i)}, 50);
+
+  uint32_t tick = 50;
+  while (queue.readable()) {
+    EXPECT_LE(queue.Drain(tick++, HS::MIDI_INGEST_PER_TICK, [&](const MIDIMessage &msg) {
+      order.push_back(msg.data2);
+    }), HS::MIDI_INGEST_PER_TICK);
+  }
+
+  ASSERT_EQ(30U, order.size());
+  for (int i = 0; i < 30; ++i) EXPECT_EQ(i, order[i]);
+
+  const uint32_t ticks = (30 + HS::MIDI_INGEST_PER_TICK - 1) / HS::MIDI_INGEST_PER_TICK;
+  EXPECT_EQ(50 + ticks, tick);
+  EXPECT_EQ(ticks - 1, queue.max_latency);
+  EXPECT_EQ(30U, queue.max_depth);
+  EXPECT_GT(queue.mean_latency(), 0U);
+  EXPECT_LT(queue.mean_latency(), queue.max_latency);
+}
+
+TEST(MIDIIngest, FutureEventsWait) {
+  HS::MIDIIngestQueue<MIDIMessage, 8> queue;
+  int processed = 0;
+  auto count = [&](const MIDIMessage &) { ++processed; };
+
+  queue.Push({1, midi::Clock, 0, 0}, 10);
+  queue.Push({1, midi::Clock, 0, 0}, 12);
+  EXPECT_EQ(0U, queue.Drain(9, 4, count));
+  EXPECT_EQ(1U, queue.Drain(10, 4, count));
+  EXPECT_EQ(0U, queue.Drain(11, 4, count));
+  EXPECT_EQ(1U, queue.Drain(12, 4, count));
+  EXPECT_EQ(2, processed);
+  EXPECT_EQ(0U, queue.max_latency);
+
+  // stamps are compared with wraparound
+  queue.Push({1, midi::Clock, 0, 0}, 0xfffffffe);
+  EXPECT_EQ(1U, queue.Drain(1, 4, count));
+  EXPECT_EQ(3U, queue.max_latency);
+}
+
+TEST(MIDIIngest, OverflowDropsNewest) {
+  HS::MIDIIngestQueue<MIDIMessage, 16> queue;
+  for (int i = 0; i < 40; ++i) {
+    EXPECT_EQ(i < 16, queue.Push({1, midi::ControlChange, 1, uint8_t(i)}, 0));
+  }
+  EXPECT_EQ(16U, queue.received);
+  EXPECT_EQ(24U, queue.dropped);
+  EXPECT_EQ(16U, queue.readable());
+
+  // the oldest messages survive
+  std::vector<uint8_t> values;
+  queue.Drain(0, 100, [&](const MIDIMessage &msg) { values.push_back(msg.data2); });
+  ASSERT_EQ(16U, values.size());
+  EXPECT_EQ(0, values.front());
+  EXPECT_EQ(15, values.back());
+
+  // room again, and counters can be cleared without touching the queue
+  EXPECT_TRUE(queue.Push({1, midi::ControlChange, 1, 99}, 1));
+  queue.ResetStats();
+  EXPECT_EQ(0U, queue.dropped);
+  EXPECT_EQ(1U, queue.readable());
+}
+
+TEST(MIDIIngest, FlushDiscardsQueued) {
+  HS::MIDIIngestQueue<MIDIMessage, 8> queue;
+  for (int i = 0; i < 5; ++i) queue.Push({1, midi::Clock, 0, 0}, 0);
+  queue.Flush();
+  EXPECT_EQ(0U, queue.readable());
+  EXPECT_EQ(5U, queue.dropped);
+  EXPECT_EQ(0U, queue.Drain(0, 100, [](const MIDIMessage &) { }));
+
+  // and keeps working afterwards
+  EXPECT_TRUE(queue.Push({1, midi::Clock, 0, 0}, 0));
+  EXPECT_EQ(1U, queue.Drain(0, 100, [](const MIDIMessage &) { }));
+  EXPECT_EQ(6U, queue.received);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,134 @@
+// Host tests for state in HS::frame that every HSApplication app shares: a
+// trigger input patched from an applet output is clocked by Hemisphere, not
+// by Load(), and that must not carry over to the next app; queued MIDI is
+// applied whichever app is running.
+
+// Applet registry and app container, which the firmware archive refers to
+#include "OC_apps.cpp"
+
+#include <gtest/gtest.h>
+#include "OC_ADC.h"
+#include "OC_DAC.h"
+#include "OC_calibration.h"
+#include "OC_digital_inputs.h"
+#include "host_hal.h"
+
+namespace {
+
+OC::IOFrame io_frame;
+
+// The app part of CORE_timer_ISR()
+void Tick() {
+  OC::DigitalInputs::Scan();
+  ++OC::CORE::ticks;
+  OC::app_switcher.Process(&io_frame);
+}
+
+OC::AppBase *SwitchTo(uint16_t id) {
+  OC::app_switcher.current_app()->DispatchAppEvent(OC::APP_EVENT_SUSPEND);
+  OC::app_switcher.set_current_app(OC::app_container.IndexOfAppByID(id));
+  OC::AppBase *app = OC::app_switcher.current_app();
+  app->DispatchAppEvent(OC::APP_EVENT_RESUME);
+  return app;
+}
+
+class PatchStateTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    host::inputs.gates = 0;
+    HS::trigmap[0].SetGateInput(0);
+    OC::app_switcher.set_current_app(OC::app_container.IndexOfAppByID(AppHemisphere::kAppId));
+    OC::app_switcher.current_app()->DispatchAppEvent(OC::APP_EVENT_RESUME);
+    Tick();
+  }
+
+  // TR1 low then high, @return whether clocked[0] came up on the rising edge
+  bool PulseTR1() {
+    host::inputs.gates = 0;
+    Tick();
+    host::inputs.gates = 1;
+    Tick();
+    return HS::frame.clocked[0];
+  }
+};
+
+TEST_F(PatchStateTest, UnpatchedInputsClockInLoad) {
+  EXPECT_EQ(0u, HS::frame.deferred_clocks);
+  EXPECT_TRUE(PulseTR1());
+}
+
+TEST_F(PatchStateTest, PatchedInputIsDeferred) {
+  // Left A input from the left applet's own output B
+  HS::trigmap[0].SetOutput(1);
+  Tick();
+  EXPECT_EQ(1u, HS::frame.deferred_clocks);
+  EXPECT_EQ(0u, HS::frame.pushed_outputs);
+}
+
+TEST_F(PatchStateTest, SuspendClearsPatching) {
+  HS::trigmap[0].SetOutput(1);
+  Tick();
+  ASSERT_NE(0u, HS::frame.deferred_clocks);
+
+  OC::app_switcher.current_app()->DispatchAppEvent(OC::APP_EVENT_SUSPEND);
+  EXPECT_EQ(0u, HS::frame.deferred_clocks);
+  EXPECT_EQ(0u, HS::frame.pushed_outputs);
+}
+
+TEST_F(PatchStateTest, NextAppClocksEveryInput) {
+  HS::trigmap[0].SetOutput(1);
+  Tick();
+  ASSERT_NE(0u, HS::frame.deferred_clocks);
+
+  // Calibr8or only clocks through Load(); a leftover mask would leave
+  // clocked[0] stuck at whatever Hemisphere last computed
+  HS::frame.clocked[0] = false;
+  OC::AppBase *app = SwitchTo(AppCalibr8or::kAppId);
+  ASSERT_EQ(AppCalibr8or::kAppId, app->id());
+  HS::trigmap[0].SetGateInput(0);
+  EXPECT_TRUE(PulseTR1());
+  Tick();
+  EXPECT_FALSE(HS::frame.clocked[0]);
+
+  // and back again, patching resumes
+  SwitchTo(AppHemisphere::kAppId);
+  HS::trigmap[0].SetOutput(1);
+  Tick();
+  EXPECT_EQ(1u, HS::frame.deferred_clocks);
+}
+
+TEST_F(PatchStateTest, EveryAppDrainsQueuedMIDI) {
+  HS::MIDIFrame &f = HS::frame.MIDIState;
+  for (uint16_t id : {AppHemisphere::kAppId, AppCalibr8or::kAppId}) {
+    SwitchTo(id);
+    for (size_t i = 0; i < HS::MIDI_INGEST_PER_TICK + 1; ++i)
+      ASSERT_TRUE(f.QueueMIDIMsg({1, midi::ControlChange, 1, uint8_t(i)}));
+    Tick();
+    EXPECT_EQ(1u, f.ingest.readable()) << id;
+    Tick();
+    EXPECT_EQ(0u, f.ingest.readable()) << id;
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // Same order as setup() in Main.cpp, minus the UI and splash screens
+  OC::DigitalInputs::Init();
+  OC::calibration_load();
+  OC::ADC::Init(&OC::calibration_data.adc);
+  OC::ADC::Init_DMA();
+  OC::DAC::Init(&OC::calibration_data.dac, &OC::global_settings.autotune_calibration_data);
+  io_frame.Reset();
+  PhzConfig::Init();
+  // Valid metadata, so AppSwitcher::Init doesn't wait for a reset confirmation
+  uint64_t metadata = 0;
+  Pack(metadata, PackLocation{0, 16}, AppHemisphere::kAppId);
+  Pack(metadata, PackLocation{17, 1}, 1);
+  PhzConfig::setValue(OC::METADATA_KEY, metadata);
+  OC::app_switcher.Init(false);
+  OC::CORE::app_isr_enabled = true;
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
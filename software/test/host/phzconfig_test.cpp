@@ -0,0 +1,256 @@
+// Host tests for PhzConfig file storage: files in the original single-write
+// format still load, and journaled saves round-trip through append/compact.
+
+// Applet registry and app container, which the firmware archive refers to
+#include "OC_apps.cpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "PhzConfig.h"
+
+namespace {
+
+using PhzConfig::KEY;
+using PhzConfig::VALUE;
+
+const char * const TEST_FILE = "TEST.CFG";
+
+host::FileData &file_bytes(const char *filename = TEST_FILE) {
+  return *PhzConfig::myfs.files().at(filename);
+}
+
+void put_le(std::vector<uint8_t> &buf, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i) buf.push_back((value >> (i * 8)) & 0xff);
+}
+
+// Same layout save_chunk() has always written: sig, count, XOR checksum,
+// then key/value records, little-endian
+void put_chunk(std::vector<uint8_t> &buf, const char *sig,
+               const std::vector<std::pair<KEY, VALUE>> &records) {
+  uint64_t checksum = 0;
+  for (auto &r : records) checksum ^= r.second;
+  buf.push_back(sig[0]);
+  buf.push_back(sig[1]);
+  put_le(buf, records.size(), 2);
+  put_le(buf, checksum, 8);
+  for (auto &r : records) {
+    put_le(buf, r.first, 2);
+    put_le(buf, r.second, 8);
+  }
+}
+
+void write_file(const std::vector<uint8_t> &bytes, const char *filename = TEST_FILE) {
+  PhzConfig::myfs.remove(filename);
+  File f = PhzConfig::myfs.open(filename, FILE_WRITE_BEGIN);
+  f.write(bytes.data(), bytes.size());
+  f.close();
+}
+
+VALUE value_of(KEY key) {
+  VALUE v = 0;
+  EXPECT_TRUE(PhzConfig::getValue(key, v)) << "key " << key;
+  return v;
+}
+
+class PhzConfigTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    PhzConfig::myfs.format();
+    PhzConfig::clear_config();
+  }
+};
+
+TEST_F(PhzConfigTest, LoadsLegacyFile) {
+  std::vector<uint8_t> bytes;
+  put_chunk(bytes, "PZ", { {1, 0x1122334455667788ULL}, {0xffff, 3}, {42, 0} });
+  put_chunk(bytes, "PX", { {7, 0xdeadbeef} });
+  write_file(bytes);
+
+  ASSERT_TRUE(PhzConfig::load_config(TEST_FILE));
+  EXPECT_EQ(0x1122334455667788ULL, value_of(1));
+  EXPECT_EQ(3U, value_of(0xffff));
+  EXPECT_EQ(0U, value_of(42));
+  VALUE v;
+  EXPECT_FALSE(PhzConfig::getValue(7, v));
+  ASSERT_TRUE(PhzConfig::getData(7, v));
+  EXPECT_EQ(0xdeadbeefULL, v);
+}
+
+TEST_F(PhzConfigTest, LoadsLegacyFileWithEmptyChunk) {
+  std::vector<uint8_t> bytes;
+  put_chunk(bytes, "PZ", { {5, 55} });
+  put_chunk(bytes, "PX", { });
+  write_file(bytes);
+
+  ASSERT_TRUE(PhzConfig::load_config(TEST_FILE));
+  EXPECT_EQ(55U, value_of(5));
+}
+
+TEST_F(PhzConfigTest, RejectsBadSignatureOrChecksum) {
+  std::vector<uint8_t> bytes;
+  put_chunk(bytes, "QQ", { {5, 55} });
+  write_file(bytes);
+  EXPECT_FALSE(PhzConfig::load_config(TEST_FILE));
+
+  bytes.clear();
+  put_chunk(bytes, "PZ", { {5, 55} });
+  bytes[4] ^= 1; // checksum
+  write_file(bytes);
+  EXPECT_FALSE(PhzConfig::load_config(TEST_FILE));
+}
+
+TEST_F(PhzConfigTest, FullSaveMatchesLegacyLayout) {
+  PhzConfig::setValue(300, 3);
+  PhzConfig::setValue(2, 0x0102030405060708ULL);
+  PhzConfig::setData(9, 99);
+  ASSERT_TRUE(PhzConfig::save_config(TEST_FILE));
+
+  // records come out sorted by key
+  std::vector<uint8_t> expected;
+  put_chunk(expected, "PZ", { {2, 0x0102030405060708ULL}, {300, 3} });
+  put_chunk(expected, "PX", { {9, 99} });
+  EXPECT_EQ(expected, file_bytes());
+}
+
+TEST_F(PhzConfigTest, JournalAppendsOnlyChanges) {
+  for (KEY k = 0; k < 100; ++k) PhzConfig::setValue(k, k * 3);
+  ASSERT_TRUE(PhzConfig::save_config(TEST_FILE));
+  const size_t base_size = file_bytes().size();
+
+  // unchanged: file untouched
+  PhzConfig::setValue(10, 30);
+  ASSERT_TRUE(PhzConfig::save_config(TEST_FILE));
+  EXPECT_EQ(base_size, file_bytes().size());
+
+  PhzConfig::setValue(10, 1000);
+  PhzConfig::setValue(500, 5);
+  PhzConfig::deleteKey(20);
+  ASSERT_TRUE(PhzConfig::save_config(TEST_FILE));
+  // one chunk of two records, one chunk of one delete
+  EXPECT_EQ(base_size + 12 + 2 * 10 + 12 + 10, file_bytes().size());
+
+  PhzConfig::clear_config();
+  ASSERT_TRUE(PhzConfig::load_config(TEST_FILE));
+  EXPECT_EQ(1000U, value_of(10));
+  EXPECT_EQ(5U, value_of(500));
+  EXPECT_EQ(33U, value_of(11));
+  VALUE v;
+  EXPECT_FALSE(PhzConfig::getValue(20, v));
+}
+
+TEST_F(PhzConfigTest, JournalCompacts) {
+  for (KEY k = 0; k < 10; ++k) PhzConfig::setValue(k, k);
+  ASSERT_TRUE(PhzConfig::save_config(TEST_FILE));
+  const size_t base_size = file_bytes().size();
+
+  size_t max_size = 0;
+  for (VALUE n = 1; n <= PhzConfig::JOURNAL_SLACK * 2; ++n) {
+    PhzConfig::setValue(3, n);
+    ASSERT_TRUE(PhzConfig::save_config(TEST_FILE));
+    max_size = std::max<size_t>(max_size, file_bytes().size());
+  }
+  EXPECT_LE(max_size, base_size + PhzConfig::JOURNAL_SLACK * (12 + 10));
+  EXPECT_LT(file_bytes().size(), max_size);
+
+  PhzConfig::clear_config();
+  ASSERT_TRUE(PhzConfig::load_config(TEST_FILE));
+  EXPECT_EQ(PhzConfig::JOURNAL_SLACK * 2, value_of(3));
+  EXPECT_EQ(9U, value_of(9));
+}
+
+TEST_F(PhzConfigTest, TornAppendKeepsPreviousValues) {
+  PhzConfig::setValue(1, 11);
+  PhzConfig::setValue(2, 22);
+  ASSERT_TRUE(PhzConfig::save_config(TEST_FILE));
+  const size_t base_size = file_bytes().size();
+
+  PhzConfig::setValue(1, 111);
+  PhzConfig::setValue(2, 222);
+  ASSERT_TRUE(PhzConfig::save_config(TEST_FILE));
+  file_bytes().resize(file_bytes().size() - 5); // power lost mid-append
+
+  PhzConfig::clear_config();
+  ASSERT_TRUE(PhzConfig::load_config(TEST_FILE));
+  EXPECT_EQ(11U, value_of(1));
+  EXPECT_EQ(22U, value_of(2));
+
+  // next save rewrites the file cleanly
+  PhzConfig::setValue(3, 33);
+  ASSERT_TRUE(PhzConfig::save_config(TEST_FILE));
+  EXPECT_EQ(base_size + 10, file_bytes().size());
+}
+
+TEST_F(PhzConfigTest, OtherFileGetsFullWrite) {
+  PhzConfig::setValue(1, 1);
+  ASSERT_TRUE(PhzConfig::save_config(TEST_FILE));
+  PhzConfig::setValue(2, 2);
+  ASSERT_TRUE(PhzConfig::save_config("OTHER.CFG"));
+
+  PhzConfig::clear_config();
+  ASSERT_TRUE(PhzConfig::load_config("OTHER.CFG"));
+  EXPECT_EQ(1U, value_of(1));
+  EXPECT_EQ(2U, value_of(2));
+}
+
+TEST_F(PhzConfigTest, DeferredSaveWaitsForStorageTask) {
+  PhzConfig::setValue(1, 1);
+  ASSERT_TRUE(PhzConfig::defer_save(TEST_FILE));
+  PhzConfig::setValue(2, 2);
+  ASSERT_TRUE(PhzConfig::defer_save(TEST_FILE)); // coalesces
+  EXPECT_FALSE(PhzConfig::myfs.exists(TEST_FILE));
+
+  OC::CORE::FlushTasks();
+  ASSERT_TRUE(PhzConfig::myfs.exists(TEST_FILE));
+  ASSERT_TRUE(PhzConfig::load_config(TEST_FILE));
+  EXPECT_EQ(1U, value_of(1));
+  EXPECT_EQ(2U, value_of(2));
+}
+
+TEST_F(PhzConfigTest, LoadWritesPendingSaveFirst) {
+  PhzConfig::setValue(1, 1);
+  ASSERT_TRUE(PhzConfig::save_config("OTHER.CFG"));
+  PhzConfig::clear_config();
+
+  PhzConfig::setValue(3, 3);
+  ASSERT_TRUE(PhzConfig::defer_save(TEST_FILE));
+  ASSERT_TRUE(PhzConfig::load_config("OTHER.CFG"));
+  EXPECT_EQ(1U, value_of(1));
+
+  ASSERT_TRUE(PhzConfig::load_config(TEST_FILE));
+  EXPECT_EQ(3U, value_of(3));
+  VALUE v;
+  EXPECT_FALSE(PhzConfig::getValue(1, v));
+  OC::CORE::FlushTasks(); // the queued task finds nothing left to save
+}
+
+TEST(PhzConfigStore, SortedInsertEraseFind) {
+  static PhzConfig::ConfigStore<64, 4> store;
+  store.clear();
+  const KEY keys[] = { 50, 3, 9000, 7, 3, 65535, 0 };
+  for (KEY k : keys) EXPECT_TRUE(store.insert_or_assign(k, k + 1));
+  EXPECT_EQ(6U, store.size());
+  for (size_t i = 1; i < store.size(); ++i) EXPECT_LT(store.key_at(i - 1), store.key_at(i));
+
+  VALUE v;
+  ASSERT_TRUE(store.find(9000, v));
+  EXPECT_EQ(9001U, v);
+  EXPECT_FALSE(store.find(8, v));
+
+  store.erase(9000);
+  EXPECT_FALSE(store.find(9000, v));
+  EXPECT_EQ(1U, store.deleted_count());
+  store.insert_or_assign(9000, 1);
+  EXPECT_EQ(0U, store.deleted_count());
+
+  for (KEY k = 100; store.size() < store.capacity(); ++k) store.insert_or_assign(k, k);
+  EXPECT_FALSE(store.insert_or_assign(1, 1));
+  EXPECT_TRUE(store.insert_or_assign(50, 5)); // existing key still updates
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  PhzConfig::myfs.begin(1024 * 512);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
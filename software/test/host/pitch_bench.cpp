@@ -0,0 +1,189 @@
+// Benchmark for TuneTracker pitch detection: the time-domain YIN that
+// SafeNoteFrequencyAnalyzer used to run (a 1920-sample window, stride-4
+// difference sums, lags searched one at a time until the first dip) against
+// YinPitchDetector's FFT difference function over a 2048-sample window.
+//
+// Each tone is analysed at a number of random phases; the table shows how
+// often a pitch was found, the mean and worst error in cents and the time per
+// window. Host times stand in for target cycles, the ratio is what matters.
+//
+// Usage: pitch_bench [WINDOWS] [FILE HZ]
+//   FILE is raw 16-bit mono at 44.1kHz (e.g. sox in.wav -t raw -r 44100 -b 16
+//   -c 1 -e signed out.raw), HZ the pitch it should read as.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+#include "Audio/YinPitchDetector.h"
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+static const float kSampleRate = 44100.0f;
+static const float kThreshold = 0.14f; // as TuneTrackerApplet
+static const size_t kLegacyWindow = 1920;
+static const size_t kWindow = 2048;
+
+// SafeNoteFrequencyAnalyzer::process()/estimate() run to completion on one
+// window. Returns the period in samples, 0 if none was found.
+static float LegacyYin(const int16_t *p, float threshold) {
+  const size_t half = kLegacyWindow / 2;
+  static float cmnd[kLegacyWindow / 2 + 1];
+  uint64_t running_sum = 0;
+  cmnd[0] = 1.0f;
+  for (size_t tau = 1; tau < half; ++tau) {
+    uint64_t sum = 0;
+    for (size_t x = 0; x < half; x += 4) {
+      const int32_t delta = p[x] - p[x + tau];
+      sum += delta * delta;
+    }
+    running_sum += sum;
+    cmnd[tau] = running_sum ? float(sum * tau) / running_sum : 1.0f;
+    // A dip is taken once the lag after it is higher, as estimate() did
+    // with its five-entry ring
+    const size_t t = tau - 1;
+    if (t > 1 && cmnd[t] < threshold && cmnd[t] < cmnd[tau]) {
+      const float s0 = cmnd[t - 1], s1 = cmnd[t], s2 = cmnd[tau];
+      return t + 0.5f * (s0 - s2) / (s0 - 2.0f * s1 + s2);
+    }
+  }
+  return 0.0f;
+}
+
+struct Rng {
+  uint32_t state = 1;
+  uint32_t operator()() {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  }
+  float uniform() { return (*this)() / float(1 << 24) * 2.0f - 1.0f; }
+};
+
+enum Shape { SINE, HARMONIC, NOISY };
+static const char *const kShapeNames[] = { "sine", "harmonic", "noisy" };
+
+static void Tone(std::vector<int16_t> &out, float freq, Shape shape, Rng &rng) {
+  const float phase0 = rng.uniform() * float(M_PI);
+  for (size_t i = 0; i < out.size(); ++i) {
+    const float phase = phase0 + 2.0f * float(M_PI) * freq * i / kSampleRate;
+    float x = sinf(phase);
+    if (shape != SINE) {
+      for (int h = 2; h <= 8 && h * freq < kSampleRate / 2; ++h) x += sinf(h * phase) / h;
+    }
+    x *= 0.4f;
+    if (shape == NOISY) x += 0.1f * rng.uniform();
+    out[i] = int16_t(x * 20000.0f);
+  }
+}
+
+struct Stats {
+  int windows = 0;
+  int found = 0;
+  double cents = 0.0;
+  double worst = 0.0;
+  uint64_t ns = 0;
+
+  void Add(float period, float freq, uint64_t elapsed) {
+    ++windows;
+    ns += elapsed;
+    if (period <= 0.0f) return;
+    ++found;
+    const double error = fabs(1200.0 * log2(kSampleRate / period / freq));
+    cents += error;
+    if (error > worst) worst = error;
+  }
+};
+
+static void PrintRow(const char *name, float freq, const Stats &legacy, const Stats &fft) {
+  printf("%-10s %8.2f | %5.1f%% %8.2f %8.2f %8.0f | %5.1f%% %8.2f %8.2f %8.0f\n",
+         name, freq,
+         100.0 * legacy.found / legacy.windows, legacy.found ? legacy.cents / legacy.found : 0.0,
+         legacy.worst, double(legacy.ns) / legacy.windows,
+         100.0 * fft.found / fft.windows, fft.found ? fft.cents / fft.found : 0.0,
+         fft.worst, double(fft.ns) / fft.windows);
+}
+
+int main(int argc, char **argv) {
+  const int windows = argc > 1 ? atoi(argv[1]) : 50;
+  auto *detector = new YinPitchDetector<kWindow>;
+  detector->Init(kThreshold, kWindow / 4);
+
+  printf("%-10s %8s | %36s | %36s\n", "", "", "legacy time-domain YIN", "FFT YIN");
+  printf("%-10s %8s | %6s %8s %8s %8s | %6s %8s %8s %8s\n", "tone", "Hz",
+         "found", "cents", "worst", "ns/win", "found", "cents", "worst", "ns/win");
+
+  Rng rng;
+  std::vector<int16_t> signal(kWindow);
+  Stats legacy_total, fft_total;
+  double legacy_slowest = 0.0, fft_slowest = 0.0;
+  for (int shape = SINE; shape <= NOISY; ++shape) {
+    for (float freq : { 55.0f, 82.41f, 110.0f, 196.0f, 261.63f, 440.0f, 880.0f, 1760.0f, 3520.0f }) {
+      Stats legacy, fft;
+      for (int w = 0; w < windows; ++w) {
+        Tone(signal, freq, Shape(shape), rng);
+        uint64_t t0 = now_ns();
+        const float legacy_period = LegacyYin(signal.data(), kThreshold);
+        uint64_t t1 = now_ns();
+        const float period = detector->Analyze(signal.data()) ? detector->period() : 0.0f;
+        uint64_t t2 = now_ns();
+        legacy.Add(legacy_period, freq, t1 - t0);
+        fft.Add(period, freq, t2 - t1);
+      }
+      PrintRow(kShapeNames[shape], freq, legacy, fft);
+      legacy_total.windows += legacy.windows;
+      legacy_total.ns += legacy.ns;
+      fft_total.windows += fft.windows;
+      fft_total.ns += fft.ns;
+      legacy_slowest = std::max(legacy_slowest, double(legacy.ns) / legacy.windows);
+      fft_slowest = std::max(fft_slowest, double(fft.ns) / fft.windows);
+    }
+  }
+  printf("\nMean time per window: legacy %.0f ns, FFT %.0f ns (%.1fx)\n",
+         double(legacy_total.ns) / legacy_total.windows, double(fft_total.ns) / fft_total.windows,
+         double(legacy_total.ns) / fft_total.ns * fft_total.windows / legacy_total.windows);
+  // The legacy search stops at the first dip, so its cost (and latency, at 64
+  // lags per audio block) grows with the period; the FFT cost is fixed
+  printf("Slowest tone: legacy %.0f ns, FFT %.0f ns (%.1fx)\n",
+         legacy_slowest, fft_slowest, legacy_slowest / fft_slowest);
+
+  if (argc > 3) {
+    const float freq = atof(argv[3]);
+    FILE *f = fopen(argv[2], "rb");
+    if (!f) {
+      fprintf(stderr, "Can't open %s\n", argv[2]);
+      return 1;
+    }
+    std::vector<int16_t> recording;
+    int16_t buffer[1024];
+    size_t n;
+    while ((n = fread(buffer, sizeof(int16_t), 1024, f)) > 0) recording.insert(recording.end(), buffer, buffer + n);
+    fclose(f);
+    if (recording.size() < kWindow) {
+      fprintf(stderr, "%s is shorter than one window\n", argv[2]);
+      return 1;
+    }
+
+    Stats legacy, fft;
+    for (size_t pos = 0; pos + kWindow <= recording.size(); pos += kWindow / 4) {
+      uint64_t t0 = now_ns();
+      const float legacy_period = LegacyYin(&recording[pos], kThreshold);
+      uint64_t t1 = now_ns();
+      const float period = detector->Analyze(&recording[pos]) ? detector->period() : 0.0f;
+      uint64_t t2 = now_ns();
+      legacy.Add(legacy_period, freq, t1 - t0);
+      fft.Add(period, freq, t2 - t1);
+    }
+    printf("\n");
+    PrintRow("recording", freq, legacy, fft);
+  }
+
+  delete detector;
+  return 0;
+}
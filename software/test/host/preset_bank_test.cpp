@@ -0,0 +1,190 @@
+// Host tests for the indexed preset bank: whole-file round-trips, in-place
+// saves of a single slot, and recovery from damaged slots.
+
+// Applet registry and app container, which the firmware archive refers to
+#include "OC_apps.cpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "PhzPresetBank.h"
+
+namespace {
+
+using PhzConfig::PresetBank;
+using PhzConfig::PresetBlob;
+using PhzConfig::VALUE;
+
+const char * const TEST_FILE = "TEST.IDX";
+constexpr size_t kSlots = 6;
+
+host::FileData &file_bytes() {
+  return *PhzConfig::myfs.files().at(TEST_FILE);
+}
+
+void fill(PresetBlob &preset, int seed) {
+  preset.clear();
+  for (size_t key = 0; key < 22; key += (seed % 3) + 1)
+    preset.set(key, VALUE(seed) << 32 | key);
+}
+
+class PresetBankTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    PhzConfig::myfs.format();
+  }
+
+  PresetBlob slots[kSlots];
+  PresetBank bank{TEST_FILE, slots, kSlots};
+};
+
+TEST_F(PresetBankTest, MissingFileLoadsEmpty) {
+  EXPECT_FALSE(bank.Load());
+  EXPECT_TRUE(bank.loaded());
+  for (size_t i = 0; i < kSlots; ++i) EXPECT_TRUE(bank[i].empty());
+}
+
+TEST_F(PresetBankTest, SaveAllRoundTrip) {
+  for (size_t i = 0; i < kSlots; ++i) fill(bank[i], i + 1);
+  bank[3].clear();
+  ASSERT_TRUE(bank.SaveAll());
+  EXPECT_EQ(PresetBank::slot_offset(kSlots, kSlots), file_bytes().size());
+
+  PresetBlob other_slots[kSlots];
+  PresetBank other(TEST_FILE, other_slots, kSlots);
+  ASSERT_TRUE(other.Load());
+  for (size_t i = 0; i < kSlots; ++i) {
+    EXPECT_EQ(bank[i].present, other[i].present) << "slot " << i;
+    EXPECT_EQ(0, memcmp(bank[i].values, other[i].values, sizeof(bank[i].values)));
+  }
+  EXPECT_TRUE(other[3].empty());
+
+  VALUE v;
+  ASSERT_TRUE(other[1].get(3, v));
+  EXPECT_EQ(VALUE(2) << 32 | 3, v);
+  EXPECT_FALSE(other[1].get(1, v));
+  EXPECT_FALSE(other[1].get(PresetBlob::KEYS, v));
+}
+
+TEST_F(PresetBankTest, SaveRewritesOneSlotInPlace) {
+  for (size_t i = 0; i < kSlots; ++i) fill(bank[i], i + 1);
+  ASSERT_TRUE(bank.SaveAll());
+  const host::FileData before = file_bytes();
+
+  PresetBlob preset;
+  fill(preset, 42);
+  ASSERT_TRUE(bank.Store(4, preset));
+
+  const host::FileData &after = file_bytes();
+  ASSERT_EQ(before.size(), after.size());
+  const size_t start = PresetBank::slot_offset(kSlots, 4);
+  const size_t end = start + sizeof(PresetBlob);
+  for (size_t i = 0; i < after.size(); ++i) {
+    if (i < start || i >= end) ASSERT_EQ(before[i], after[i]) << "byte " << i;
+  }
+
+  ASSERT_TRUE(bank.Load());
+  VALUE v;
+  ASSERT_TRUE(bank[4].get(0, v));
+  EXPECT_EQ(VALUE(42) << 32, v);
+}
+
+TEST_F(PresetBankTest, StoreSkipsUnchanged) {
+  fill(bank[0], 7);
+  ASSERT_TRUE(bank.SaveAll());
+
+  PresetBlob preset;
+  fill(preset, 7);
+  file_bytes()[PresetBank::slot_offset(kSlots, 0)] ^= 0xff; // would be fixed by a write
+  ASSERT_TRUE(bank.Store(0, preset));
+  EXPECT_EQ(0xff ^ (preset.present & 0xff), file_bytes()[PresetBank::slot_offset(kSlots, 0)]);
+}
+
+TEST_F(PresetBankTest, DeferredSavesWaitForStorageTask) {
+  for (size_t i = 0; i < kSlots; ++i) fill(bank[i], i + 1);
+  ASSERT_TRUE(bank.SaveAll());
+
+  PresetBlob preset;
+  fill(preset, 42);
+  ASSERT_TRUE(bank.DeferStore(2, preset));
+  bank[5].clear();
+  ASSERT_TRUE(bank.DeferSave(5));
+
+  PresetBlob file_slots[kSlots];
+  PresetBank file(TEST_FILE, file_slots, kSlots);
+  ASSERT_TRUE(file.Load());
+  VALUE v;
+  ASSERT_TRUE(file[2].get(0, v));
+  EXPECT_EQ(VALUE(3) << 32, v);
+  EXPECT_FALSE(file[5].empty());
+
+  OC::CORE::FlushTasks();
+  ASSERT_TRUE(file.Load());
+  ASSERT_TRUE(file[2].get(0, v));
+  EXPECT_EQ(VALUE(42) << 32, v);
+  EXPECT_TRUE(file[5].empty());
+}
+
+TEST_F(PresetBankTest, CorruptSlotIsDropped) {
+  for (size_t i = 0; i < kSlots; ++i) fill(bank[i], i + 1);
+  ASSERT_TRUE(bank.SaveAll());
+
+  // interrupted write: tail of slot 2 never made it
+  const size_t offset = PresetBank::slot_offset(kSlots, 2);
+  memset(file_bytes().data() + offset + 100, 0, sizeof(PresetBlob) - 100);
+
+  ASSERT_TRUE(bank.Load());
+  EXPECT_TRUE(bank[2].empty());
+  EXPECT_FALSE(bank[1].empty());
+  EXPECT_FALSE(bank[3].empty());
+}
+
+TEST_F(PresetBankTest, SlotCountChangeRewritesFile) {
+  PresetBlob small_slots[3];
+  PresetBank small(TEST_FILE, small_slots, 3);
+  small.Load();
+  for (size_t i = 0; i < 3; ++i) fill(small[i], i + 1);
+  ASSERT_TRUE(small.SaveAll());
+
+  ASSERT_TRUE(bank.Load());
+  EXPECT_FALSE(bank[2].empty());
+  EXPECT_TRUE(bank[5].empty());
+
+  fill(bank[5], 9);
+  ASSERT_TRUE(bank.Save(5));
+  EXPECT_EQ(PresetBank::slot_offset(kSlots, kSlots), file_bytes().size());
+
+  ASSERT_TRUE(bank.Load());
+  EXPECT_FALSE(bank[2].empty());
+  EXPECT_FALSE(bank[5].empty());
+}
+
+TEST_F(PresetBankTest, BadHeaderIsRejected) {
+  ASSERT_TRUE(bank.SaveAll());
+  file_bytes()[0] = 'Q';
+  EXPECT_FALSE(bank.Load());
+}
+
+TEST_F(PresetBankTest, UnreadableFileIsKept) {
+  for (size_t i = 0; i < kSlots; ++i) fill(bank[i], i + 1);
+  ASSERT_TRUE(bank.SaveAll());
+  file_bytes()[4] = PresetBank::VERSION + 1;
+  const host::FileData unreadable = file_bytes();
+
+  EXPECT_FALSE(bank.Load());
+  EXPECT_FALSE(PhzConfig::myfs.exists(TEST_FILE));
+  ASSERT_TRUE(PhzConfig::myfs.exists("TEST.OLD"));
+  EXPECT_EQ(unreadable, *PhzConfig::myfs.files().at("TEST.OLD"));
+
+  // saving starts a new file next to it
+  ASSERT_TRUE(bank.Save(0));
+  EXPECT_TRUE(PhzConfig::myfs.exists(TEST_FILE));
+  EXPECT_EQ(unreadable, *PhzConfig::myfs.files().at("TEST.OLD"));
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  PhzConfig::myfs.begin(1024 * 512);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,90 @@
+// Benchmark for braids::Quantizer: the original linear scan vs. the bucket
+// table, over 8 channels of audio-rate input that leaves the hysteresis cell
+// on nearly every sample. Outputs are compared sample by sample; any mismatch
+// fails the run.
+//
+// Usage: quantizer_bench [SAMPLES]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+#include <Arduino.h>
+#include "braids_quantizer.h"
+#include "braids_quantizer_scales.h"
+#include "braids_quantizer_reference.h"
+
+static constexpr size_t kChannels = 8;
+static constexpr int32_t kOctave = 12 << 7;
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+  const size_t num_samples = argc > 1 ? strtoul(argv[1], nullptr, 0) : 200000;
+  // chromatic, major, a 16-note microtonal and a 7-note scale
+  const int scale_ids[kChannels] = { 1, 2, 100, 140, 1, 2, 100, 140 };
+
+  // Triangle sweeps across 8 octaves at different rates per channel
+  std::vector<int32_t> input(num_samples * kChannels);
+  for (size_t i = 0; i < num_samples; ++i) {
+    for (size_t ch = 0; ch < kChannels; ++ch) {
+      const int32_t period = 8 * kOctave;
+      const int32_t phase = int32_t((i * (97 + 31 * ch)) % (2 * period));
+      input[i * kChannels + ch] = (phase < period ? phase : 2 * period - phase) - 3 * kOctave;
+    }
+  }
+
+  std::vector<int32_t> out_ref(input.size()), out_table(input.size());
+
+  ReferenceQuantizer reference[kChannels];
+  braids::Quantizer table[kChannels];
+  for (size_t ch = 0; ch < kChannels; ++ch) {
+    reference[ch].Init();
+    table[ch].Init();
+    reference[ch].Configure(braids::scales[scale_ids[ch]]);
+    table[ch].Configure(braids::scales[scale_ids[ch]]);
+  }
+
+  // best of several passes to keep scheduler noise out of the comparison
+  uint64_t best[2] = { UINT64_MAX, UINT64_MAX };
+  for (int pass = 0; pass < 5; ++pass) {
+    for (size_t ch = 0; ch < kChannels; ++ch) {
+      reference[ch].Requantize();
+      table[ch].Requantize();
+    }
+    uint64_t t0 = now_ns();
+    for (size_t i = 0; i < input.size(); i += kChannels)
+      for (size_t ch = 0; ch < kChannels; ++ch)
+        out_ref[i + ch] = reference[ch].Process(input[i + ch], 0, 0);
+    uint64_t t1 = now_ns();
+    for (size_t i = 0; i < input.size(); i += kChannels)
+      for (size_t ch = 0; ch < kChannels; ++ch)
+        out_table[i + ch] = table[ch].Process(input[i + ch], 0, 0);
+    uint64_t t2 = now_ns();
+    best[0] = std::min(best[0], t1 - t0);
+    best[1] = std::min(best[1], t2 - t1);
+  }
+
+  size_t mismatches = 0;
+  for (size_t i = 0; i < input.size(); ++i) {
+    if (out_ref[i] != out_table[i]) {
+      if (!mismatches)
+        fprintf(stderr, "mismatch at sample %zu ch %zu: ref %d table %d\n",
+                i / kChannels, i % kChannels, out_ref[i], out_table[i]);
+      ++mismatches;
+    }
+  }
+
+  const double n = double(input.size());
+  printf("%zu samples x %zu channels\n", num_samples, kChannels);
+  printf("reference   %7.2f ns/sample\n", best[0] / n);
+  printf("table       %7.2f ns/sample\n", best[1] / n);
+  printf("bit-exact: %s\n", mismatches ? "NO" : "yes");
+  return mismatches ? 1 : 0;
+}
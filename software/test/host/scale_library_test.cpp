@@ -0,0 +1,163 @@
+// Host tests for the Scala scale library: indexing a directory in the
+// background, reading entries back from the index alone, and rescans.
+
+// Applet registry and app container, which the firmware archive refers to
+#include "OC_apps.cpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include "OC_scale_library.h"
+
+namespace {
+
+using OC::ScaleLibrary;
+
+const char * const TEST_INDEX = "TEST.IDX";
+
+void WriteFile(FS &fs, const char *path, const std::string &text) {
+  fs.remove(path);
+  File file = fs.open(path, FILE_WRITE_BEGIN);
+  file.write(text.data(), text.size());
+  file.close();
+}
+
+int16_t Cents(float cents) {
+  return static_cast<int16_t>(lroundf(cents * 1.28f));
+}
+
+class ScaleLibraryTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    PhzConfig::myfs.format();
+    card.format();
+    WriteFile(card, "/SCALES/pelog.scl", "! pelog.scl\n!\nPelog\n5\n120.\n270.\n540.\n670.\n1200.\n");
+    WriteFile(card, "/SCALES/README.txt", "not a scale\n");
+    WriteFile(card, "/SCALES/broken.scl", "Broken\n7\n100.0\n");
+    WriteFile(card, "/SCALES/JUST.SCL", "\n4\n5/4\n3/2\n7/4\n2/1\n");
+    WriteFile(card, "/SCALES/old/nested.scl", "Nested\n2\n700.0\n1200.0\n");
+    WriteFile(card, "/other.scl", "Elsewhere\n2\n700.0\n1200.0\n");
+  }
+
+  // Runs the indexer to completion, @return the number of Poll() calls
+  int IndexAll() {
+    int polls = 0;
+    while (library.Poll()) ++polls;
+    return polls;
+  }
+
+  FS card;
+  ScaleLibrary library{TEST_INDEX};
+};
+
+TEST_F(ScaleLibraryTest, MissingIndexIsEmpty) {
+  EXPECT_FALSE(library.Open());
+  EXPECT_EQ(0u, library.size());
+  ScaleLibrary::Entry entry;
+  EXPECT_FALSE(library.Read(0, entry));
+}
+
+TEST_F(ScaleLibraryTest, IndexesScalaFilesInDirectory) {
+  ASSERT_TRUE(library.StartIndexing(card));
+  EXPECT_TRUE(library.indexing());
+  // one call per .scl file, broken or not
+  EXPECT_EQ(3, IndexAll());
+  EXPECT_FALSE(library.indexing());
+
+  // JUST.SCL and pelog.scl, in directory order
+  ASSERT_EQ(2u, library.size());
+  EXPECT_EQ(ScaleLibrary::entry_offset(2), PhzConfig::myfs.files().at(TEST_INDEX)->size());
+
+  ScaleLibrary::Entry entry;
+  ASSERT_TRUE(library.Read(0, entry));
+  EXPECT_STREQ("JUST", entry.name); // no description
+  EXPECT_EQ(4, entry.num_notes);
+  EXPECT_EQ(Cents(386.3137f), entry.notes[1]);
+  EXPECT_EQ(12 << 7, entry.span);
+
+  ASSERT_TRUE(library.Read(1, entry));
+  EXPECT_STREQ("Pelog", entry.name);
+  EXPECT_EQ(5, entry.num_notes);
+  EXPECT_EQ(Cents(670.0f), entry.notes[4]);
+  EXPECT_EQ(0, entry.notes[5]);
+
+  EXPECT_FALSE(library.Read(2, entry));
+}
+
+TEST_F(ScaleLibraryTest, IndexOutlivesTheCard) {
+  ASSERT_TRUE(library.StartIndexing(card));
+  IndexAll();
+  card.format();
+  EXPECT_FALSE(PhzConfig::myfs.exists("SCALES.TMP"));
+
+  ScaleLibrary reopened{TEST_INDEX};
+  ASSERT_TRUE(reopened.Open());
+  ASSERT_EQ(2u, reopened.size());
+
+  OC::Scale scale;
+  ASSERT_TRUE(reopened.Load(1, scale));
+  EXPECT_EQ(5u, scale.num_notes);
+  EXPECT_EQ(12 << 7, scale.span);
+  EXPECT_EQ(Cents(120.0f), scale.notes[1]);
+}
+
+TEST_F(ScaleLibraryTest, OldIndexServesUntilRescanCompletes) {
+  ASSERT_TRUE(library.StartIndexing(card));
+  IndexAll();
+
+  WriteFile(card, "/SCALES/new.scl", "New\n2\n500.0\n1200.0\n");
+  ASSERT_TRUE(library.StartIndexing(card));
+  ASSERT_TRUE(library.Poll());
+  EXPECT_EQ(2u, library.size());
+  ScaleLibrary::Entry entry;
+  EXPECT_TRUE(library.Read(1, entry));
+
+  IndexAll();
+  EXPECT_EQ(3u, library.size());
+}
+
+TEST_F(ScaleLibraryTest, MissingDirectory) {
+  EXPECT_FALSE(library.StartIndexing(card, "/TUNINGS"));
+  EXPECT_FALSE(library.indexing());
+  EXPECT_FALSE(library.Poll());
+}
+
+TEST_F(ScaleLibraryTest, DamagedIndex) {
+  ASSERT_TRUE(library.StartIndexing(card));
+  IndexAll();
+
+  // truncated mid-entry: the whole entries are kept
+  auto &bytes = *PhzConfig::myfs.files().at(TEST_INDEX);
+  bytes.resize(ScaleLibrary::entry_offset(1) + 10);
+  ASSERT_TRUE(library.Open());
+  EXPECT_EQ(1u, library.size());
+
+  bytes[0] = 'Q';
+  EXPECT_FALSE(library.Open());
+  EXPECT_EQ(0u, library.size());
+}
+
+TEST_F(ScaleLibraryTest, LoadScalaRoundTrip) {
+  OC::Scale scale = braids::scales[4];
+  {
+    File file = card.open("RT.SCL", FILE_WRITE_BEGIN);
+    OC::Scales::SaveToScala(scale, file);
+    file.close();
+  }
+  OC::Scale loaded;
+  memset(&loaded, 0, sizeof(loaded));
+  File file = card.open("RT.SCL");
+  char name[ScaleLibrary::NAME_LENGTH];
+  ASSERT_TRUE(OC::Scales::LoadScala(loaded, file, name));
+  EXPECT_STREQ("O_C User Scale", name);
+  EXPECT_EQ(scale.num_notes, loaded.num_notes);
+  EXPECT_EQ(scale.span, loaded.span);
+  for (size_t i = 0; i < scale.num_notes; ++i) EXPECT_EQ(scale.notes[i], loaded.notes[i]) << i;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  PhzConfig::myfs.begin(1024 * 512);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,204 @@
+// Host tests for StreamResampler, the rate converter behind
+// InterpolatingStream: pushes at a drifting core rate and blocks pulled at
+// a slightly-off audio rate with service jitter, for hours of virtual
+// time. In adaptive mode the stream must never skip a block or force the
+// read rate once it has settled, and the measured ratio must follow the
+// real one.
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+
+#include "OC_config.h"
+#include "Audio/StreamResampler.h"
+
+namespace {
+
+constexpr double kNominalIn = OC_CORE_ISR_FREQ;
+constexpr double kNominalOut = AUDIO_SAMPLE_RATE_EXACT;
+
+struct Rng {
+  uint32_t state = 1;
+  double uniform() {
+    state = state * 1664525u + 1013904223u;
+    return (state >> 8) / double(1 << 24);
+  }
+};
+
+// Core clock off by 300ppm and wandering +-200ppm over ten minutes, audio
+// clock 150ppm slow, and each block serviced up to 20us late
+struct Clocks {
+  double in_offset = 300e-6;
+  double in_wander = 200e-6;
+  double out_offset = -150e-6;
+  double jitter = 20e-6;
+
+  double in_rate(double t) const {
+    return kNominalIn * (1.0 + in_offset + in_wander * sin(2.0 * M_PI * t / 600.0));
+  }
+  double out_rate() const {
+    return kNominalOut * (1.0 + out_offset);
+  }
+};
+
+struct Result {
+  uint32_t blocks = 0;
+  uint32_t skipped = 0;      // after settling
+  uint32_t underruns = 0;    // after settling
+  uint32_t overruns = 0;     // after settling
+  float min_fill = 1e9f;
+  float max_fill = 0.0f;
+  double max_step = 0.0;     // largest jump between output samples
+  double ratio_error = 0.0;  // relative, at the end
+};
+
+// Push a slow sine at the core rate for seconds of virtual time, pulling
+// blocks at the audio rate
+Result Simulate(InterpolationMethod method, bool adaptive, double seconds, const Clocks &clocks,
+           double settle = 2.0) {
+  StreamResampler<> stream(kNominalIn / kNominalOut);
+  stream.Method(method);
+  stream.Adaptive(adaptive);
+  stream.Acquire();
+
+  Rng rng;
+  Result result;
+  const double block_period = AUDIO_BLOCK_SAMPLES / clocks.out_rate();
+  double t_push = 0.0;
+  double phase = 0.0;
+  double last = 0.0;
+  bool settled = false;
+  int16_t out[AUDIO_BLOCK_SAMPLES];
+
+  for (uint32_t block = 1; block * block_period < seconds; ++block) {
+    const double t_block = block * block_period + clocks.jitter * rng.uniform();
+    while (t_push < t_block) {
+      stream.Push(int16_t(20000.0 * sin(phase)));
+      phase += 2.0 * M_PI * 5.0 / kNominalIn;
+      t_push += 1.0 / clocks.in_rate(t_push);
+    }
+
+    if (!settled && t_block > settle) {
+      settled = true;
+      stream.ResetCounters();
+    }
+    const float fill = stream.Length();
+    const bool rendered = stream.Render(out);
+    if (!settled) {
+      if (rendered) last = out[AUDIO_BLOCK_SAMPLES - 1];
+      continue;
+    }
+
+    ++result.blocks;
+    result.min_fill = std::min(result.min_fill, fill);
+    result.max_fill = std::max(result.max_fill, fill);
+    if (!rendered) {
+      ++result.skipped;
+      std::fill(out, out + AUDIO_BLOCK_SAMPLES, 0);
+    }
+    for (int i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) {
+      result.max_step = std::max(result.max_step, fabs(out[i] - last));
+      last = out[i];
+    }
+  }
+  result.underruns = stream.underruns();
+  result.overruns = stream.overruns();
+  const double true_ratio = clocks.in_rate(seconds) / clocks.out_rate();
+  result.ratio_error = fabs(stream.ratio() / true_ratio - 1.0);
+  stream.Release();
+  return result;
+}
+
+// A 5Hz sine of 20000 moves at most ~15 per output sample; a skipped or
+// jumping block shows up as a much bigger step
+constexpr double kMaxStep = 20.0;
+
+TEST(StreamResampler, SincKernelHasUnityGain) {
+  const float *kernel = SincKernel::Table::values;
+  for (int phase = 0; phase <= SincKernel::kPhases; ++phase) {
+    float sum = 0.0f;
+    for (int t = 0; t < SincKernel::kTaps; ++t) sum += kernel[phase * SincKernel::kTaps + t];
+    EXPECT_NEAR(1.0f, sum, 1e-5f) << phase;
+  }
+  // The last phase is the first, one tap later
+  for (int t = 1; t < SincKernel::kTaps; ++t) {
+    EXPECT_NEAR(kernel[t - 1], kernel[SincKernel::kPhases * SincKernel::kTaps + t], 1e-6f) << t;
+  }
+}
+
+TEST(StreamResampler, FixedRateDrifts) {
+  // What adaptive mode is for: with the same clocks, the fixed ratio keeps
+  // being forced
+  const Result r = Simulate(INTERPOLATION_LINEAR, false, 600.0, Clocks());
+  EXPECT_GT(r.underruns + r.overruns, 1000u);
+}
+
+TEST(StreamResampler, AdaptiveTracksDrift) {
+  for (InterpolationMethod method : {INTERPOLATION_ZOH, INTERPOLATION_LINEAR,
+                                     INTERPOLATION_HERMITE, INTERPOLATION_SINC}) {
+    const Result r = Simulate(method, true, 600.0, Clocks());
+    EXPECT_EQ(0u, r.skipped) << method;
+    EXPECT_EQ(0u, r.underruns) << method;
+    EXPECT_EQ(0u, r.overruns) << method;
+    EXPECT_LT(r.ratio_error, 20e-6) << method;
+    if (method != INTERPOLATION_ZOH) {
+      EXPECT_LT(r.max_step, kMaxStep) << method;
+    }
+  }
+}
+
+TEST(StreamResampler, AdaptiveForHours) {
+  // Three hours, with a larger offset and faster wander
+  Clocks clocks;
+  clocks.in_offset = -800e-6;
+  clocks.in_wander = 500e-6;
+  clocks.jitter = 40e-6;
+  const Result r = Simulate(INTERPOLATION_LINEAR, true, 3 * 3600.0, clocks);
+  EXPECT_GT(r.blocks, 3u * 3600 * 344);
+  EXPECT_EQ(0u, r.skipped);
+  EXPECT_EQ(0u, r.underruns);
+  EXPECT_EQ(0u, r.overruns);
+  EXPECT_LT(r.max_step, kMaxStep);
+  EXPECT_LT(r.ratio_error, 20e-6);
+  // The fill level stays close to the target: a block's worth plus the
+  // interpolation padding and margin
+  const float target = kNominalIn / kNominalOut * AUDIO_BLOCK_SAMPLES + 2 + StreamResampler<>::kMargin;
+  EXPECT_GT(r.min_fill, target - 4.0f);
+  EXPECT_LT(r.max_fill, target + 4.0f);
+}
+
+TEST(StreamResampler, AdaptiveRecoversFromStall) {
+  // The core stops pushing for 10ms (e.g. a long flash write), then carries
+  // on: one underrun, then it settles again
+  StreamResampler<> stream(kNominalIn / kNominalOut);
+  stream.Method(INTERPOLATION_LINEAR);
+  stream.Adaptive(true);
+  stream.Acquire();
+  int16_t out[AUDIO_BLOCK_SAMPLES];
+  double t_push = 0.0;
+  const double block_period = AUDIO_BLOCK_SAMPLES / kNominalOut;
+  int rendered = 0;
+  for (int block = 1; block < 20000; ++block) {
+    const double t_block = block * block_period;
+    while (t_push < t_block) {
+      if (t_push < 40.0 || t_push > 40.01) stream.Push(1000);
+      t_push += 1.0 / kNominalIn;
+    }
+    if (block == 10000) stream.ResetCounters();
+    if (block > 10000) rendered += stream.Render(out);
+    else stream.Render(out);
+  }
+  stream.Release();
+  EXPECT_GE(stream.underruns(), 1u);
+  EXPECT_LE(stream.underruns(), 6u);
+  EXPECT_EQ(0u, stream.overruns());
+  EXPECT_GT(rendered, 9990);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
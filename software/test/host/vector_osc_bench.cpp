@@ -0,0 +1,85 @@
+// Benchmark for VectorOscillator: Next() per sample vs. Render() in blocks,
+// at LFO and audio rates, for a few waveform shapes. Outputs are compared
+// sample by sample; any mismatch fails the run.
+//
+// Usage: vector_osc_bench [SAMPLES] [BLOCK]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include <Arduino.h>
+#include "vector_osc/HSVectorOscillator.h"
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+struct Shape {
+  const char *name;
+  HS::VOSegment segments[HS::VO_MAX_SEGMENTS];
+  int count;
+};
+
+static const Shape shapes[] = {
+  { "triangle", {{255, 1}, {0, 1}}, 2 },
+  { "ramp", {{255, 9}, {0, 0}}, 2 },
+  { "steps", {{200, 1}, {200, 0}, {60, 1}, {60, 0}, {150, 2}, {150, 0}}, 6 },
+  { "12-seg", {{255, 3}, {20, 1}, {180, 5}, {90, 2}, {90, 0}, {240, 9},
+               {10, 4}, {128, 1}, {60, 7}, {200, 2}, {30, 6}, {128, 3}}, 12 },
+};
+
+static void Setup(VectorOscillator &osc, const Shape &shape, uint32_t freq) {
+  for (int i = 0; i < shape.count; ++i) osc.SetSegment(shape.segments[i]);
+  osc.SetScale(7680); // 5V
+  osc.SetFrequency(freq);
+  osc.Reset();
+}
+
+int main(int argc, char **argv) {
+  const size_t num_samples = argc > 1 ? strtoul(argv[1], nullptr, 0) : 1000000;
+  const size_t block = argc > 2 ? strtoul(argv[2], nullptr, 0) : 32;
+  // centihertz: a slow LFO, a fast LFO, and audio
+  const uint32_t freqs[] = { 50, 2000, 44000 };
+
+  std::vector<int32_t> out_next(num_samples), out_render(num_samples);
+  bool ok = true;
+
+  printf("%-9s %8s %10s %10s %7s\n", "shape", "Hz", "Next ns", "Render ns", "speedup");
+  for (const Shape &shape : shapes) {
+    for (uint32_t freq : freqs) {
+      uint64_t best[2] = { UINT64_MAX, UINT64_MAX };
+      for (int pass = 0; pass < 5; ++pass) {
+        VectorOscillator a, b;
+        Setup(a, shape, freq);
+        Setup(b, shape, freq);
+
+        uint64_t t0 = now_ns();
+        for (size_t i = 0; i < num_samples; ++i) out_next[i] = a.Next();
+        uint64_t t1 = now_ns();
+        for (size_t i = 0; i < num_samples; i += block) {
+          b.Render(&out_render[i], std::min(block, num_samples - i));
+        }
+        uint64_t t2 = now_ns();
+
+        if (t1 - t0 < best[0]) best[0] = t1 - t0;
+        if (t2 - t1 < best[1]) best[1] = t2 - t1;
+        for (size_t i = 0; i < num_samples; ++i) {
+          if (out_next[i] != out_render[i]) {
+            printf("MISMATCH %s %u.%02uHz at %zu: %d != %d\n", shape.name, freq / 100, freq % 100,
+                   i, out_next[i], out_render[i]);
+            ok = false;
+            break;
+          }
+        }
+      }
+      printf("%-9s %5u.%02u %10.2f %10.2f %6.2fx\n", shape.name, freq / 100, freq % 100,
+             double(best[0]) / num_samples, double(best[1]) / num_samples,
+             double(best[0]) / best[1]);
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include "Audio/AudioBuffer.h"
+
+namespace {
+
+struct Rng {
+  uint32_t state;
+  uint32_t operator()() {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  }
+};
+
+template <bool PowerOfTwo>
+struct TestBuffer {
+  std::vector<int16_t> storage;
+  AudioBuffer<int16_t, PowerOfTwo> buffer;
+
+  TestBuffer(size_t samples) : storage(samples), buffer(storage.data(), samples) {}
+
+  void Fill(Rng &rng, size_t samples) {
+    for (size_t i = 0; i < samples; ++i) buffer.WriteSample(int16_t(rng()));
+  }
+};
+
+// Reads that a modulated delay line does: a slowly moving read head, with
+// the sample offset subtracted, like AudioDelayExt::ReadStretchChunk
+std::vector<float> ReadPositions(Rng &rng, size_t max_back, size_t n) {
+  std::vector<float> positions(n);
+  float pos = 4 + (rng() % (max_back - 8 - n));
+  const float speed = (int(rng() % 2001) - 1000) / 1000.0f;
+  for (size_t i = 0; i < n; ++i) {
+    positions[i] = pos - i;
+    pos += speed;
+  }
+  return positions;
+}
+
+TEST(TestAudioBuffer, PowerOfTwoRoundsDown) {
+  std::vector<int16_t> storage(1000);
+  AudioBuffer<int16_t, true> pow2(storage.data(), 1000);
+  EXPECT_EQ(512U, pow2.NumSamples);
+  AudioBuffer<int16_t, true> exact(storage.data(), 256);
+  EXPECT_EQ(256U, exact.NumSamples);
+  AudioBuffer<int16_t> plain(storage.data(), 1000);
+  EXPECT_EQ(1000U, plain.NumSamples);
+}
+
+TEST(TestAudioBuffer, PowerOfTwoReadsMatch) {
+  // Same contents and write position, one wrapping with % and one with &
+  Rng rng{1};
+  TestBuffer<false> plain(1024);
+  TestBuffer<true> pow2(1024);
+  for (size_t written : {100u, 1024u, 3000u}) {
+    Rng a = rng, b = rng;
+    plain.Fill(a, written);
+    pow2.Fill(b, written);
+    rng = a;
+    for (size_t back = 0; back <= 1024; ++back) {
+      ASSERT_EQ(plain.buffer.ReadSample(back), pow2.buffer.ReadSample(back)) << back;
+    }
+
+    int16_t expected[AUDIO_BLOCK_SAMPLES], actual[AUDIO_BLOCK_SAMPLES];
+    for (size_t back : {128u, 500u, 1000u}) {
+      plain.buffer.ReadFromSamplesAgo(back, expected);
+      pow2.buffer.ReadFromSamplesAgo(back, actual);
+      for (size_t i = 0; i < AUDIO_BLOCK_SAMPLES; ++i) ASSERT_EQ(expected[i], actual[i]);
+    }
+  }
+}
+
+template <bool PowerOfTwo>
+void ExpectBlockMatchesReadInterp(size_t samples, uint32_t seed) {
+  Rng rng{seed};
+  TestBuffer<PowerOfTwo> buf(samples);
+  for (int trial = 0; trial < 200; ++trial) {
+    buf.Fill(rng, 1 + rng() % 300);
+    const size_t n = 1 + rng() % (2 * AUDIO_BLOCK_SAMPLES);
+    const auto positions = ReadPositions(rng, buf.buffer.NumSamples, n);
+
+    std::vector<float> block(n);
+    buf.buffer.ReadInterpBlock(positions.data(), block.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      ASSERT_EQ(buf.buffer.ReadInterp(positions[i]), block[i]) << "trial " << trial << " sample " << i;
+    }
+  }
+}
+
+TEST(TestAudioBuffer, ReadInterpBlockMatchesReadInterp) {
+  ExpectBlockMatchesReadInterp<false>(1000, 1);
+  ExpectBlockMatchesReadInterp<false>(44117, 2);
+  ExpectBlockMatchesReadInterp<true>(1024, 3);
+  ExpectBlockMatchesReadInterp<true>(65536, 4);
+}
+
+TEST(TestAudioBuffer, ReadInterpBlockAtWriteHead) {
+  // Positions just behind the write head use the sample after it (the
+  // oldest one), the same as ReadInterp
+  Rng rng{5};
+  TestBuffer<true> buf(256);
+  buf.Fill(rng, 300);
+  const float positions[] = {0.0f, 0.25f, 0.5f, 0.99f, 1.0f, 254.5f};
+  float block[6];
+  buf.buffer.ReadInterpBlock(positions, block, 6);
+  for (int i = 0; i < 6; ++i) EXPECT_EQ(buf.buffer.ReadInterp(positions[i]), block[i]);
+}
+
+TEST(TestAudioBuffer, ReadInterpBlockLinear) {
+  std::vector<int16_t> storage(64);
+  AudioBuffer<int16_t, true> buffer(storage.data(), 64);
+  for (int i = 0; i < 64; ++i) buffer.WriteSample(int16_t(i * 100));
+
+  // A ramp interpolates exactly; sample n back is (63 - n + 1) * 100
+  const float positions[] = {1.0f, 1.5f, 2.25f, 10.75f};
+  float out[4];
+  buffer.ReadInterpBlock<AudioBuffer<int16_t, true>::INTERP_LINEAR>(positions, out, 4);
+  for (int i = 0; i < 4; ++i) EXPECT_FLOAT_EQ((64 - positions[i]) * 100, out[i]);
+}
+
+} // namespace
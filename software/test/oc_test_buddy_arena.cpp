@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <vector>
+#include "util/util_buddy_arena.h"
+
+namespace {
+
+constexpr size_t kChunk = 64;
+constexpr size_t kChunks = 64;
+using Arena = util::BuddyArena<kChunk, kChunks, 4>;
+
+struct TestArena {
+  std::vector<uint8_t> region;
+  Arena arena;
+
+  explicit TestArena(size_t chunks) : region(chunks * kChunk, 0xaa) {
+    arena.Init(region.data(), region.size());
+  }
+
+  bool IsZero(const void *p, size_t bytes) const {
+    const uint8_t *b = static_cast<const uint8_t *>(p);
+    return std::all_of(b, b + bytes, [](uint8_t c) { return c == 0; });
+  }
+};
+
+TEST(TestBuddyArena, AllocatesZeroedAndTrims) {
+  TestArena t(kChunks);
+  EXPECT_EQ(kChunks * kChunk, t.arena.capacity());
+  EXPECT_EQ(kChunks * kChunk, t.arena.largest_available());
+
+  // 5 chunks come from an 8-chunk block; the other 3 stay free
+  void *a = t.arena.Allocate(5 * kChunk - 10, 0);
+  ASSERT_NE(nullptr, a);
+  EXPECT_TRUE(t.IsZero(a, 5 * kChunk));
+  EXPECT_EQ(5 * kChunk, t.arena.used());
+  EXPECT_EQ(5 * kChunk, t.arena.used(0));
+  EXPECT_EQ((kChunks - 5) * kChunk, t.arena.available());
+  EXPECT_EQ(32 * kChunk, t.arena.largest_available());
+
+  // The trimmed tail is used before anything bigger is split
+  void *b = t.arena.Allocate(2 * kChunk, 1);
+  EXPECT_EQ(static_cast<uint8_t *>(a) + 6 * kChunk, b);
+  void *c = t.arena.Allocate(1, 1);
+  EXPECT_EQ(static_cast<uint8_t *>(a) + 5 * kChunk, c);
+  EXPECT_EQ(32 * kChunk, t.arena.largest_available());
+
+  t.arena.Free(a);
+  t.arena.Free(b);
+  t.arena.Free(c);
+  EXPECT_EQ(0u, t.arena.used());
+  EXPECT_EQ(kChunks * kChunk, t.arena.largest_available());
+}
+
+TEST(TestBuddyArena, NoFragmentationWhenSwapping) {
+  // Buffers of mixed sizes come and go, as applets are swapped; once
+  // they're all gone the whole region must be available as one block again
+  TestArena t(kChunks);
+  uint32_t seed = 1;
+  std::vector<void *> live;
+  for (int i = 0; i < 2000; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    if (live.size() < 6 && (seed >> 28) < 10) {
+      void *p = t.arena.Allocate(((seed >> 8) % (12 * kChunk)) + 1);
+      if (p) live.push_back(p);
+    } else if (!live.empty()) {
+      const size_t ix = (seed >> 8) % live.size();
+      t.arena.Free(live[ix]);
+      live.erase(live.begin() + ix);
+    }
+  }
+  for (void *p : live) t.arena.Free(p);
+  EXPECT_EQ(0u, t.arena.used());
+  EXPECT_EQ(kChunks * kChunk, t.arena.largest_available());
+  EXPECT_NE(nullptr, t.arena.Allocate(kChunks * kChunk));
+}
+
+TEST(TestBuddyArena, Budgets) {
+  TestArena t(kChunks);
+  t.arena.set_budget(2, 8 * kChunk);
+  EXPECT_EQ(8 * kChunk, t.arena.budget(2));
+  EXPECT_EQ(SIZE_MAX, t.arena.budget(Arena::kUnowned));
+
+  void *a = t.arena.Allocate(6 * kChunk, 2);
+  ASSERT_NE(nullptr, a);
+  EXPECT_EQ(nullptr, t.arena.Allocate(3 * kChunk, 2));
+  void *b = t.arena.Allocate(2 * kChunk, 2);
+  EXPECT_NE(nullptr, b);
+  EXPECT_EQ(8 * kChunk, t.arena.used(2));
+
+  // Other owners aren't affected, unowned allocations have no budget
+  EXPECT_NE(nullptr, t.arena.Allocate(16 * kChunk, 1));
+  EXPECT_NE(nullptr, t.arena.Allocate(16 * kChunk));
+  EXPECT_EQ(16 * kChunk, t.arena.used(Arena::kUnowned));
+
+  // Freeing credits the owner it was charged to
+  t.arena.Free(a);
+  EXPECT_EQ(2 * kChunk, t.arena.used(2));
+  EXPECT_NE(nullptr, t.arena.Allocate(6 * kChunk, 2));
+}
+
+TEST(TestBuddyArena, ClearsOnlyReusedChunks) {
+  std::vector<uint8_t> region(16 * kChunk, 0);
+  Arena arena;
+  arena.Init(region.data(), region.size(), true);
+
+  // A pre-zeroed region isn't cleared on first use; fill in a marker to
+  // check that
+  region[3 * kChunk] = 1;
+  uint8_t *a = static_cast<uint8_t *>(arena.Allocate(4 * kChunk));
+  ASSERT_EQ(region.data(), a);
+  EXPECT_EQ(1, a[3 * kChunk]);
+
+  // Freed memory is cleared when it's handed out again
+  std::fill(a, a + 4 * kChunk, 0x55);
+  arena.Free(a);
+  uint8_t *b = static_cast<uint8_t *>(arena.Allocate(2 * kChunk));
+  ASSERT_EQ(a, b);
+  EXPECT_TRUE(std::all_of(b, b + 2 * kChunk, [](uint8_t c) { return c == 0; }));
+  // ...but only as much of it as is needed
+  EXPECT_EQ(0x55, b[2 * kChunk]);
+}
+
+TEST(TestBuddyArena, OddSizedRegion) {
+  // 13 chunks: blocks of 8, 4 and 1
+  TestArena t(13);
+  EXPECT_EQ(8 * kChunk, t.arena.largest_available());
+  EXPECT_EQ(nullptr, t.arena.Allocate(9 * kChunk));
+  void *a = t.arena.Allocate(8 * kChunk);
+  void *b = t.arena.Allocate(4 * kChunk);
+  void *c = t.arena.Allocate(kChunk);
+  EXPECT_NE(nullptr, a);
+  EXPECT_NE(nullptr, b);
+  EXPECT_NE(nullptr, c);
+  EXPECT_EQ(nullptr, t.arena.Allocate(1));
+  EXPECT_EQ(0u, t.arena.available());
+
+  // Pointers from elsewhere are ignored
+  int x;
+  EXPECT_FALSE(t.arena.Owns(&x));
+  t.arena.Free(&x);
+  t.arena.Free(b);
+  t.arena.Free(a);
+  t.arena.Free(c);
+  EXPECT_EQ(13 * kChunk, t.arena.available());
+  EXPECT_EQ(8 * kChunk, t.arena.largest_available());
+}
+
+} // namespace
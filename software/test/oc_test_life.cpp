@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include "util/util_life.h"
+
+namespace {
+
+struct Rng {
+  uint32_t state;
+  uint32_t operator()() {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  }
+};
+
+// Cell by cell, the way GameOfLife used to do it
+struct ReferenceBoard {
+  int width, height;
+  std::vector<bool> cells;
+
+  ReferenceBoard(int w, int h) : width(w), height(h), cells(w * h) {}
+
+  bool Get(int x, int y) const {
+    x = (x + width) % width;
+    y = (y + height) % height;
+    return cells[y * width + x];
+  }
+
+  uint32_t Step(util::LifeRule rule) {
+    std::vector<bool> next(cells.size());
+    uint32_t population = 0;
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        int n = 0;
+        for (int dy = -1; dy <= 1; ++dy) {
+          for (int dx = -1; dx <= 1; ++dx) {
+            if (dx || dy) n += Get(x + dx, y + dy);
+          }
+        }
+        const uint16_t mask = Get(x, y) ? rule.survive : rule.birth;
+        next[y * width + x] = (mask >> n) & 1;
+        population += next[y * width + x];
+      }
+    }
+    cells = next;
+    return population;
+  }
+};
+
+template <size_t Rows>
+void ExpectSame(const util::LifeBoard<Rows> &board, const ReferenceBoard &ref) {
+  for (int y = 0; y < ref.height; ++y) {
+    for (int x = 0; x < ref.width; ++x) {
+      ASSERT_EQ(ref.Get(x, y), board.Get(x, y)) << "(" << x << ", " << y << ")";
+    }
+  }
+}
+
+template <size_t Rows>
+void RandomBoards(util::LifeRule rule, uint32_t seed, int trials, int generations) {
+  Rng rng{seed};
+  for (int trial = 0; trial < trials; ++trial) {
+    util::LifeBoard<Rows> board;
+    ReferenceBoard ref(64, Rows);
+    board.SetRule(rule);
+    const uint32_t density = 1 + rng() % 7; // 1/8 to 7/8 full
+    for (int y = 0; y < int(Rows); ++y) {
+      for (int x = 0; x < 64; ++x) {
+        if (rng() % 8 < density) {
+          board.Set(x, y);
+          ref.cells[y * 64 + x] = true;
+        }
+      }
+    }
+    for (int gen = 0; gen < generations; ++gen) {
+      const uint32_t expected = ref.Step(rule);
+      ASSERT_EQ(expected, board.Step()) << "generation " << gen;
+      ASSERT_EQ(expected, board.Population());
+      ExpectSame(board, ref);
+    }
+  }
+}
+
+TEST(TestLife, ConwayMatchesReference) {
+  RandomBoards<40>(util::LifeRule::Conway(), 1, 20, 30);
+  // The wrap needs at least three rows to be distinct from the cell itself
+  RandomBoards<3>(util::LifeRule::Conway(), 2, 20, 10);
+  RandomBoards<1>(util::LifeRule::Conway(), 3, 20, 10);
+}
+
+TEST(TestLife, OtherRulesMatchReference) {
+  RandomBoards<40>(util::LifeRule::HighLife(), 4, 10, 20);
+  RandomBoards<40>(util::LifeRule::Seeds(), 5, 10, 20);
+  RandomBoards<40>(util::LifeRule::DayAndNight(), 6, 10, 20);
+
+  Rng rng{7};
+  for (int i = 0; i < 20; ++i) {
+    const util::LifeRule rule = { uint16_t(rng() & 0x1ff), uint16_t(rng() & 0x1ff) };
+    RandomBoards<17>(rule, rng(), 2, 10);
+  }
+}
+
+TEST(TestLife, GliderWrapsAround) {
+  util::LifeBoard<40> board;
+  // Glider heading +x, +y, straddling the right and bottom edges
+  const int cells[][2] = {{63, 38}, {0, 39}, {62, 0}, {63, 0}, {0, 0}};
+  for (const auto &c : cells) board.Set(c[0], c[1]);
+
+  // Moves one cell diagonally every four generations
+  for (int gen = 0; gen < 4; ++gen) EXPECT_EQ(5U, board.Step());
+  for (const auto &c : cells) EXPECT_TRUE(board.Get((c[0] + 1) % 64, (c[1] + 1) % 40));
+}
+
+TEST(TestLife, PopulationInWindow) {
+  util::LifeBoard<40> board;
+  for (int y = 0; y < 40; ++y) {
+    for (int x = 0; x < 64; ++x) board.Set(x, y, (x + y) % 3 == 0);
+  }
+  Rng rng{9};
+  for (int i = 0; i < 500; ++i) {
+    const int x = int(rng() % 80) - 8, y = int(rng() % 56) - 8;
+    uint32_t expected = 0;
+    for (int yy = y - 7; yy <= y + 7; ++yy) {
+      for (int xx = x - 7; xx <= x + 7; ++xx) {
+        if (xx >= 0 && xx < 64 && yy >= 0 && yy < 40) expected += board.Get(xx, yy);
+      }
+    }
+    ASSERT_EQ(expected, board.PopulationIn(x - 7, y - 7, x + 7, y + 7)) << x << ", " << y;
+  }
+  EXPECT_EQ(board.Population(), board.PopulationIn(0, 0, 63, 39));
+  EXPECT_EQ(0U, board.PopulationIn(70, 0, 80, 39));
+
+  board.Clear();
+  EXPECT_EQ(0U, board.Population());
+}
+
+} // namespace
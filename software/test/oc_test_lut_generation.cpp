@@ -0,0 +1,296 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include "tideslite.h"
+#include "src/extern/frames_resources.h"
+#include "src/extern/peaks_resources.h"
+#include "src/extern/streams_resources.h"
+#include "Audio/DspTables.h"
+
+namespace {
+
+// The tables as they were checked in before being generated at compile time:
+// tideslite at 16666 Hz, peaks envelopes at 16666 Hz, peaks gravity at
+// 48000 Hz, frames at 16667 Hz, streams Lorenz at the stock core rate.
+const uint32_t kTidesLiteIncrements[] = {
+  2106971, 2122239, 2137618, 2153108, 2168710, 2184425, 2200255, 2216199,
+  2232258, 2248434, 2264727, 2281138, 2297668, 2314318, 2331089, 2347981,
+  2364995, 2382133, 2399395, 2416782, 2434295, 2451935, 2469702, 2487599,
+  2505625, 2523782, 2542070, 2560491, 2579046, 2597734, 2616559, 2635519,
+  2654617, 2673854, 2693230, 2712746, 2732404, 2752204, 2772147, 2792235,
+  2812469, 2832850, 2853377, 2874054, 2894881, 2915858, 2936988, 2958270,
+  2979707, 3001300, 3023048, 3044954, 3067019, 3089244, 3111630, 3134178,
+  3156890, 3179766, 3202808, 3226017, 3249394, 3272940, 3296657, 3320546,
+  3344608, 3368845, 3393257, 3417846, 3442613, 3467560, 3492687, 3517996,
+  3543489, 3569167, 3595031, 3621082, 3647321, 3673751, 3700373, 3727187,
+  3754196, 3781401, 3808802, 3836402, 3864202, 3892204, 3920409, 3948818,
+  3977432, 4006254, 4035285, 4064527, 4093980, 4123647, 4153528, 4183626,
+  4213943,
+};
+
+const uint32_t kPeaksEnvIncrements[] = {
+  515416692, 467165981, 424136651, 385689885, 351273767, 320410310, 292684581, 267735574,
+  245248504, 224948313, 206594161, 189974741, 174904307, 161219269, 148775289, 137444789,
+  127114809, 117685165, 109066861, 101180711, 93956148, 87330196, 81246566, 75654875,
+  70509966, 65771309, 61402477, 57370692, 53646419, 50203015, 47016415, 44064857,
+  41328639, 38789905, 36432455, 34241573, 32203878, 30307191, 28540417, 26893434,
+  25357006, 23922691, 22582767, 21330168, 20158417, 19061577, 18034198, 17071272,
+  16168198, 15320740, 14524999, 13777381, 13074574, 12413517, 11791388, 11205574,
+  10653662, 10133417, 9642769, 9179800, 8742730, 8329909, 7939804, 7570990,
+  7222144, 6892032, 6579509, 6283506, 6003027, 5737145, 5484993, 5245763,
+  5018701, 4803099, 4598299, 4403683, 4218675, 4042732, 3875349, 3716050,
+  3564389, 3419950, 3282340, 3151190, 3026155, 2906909, 2793146, 2684578,
+  2580936, 2481963, 2387420, 2297081, 2210732, 2128171, 2049210, 1973669,
+  1901379, 1832181, 1765922, 1702462, 1641664, 1583401, 1527554, 1474006,
+  1422650, 1373384, 1326111, 1280738, 1237178, 1195349, 1155172, 1116572,
+  1079479, 1043825, 1009547, 976584, 944879, 914376, 885024, 856772,
+  829575, 803386, 778163, 753866, 730455, 707894, 686147, 665181,
+  644964, 625465, 606654, 588506, 570991, 554086, 537766, 522008,
+  506790, 492090, 477889, 464167, 450906, 438088, 425695, 413713,
+  402124, 390916, 380073, 369581, 359428, 349601, 340089, 330879,
+  321960, 313323, 304957, 296852, 288999, 281389, 274014, 266864,
+  259933, 253212, 246694, 240373, 234241, 228293, 222520, 216919,
+  211483, 206206, 201083, 196109, 191278, 186587, 182031, 177605,
+  173305, 169126, 165066, 161119, 157283, 153554, 149928, 146403,
+  142974, 139639, 136396, 133240, 130170, 127183, 124276, 121447,
+  118693, 116012, 113402, 110861, 108387, 105977, 103630, 101343,
+  99116, 96946, 94832, 92771, 90763, 88806, 86898, 85039,
+  83225, 81458, 79734, 78052, 76413, 74813, 73253, 71731,
+  70246, 68797, 67383, 66002, 64655, 63341, 62057, 60804,
+  59581, 58386, 57220, 56080, 54968, 53881, 52819, 51782,
+  50769, 49778, 48811, 47865, 46941, 46038, 45155, 44293,
+  43449, 42624, 41817, 41029, 40258, 39503, 38766, 38044,
+  37338, 36648, 35972, 35311, 34665, 34032, 33412, 32806,
+  32213,
+};
+
+const uint16_t kPeaksGravity[] = {
+  33140, 31065, 29132, 27330, 25650, 24084, 22621, 21256,
+  19981, 18790, 17676, 16634, 15660, 14748, 13894, 13094,
+  12344, 11642, 10983, 10365, 9785, 9240, 8729, 8249,
+  7797, 7373, 6973, 6598, 6244, 5912, 5598, 5303,
+  5025, 4763, 4516, 4283, 4063, 3855, 3659, 3474,
+  3299, 3134, 2978, 2830, 2690, 2558, 2433, 2315,
+  2203, 2097, 1996, 1901, 1811, 1725, 1644, 1567,
+  1494, 1425, 1359, 1297, 1237, 1181, 1127, 1077,
+  1028, 982, 938, 897, 857, 820, 784, 750,
+  717, 686, 657, 629, 602, 576, 552, 529,
+  506, 485, 465, 446, 427, 410, 393, 377,
+  362, 347, 333, 320, 307, 295, 283, 272,
+  261, 251, 241, 232, 223, 214, 206, 198,
+  191, 183, 176, 170, 163, 157, 151, 146,
+  140, 135, 130, 125, 121, 116, 112, 108,
+  104, 100, 97, 93, 90, 87, 84, 81,
+  78, 75, 73, 70, 68, 65, 63, 61,
+  59, 57, 55, 53, 51, 50, 48, 46,
+  45, 43, 42, 40, 39, 38, 37, 35,
+  34, 33, 32, 31, 30, 29, 28, 27,
+  26, 25, 25, 24, 23, 22, 22, 21,
+  20, 20, 19, 19, 18, 17, 17, 16,
+  16, 15, 15, 14, 14, 14, 13, 13,
+  12, 12, 12, 11, 11, 11, 10, 10,
+  10, 9, 9, 9, 9, 8, 8, 8,
+  8, 7, 7, 7, 7, 7, 6, 6,
+  6, 6, 6, 5, 5, 5, 5, 5,
+  5, 5, 4, 4, 4, 4, 4, 4,
+  4, 4, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 1, 1,
+  1,
+};
+
+const uint32_t kStreamsLorenzRate[] = {
+  3, 3, 3, 4, 4, 4, 4, 4,
+  5, 5, 5, 5, 6, 6, 6, 7,
+  7, 7, 8, 8, 8, 9, 9, 10,
+  10, 11, 11, 12, 12, 13, 13, 14,
+  15, 15, 16, 17, 18, 18, 19, 20,
+  21, 22, 23, 24, 25, 27, 28, 29,
+  30, 32, 33, 35, 36, 38, 40, 42,
+  44, 46, 48, 50, 52, 55, 57, 60,
+  63, 66, 69, 72, 75, 78, 82, 86,
+  90, 94, 98, 103, 107, 112, 118, 123,
+  129, 135, 141, 147, 154, 161, 168, 176,
+  184, 193, 201, 211, 220, 230, 241, 252,
+  263, 275, 288, 301, 315, 329, 344, 360,
+  377, 394, 412, 431, 451, 471, 493, 515,
+  539, 563, 589, 616, 644, 674, 705, 737,
+  770, 806, 843, 881, 921, 963, 1007, 1054,
+  1102, 1152, 1205, 1260, 1317, 1378, 1441, 1506,
+  1575, 1647, 1722, 1801, 1883, 1970, 2060, 2154,
+  2252, 2355, 2463, 2575, 2693, 2816, 2945, 3079,
+  3220, 3367, 3521, 3682, 3850, 4026, 4210, 4402,
+  4603, 4814, 5034, 5264, 5504, 5756, 6019, 6294,
+  6581, 6882, 7196, 7525, 7869, 8229, 8605, 8998,
+  9409, 9839, 10288, 10758, 11250, 11764, 12302, 12864,
+  13451, 14066, 14709, 15381, 16083, 16818, 17587, 18390,
+  19230, 20109, 21028, 21989, 22993, 24044, 25142, 26291,
+  27492, 28748, 30062, 31435, 32872, 34374, 35944, 37586,
+  39304, 41099, 42977, 44941, 46994, 49141, 51386, 53734,
+  56189, 58756, 61441, 64248, 67184, 70253, 73463, 76819,
+  80329, 83999, 87837, 91850, 96047, 100435, 105024, 109822,
+  114840, 120087, 125573, 131310, 137310, 143583, 150144, 157003,
+  164177, 171678, 179521, 187723, 196300, 205269, 214647, 224454,
+  234709, 245433, 256646, 268372, 280634, 293455, 306863, 320883,
+  335544,
+};
+
+const uint32_t kFramesIncrementsMed[] = {
+  3460, 3475, 3491, 3506, 3521, 3537, 3553, 3568,
+  3584, 3600, 3615, 3631, 3647, 3663, 3679, 3696,
+  3712, 3728, 3745, 3761, 3778, 3794, 3811, 3828,
+  3844, 3861, 3878, 3895, 3912, 3930, 3947, 3964,
+  3982, 3999, 4017, 4034, 4052, 4070, 4088, 4106,
+  4124, 4142, 4160, 4179, 4197, 4215, 4234, 4253,
+  4271, 4290, 4309, 4328, 4347, 4366, 4385, 4404,
+  4424, 4443, 4463, 4482, 4502, 4522, 4542, 4562,
+  4582, 4602, 4622, 4643, 4663, 4683, 4704, 4725,
+  4746, 4766, 4787, 4808, 4830, 4851, 4872, 4894,
+  4915, 4937, 4958, 4980, 5002, 5024, 5046, 5068,
+  5091, 5113, 5135, 5158, 5181, 5203, 5226, 5249,
+  5272, 5296, 5319, 5342, 5366, 5389, 5413, 5437,
+  5461, 5485, 5509, 5533, 5557, 5582, 5606, 5631,
+  5656, 5681, 5706, 5731, 5756, 5781, 5807, 5832,
+  5858, 5884, 5909, 5935, 5962, 5988, 6014, 6040,
+  6067, 6094, 6121, 6147, 6174, 6202, 6229, 6256,
+  6284, 6311, 6339, 6367, 6395, 6423, 6451, 6480,
+  6508, 6537, 6566, 6594, 6623, 6653, 6682, 6711,
+  6741, 6770, 6800, 6830, 6860, 6890, 6920,
+};
+// AudioEffectClouds' Hann window, as it was checked in
+const int16_t kCloudsHann[] = {
+       0,     5,    20,    45,    80,   124,   179,   243,
+     317,   401,   495,   598,   711,   833,   965,  1106,
+    1257,  1416,  1585,  1763,  1949,  2145,  2349,  2561,
+    2782,  3011,  3249,  3494,  3747,  4008,  4276,  4552,
+    4834,  5124,  5421,  5724,  6034,  6350,  6672,  7000,
+    7334,  7673,  8018,  8367,  8722,  9081,  9444,  9812,
+   10184, 10559, 10938, 11321, 11706, 12094, 12485, 12879,
+   13274, 13671, 14070, 14470, 14872, 15274, 15677, 16081,
+   16484, 16888, 17291, 17694, 18096, 18497, 18897, 19295,
+   19691, 20085, 20477, 20867, 21254, 21638, 22019, 22396,
+   22770, 23139, 23505, 23866, 24223, 24575, 24922, 25264,
+   25601, 25932, 26257, 26576, 26889, 27195, 27495, 27789,
+   28075, 28354, 28626, 28891, 29148, 29397, 29638, 29871,
+   30096, 30313, 30521, 30721, 30912, 31094, 31267, 31432,
+   31587, 31732, 31869, 31996, 32114, 32222, 32320, 32409,
+   32488, 32557, 32617, 32666, 32706, 32736, 32756, 32766,
+   32766, 32756, 32736, 32706, 32666, 32617, 32557, 32488,
+   32409, 32320, 32222, 32114, 31996, 31869, 31732, 31587,
+   31432, 31267, 31094, 30912, 30721, 30521, 30313, 30096,
+   29871, 29638, 29397, 29148, 28891, 28626, 28354, 28075,
+   27789, 27495, 27195, 26889, 26576, 26257, 25932, 25601,
+   25264, 24922, 24575, 24223, 23866, 23505, 23139, 22770,
+   22396, 22019, 21638, 21254, 20867, 20477, 20085, 19691,
+   19295, 18897, 18497, 18096, 17694, 17291, 16888, 16484,
+   16081, 15677, 15274, 14872, 14470, 14070, 13671, 13274,
+   12879, 12485, 12094, 11706, 11321, 10938, 10559, 10184,
+    9812,  9444,  9081,  8722,  8367,  8018,  7673,  7334,
+    7000,  6672,  6350,  6034,  5724,  5421,  5124,  4834,
+    4552,  4276,  4008,  3747,  3494,  3249,  3011,  2782,
+    2561,  2349,  2145,  1949,  1763,  1585,  1416,  1257,
+    1106,   965,   833,   711,   598,   495,   401,   317,
+     243,   179,   124,    80,    45,    20,     5,     0,
+};
+
+template <typename T, size_t N, typename F>
+void ExpectTable(const T (&expected)[N], size_t size, F &&generate) {
+  ASSERT_EQ(N, size);
+  for (size_t i = 0; i < N; ++i) ASSERT_EQ(expected[i], generate(i)) << "entry " << i;
+}
+
+TEST(TestLutGeneration, MatchesCheckedInTables) {
+  ExpectTable(kTidesLiteIncrements, LUT_INCREMENTS_SIZE,
+              [](size_t i) { return TidesLiteIncrement(i, 16666); });
+  ExpectTable(kPeaksEnvIncrements, LUT_ENV_INCREMENTS_SIZE,
+              [](size_t i) { return peaks::EnvIncrement(i, 16666); });
+  ExpectTable(kPeaksGravity, LUT_GRAVITY_SIZE,
+              [](size_t i) { return peaks::Gravity(i, 48000); });
+  ExpectTable(kStreamsLorenzRate, LUT_LORENZ_RATE_SIZE,
+              [](size_t i) { return streams::LorenzRate(i, 1.0); });
+  ExpectTable(kFramesIncrementsMed, LUT_INCREMENTS_MED_SIZE,
+              [](size_t i) { return frames::PhaseIncrement(i, 13, 16667); });
+}
+
+TEST(TestLutGeneration, DefaultRateTablesUnchanged) {
+  // The firmware's tables at the configured (default) rate
+  ASSERT_EQ(16666U, OC_CORE_ISR_FREQ);
+  ExpectTable(kTidesLiteIncrements, LUT_INCREMENTS_SIZE, [](size_t i) { return lut_increments[i]; });
+  ExpectTable(kPeaksEnvIncrements, LUT_ENV_INCREMENTS_SIZE,
+              [](size_t i) { return peaks::lut_env_increments[i]; });
+  ExpectTable(kPeaksGravity, LUT_GRAVITY_SIZE, [](size_t i) { return peaks::lut_gravity[i]; });
+  ExpectTable(kStreamsLorenzRate, LUT_LORENZ_RATE_SIZE,
+              [](size_t i) { return streams::lut_lorenz_rate[i]; });
+  ExpectTable(kFramesIncrementsMed, LUT_INCREMENTS_MED_SIZE,
+              [](size_t i) { return frames::lut_increments_med[i]; });
+
+  // Generated before main(), not computed at startup
+  static_assert(lut_increments[96] == 4213943, "");
+  static_assert(peaks::lut_env_increments[0] == 515416692, "");
+}
+
+TEST(TestLutGeneration, ScalesWithRate) {
+  // Twice the rate, half the increment (to within truncation)
+  for (size_t i = 0; i < LUT_INCREMENTS_SIZE; ++i) {
+    EXPECT_NEAR(kTidesLiteIncrements[i] / 2.0, TidesLiteIncrement(i, 33332), 1.0);
+  }
+  for (size_t i = 0; i < LUT_ENV_INCREMENTS_SIZE; ++i) {
+    EXPECT_NEAR(kPeaksEnvIncrements[i] / 2.0, peaks::EnvIncrement(i, 33332), 1.0);
+    EXPECT_NEAR(kStreamsLorenzRate[i] / 2.0, streams::LorenzRate(i, 2.0), 1.0);
+  }
+}
+
+TEST(TestLutGeneration, ConstexprMath) {
+  namespace cm = util::cmath;
+  auto ulps = [](double expected, double actual) {
+    return std::fabs(expected - actual) / std::fabs(std::nextafter(expected, 2 * expected) - expected);
+  };
+  for (double x = -40.0; x < 40.0; x += 0.0137) {
+    EXPECT_LE(ulps(std::exp(x), cm::exp(x)), 4) << x;
+    EXPECT_LE(ulps(std::exp2(x), cm::exp2(x)), 4) << x;
+  }
+  for (double x = 1e-6; x < 1e7; x *= 1.0371) {
+    EXPECT_LE(ulps(std::log(x), cm::log(x)), 4) << x;
+    EXPECT_LE(ulps(std::log2(x), cm::log2(x)), 4) << x;
+    EXPECT_LE(ulps(std::pow(x, 0.175), cm::pow(x, 0.175)), 8) << x;
+  }
+  for (double x = -8 * M_PI; x < 8 * M_PI; x += 0.0113) {
+    EXPECT_NEAR(std::sin(x), cm::sin(x), 1e-15) << x;
+    EXPECT_NEAR(std::cos(x), cm::cos(x), 1e-15) << x;
+  }
+  EXPECT_EQ(2.0, cm::round(2.5));
+  EXPECT_EQ(4.0, cm::round(3.5));
+  EXPECT_EQ(-3.0, cm::round(-2.6));
+  EXPECT_EQ(-2.0, cm::floor(-1.5));
+}
+
+TEST(TestLutGeneration, DspTables) {
+  ExpectTable(kCloudsHann, 256, [](size_t i) { return DspTables::Hann<256>()[i]; });
+
+  // AudioDelayExt used to fill these in Acquire()
+  constexpr size_t kSize = 2048;
+  const int16_t *fade_in = DspTables::EqualPowerFadeIn<kSize>();
+  const int16_t *fade_out = DspTables::EqualPowerFadeOut<kSize>();
+  auto q15 = [](float x) {
+    x = x * 32768.0f + (x > 0.0f ? 0.5f : -0.5f);
+    return int16_t(std::max(-32768, std::min(32767, int32_t(x))));
+  };
+  const float n = static_cast<float>(kSize - 1);
+  for (size_t i = 0; i < kSize; ++i) {
+    float out, in;
+    EqualPowerFade(out, in, i / n);
+    ASSERT_EQ(q15(in), fade_in[i]) << i;
+    ASSERT_EQ(q15(out), fade_out[i]) << i;
+  }
+  EXPECT_EQ(0, fade_in[0]);
+  EXPECT_EQ(32767, fade_in[kSize - 1]);
+  EXPECT_EQ(32767, fade_out[0]);
+
+  // One table per size, whoever asks for it
+  EXPECT_EQ(fade_in, DspTables::EqualPowerFadeIn<kSize>());
+  EXPECT_NE(fade_in, DspTables::EqualPowerFadeIn<kSize / 2>());
+  static_assert(DspTables::Hann<256>()[0] == 0, "");
+}
+
+} // namespace
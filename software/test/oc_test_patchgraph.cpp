@@ -0,0 +1,82 @@
+#include "gtest/gtest.h"
+#include "HSPatchGraph.h"
+
+namespace {
+
+using Graph = HS::PatchGraph<4>;
+
+void expect_order(const Graph &graph, std::initializer_list<int> expected) {
+  int i = 0;
+  for (int slot : expected) {
+    EXPECT_EQ(slot, int(graph.order[i])) << "position " << i;
+    ++i;
+  }
+}
+
+TEST(TestPatchGraph, SlotMask) {
+  EXPECT_EQ(0, Graph::SlotMask(0));
+  EXPECT_EQ(0x1, Graph::SlotMask(0x1));
+  EXPECT_EQ(0x1, Graph::SlotMask(0x2));
+  EXPECT_EQ(0xa, Graph::SlotMask(0x4c));
+  // clock outputs and other virtual channels past the slots
+  EXPECT_EQ(0, Graph::SlotMask(0xf00));
+}
+
+TEST(TestPatchGraph, UnpatchedKeepsSlotOrder) {
+  Graph graph;
+  expect_order(graph, {0, 1, 2, 3});
+
+  const uint8_t reads[4] = {0, 0, 0, 0};
+  EXPECT_FALSE(graph.Update(reads));
+  expect_order(graph, {0, 1, 2, 3});
+  EXPECT_EQ(0, graph.cyclic);
+}
+
+TEST(TestPatchGraph, SourceRunsFirst) {
+  Graph graph;
+  // slot 1 reads slot 3
+  const uint8_t reads[4] = {0, 1 << 3, 0, 0};
+  EXPECT_TRUE(graph.Update(reads));
+  expect_order(graph, {0, 2, 3, 1});
+  EXPECT_EQ(0, graph.cyclic);
+  EXPECT_FALSE(graph.Update(reads));
+}
+
+TEST(TestPatchGraph, ReverseChain) {
+  Graph graph;
+  // 3 -> 2 -> 1 -> 0
+  const uint8_t reads[4] = {1 << 1, 1 << 2, 1 << 3, 0};
+  graph.Update(reads);
+  expect_order(graph, {3, 2, 1, 0});
+  EXPECT_EQ(0, graph.cyclic);
+}
+
+TEST(TestPatchGraph, LoopsAreFlagged) {
+  Graph graph;
+  // 0 <-> 1, and 2 reads 1; the unpatched slot goes first
+  const uint8_t reads[4] = {1 << 1, 1 << 0, 1 << 1, 0};
+  graph.Update(reads);
+  expect_order(graph, {3, 0, 1, 2});
+  EXPECT_EQ(0x3, graph.cyclic);
+  EXPECT_TRUE(graph.is_cyclic(0));
+  EXPECT_FALSE(graph.is_cyclic(2));
+}
+
+TEST(TestPatchGraph, SelfPatchIsALoop) {
+  Graph graph;
+  const uint8_t reads[4] = {0, 0, 1 << 2, 1 << 2};
+  graph.Update(reads);
+  expect_order(graph, {0, 1, 2, 3});
+  EXPECT_EQ(1 << 2, graph.cyclic);
+}
+
+TEST(TestPatchGraph, LoopsRunAfterTheirSources) {
+  Graph graph;
+  // 0 reads itself and 3; 2 <-> 3
+  const uint8_t reads[4] = {(1 << 0) | (1 << 3), 0, 1 << 3, 1 << 2};
+  graph.Update(reads);
+  expect_order(graph, {1, 2, 3, 0});
+  EXPECT_EQ(0xd, graph.cyclic);
+}
+
+} // namespace
@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "util/util_fft.h"
+#include "Audio/YinPitchDetector.h"
+
+namespace {
+
+struct Rng {
+  uint32_t state;
+  uint32_t operator()() {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  }
+  float uniform() { return (*this)() / float(1 << 24) * 2.0f - 1.0f; }
+};
+
+TEST(TestPitch, FFTMatchesDFT) {
+  constexpr size_t N = 64;
+  Rng rng{1};
+  float re[N], im[N];
+  double xr[N], xi[N];
+  for (size_t i = 0; i < N; ++i) {
+    xr[i] = re[i] = rng.uniform();
+    xi[i] = im[i] = rng.uniform();
+  }
+  util::FFT<N>::Forward(re, im);
+  for (size_t k = 0; k < N; ++k) {
+    double sr = 0.0, si = 0.0;
+    for (size_t n = 0; n < N; ++n) {
+      const double w = -2.0 * M_PI * k * n / N;
+      sr += xr[n] * cos(w) - xi[n] * sin(w);
+      si += xr[n] * sin(w) + xi[n] * cos(w);
+    }
+    EXPECT_NEAR(sr, re[k], 1e-4) << k;
+    EXPECT_NEAR(si, im[k], 1e-4) << k;
+  }
+
+  util::FFT<N>::Inverse(re, im);
+  for (size_t i = 0; i < N; ++i) {
+    EXPECT_NEAR(xr[i], re[i] / N, 1e-5);
+    EXPECT_NEAR(xi[i], im[i] / N, 1e-5);
+  }
+}
+
+// d'(tau) straight from the definition
+std::vector<double> DirectCMND(const std::vector<int16_t> &window) {
+  const size_t w = window.size() / 2;
+  std::vector<double> cmnd(w);
+  cmnd[0] = 1.0;
+  double sum = 0.0;
+  for (size_t tau = 1; tau < w; ++tau) {
+    double d = 0.0;
+    for (size_t j = 0; j < w; ++j) {
+      const double delta = (window[j] - window[j + tau]) / 32768.0;
+      d += delta * delta;
+    }
+    sum += d;
+    cmnd[tau] = sum > 0.0 ? d * tau / sum : 1.0;
+  }
+  return cmnd;
+}
+
+std::vector<int16_t> Tone(float freq, size_t n, float harmonics, float noise, Rng &rng,
+                          float sample_rate = 44100.0f) {
+  std::vector<int16_t> out(n);
+  for (size_t i = 0; i < n; ++i) {
+    const float phase = 2.0f * float(M_PI) * freq * i / sample_rate;
+    float x = sinf(phase);
+    for (int h = 2; h <= 8 && h * freq < sample_rate / 2; ++h) x += harmonics * sinf(h * phase) / h;
+    x = 0.4f * x + noise * rng.uniform();
+    out[i] = int16_t(x * 20000.0f);
+  }
+  return out;
+}
+
+TEST(TestPitch, DifferenceMatchesDirect) {
+  Rng rng{3};
+  YinPitchDetector<256> detector;
+  detector.Init(0.15f, 64);
+  for (int trial = 0; trial < 4; ++trial) {
+    const auto window = trial & 1 ? Tone(440.0f + trial * 300, 256, 0.5f, 0.05f, rng)
+                                  : Tone(0.0f, 256, 0.0f, 0.8f, rng);
+    detector.Analyze(window.data());
+    const auto expected = DirectCMND(window);
+    for (size_t tau = 0; tau < expected.size(); ++tau) {
+      ASSERT_NEAR(expected[tau], detector.difference()[tau], 2e-3) << trial << " tau " << tau;
+    }
+  }
+}
+
+TEST(TestPitch, DetectsTones) {
+  Rng rng{5};
+  auto *detector = new YinPitchDetector<2048>;
+  detector->Init(0.15f, 512);
+  for (float freq : {50.0f, 82.41f, 110.0f, 196.0f, 261.63f, 440.0f, 1000.0f, 1760.0f, 3000.0f}) {
+    for (float harmonics : {0.0f, 1.0f}) {
+      const auto window = Tone(freq, 2048, harmonics, 0.01f, rng);
+      ASSERT_TRUE(detector->Analyze(window.data())) << freq;
+      const float detected = 44100.0f / detector->period();
+      const float cents = 1200.0f * log2f(detected / freq);
+      // Parabolic interpolation is good to about a tenth of a sample, which
+      // is more than 5 cents for the shortest periods
+      const float tolerance = std::max(5.0f, 1200.0f * log2f(1.0f + 0.1f * freq / 44100.0f));
+      EXPECT_LT(fabsf(cents), tolerance) << freq << " Hz detected as " << detected;
+      EXPECT_GT(detector->periodicity(), 0.9f);
+    }
+  }
+
+  // Noise has no pitch
+  const auto noise = Tone(0.0f, 2048, 0.0f, 1.0f, rng);
+  EXPECT_FALSE(detector->Analyze(noise.data()));
+  EXPECT_EQ(0.0f, detector->period());
+  delete detector;
+}
+
+TEST(TestPitch, PushEveryHop) {
+  Rng rng{9};
+  const auto signal = Tone(220.0f, 6000, 0.5f, 0.01f, rng);
+  auto *streamed = new YinPitchDetector<1024>;
+  auto *direct = new YinPitchDetector<1024>;
+  streamed->Init(0.15f, 300);
+  direct->Init(0.15f, 300);
+
+  int analyses = 0;
+  size_t pos = 0;
+  while (pos < signal.size()) {
+    // Blocks that don't line up with the hop
+    const size_t n = std::min<size_t>(128, signal.size() - pos);
+    if (streamed->Push(&signal[pos], n)) {
+      ++analyses;
+      EXPECT_NEAR(220.0f, 44100.0f / streamed->period(), 1.0f);
+    }
+    pos += n;
+  }
+  // The first estimate needs a full window
+  EXPECT_EQ(int((6000 - 1024) / 300 + 1), analyses);
+
+  // The last estimate covers the last 1024 samples up to a hop boundary
+  const size_t end = 1024 + (6000 - 1024) / 300 * 300;
+  direct->Analyze(&signal[end - 1024]);
+  EXPECT_FLOAT_EQ(direct->period(), streamed->period());
+  delete streamed;
+  delete direct;
+}
+
+} // namespace
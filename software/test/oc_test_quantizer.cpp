@@ -39,3 +39,66 @@ TEST_F(QuantizerTest, SingleNote) {
   EXPECT_EQ(0, quantizer_.Process(-128));
   EXPECT_EQ(0, quantizer_.Process(-kOctave/2));
 }
+
+#include "braids_quantizer_reference.h"
+
+// Drives the table-driven quantizer and the original linear scan with the same
+// stimulus and expects identical codewords and note numbers.
+class QuantizerEquivalenceTest : public ::testing::TestWithParam<int> {
+protected:
+  uint32_t rng_ = 0x2545f491;
+  uint32_t Next() {
+    rng_ ^= rng_ << 13; rng_ ^= rng_ >> 17; rng_ ^= rng_ << 5;
+    return rng_;
+  }
+};
+
+TEST_P(QuantizerEquivalenceTest, BitExact) {
+  const braids::Scale &scale = braids::scales[GetParam()];
+  const uint16_t masks[] = { 0xffff, 0x0001, 0x0aa5, 0x8001, 0x5555, 0x00f0 };
+
+  for (uint16_t mask : masks) {
+    braids::Quantizer quantizer;
+    ReferenceQuantizer reference;
+    quantizer.Init();
+    reference.Init();
+    quantizer.Configure(scale, mask);
+    reference.Configure(scale, mask);
+    ASSERT_EQ(reference.Process(0, 0, 0), quantizer.Process(0, 0, 0));
+
+    int32_t pitch = -5 * kOctave;
+    for (int i = 0; i < 20000; ++i) {
+      // mix slow ramps (hysteresis hits) with jumps, transposes and roots
+      const uint32_t r = Next();
+      if ((r & 0xff) < 8) pitch = int32_t(Next() % (20 * kOctave)) - 10 * kOctave;
+      else pitch += int32_t(r >> 28) - 6;
+      const int32_t root = (r & 0x100) ? int32_t((r >> 9) & 0xf) << 7 : 0;
+      const int32_t transpose = (r & 0x3000) == 0x3000 ? int32_t((r >> 14) % 15) - 7 : 0;
+      if ((r & 0x7ff0000) == 0) {
+        const uint8_t constraint = (r >> 27) % braids::OCTAVE_CONSTRAINT_LAST;
+        quantizer.ConfigureOctaveConstraint(constraint, 2);
+        reference.ConfigureOctaveConstraint(constraint, 2);
+      }
+
+      ASSERT_EQ(reference.Process(pitch, root, transpose), quantizer.Process(pitch, root, transpose))
+          << "mask " << mask << " pitch " << pitch << " root " << root << " transpose " << transpose;
+      if (quantizer.enabled()) {
+        ASSERT_EQ(reference.GetLatestNoteNumber(), quantizer.GetLatestNoteNumber());
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllScales, QuantizerEquivalenceTest,
+                         ::testing::Range(0, braids::kNumScales));
+
+TEST_F(QuantizerTest, UnsortedScaleMatchesReference) {
+  const braids::Scale unsorted = { 12 << 7, 5, { 896, 0, 1408, 384, 640 } };
+  ReferenceQuantizer reference;
+  reference.Init();
+  reference.Configure(unsorted);
+  quantizer_.Configure(unsorted);
+  for (int32_t pitch = -4 * kOctave; pitch < 4 * kOctave; pitch += 7) {
+    ASSERT_EQ(reference.Process(pitch, 0, 0), quantizer_.Process(pitch));
+  }
+}
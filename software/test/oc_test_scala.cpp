@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+#include <string.h>
+#include <string>
+#include "util/util_scala.h"
+
+namespace {
+
+using util::ScalaParser;
+
+bool ParseAll(ScalaParser &parser, const char *text, size_t chunk = 0) {
+  parser.Reset();
+  const size_t length = strlen(text);
+  if (!chunk) chunk = length;
+  for (size_t i = 0; i < length; i += chunk) {
+    if (!parser.Parse(text + i, chunk < length - i ? chunk : length - i)) break;
+  }
+  return parser.Finish();
+}
+
+const char kMeantone[] =
+  "! meanquar.scl\r\n"
+  "!\r\n"
+  "Meantone 1/4-comma \r\n"
+  " 12\r\n"
+  "!\r\n"
+  " 76.04900\r\n"
+  " 193.15686\r\n"
+  " 310.26471\r\n"
+  " 5/4\r\n"
+  " 503.42157\r\n"
+  " 579.47057\r\n"
+  " 696.57843\r\n"
+  " 25/16\r\n"
+  " 889.73529\r\n"
+  " 1006.84314\r\n"
+  " 1082.89214\r\n"
+  " 2/1\r\n";
+
+int16_t Cents(float cents) {
+  return static_cast<int16_t>(lroundf(cents * 1.28f));
+}
+
+TEST(TestScala, ParsesCentsAndRatios) {
+  ScalaParser parser;
+  ASSERT_TRUE(ParseAll(parser, kMeantone));
+  EXPECT_STREQ("Meantone 1/4-comma", parser.name());
+  ASSERT_EQ(12u, parser.num_notes());
+  EXPECT_EQ(0, parser.notes()[0]);
+  EXPECT_EQ(Cents(76.049f), parser.notes()[1]);
+  EXPECT_EQ(Cents(386.3137f), parser.notes()[4]); // 5/4
+  EXPECT_EQ(Cents(772.6274f), parser.notes()[8]); // 25/16
+  EXPECT_EQ(Cents(1082.89214f), parser.notes()[11]);
+  EXPECT_EQ(12 << 7, parser.span());
+}
+
+TEST(TestScala, ChunkSizeDoesNotMatter) {
+  ScalaParser whole, bytes;
+  ASSERT_TRUE(ParseAll(whole, kMeantone));
+  for (size_t chunk : {1, 3, 7, 64}) {
+    ASSERT_TRUE(ParseAll(bytes, kMeantone, chunk)) << chunk;
+    EXPECT_STREQ(whole.name(), bytes.name());
+    ASSERT_EQ(whole.num_notes(), bytes.num_notes());
+    EXPECT_EQ(0, memcmp(whole.notes(), bytes.notes(), whole.num_notes() * sizeof(int16_t)));
+  }
+}
+
+TEST(TestScala, IntegersAreRatios) {
+  // Bohlen-Pierce steps on a 3/1 period, plain integers, trailing text
+  ScalaParser parser;
+  ASSERT_TRUE(ParseAll(parser,
+    "BP\n"
+    "3\n"
+    "9/7 fourth-ish\n"
+    "7/5\n"
+    "3\n"));
+  ASSERT_EQ(3u, parser.num_notes());
+  EXPECT_EQ(Cents(435.0841f), parser.notes()[1]);
+  EXPECT_EQ(Cents(582.5122f), parser.notes()[2]);
+  EXPECT_EQ(Cents(1901.955f), parser.span());
+}
+
+TEST(TestScala, EmptyDescriptionAndNoTrailingNewline) {
+  ScalaParser parser;
+  ASSERT_TRUE(ParseAll(parser, "!comment\n\n2\n600.0\n1200.0"));
+  EXPECT_STREQ("", parser.name());
+  ASSERT_EQ(2u, parser.num_notes());
+  EXPECT_EQ(Cents(600.0f), parser.notes()[1]);
+  EXPECT_EQ(12 << 7, parser.span());
+}
+
+TEST(TestScala, LongScalesKeepFirstNotesAndPeriod) {
+  std::string text = "22-EDO, with a name much longer than the name buffer\n22\n";
+  for (int i = 1; i <= 22; ++i) text += std::to_string(i * 1200.0 / 22) + "\n";
+  ScalaParser parser;
+  ASSERT_TRUE(ParseAll(parser, text.c_str()));
+  EXPECT_EQ(ScalaParser::kNameLength - 1, strlen(parser.name()));
+  ASSERT_EQ(ScalaParser::kMaxNotes, parser.num_notes());
+  EXPECT_EQ(Cents(15 * 1200.0f / 22), parser.notes()[15]);
+  EXPECT_EQ(12 << 7, parser.span());
+}
+
+TEST(TestScala, FilesWithoutPeriod) {
+  // As SaveToScala wrote them before the period was added: the span is
+  // guessed from the notes
+  ScalaParser parser;
+  ASSERT_TRUE(ParseAll(parser, "O_C User Scale\n4\n200.0000\n1400.0000\n1700.0000\n"));
+  ASSERT_EQ(4u, parser.num_notes());
+  EXPECT_EQ(24 << 7, parser.span());
+
+  ASSERT_TRUE(ParseAll(parser, "O_C User Scale\n3\n200.0000\n700.0000\n"));
+  EXPECT_EQ(12 << 7, parser.span());
+}
+
+TEST(TestScala, RejectsIncompleteFiles) {
+  ScalaParser parser;
+  EXPECT_FALSE(ParseAll(parser, ""));
+  EXPECT_FALSE(ParseAll(parser, "! only comments\n"));
+  EXPECT_FALSE(ParseAll(parser, "name\nzero\n"));
+  EXPECT_FALSE(ParseAll(parser, "name\n0\n"));
+  EXPECT_FALSE(ParseAll(parser, "name\n5\n100.0\n200.0\n"));
+  EXPECT_FALSE(ParseAll(parser, "name\n3\n100.0\n-3/2\n1200.0\n"));
+  EXPECT_FALSE(ParseAll(parser, "name\n3\n100.0\n3/0\n1200.0\n"));
+}
+
+} // namespace
@@ -0,0 +1,151 @@
+#include "gtest/gtest.h"
+#include <stdlib.h>
+#include "util/util_screenstream.h"
+
+namespace {
+
+constexpr size_t kFrameSize = 1024;
+using Encoder = util::ScreenStreamEncoder<kFrameSize>;
+
+// Mirrors software/res/screenstream.py
+class Decoder {
+public:
+  Decoder() { memset(frame, 0, sizeof(frame)); }
+
+  bool Decode(const uint8_t *packet, size_t size) {
+    if (size < Encoder::kHeaderSize + Encoder::kChecksumSize) return false;
+    if (packet[0] != Encoder::kSync0 || packet[1] != Encoder::kSync1) return false;
+    const size_t length = packet[4] | packet[5] << 8;
+    if (size != Encoder::kHeaderSize + length + Encoder::kChecksumSize) return false;
+    const uint16_t checksum = packet[size - 2] | packet[size - 1] << 8;
+    if (checksum != Encoder::Fletcher16(packet + 2, Encoder::kHeaderSize - 2 + length)) return false;
+
+    uint8_t data[kFrameSize];
+    const uint8_t *src = packet + Encoder::kHeaderSize, *end = src + length;
+    size_t n = 0;
+    while (src < end) {
+      const uint8_t control = *src++;
+      const size_t count = control < 0x80 ? control + 1 : control - 0x80 + 2;
+      if (n + count > kFrameSize) return false;
+      if (control < 0x80) {
+        for (size_t i = 0; i < count; ++i) data[n++] = *src++;
+      } else {
+        for (size_t i = 0; i < count; ++i) data[n++] = *src;
+        ++src;
+      }
+    }
+    if (n != kFrameSize) return false;
+
+    type = packet[2];
+    for (size_t i = 0; i < kFrameSize; ++i)
+      frame[i] = (type == Encoder::kDelta) ? frame[i] ^ data[i] : data[i];
+    return true;
+  }
+
+  uint8_t frame[kFrameSize];
+  uint8_t type = 0;
+};
+
+void random_frame(uint8_t *frame, int density) {
+  for (size_t i = 0; i < kFrameSize; ++i) frame[i] = (rand() % 100 < density) ? rand() & 0xff : 0;
+}
+
+TEST(TestScreenStream, RoundTrip) {
+  static Encoder encoder;
+  encoder.Init();
+  Decoder decoder;
+  uint8_t frame[kFrameSize];
+  uint8_t packet[Encoder::kMaxPacketSize];
+
+  srand(1234);
+  for (int n = 0; n < 200; ++n) {
+    if (n % 20 == 0) {
+      random_frame(frame, n % 100);
+    } else {
+      // a few changed bytes, like a cursor or a scrolling value
+      for (int c = 0; c < 4; ++c) frame[rand() % kFrameSize] ^= 1 << (rand() % 8);
+    }
+
+    const size_t size = encoder.Encode(frame, packet);
+    ASSERT_GT(size, 0U);
+    ASSERT_LE(size, Encoder::kMaxPacketSize);
+    ASSERT_TRUE(decoder.Decode(packet, size)) << "frame " << n;
+    ASSERT_EQ(0, memcmp(frame, decoder.frame, kFrameSize)) << "frame " << n;
+    EXPECT_EQ(n & 0xff, packet[3]);
+  }
+}
+
+TEST(TestScreenStream, DeltasAreSmall) {
+  static Encoder encoder;
+  encoder.Init();
+  uint8_t frame[kFrameSize];
+  uint8_t packet[Encoder::kMaxPacketSize];
+
+  srand(99);
+  random_frame(frame, 30);
+  const size_t key_size = encoder.Encode(frame, packet);
+  EXPECT_EQ(Encoder::kKeyframe, packet[2]);
+
+  EXPECT_EQ(0U, encoder.Encode(frame, packet)); // unchanged
+
+  frame[500] ^= 0x10;
+  const size_t delta_size = encoder.Encode(frame, packet);
+  EXPECT_EQ(Encoder::kDelta, packet[2]);
+  EXPECT_LT(delta_size, 32U);
+  EXPECT_LT(delta_size, key_size);
+
+  encoder.RequestKeyframe();
+  EXPECT_GT(encoder.Encode(frame, packet), delta_size);
+  EXPECT_EQ(Encoder::kKeyframe, packet[2]);
+}
+
+TEST(TestScreenStream, PeriodicKeyframes) {
+  static Encoder encoder;
+  encoder.Init();
+  uint8_t frame[kFrameSize] = {0};
+  uint8_t packet[Encoder::kMaxPacketSize];
+
+  int keyframes = 0;
+  for (int n = 0; n < Encoder::kKeyframeInterval * 3; ++n) {
+    frame[n % kFrameSize] ^= 1;
+    ASSERT_GT(encoder.Encode(frame, packet), 0U);
+    if (packet[2] == Encoder::kKeyframe) ++keyframes;
+  }
+  EXPECT_EQ(3, keyframes);
+}
+
+TEST(TestScreenStream, WorstCaseFits) {
+  static Encoder encoder;
+  encoder.Init();
+  Decoder decoder;
+  uint8_t frame[kFrameSize];
+  uint8_t packet[Encoder::kMaxPacketSize];
+
+  // no runs at all, and runs of exactly 2 between literals
+  for (size_t i = 0; i < kFrameSize; ++i) frame[i] = i * 7 + 1;
+  size_t size = encoder.Encode(frame, packet);
+  ASSERT_LE(size, Encoder::kMaxPacketSize);
+  ASSERT_TRUE(decoder.Decode(packet, size));
+  EXPECT_EQ(0, memcmp(frame, decoder.frame, kFrameSize));
+
+  for (size_t i = 0; i < kFrameSize; ++i) frame[i] = (i / 2) * 3 + (i % 5 == 0);
+  size = encoder.Encode(frame, packet);
+  ASSERT_LE(size, Encoder::kMaxPacketSize);
+  ASSERT_TRUE(decoder.Decode(packet, size));
+  EXPECT_EQ(0, memcmp(frame, decoder.frame, kFrameSize));
+}
+
+TEST(TestScreenStream, CorruptPacketIsRejected) {
+  static Encoder encoder;
+  encoder.Init();
+  Decoder decoder;
+  uint8_t frame[kFrameSize] = {0};
+  uint8_t packet[Encoder::kMaxPacketSize];
+
+  frame[10] = 0xff;
+  const size_t size = encoder.Encode(frame, packet);
+  packet[Encoder::kHeaderSize] ^= 0x01;
+  EXPECT_FALSE(decoder.Decode(packet, size));
+}
+
+} // namespace
@@ -0,0 +1,327 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include "util/util_settings.h"
+#include "util/util_sysex.h"
+
+namespace {
+
+// The packing loop from _SysExData::pack() in HSMIDI.h, without the size cap
+std::vector<uint8_t> ReferencePack(const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> packed;
+  uint8_t packbyte = 0, pos = 0;
+  uint8_t packet[7];
+  for (uint8_t c : data) {
+    if (pos == 7) {
+      packed.push_back(packbyte);
+      packed.insert(packed.end(), packet, packet + pos);
+      packbyte = 0;
+      pos = 0;
+    }
+    if (c & 0x80) {
+      packbyte += (1 << pos);
+      c &= 0x7f;
+    }
+    packet[pos++] = c;
+  }
+  packed.push_back(packbyte);
+  packed.insert(packed.end(), packet, packet + pos);
+  return packed;
+}
+
+std::vector<uint8_t> RandomBytes(uint32_t &state, size_t n) {
+  std::vector<uint8_t> data(n);
+  for (auto &c : data) {
+    state = state * 1664525u + 1013904223u;
+    c = state >> 24;
+  }
+  return data;
+}
+
+TEST(TestSysEx, PackMatchesLegacy) {
+  uint32_t state = 1;
+  for (size_t n = 1; n < 100; ++n) {
+    const auto data = RandomBytes(state, n);
+    std::vector<uint8_t> buffer(util::SysExPacker::PackedSize(n) + 4, 0xaa);
+
+    util::SysExPacker packer{buffer};
+    // Mix of single bytes and larger writes
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      uint32_t word;
+      memcpy(&word, &data[i], 4);
+      packer.Write(word);
+    }
+    packer.Write(&data[i], n - i);
+    ASSERT_FALSE(packer.overflow());
+    ASSERT_EQ(util::SysExPacker::PackedSize(n), packer.written());
+
+    buffer.resize(packer.written());
+    EXPECT_EQ(ReferencePack(data), buffer) << n << " bytes";
+    for (uint8_t c : buffer) EXPECT_EQ(0, c & 0x80);
+  }
+}
+
+TEST(TestSysEx, RoundTrip) {
+  uint32_t state = 7;
+  for (size_t n = 0; n < 100; ++n) {
+    const auto data = RandomBytes(state, n);
+    std::vector<uint8_t> buffer(util::SysExPacker::PackedSize(n) + 1);
+    util::SysExPacker packer{buffer};
+    packer.Write(data.data(), n);
+    buffer[packer.written()] = 0xf7; // reading stops at end-of-exclusive
+
+    util::SysExUnpacker unpacker{buffer};
+    ASSERT_EQ(n, unpacker.available());
+    std::vector<uint8_t> unpacked(n + 10);
+    EXPECT_EQ(n, unpacker.Read(unpacked.data(), unpacked.size()));
+    unpacked.resize(n);
+    EXPECT_EQ(data, unpacked);
+    EXPECT_EQ(0U, unpacker.available());
+    EXPECT_EQ(0, unpacker.Read<uint8_t>());
+    EXPECT_TRUE(unpacker.underflow());
+  }
+}
+
+TEST(TestSysEx, Available) {
+  // A frame's 55 payload bytes hold 48 data bytes
+  std::vector<uint8_t> buffer(55);
+  util::SysExPacker packer{buffer};
+  EXPECT_EQ(48U, packer.available());
+  size_t written = 0;
+  while (packer.available()) {
+    const size_t before = packer.available();
+    packer.Write<uint8_t>(0x80 | written);
+    ++written;
+    ASSERT_EQ(before - 1, packer.available());
+  }
+  EXPECT_EQ(48U, written);
+  EXPECT_EQ(55U, packer.written());
+  EXPECT_FALSE(packer.overflow());
+
+  packer.Write<uint8_t>(0);
+  EXPECT_TRUE(packer.overflow());
+  EXPECT_EQ(55U, packer.written());
+
+  util::SysExPacker small{buffer.data(), 5};
+  small.Write<uint32_t>(0);
+  EXPECT_FALSE(small.overflow());
+  small.Write<uint8_t>(0);
+  EXPECT_TRUE(small.overflow());
+}
+
+class TestChunkedSettings : public settings::SettingsBase<TestChunkedSettings, 40> {
+public:
+  int *values() { return values_.data(); }
+  SETTINGS_ARRAY_DECLARE() {{
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, -128, 127, "I8", nullptr, settings::STORAGE_TYPE_I8 },
+    { 0, 0, 65535, "U16", nullptr, settings::STORAGE_TYPE_U16 },
+    { 0, -100000, 100000, "I32", nullptr, settings::STORAGE_TYPE_I32 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, 0, 255, "U8", nullptr, settings::STORAGE_TYPE_U8 },
+    { 0, 0, 0, "NOP", nullptr, settings::STORAGE_TYPE_NOP },
+    { 0, -30000, 30000, "I16", nullptr, settings::STORAGE_TYPE_I16 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, 0, 1000000, "U32", nullptr, settings::STORAGE_TYPE_U32 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, 0, 255, "U8", nullptr, settings::STORAGE_TYPE_U8 },
+    { 0, 0, 255, "U8", nullptr, settings::STORAGE_TYPE_U8 },
+    { 0, 0, 255, "U8", nullptr, settings::STORAGE_TYPE_U8 },
+    { 0, 0, 255, "U8", nullptr, settings::STORAGE_TYPE_U8 },
+    { 0, -30000, 30000, "I16", nullptr, settings::STORAGE_TYPE_I16 },
+    { 0, -30000, 30000, "I16", nullptr, settings::STORAGE_TYPE_I16 },
+    { 0, -30000, 30000, "I16", nullptr, settings::STORAGE_TYPE_I16 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, -100000, 100000, "I32", nullptr, settings::STORAGE_TYPE_I32 },
+    { 0, -100000, 100000, "I32", nullptr, settings::STORAGE_TYPE_I32 },
+    { 0, -100000, 100000, "I32", nullptr, settings::STORAGE_TYPE_I32 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, 0, 255, "U8", nullptr, settings::STORAGE_TYPE_U8 },
+    { 0, 0, 65535, "U16", nullptr, settings::STORAGE_TYPE_U16 },
+    { 0, 0, 65535, "U16", nullptr, settings::STORAGE_TYPE_U16 },
+    { 0, 0, 65535, "U16", nullptr, settings::STORAGE_TYPE_U16 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, -128, 127, "I8", nullptr, settings::STORAGE_TYPE_I8 },
+    { 0, -128, 127, "I8", nullptr, settings::STORAGE_TYPE_I8 },
+    { 0, -100000, 100000, "I32", nullptr, settings::STORAGE_TYPE_I32 },
+    { 0, -100000, 100000, "I32", nullptr, settings::STORAGE_TYPE_I32 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+    { 0, 0, 65535, "U16", nullptr, settings::STORAGE_TYPE_U16 },
+    { 0, 0, 15, "U4", nullptr, settings::STORAGE_TYPE_U4 },
+  }};
+};
+SETTINGS_ARRAY_DEFINE(TestChunkedSettings);
+
+const settings::ValueAttributes *chunked_attributes = TestChunkedSettings::value_attributes_array.data();
+
+void Randomize(TestChunkedSettings &s, uint32_t &state) {
+  for (size_t i = 0; i < 40; ++i) {
+    state = state * 1664525u + 1013904223u;
+    s.apply_value(i, static_cast<int>(state) >> 8);
+  }
+}
+
+TEST(TestSysEx, StorageSize) {
+  EXPECT_EQ(TestChunkedSettings::storageSize(),
+            settings::SettingsRW::StorageSize(chunked_attributes, 40));
+  for (size_t first = 0; first < 40; ++first) {
+    for (size_t max_bytes = 0; max_bytes < 20; ++max_bytes) {
+      const size_t n = settings::SettingsRW::ChunkLength(chunked_attributes + first, 40 - first, max_bytes);
+      EXPECT_LE(settings::SettingsRW::StorageSize(chunked_attributes + first, n), max_bytes);
+      if (first + n < 40) {
+        EXPECT_GT(settings::SettingsRW::StorageSize(chunked_attributes + first, n + 1), max_bytes);
+      }
+    }
+  }
+}
+
+// Whole settings in one go through the packer, same bytes as the plain stream
+TEST(TestSysEx, SettingsMatchStream) {
+  uint32_t state = 3;
+  TestChunkedSettings a;
+  a.InitDefaults();
+  Randomize(a, state);
+
+  std::vector<uint8_t> plain(TestChunkedSettings::storageSize());
+  util::StreamBufferWriter writer{plain};
+  a.Save(writer);
+  ASSERT_FALSE(writer.overflow());
+
+  std::vector<uint8_t> packed(util::SysExPacker::PackedSize(plain.size()));
+  util::SysExPacker packer{packed};
+  settings::SettingsRW::Write(a.values(), chunked_attributes, 40, packer);
+  ASSERT_FALSE(packer.overflow());
+  EXPECT_EQ(ReferencePack(plain), packed);
+
+  TestChunkedSettings b;
+  b.InitDefaults();
+  util::SysExUnpacker unpacker{packed};
+  settings::SettingsRW::Read(b.values(), chunked_attributes, 40, unpacker);
+  EXPECT_FALSE(unpacker.underflow());
+  for (size_t i = 0; i < 40; ++i) EXPECT_EQ(a.get_value(i), b.get_value(i)) << i;
+}
+
+// The way SendSysExSettings() in HSMIDI.h sends settings: a message per chunk,
+// unchanged chunks skipped
+struct Message {
+  std::vector<uint8_t> payload;
+};
+
+size_t SendChunks(const TestChunkedSettings &s, uint32_t *hashes,
+                  std::vector<Message> &messages) {
+  static constexpr size_t kMaxBytes = 48;
+  size_t chunk = 0, first = 0;
+  for (size_t count; (count = s.ChunkLength(first, kMaxBytes)); ++chunk) {
+    const uint32_t hash = s.ChunkHash(first, count);
+    if (hashes[chunk] != hash) {
+      hashes[chunk] = hash;
+      Message m;
+      m.payload.resize(55);
+      util::SysExPacker packer{m.payload};
+      s.SaveChunk(first, count, packer);
+      EXPECT_FALSE(packer.overflow());
+      EXPECT_LE(packer.written(), util::SysExPacker::PackedSize(kMaxBytes));
+      m.payload.resize(packer.written());
+      messages.push_back(m);
+    }
+    first += count;
+  }
+  EXPECT_EQ(40U, first);
+  return chunk;
+}
+
+void ReceiveChunks(const std::vector<Message> &messages, TestChunkedSettings &s) {
+  for (const auto &m : messages) {
+    util::SysExUnpacker unpacker{m.payload};
+    EXPECT_TRUE(s.RestoreChunk(unpacker));
+    EXPECT_FALSE(unpacker.underflow());
+  }
+}
+
+TEST(TestSysEx, ChunkedSettings) {
+  uint32_t state = 11;
+  TestChunkedSettings a, b;
+  a.InitDefaults();
+  b.InitDefaults();
+  Randomize(a, state);
+
+  uint32_t hashes[8] = {};
+  std::vector<Message> messages;
+  const size_t chunks = SendChunks(a, hashes, messages);
+  ASSERT_LE(chunks, 8U);
+  EXPECT_GT(chunks, 1U);
+  EXPECT_EQ(chunks, messages.size());
+  ReceiveChunks(messages, b);
+  for (size_t i = 0; i < 40; ++i) ASSERT_EQ(a.get_value(i), b.get_value(i)) << i;
+
+  // Nothing changed, nothing sent
+  messages.clear();
+  SendChunks(a, hashes, messages);
+  EXPECT_TRUE(messages.empty());
+
+  // One change, one message
+  a.change_value(30, 1);
+  SendChunks(a, hashes, messages);
+  EXPECT_EQ(1U, messages.size());
+  ReceiveChunks(messages, b);
+  for (size_t i = 0; i < 40; ++i) ASSERT_EQ(a.get_value(i), b.get_value(i)) << i;
+}
+
+TEST(TestSysEx, RestoreChunkChecksMessage) {
+  TestChunkedSettings a, b;
+  a.InitDefaults();
+  b.InitDefaults();
+  a.apply_value(7, 200);
+  a.apply_value(13, 999999);
+
+  const size_t count = a.ChunkLength(5, 48);
+  ASSERT_GT(count, 9U);
+  std::vector<uint8_t> payload(55);
+  util::SysExPacker packer{payload};
+  a.SaveChunk(5, count, packer);
+  payload.resize(packer.written());
+
+  // truncated
+  std::vector<uint8_t> truncated(payload.begin(), payload.end() - 8);
+  util::SysExUnpacker short_unpacker{truncated};
+  EXPECT_FALSE(b.RestoreChunk(short_unpacker));
+  EXPECT_EQ(0, b.get_value(7));
+
+  // past the end of the settings
+  std::vector<uint8_t> bad(55);
+  util::SysExPacker bad_packer{bad};
+  bad_packer.Write<uint16_t>(38);
+  bad_packer.Write<uint8_t>(3);
+  bad_packer.Write<uint32_t>(0);
+  bad.resize(bad_packer.written());
+  util::SysExUnpacker bad_unpacker{bad};
+  EXPECT_FALSE(b.RestoreChunk(bad_unpacker));
+
+  util::SysExUnpacker unpacker{payload};
+  ASSERT_TRUE(b.RestoreChunk(unpacker));
+  EXPECT_EQ(200, b.get_value(7));
+  EXPECT_EQ(999999, b.get_value(13));
+}
+
+TEST(TestSysEx, RestoreChunkClamps) {
+  TestChunkedSettings b;
+  b.InitDefaults();
+  // I32 storage holds more than the attributes allow
+  std::vector<uint8_t> payload(55);
+  util::SysExPacker packer{payload};
+  packer.Write<uint16_t>(5);
+  packer.Write<uint8_t>(1);
+  packer.Write<int32_t>(200000);
+  payload.resize(packer.written());
+
+  util::SysExUnpacker unpacker{payload};
+  ASSERT_TRUE(b.RestoreChunk(unpacker));
+  EXPECT_EQ(100000, b.get_value(5));
+}
+
+} // namespace
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include "util/util_task_queue.h"
+
+namespace {
+
+using Task = util::InplaceTask<sizeof(void *)>;
+
+int calls = 0;
+void Increment() { ++calls; }
+
+TEST(TestTaskQueue, InplaceTaskInvokes) {
+  calls = 0;
+  Task empty;
+  EXPECT_FALSE(empty);
+
+  Task fn(&Increment);
+  ASSERT_TRUE(fn);
+  fn();
+  EXPECT_EQ(1, calls);
+
+  Task lambda([]() { calls += 10; });
+  lambda();
+  EXPECT_EQ(11, calls);
+
+  int target = 0;
+  int *p = &target;
+  Task capture([p]() { *p = 42; });
+  Task copy = capture;
+  copy();
+  EXPECT_EQ(42, target);
+}
+
+TEST(TestTaskQueue, FifoOrder) {
+  util::MPSCQueue<int, 8> q;
+  for (int i = 0; i < 5; ++i) EXPECT_TRUE(q.Push(i));
+  EXPECT_EQ(5U, q.size());
+
+  int value;
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(q.Pop(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(q.Pop(value));
+  EXPECT_EQ(0U, q.size());
+}
+
+TEST(TestTaskQueue, FullQueueDropsAndCounts) {
+  util::MPSCQueue<int, 4> q;
+  for (int i = 0; i < 6; ++i) EXPECT_EQ(i < 4, q.Push(i));
+  EXPECT_EQ(2U, q.dropped());
+  EXPECT_EQ(4U, q.peak());
+
+  int value;
+  ASSERT_TRUE(q.Pop(value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(q.Push(100));
+  EXPECT_FALSE(q.Push(101));
+  EXPECT_EQ(3U, q.dropped());
+
+  std::vector<int> rest;
+  while (q.Pop(value)) rest.push_back(value);
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 100}), rest);
+
+  q.ResetStats();
+  EXPECT_EQ(0U, q.dropped());
+  EXPECT_EQ(0U, q.peak());
+}
+
+TEST(TestTaskQueue, WrapsAround) {
+  util::MPSCQueue<uint32_t, 4> q;
+  uint32_t next = 0, expected = 0, value;
+  for (int round = 0; round < 1000; ++round) {
+    const int n = 1 + round % 4;
+    for (int i = 0; i < n; ++i) EXPECT_TRUE(q.Push(next++));
+    for (int i = 0; i < n; ++i) {
+      ASSERT_TRUE(q.Pop(value));
+      EXPECT_EQ(expected++, value);
+    }
+  }
+  EXPECT_EQ(0U, q.dropped());
+  EXPECT_EQ(4U, q.peak());
+}
+
+// Tasks that queue more tasks while the queue is being drained, the way an
+// ISR firing during FlushTasks() does
+util::MPSCQueue<Task, 8> *reentrant_queue;
+std::vector<int> order;
+
+TEST(TestTaskQueue, PushWhileDraining) {
+  util::MPSCQueue<Task, 8> q;
+  reentrant_queue = &q;
+  order.clear();
+
+  q.Push([]() {
+    order.push_back(1);
+    reentrant_queue->Push([]() { order.push_back(3); });
+  });
+  q.Push([]() { order.push_back(2); });
+
+  Task task;
+  while (q.Pop(task)) task();
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), order);
+  EXPECT_EQ(0U, q.dropped());
+}
+
+} // namespace
@@ -0,0 +1,169 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include "vector_osc/HSVectorOscillator.h"
+
+namespace {
+
+struct Rng {
+  uint32_t state;
+  uint32_t operator()() {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  }
+};
+
+void RandomWaveform(Rng &rng, VectorOscillator &a, VectorOscillator &b) {
+  const int count = 2 + rng() % (HS::VO_MAX_SEGMENTS - 1);
+  for (int i = 0; i < count; ++i) {
+    // 0-9, like the waveform editor, with extra zero-length segments
+    const uint8_t time = (rng() % 4) ? rng() % 10 : 0;
+    HS::VOSegment seg = {uint8_t(rng() % 256), time};
+    a.SetSegment(seg);
+    b.SetSegment(seg);
+  }
+}
+
+// Render() in random block sizes against Next() one sample at a time
+void ExpectEquivalent(VectorOscillator &next, VectorOscillator &block, Rng &rng, size_t samples) {
+  std::vector<int32_t> expected(samples), actual(samples);
+  for (size_t i = 0; i < samples; ++i) expected[i] = next.Next();
+
+  size_t done = 0;
+  while (done < samples) {
+    const size_t n = std::min<size_t>(samples - done, rng() % 40);
+    block.Render(actual.data() + done, n);
+    done += n;
+  }
+
+  for (size_t i = 0; i < samples; ++i) {
+    ASSERT_EQ(expected[i], actual[i]) << "sample " << i;
+  }
+  EXPECT_EQ(next.GetPhase(), block.GetPhase());
+  EXPECT_EQ(next.GetEOC(), block.GetEOC());
+}
+
+TEST(TestVectorOscillator, RenderMatchesNext) {
+  Rng rng{1};
+  for (int trial = 0; trial < 200; ++trial) {
+    VectorOscillator next, block;
+    RandomWaveform(rng, next, block);
+
+    const uint16_t scale = 1 + rng() % 9216; // up to HEMISPHERE_MAX_CV on T4
+    const int16_t offset = (rng() % 2) ? scale : 0;
+    // from sub-Hz LFO up to a few kHz
+    const uint32_t freq = (trial % 3 == 0) ? 1 + rng() % 1000 : 1 + rng() % 400000;
+    for (VectorOscillator *osc : {&next, &block}) {
+      osc->SetScale(scale);
+      osc->Offset(offset);
+      osc->SetFrequency(freq);
+      osc->Reset();
+    }
+    ExpectEquivalent(next, block, rng, 5000);
+
+    // frequency and phase changes between blocks
+    const uint32_t freq2 = 1 + rng() % 200000;
+    const uint32_t phase = rng() << 8;
+    for (VectorOscillator *osc : {&next, &block}) {
+      osc->SetFrequency(freq2);
+      osc->Reset(phase);
+    }
+    ExpectEquivalent(next, block, rng, 2000);
+  }
+}
+
+TEST(TestVectorOscillator, RenderHugeIncrement) {
+  // phase wraps more than once per segment
+  Rng rng{7};
+  for (int trial = 0; trial < 50; ++trial) {
+    VectorOscillator next, block;
+    RandomWaveform(rng, next, block);
+    const uint32_t increment = 0x80000000u + (rng() << 4);
+    for (VectorOscillator *osc : {&next, &block}) {
+      osc->SetScale(1000);
+      osc->SetPhaseIncrement(increment);
+      osc->Reset();
+    }
+    ExpectEquivalent(next, block, rng, 1000);
+  }
+}
+
+TEST(TestVectorOscillator, RenderEnvelopes) {
+  Rng rng{12345};
+  for (int trial = 0; trial < 50; ++trial) {
+    VectorOscillator next, block;
+    RandomWaveform(rng, next, block);
+    const bool sustain = trial & 1;
+    const uint32_t freq = 100 + rng() % 20000;
+    for (VectorOscillator *osc : {&next, &block}) {
+      osc->SetScale(2000);
+      osc->Cycle(false);
+      osc->Sustain(sustain);
+      osc->SetFrequency(freq);
+      osc->Start();
+    }
+    ExpectEquivalent(next, block, rng, 3000);
+    if (sustain) {
+      next.Release();
+      block.Release();
+      ExpectEquivalent(next, block, rng, 3000);
+    }
+  }
+}
+
+TEST(TestVectorOscillator, RenderIdle) {
+  VectorOscillator next, block;
+  // one segment: not a valid waveform, holds still
+  next.SetSegment({200, 10});
+  block.SetSegment({200, 10});
+  next.SetScale(1000);
+  block.SetScale(1000);
+  next.SetFrequency(1000);
+  block.SetFrequency(1000);
+  Rng rng{3};
+  ExpectEquivalent(next, block, rng, 100);
+}
+
+// With a total time that doesn't divide 2^32, time_unit * total_time falls
+// short of the end of the phase range; the last segment has to cover the gap
+TEST(TestVectorOscillator, PhasePastLastSegmentTime) {
+  VectorOscillator osc;
+  osc.SetSegment({255, 3});
+  osc.SetSegment({0, 4});
+  osc.SetScale(1000);
+  osc.SetPhaseIncrement(1);
+  osc.Reset(0xfffffffd);
+
+  // the ramp down from 255 has just about reached 0
+  EXPECT_NEAR(-1000, osc.Next(), 5);
+  EXPECT_NEAR(-1000, osc.Next(), 5);
+  EXPECT_EQ(0xffffffffu, osc.GetPhase());
+  EXPECT_NEAR(-1000, osc.Phase(3599), 5);
+
+  // and wraps into the first segment
+  osc.Next();
+  EXPECT_EQ(0u, osc.GetPhase());
+}
+
+TEST(TestVectorOscillator, RandomWaveformsSettle) {
+  // 0-9, like the waveform editor, with extra zero-length segments; huge
+  // increments wrap more than once per segment
+  Rng rng{1};
+  for (int trial = 0; trial < 200; ++trial) {
+    VectorOscillator osc;
+    const int count = 2 + rng() % (HS::VO_MAX_SEGMENTS - 1);
+    for (int i = 0; i < count; ++i) {
+      const uint8_t time = (rng() % 4) ? rng() % 10 : 0;
+      osc.SetSegment({uint8_t(rng() % 256), time});
+    }
+    osc.SetScale(1000);
+    osc.SetPhaseIncrement((trial & 1) ? 0x80000000u + (rng() << 4) : rng() << 6);
+    osc.Reset(rng() << 8);
+    for (int i = 0; i < 2000; ++i) {
+      const int32_t value = osc.Next();
+      ASSERT_LE(value, 1000);
+      ASSERT_GE(value, -1000);
+    }
+  }
+}
+
+} // namespace